@@ -540,6 +540,13 @@ void ParseCommandLine(int argc, const char* argv[],
         })
         .Help("Alters format of output file for the model. Supported values {CatboostBinary, AppleCoreML, CPP, Python}. Default is CatboostBinary. Corresponding extensions will be added to model-file if more than one format is set.");
 
+    parser.AddLongOption("precompute-ctr-values")
+        .NoArgument()
+        .Handler0([plainJsonPtr]() {
+            (*plainJsonPtr).InsertValue("precompute_ctr_values", true);
+        })
+        .Help("Store precomputed ctr values in CatboostBinary model. Model file is larger, but ctrs are applied faster.");
+
     parser.AddLongOption("one-hot-max-size")
         .RequiredArgument("size_t")
         .Handler1T<size_t>([plainJsonPtr](const size_t oneHotMaxSize) {
@@ -26,30 +26,32 @@ static TEvalResult Apply(
 {
     TEvalResult resultApprox;
     TVector<TVector<TVector<double>>>& rawValues = resultApprox.GetRawValuesRef();
-    rawValues.resize(1);
-    if (pool.Docs.Baseline.ysize() > 0) {
-        rawValues[0].assign(pool.Docs.Baseline.begin(), pool.Docs.Baseline.end());
+    const size_t docCount = pool.Docs.GetDocCount();
+    const size_t approxDimension = model.ObliviousTrees.ApproxDimension;
+    TVector<double> stagedApprox;
+    size_t stageCount = 1;
+    if (begin < end) {
+        stageCount = GetStageTreeEnds(begin, end, evalPeriod).size();
+        stagedApprox.yresize(stageCount * approxDimension * docCount);
+        ApplyModelStaged(model, pool, begin, end, evalPeriod, *executor, stagedApprox);
     } else {
-        rawValues[0].resize(model.ObliviousTrees.ApproxDimension, TVector<double>(pool.Docs.GetDocCount(), 0.0));
+        // empty tree range still gives one stage with baseline values only
+        stagedApprox.resize(approxDimension * docCount, 0.0);
     }
-    TModelCalcerOnPool modelCalcerOnPool(model, pool, *executor);
-    TVector<double> flatApprox;
-    TVector<TVector<double>> approx;
-    for (; begin < end; begin += evalPeriod) {
-        modelCalcerOnPool.ApplyModelMulti(EPredictionType::RawFormulaVal,
-                                          begin,
-                                          Min(begin + evalPeriod, end),
-                                          &flatApprox,
-                                          &approx);
 
-        for (size_t i = 0; i < approx.size(); ++i) {
-            for (size_t j = 0; j < approx[0].size(); ++j) {
-                rawValues.back()[i][j] += approx[i][j];
+    rawValues.resize(stageCount);
+    for (size_t stageIdx = 0; stageIdx < stageCount; ++stageIdx) {
+        auto& stageValues = rawValues[stageIdx];
+        stageValues.resize(approxDimension);
+        for (size_t dim = 0; dim < approxDimension; ++dim) {
+            const double* stageDimApprox = stagedApprox.data() + (stageIdx * approxDimension + dim) * docCount;
+            stageValues[dim].assign(stageDimApprox, stageDimApprox + docCount);
+            if (pool.Docs.Baseline.ysize() > 0) {
+                for (size_t doc = 0; doc < docCount; ++doc) {
+                    stageValues[dim][doc] += pool.Docs.Baseline[dim][doc];
+                }
             }
         }
-        if (begin + evalPeriod < end) {
-            rawValues.push_back(rawValues.back());
-        }
     }
     return resultApprox;
 }
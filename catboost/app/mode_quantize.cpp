@@ -0,0 +1,241 @@
+#include "modes.h"
+#include "cmd_line.h"
+#include "proceed_pool_in_blocks.h"
+
+#include <catboost/idl/pool/proto/quantization_schema.pb.h>
+#include <catboost/libs/algo/feature_values_sketch.h>
+#include <catboost/libs/algo/helpers.h>
+#include <catboost/libs/data/load_data.h>
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/logging/logging.h>
+#include <catboost/libs/options/enums.h>
+#include <catboost/libs/quantized_pool/serialization.h>
+
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/maybe.h>
+#include <util/generic/ymath.h>
+#include <util/stream/file.h>
+#include <util/string/cast.h>
+
+struct TModeQuantizeParams {
+    int BorderCount = 128;
+    EBorderSelectionType BorderType = EBorderSelectionType::GreedyLogSum;
+    ENanMode NanMode = ENanMode::Min;
+    int ReadBlockSize = 32768;
+    size_t SketchSize = 200000;
+
+    void BindParserOpts(NLastGetopt::TOpts& parser) {
+        parser.AddLongOption('x', "border-count", "count of borders per float feature. Should be in range [1, 254]")
+                .RequiredArgument("INT")
+                .DefaultValue("128")
+                .StoreResult(&BorderCount);
+        parser.AddLongOption("feature-border-type", "Should be one of: Median, GreedyLogSum, UniformAndQuantiles, MinEntropy, MaxLogSum")
+                .RequiredArgument("border-type")
+                .DefaultValue("GreedyLogSum")
+                .StoreResult(&BorderType);
+        parser.AddLongOption("nan-mode", "Should be one of: {Min, Forbidden}. Default: Min")
+                .RequiredArgument("nan-mode")
+                .DefaultValue("Min")
+                .StoreResult(&NanMode);
+        parser.AddLongOption("block-size", "Read block size")
+                .RequiredArgument("INT")
+                .DefaultValue("32768")
+                .StoreResult(&ReadBlockSize);
+        parser.AddLongOption("sketch-size", "Number of distinct values kept per feature to select borders")
+                .RequiredArgument("INT")
+                .DefaultValue("200000")
+                .StoreResult(&SketchSize);
+    }
+
+    void Validate() const {
+        // bins are stored in one byte, NaN border for nan_mode=Min takes one more bin
+        CB_ENSURE(BorderCount > 0 && BorderCount < 255, "Border count should be in range [1, 254]");
+        CB_ENSURE(NanMode != ENanMode::Max, "nan_mode=Max is not supported for quantized pools");
+        CB_ENSURE(ReadBlockSize > 0, "Block size should be positive");
+        CB_ENSURE(SketchSize > 0, "Sketch size should be positive");
+    }
+};
+
+static TVector<float> SelectQuantizedPoolBorders(const TFeatureValuesSketch& sketch, const TModeQuantizeParams& quantizeParams) {
+    TVector<float> values = sketch.MakeSample(quantizeParams.SketchSize);
+    TVector<float> borders = SelectBorders(&values, quantizeParams.BorderCount, quantizeParams.BorderType);
+    if (sketch.HasNans()) {
+        CB_ENSURE(quantizeParams.NanMode == ENanMode::Min,
+                  "There are nan factors and nan values for float features are not allowed. Set nan_mode != Forbidden.");
+        borders.insert(borders.begin(), std::numeric_limits<float>::lowest());
+    }
+    return borders;
+}
+
+static void WriteValues(size_t columnIdx, const void* values, size_t size, NCB::NIdl::EBitsPerDocumentFeature bitsPerDocument,
+                        ui64 documentOffset, size_t documentCount, NCB::TQuantizedPoolWriter* writer) {
+    writer->WriteChunk(columnIdx, bitsPerDocument, documentOffset, documentCount,
+                       MakeArrayRef(static_cast<const ui8*>(values), size));
+}
+
+template <typename T>
+static void WriteValues(size_t columnIdx, const TVector<T>& values, NCB::NIdl::EBitsPerDocumentFeature bitsPerDocument,
+                        ui64 documentOffset, NCB::TQuantizedPoolWriter* writer) {
+    static_assert(std::is_pod<T>::value, "T must be a pod");
+    Y_ASSERT(static_cast<size_t>(bitsPerDocument) == sizeof(T) * 8);
+    WriteValues(columnIdx, values.data(), values.size() * sizeof(T), bitsPerDocument, documentOffset, values.size(), writer);
+}
+
+// Converts dsv pool to quantized pool in two passes by blocks: the first one collects values sketches
+// of float features and selects borders, the second one writes bins of each block as separate chunks.
+int mode_quantize(int argc, const char* argv[]) {
+    TAnalyticalModeCommonParams params;
+    TModeQuantizeParams quantizeParams;
+
+    auto parser = NLastGetopt::TOpts();
+    parser.AddHelpOption();
+    params.BindParserOpts(parser);
+    quantizeParams.BindParserOpts(parser);
+    parser.SetFreeArgsNum(0);
+    {
+        NLastGetopt::TOptsParseResult parseResult(&parser, argc, argv);
+        Y_UNUSED(parseResult);
+    }
+    quantizeParams.Validate();
+    CB_ENSURE(!params.PairsFilePath.Inited(), "Pairs are not stored in quantized pools, pass them to fit");
+
+    NPar::TLocalExecutor executor;
+    executor.RunAdditionalThreads(params.ThreadCount - 1);
+
+    TPoolMetaInfo metaInfo;
+    TVector<TFeatureValuesSketch> sketches;
+    ui64 docCount = 0;
+    ReadAndProceedPoolInBlocks(params, quantizeParams.ReadBlockSize, [&](TPool& poolPart) {
+        if (docCount == 0) {
+            CB_ENSURE(poolPart.CatFeatures.empty(), "Categorical features are not supported by quantized pools");
+            metaInfo = poolPart.MetaInfo;
+            sketches.resize(metaInfo.FeatureCount, TFeatureValuesSketch(quantizeParams.SketchSize));
+        }
+        executor.ExecRange([&](int featureIdx) {
+            sketches[featureIdx].Add(poolPart.Docs.Factors[featureIdx]);
+        }, 0, sketches.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
+        docCount += poolPart.Docs.GetDocCount();
+    },
+    &executor);
+    CB_ENSURE(docCount > 0, "Pool is empty");
+    CB_ENSURE(metaInfo.ColumnsInfo.Defined(), "Only dsv pools can be quantized");
+
+    TVector<TVector<float>> borders(sketches.size());
+    executor.ExecRangeWithThrow([&](int featureIdx) {
+        borders[featureIdx] = SelectQuantizedPoolBorders(sketches[featureIdx], quantizeParams);
+    }, 0, sketches.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
+    sketches.clear();
+    MATRIXNET_INFO_LOG << "Borders for float features selected" << Endl;
+
+    // original column indices are kept, the columns not supported by quantized pools are skipped
+    NCB::NIdl::TPoolQuantizationSchema quantizationSchema;
+    TVector<size_t> featureColumns;
+    TVector<size_t> baselineColumns;
+    TMaybe<size_t> labelColumn, weightColumn, groupIdColumn, subgroupIdColumn, docIdColumn;
+    const auto& columns = metaInfo.ColumnsInfo->Columns;
+    for (size_t columnIdx = 0; columnIdx < columns.size(); ++columnIdx) {
+        switch (columns[columnIdx].Type) {
+            case EColumn::Num: {
+                NCB::NIdl::TFeatureQuantizationSchema featureSchema;
+                for (float border : borders[featureColumns.size()]) {
+                    featureSchema.AddBorders(border);
+                }
+                quantizationSchema.MutableFeatureIndexToSchema()->insert({columnIdx, std::move(featureSchema)});
+                featureColumns.push_back(columnIdx);
+                break;
+            }
+            case EColumn::Label:
+                labelColumn = columnIdx;
+                break;
+            case EColumn::Weight:
+            case EColumn::GroupWeight:
+                weightColumn = columnIdx;
+                break;
+            case EColumn::Baseline:
+                baselineColumns.push_back(columnIdx);
+                break;
+            case EColumn::GroupId:
+                groupIdColumn = columnIdx;
+                break;
+            case EColumn::SubgroupId:
+                subgroupIdColumn = columnIdx;
+                break;
+            case EColumn::DocId:
+                docIdColumn = columnIdx;
+                break;
+            default:
+                MATRIXNET_WARNING_LOG << "Column " << columnIdx << " of type " << columns[columnIdx].Type << " is not stored in quantized pool" << Endl;
+        }
+    }
+    Y_VERIFY(featureColumns.size() == borders.size());
+
+    TFileOutput output(params.OutputPath);
+    NCB::TQuantizedPoolWriter writer(&output);
+    for (size_t columnIdx : featureColumns) {
+        writer.AddColumn(columnIdx, EColumn::Num);
+    }
+    for (size_t columnIdx : baselineColumns) {
+        writer.AddColumn(columnIdx, EColumn::Baseline);
+    }
+    for (const auto& column : {labelColumn, weightColumn, groupIdColumn, subgroupIdColumn, docIdColumn}) {
+        if (column.Defined()) {
+            writer.AddColumn(*column, columns[*column].Type);
+        }
+    }
+
+    ui64 documentOffset = 0;
+    ReadAndProceedPoolInBlocks(params, quantizeParams.ReadBlockSize, [&](TPool& poolPart) {
+        const auto& docs = poolPart.Docs;
+        const size_t blockDocCount = docs.GetDocCount();
+        TVector<TVector<ui8>> bins(featureColumns.size());
+        executor.ExecRange([&](int featureIdx) {
+            const auto& featureBorders = borders[featureIdx];
+            if (featureBorders.empty()) {
+                return;
+            }
+            bins[featureIdx].yresize(blockDocCount);
+            for (size_t doc = 0; doc < blockDocCount; ++doc) {
+                const float value = docs.Factors[featureIdx][doc];
+                // NaN is less than the lowest border
+                bins[featureIdx][doc] = IsNan(value) ? 0 : static_cast<ui8>(LowerBound(featureBorders.begin(), featureBorders.end(), value) - featureBorders.begin());
+            }
+        }, 0, featureColumns.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
+        for (size_t featureIdx = 0; featureIdx < featureColumns.size(); ++featureIdx) {
+            if (!borders[featureIdx].empty()) {
+                WriteValues(featureColumns[featureIdx], bins[featureIdx], NCB::NIdl::EBitsPerDocumentFeature_BPDF_8, documentOffset, &writer);
+            }
+        }
+        for (size_t baselineIdx = 0; baselineIdx < baselineColumns.size(); ++baselineIdx) {
+            WriteValues(baselineColumns[baselineIdx], docs.Baseline[baselineIdx], NCB::NIdl::EBitsPerDocumentFeature_BPDF_64, documentOffset, &writer);
+        }
+        if (labelColumn.Defined()) {
+            WriteValues(*labelColumn, docs.Target, NCB::NIdl::EBitsPerDocumentFeature_BPDF_32, documentOffset, &writer);
+        }
+        if (weightColumn.Defined()) {
+            WriteValues(*weightColumn, docs.Weight, NCB::NIdl::EBitsPerDocumentFeature_BPDF_32, documentOffset, &writer);
+        }
+        if (groupIdColumn.Defined()) {
+            WriteValues(*groupIdColumn, docs.QueryId, NCB::NIdl::EBitsPerDocumentFeature_BPDF_64, documentOffset, &writer);
+        }
+        if (subgroupIdColumn.Defined()) {
+            WriteValues(*subgroupIdColumn, docs.SubgroupId, NCB::NIdl::EBitsPerDocumentFeature_BPDF_32, documentOffset, &writer);
+        }
+        if (docIdColumn.Defined()) {
+            TVector<ui64> docIds(blockDocCount);
+            for (size_t doc = 0; doc < blockDocCount; ++doc) {
+                CB_ENSURE(TryFromString(docs.Id[doc], docIds[doc]), "Only integer DocIds can be stored in quantized pool, got " << docs.Id[doc]);
+            }
+            WriteValues(*docIdColumn, docIds, NCB::NIdl::EBitsPerDocumentFeature_BPDF_64, documentOffset, &writer);
+        }
+        documentOffset += blockDocCount;
+    },
+    &executor);
+    CB_ENSURE(documentOffset == docCount, "Pool has changed between reads");
+
+    writer.Finish(quantizationSchema);
+    output.Finish();
+    MATRIXNET_INFO_LOG << "Quantized pool with " << docCount << " documents written to " << params.OutputPath << Endl;
+    return 0;
+}
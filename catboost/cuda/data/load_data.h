@@ -118,6 +118,10 @@ namespace NCatboostCuda {
             }
         }
 
+        void SetQuantizedFloatFeature(ui32 /*featureId*/, TVector<ui8>&& /*bins*/, const TVector<float>& /*borders*/) override {
+            CB_ENSURE(false, "Quantized pools are not supported on GPU yet");
+        }
+
         void AddTarget(ui32 localIdx, float value) override {
             DataProvider.Targets[GetLineIdx(localIdx)] = value;
         }
@@ -80,6 +80,76 @@ TVector<TVector<double>> ApplyModelMulti(const TFullModel& model,
     return result;
 }
 
+void ApplyModelStaged(const TFullModel& model,
+                      const TPool& pool,
+                      int begin,
+                      int end,
+                      int evalPeriod,
+                      NPar::TLocalExecutor& executor,
+                      TArrayRef<double> stagedApprox) {
+    CB_ENSURE(pool.Docs.GetDocCount() != 0, "Pool should not be empty");
+    const size_t poolCatFeaturesCount = pool.CatFeatures.size();
+    CB_ENSURE(poolCatFeaturesCount >= model.ObliviousTrees.GetNumCatFeatures(), "Insufficient categorical features count");
+    CB_ENSURE((pool.Docs.Factors.size() - poolCatFeaturesCount) >= model.GetNumFloatFeatures(), "Insufficient float features count " << (pool.Docs.Factors.size() - poolCatFeaturesCount) << "<" << model.GetNumFloatFeatures());
+    if (end == 0) {
+        end = model.GetTreeCount();
+    } else {
+        end = Min<int>(end, model.GetTreeCount());
+    }
+    const TVector<size_t> stageTreeEnds = GetStageTreeEnds(begin, end, evalPeriod);
+    const int docCount = (int)pool.Docs.GetDocCount();
+    const int approxDimension = model.ObliviousTrees.ApproxDimension;
+    CB_ENSURE(stagedApprox.size() == stageTreeEnds.size() * approxDimension * docCount,
+              "Staged approx size should be " << stageTreeEnds.size() * approxDimension * docCount << " got " << stagedApprox.size());
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, docCount);
+    blockParams.SetBlockCount(executor.GetThreadCount() + 1);
+
+    executor.ExecRange([&](int blockId) {
+        const int blockFirstId = blockParams.FirstId + blockId * blockParams.GetBlockSize();
+        const int blockLastId = Min(blockParams.LastId, blockFirstId + blockParams.GetBlockSize());
+        const int blockDocCount = blockLastId - blockFirstId;
+        const auto& factors = pool.Docs.Factors;
+        TVector<double> blockStagedApprox(stageTreeEnds.size() * blockDocCount * approxDimension);
+        CalcTreeStagesGeneric(
+            model,
+            [&factors, blockFirstId](const TFloatFeature& floatFeature, size_t index) -> float {
+                return factors[floatFeature.FlatFeatureIndex][blockFirstId + index];
+            },
+            [&factors, blockFirstId](const TCatFeature& catFeature, size_t index) -> int {
+                return ConvertFloatCatFeatureToIntHash(factors[catFeature.FlatFeatureIndex][blockFirstId + index]);
+            },
+            blockDocCount,
+            begin,
+            stageTreeEnds,
+            blockStagedApprox
+        );
+        for (size_t stageIdx = 0; stageIdx < stageTreeEnds.size(); ++stageIdx) {
+            const double* blockStageApprox = blockStagedApprox.data() + stageIdx * blockDocCount * approxDimension;
+            for (int dim = 0; dim < approxDimension; ++dim) {
+                double* stageDimApprox = stagedApprox.data() + (stageIdx * approxDimension + dim) * docCount + blockFirstId;
+                for (int doc = 0; doc < blockDocCount; ++doc) {
+                    stageDimApprox[doc] = blockStageApprox[doc * approxDimension + dim];
+                }
+            }
+        }
+    }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
+}
+
+void ApplyModelStaged(const TFullModel& model,
+                      const TPool& pool,
+                      int begin,
+                      int end,
+                      int evalPeriod,
+                      int threadCount,
+                      TVector<double>* stagedApprox) {
+    const int treeEnd = end == 0 ? (int)model.GetTreeCount() : Min<int>(end, model.GetTreeCount());
+    const size_t stageCount = GetStageTreeEnds(begin, treeEnd, evalPeriod).size();
+    stagedApprox->yresize(stageCount * model.ObliviousTrees.ApproxDimension * pool.Docs.GetDocCount());
+    NPar::TLocalExecutor executor;
+    executor.RunAdditionalThreads(threadCount - 1);
+    ApplyModelStaged(model, pool, begin, treeEnd, evalPeriod, executor, *stagedApprox);
+}
+
 TVector<double> ApplyModel(const TFullModel& model,
                            const TPool& pool,
                            bool verbose,
@@ -24,6 +24,28 @@ TVector<TVector<double>> ApplyModelMulti(const TFullModel& model,
                                          int end = 0,
                                          int threadCount = 1);
 
+/**
+ * Staged raw formula values, stages are GetStageTreeEnds(begin, end, evalPeriod).
+ * Features of every document are binarized once and trees are applied in order, so all stages cost as much as one apply.
+ * @param[out] stagedApprox caller provided buffer of size stageCount * ApproxDimension * docCount,
+ * it gets cumulative approxes of trees [begin, stageEnd) with indexation [(stageIdx * ApproxDimension + dim) * docCount + docIdx]
+ */
+void ApplyModelStaged(const TFullModel& model,
+                      const TPool& pool,
+                      int begin,
+                      int end,
+                      int evalPeriod,
+                      NPar::TLocalExecutor& executor,
+                      TArrayRef<double> stagedApprox);
+
+void ApplyModelStaged(const TFullModel& model,
+                      const TPool& pool,
+                      int begin,
+                      int end,
+                      int evalPeriod,
+                      int threadCount,
+                      TVector<double>* stagedApprox);
+
 TVector<double> ApplyModel(const TFullModel& model,
                            const TPool& pool,
                            bool verbose = false,
@@ -6,25 +6,10 @@ bool IsSamplingPerTree(const NCatboostOptions::TObliviousTreeLearnerOptions& fit
     return fitParams.SamplingFrequency.Get() == ESamplingFrequency::PerTree;
 }
 
-TVector<TBucketStats, TPoolAllocator>& TBucketStatsCache::GetStats(const TSplitCandidate& split, int statsCount, bool* areStatsDirty) {
-    TVector<TBucketStats, TPoolAllocator>* splitStats;
-    with_lock(Lock) {
-        if (Stats.has(split) && Stats[split] != nullptr) {
-            splitStats = Stats[split].Get();
-            *areStatsDirty = false;
-        } else {
-            splitStats = new TVector<TBucketStats, TPoolAllocator>(MemoryPool.Get());
-            splitStats->yresize(statsCount);
-            Stats[split] = splitStats;
-            *areStatsDirty = true;
-        }
-    }
-    return *splitStats;
-}
-
 void TBucketStatsCache::GarbageCollect() {
     if (MemoryPool->MemoryWaste() > InitialSize) { // limit memory overhead
         Stats.clear();
+        PlainStats.clear();
         MemoryPool->Clear();
     }
 }
@@ -76,7 +61,7 @@ static int GetMaxTailFinish(const TVector<TFold>& folds, int bodyTailIdx) {
     return maxTailFinish;
 }
 
-void TCalcScoreFold::Create(const TVector<TFold>& folds, bool isPairwiseScoring, float sampleRate) {
+void TCalcScoreFold::Create(const TVector<TFold>& folds, bool isPairwiseScoring, float sampleRate, bool isLeafPartitioned) {
     BernoulliSampleRate = sampleRate;
     Y_ASSERT(BernoulliSampleRate > 0.0f && BernoulliSampleRate <= 1.0f);
     DocCount = folds[0].LearnPermutation.ysize();
@@ -90,6 +75,9 @@ void TCalcScoreFold::Create(const TVector<TFold>& folds, bool isPairwiseScoring,
     BodyTailCount = GetMaxBodyTailCount(folds);
     HasPairwiseWeights = !folds[0].BodyTailArr[0].PairwiseWeights.empty();
     IsPairwiseScoring = isPairwiseScoring;
+    IsLeafPartitioned = isLeafPartitioned;
+    Y_ASSERT(!IsLeafPartitioned || !IsPairwiseScoring);
+    LeafBounds.clear();
     Y_ASSERT(BodyTailCount > 0);
     BodyTailArr.yresize(BodyTailCount);
     ApproxDimension = folds[0].GetApproxDimension();
@@ -166,6 +154,10 @@ void TCalcScoreFold::SelectBlockFromFold(const TFoldType& fold, TSlice srcBlock,
 }
 
 void TCalcScoreFold::SelectSmallestSplitSide(int curDepth, const TCalcScoreFold& fold, NPar::TLocalExecutor* localExecutor) {
+    if (!fold.LeafBounds.empty()) {
+        SelectSmallestLeafChildren(curDepth, fold, localExecutor);
+        return;
+    }
     NPar::TLocalExecutor::TExecRangeParams blockParams(0, fold.DocCount);
     blockParams.SetBlockSize(2000);
     const int blockCount = blockParams.GetBlockCount();
@@ -192,6 +184,68 @@ void TCalcScoreFold::SelectSmallestSplitSide(int curDepth, const TCalcScoreFold&
         SelectBlockFromFold(fold, srcBlock, dstBlock);
     }, 0, blockCount, NPar::TLocalExecutor::WAIT_COMPLETE);
     PermutationBlockSize = FoldPermutationBlockSizeNotSet;
+    LeafBounds.clear();
+}
+
+template<typename TData>
+static inline void CopyElements(const TData* source, int sourceOffset, int count, TData* destination, int destinationOffset) {
+    if (source != nullptr) {
+        CopyN(source + sourceOffset, count, destination + destinationOffset);
+    }
+}
+
+void TCalcScoreFold::SelectSmallestLeafChildren(int curDepth, const TCalcScoreFold& fold, NPar::TLocalExecutor* localExecutor) {
+    Y_ASSERT(curDepth > 0);
+    const int parentLeafCount = 1 << (curDepth - 1);
+    const TIndexType splitWeight = parentLeafCount;
+    Y_ASSERT(fold.LeafBounds.ysize() <= 2 * parentLeafCount + 1);
+
+    struct TChunk {
+        int SrcOffset;
+        int DstOffset;
+        int Size;
+        TIndexType Index;
+    };
+    const int chunkSize = 2000;
+    TVector<TChunk> chunks;
+    SmallestSplitSideValues.yresize(parentLeafCount);
+    int docCount = 0;
+    for (int leaf = 0; leaf < parentLeafCount; ++leaf) {
+        const int falseCount = fold.GetLeafDocCount(leaf);
+        const int trueCount = fold.GetLeafDocCount(leaf + splitWeight);
+        SmallestSplitSideValues[leaf] = trueCount <= falseCount;
+        const int selectedLeaf = SmallestSplitSideValues[leaf] ? leaf + splitWeight : leaf;
+        const int selectedCount = Min(trueCount, falseCount);
+        for (int offset = 0; offset < selectedCount; offset += chunkSize) {
+            chunks.push_back({fold.LeafBounds[selectedLeaf] + offset, docCount + offset, Min(chunkSize, selectedCount - offset), leaf | splitWeight});
+        }
+        docCount += selectedCount;
+    }
+
+    DocCount = docCount;
+    ClearBodyTail();
+    LearnQueriesInfo = fold.LearnQueriesInfo;
+    localExecutor->ExecRange([&](int chunkIdx) {
+        const auto& chunk = chunks[chunkIdx];
+        Fill(GetDataPtr(Indices, chunk.DstOffset), GetDataPtr(Indices, chunk.DstOffset + chunk.Size), chunk.Index);
+        CopyElements(GetDataPtr(fold.IndexInFold), chunk.SrcOffset, chunk.Size, GetDataPtr(IndexInFold), chunk.DstOffset);
+        CopyElements(GetDataPtr(fold.LearnPermutation), chunk.SrcOffset, chunk.Size, GetDataPtr(LearnPermutation), chunk.DstOffset);
+        CopyElements(GetDataPtr(fold.LearnWeights), chunk.SrcOffset, chunk.Size, GetDataPtr(LearnWeights), chunk.DstOffset);
+        CopyElements(GetDataPtr(fold.SampleWeights), chunk.SrcOffset, chunk.Size, GetDataPtr(SampleWeights), chunk.DstOffset);
+        for (int bodyTailIdx = 0; bodyTailIdx < BodyTailCount; ++bodyTailIdx) {
+            const auto& srcBodyTail = fold.BodyTailArr[bodyTailIdx];
+            auto& dstBodyTail = BodyTailArr[bodyTailIdx];
+            for (int dim = 0; dim < ApproxDimension; ++dim) {
+                CopyElements(GetDataPtr(srcBodyTail.WeightedDerivatives[dim]), chunk.SrcOffset, chunk.Size, GetDataPtr(dstBodyTail.WeightedDerivatives[dim]), chunk.DstOffset);
+                CopyElements(GetDataPtr(srcBodyTail.SampleWeightedDerivatives[dim]), chunk.SrcOffset, chunk.Size, GetDataPtr(dstBodyTail.SampleWeightedDerivatives[dim]), chunk.DstOffset);
+            }
+        }
+    }, 0, chunks.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
+    for (auto& bodyTail : BodyTailArr) {
+        bodyTail.BodyFinish = bodyTail.TailFinish = DocCount;
+    }
+    PermutationBlockSize = FoldPermutationBlockSizeNotSet;
+    LeafBounds.clear();
 }
 
 void TCalcScoreFold::Sample(const TFold& fold, const TVector<TIndexType>& indices, TRestorableFastRng64* rand, NPar::TLocalExecutor* localExecutor) {
@@ -219,9 +273,19 @@ void TCalcScoreFold::Sample(const TFold& fold, const TVector<TIndexType>& indice
         SelectBlockFromFold(fold, srcBlock, dstBlock);
     }, 0, blockCount, NPar::TLocalExecutor::WAIT_COMPLETE);
     PermutationBlockSize = (BernoulliSampleRate == 1.0f || IsPairwiseScoring) ? fold.PermutationBlockSize : FoldPermutationBlockSizeNotSet;
+    if (IsLeafPartitioned) {
+        Y_ASSERT(BodyTailCount == 1 && BodyTailArr[0].BodyFinish == DocCount && BodyTailArr[0].TailFinish == DocCount);
+        LeafBounds = {0, DocCount};
+    } else {
+        LeafBounds.clear();
+    }
 }
 
 void TCalcScoreFold::UpdateIndices(const TVector<TIndexType>& indices, NPar::TLocalExecutor* localExecutor) {
+    if (IsLeafPartitioned) {
+        PartitionByLeaf(indices, localExecutor);
+        return;
+    }
     NPar::TLocalExecutor::TExecRangeParams blockParams(0, indices.ysize());
     blockParams.SetBlockSize(2000);
     const int blockCount = blockParams.GetBlockCount();
@@ -245,6 +309,91 @@ void TCalcScoreFold::UpdateIndices(const TVector<TIndexType>& indices, NPar::TLo
     }, 0, blockCount, NPar::TLocalExecutor::WAIT_COMPLETE);
 }
 
+template<typename TData>
+static void PermuteElements(
+    const NPar::TLocalExecutor::TExecRangeParams& blockParams,
+    const int* destinations,
+    TData* data,
+    TVector<TData>* buffer,
+    NPar::TLocalExecutor* localExecutor
+) {
+    if (data == nullptr) {
+        return;
+    }
+    buffer->yresize(blockParams.LastId);
+    TData* bufferData = buffer->data();
+    localExecutor->ExecRange([=](int doc) {
+        bufferData[destinations[doc]] = data[doc];
+    }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
+    Copy(bufferData, bufferData + blockParams.LastId, data);
+}
+
+// Stable counting sort of sampled documents by new leaf index, every UpdateIndices splits each leaf in two
+void TCalcScoreFold::PartitionByLeaf(const TVector<TIndexType>& indices, NPar::TLocalExecutor* localExecutor) {
+    Y_ASSERT(!LeafBounds.empty());
+    Y_ASSERT(BodyTailCount == 1 && !HasPairwiseWeights);
+    Y_ASSERT(BodyTailArr[0].BodyFinish == DocCount && BodyTailArr[0].TailFinish == DocCount);
+    const int leafCount = 2 * (LeafBounds.ysize() - 1);
+
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, DocCount);
+    blockParams.SetBlockSize(2000);
+    const int blockCount = blockParams.GetBlockCount();
+
+    const TIndexType* indicesData = GetDataPtr(indices);
+    const size_t* indexInFoldData = GetDataPtr(IndexInFold);
+    TIndexType* docLeavesData = GetDataPtr(Indices);
+    TVector<int> blockLeafOffsets(blockCount * leafCount, 0); // [block][leaf]
+    int* blockLeafOffsetsData = blockLeafOffsets.data();
+    localExecutor->ExecRange([=](int blockIdx) {
+        int* leafCounts = blockLeafOffsetsData + blockIdx * leafCount;
+        NPar::TLocalExecutor::BlockedLoopBody(blockParams, [=](int doc) {
+            const TIndexType leaf = indicesData[indexInFoldData[doc]];
+            Y_ASSERT(leaf < (TIndexType)leafCount);
+            docLeavesData[doc] = leaf;
+            ++leafCounts[leaf];
+        })(blockIdx);
+    }, 0, blockCount, NPar::TLocalExecutor::WAIT_COMPLETE);
+
+    LeafBounds.yresize(leafCount + 1);
+    int offset = 0;
+    for (int leaf = 0; leaf < leafCount; ++leaf) {
+        LeafBounds[leaf] = offset;
+        for (int blockIdx = 0; blockIdx < blockCount; ++blockIdx) {
+            const int blockLeafDocCount = blockLeafOffsets[blockIdx * leafCount + leaf];
+            blockLeafOffsets[blockIdx * leafCount + leaf] = offset;
+            offset += blockLeafDocCount;
+        }
+    }
+    LeafBounds[leafCount] = offset;
+    Y_ASSERT(offset == DocCount);
+
+    TVector<int> destinations;
+    destinations.yresize(DocCount);
+    int* destinationsData = destinations.data();
+    localExecutor->ExecRange([=](int blockIdx) {
+        int* leafOffsets = blockLeafOffsetsData + blockIdx * leafCount;
+        NPar::TLocalExecutor::BlockedLoopBody(blockParams, [=](int doc) {
+            destinationsData[doc] = leafOffsets[docLeavesData[doc]]++;
+        })(blockIdx);
+    }, 0, blockCount, NPar::TLocalExecutor::WAIT_COMPLETE);
+
+    for (int leaf = 0; leaf < leafCount; ++leaf) {
+        Fill(GetDataPtr(Indices, LeafBounds[leaf]), GetDataPtr(Indices, LeafBounds[leaf + 1]), leaf);
+    }
+    TVector<size_t> sizeBuffer;
+    PermuteElements(blockParams, destinationsData, GetDataPtr(IndexInFold), &sizeBuffer, localExecutor);
+    PermuteElements(blockParams, destinationsData, GetDataPtr(LearnPermutation), &sizeBuffer, localExecutor);
+    TVector<float> floatBuffer;
+    PermuteElements(blockParams, destinationsData, GetDataPtr(LearnWeights), &floatBuffer, localExecutor);
+    PermuteElements(blockParams, destinationsData, GetDataPtr(SampleWeights), &floatBuffer, localExecutor);
+    TVector<double> doubleBuffer;
+    for (int dim = 0; dim < ApproxDimension; ++dim) {
+        PermuteElements(blockParams, destinationsData, GetDataPtr(BodyTailArr[0].WeightedDerivatives[dim]), &doubleBuffer, localExecutor);
+        PermuteElements(blockParams, destinationsData, GetDataPtr(BodyTailArr[0].SampleWeightedDerivatives[dim]), &doubleBuffer, localExecutor);
+    }
+    PermutationBlockSize = FoldPermutationBlockSizeNotSet;
+}
+
 int TCalcScoreFold::GetApproxDimension() const {
     return ApproxDimension;
 }
@@ -281,12 +430,12 @@ void TCalcScoreFold::SetSmallestSideControl(int curDepth, int docCount, const TU
     const TIndexType splitWeight = 1 << (curDepth - 1);
     bool* controlData = GetDataPtr(Control);
     if (trueCount * 2 > docCount) {
-        SmallestSplitSideValue = false;
+        SmallestSplitSideValues.assign(splitWeight, false);
         localExecutor->ExecRange([=](int docIdx) {
             controlData[docIdx] = indicesData[docIdx] < splitWeight;
         }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
     } else {
-        SmallestSplitSideValue = true;
+        SmallestSplitSideValues.assign(splitWeight, true);
         localExecutor->ExecRange([=](int docIdx) {
             controlData[docIdx] = indicesData[docIdx] > splitWeight - 1;
         }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
@@ -4,11 +4,13 @@
 #include "split.h"
 
 #include <catboost/libs/helpers/restorable_rng.h>
+#include <catboost/libs/options/enum_helpers.h>
 #include <catboost/libs/options/restrictions.h>
 #include <catboost/libs/options/oblivious_tree_options.h>
 
 #include <util/memory/pool.h>
 #include <util/system/atomic.h>
+#include <util/system/guard.h>
 #include <util/system/spinlock.h>
 
 bool IsSamplingPerTree(const NCatboostOptions::TObliviousTreeLearnerOptions& fitParams);
@@ -38,6 +40,26 @@ static inline int GetMaxBodyTailCount(const TVector<TFold>& folds) {
     return maxBodyTailCount;
 }
 
+// Bucket sums of plain boosting, all documents of a body tail are summed with bootstrap weights
+struct TPlainBucketStats {
+    double SumWeightedDelta;
+    double SumWeight;
+
+    inline void Add(const TPlainBucketStats& other) {
+        SumWeightedDelta += other.SumWeightedDelta;
+        SumWeight += other.SumWeight;
+    }
+
+    inline void Remove(const TPlainBucketStats& other) {
+        SumWeightedDelta -= other.SumWeightedDelta;
+        SumWeight -= other.SumWeight;
+    }
+    SAVELOAD(SumWeightedDelta, SumWeight);
+};
+
+static_assert(std::is_pod<TPlainBucketStats>::value, "TPlainBucketStats must be pod to avoid memory initialization in yresize");
+
+// Bucket sums of ordered boosting, body documents are summed without bootstrap weights
 struct TBucketStats {
     double SumWeightedDelta;
     double SumWeight;
@@ -62,6 +84,10 @@ struct TBucketStats {
 
 static_assert(std::is_pod<TBucketStats>::value, "TBucketStats must be pod to avoid memory initialization in yresize");
 
+static inline size_t GetBucketStatsSize(EBoostingType boostingType) {
+    return IsPlainMode(boostingType) ? sizeof(TPlainBucketStats) : sizeof(TBucketStats);
+}
+
 inline static int CountNonCtrBuckets(const TVector<int>& splitCounts, const TVector<TVector<int>>& oneHotValues) {
     int nonCtrBucketCount = 0;
     for (int splitCount : splitCounts) {
@@ -73,18 +99,83 @@ inline static int CountNonCtrBuckets(const TVector<int>& splitCounts, const TVec
     return nonCtrBucketCount;
 }
 
+// Stats of all split candidates are of the same type, TPlainBucketStats or TBucketStats depending on boosting type.
+// Sums are kept in double, since FixUpStats gets the larger split side as a difference of sums.
 struct TBucketStatsCache {
-    THashMap<TSplitCandidate, THolder<TVector<TBucketStats, TPoolAllocator>>> Stats;
-    inline void Create(const TVector<TFold>& folds, int bucketCount, int depth) {
+    inline void Create(const TVector<TFold>& folds, int bucketCount, int depth, size_t bucketStatsSize = sizeof(TBucketStats)) {
         int approxDimension = folds[0].GetApproxDimension();
         int bodyTailCount = GetMaxBodyTailCount(folds);
-        InitialSize = sizeof(TBucketStats) * bucketCount * (1U << depth) * approxDimension * bodyTailCount;
+        InitialSize = bucketStatsSize * bucketCount * (1U << depth) * approxDimension * bodyTailCount;
         Y_ASSERT(InitialSize > 0);
         MemoryPool = new TMemoryPool(InitialSize);
     }
-    TVector<TBucketStats, TPoolAllocator>& GetStats(const TSplitCandidate& split, int statsCount, bool* areStatsDirty);
+    template<typename TStats>
+    TStats* GetStats(const TSplitCandidate& split, int statsCount, bool* areStatsDirty) {
+        return GetStats(split, statsCount, areStatsDirty, GetStatsMap((TStats*)nullptr));
+    }
+    template<typename TStats>
+    bool Has(const TSplitCandidate& split) const {
+        const auto* statsMap = GetStatsMap((TStats*)nullptr);
+        const auto it = statsMap->find(split);
+        return it != statsMap->end() && it->second != nullptr;
+    }
+    // stats of a candidate not scored on some tree level should be erased, they are not updated for this level
+    void Erase(const TSplitCandidate& split) {
+        Stats.erase(split);
+        PlainStats.erase(split);
+    }
+    template<typename TPredicate>
+    void EraseIf(const TPredicate& isErased) {
+        EraseIf(isErased, &Stats);
+        EraseIf(isErased, &PlainStats);
+    }
     void GarbageCollect();
 private:
+    template<typename TStats>
+    using TStatsMap = THashMap<TSplitCandidate, THolder<TVector<TStats, TPoolAllocator>>>;
+
+    TStatsMap<TBucketStats>* GetStatsMap(TBucketStats*) {
+        return &Stats;
+    }
+    TStatsMap<TPlainBucketStats>* GetStatsMap(TPlainBucketStats*) {
+        return &PlainStats;
+    }
+    const TStatsMap<TBucketStats>* GetStatsMap(TBucketStats*) const {
+        return &Stats;
+    }
+    const TStatsMap<TPlainBucketStats>* GetStatsMap(TPlainBucketStats*) const {
+        return &PlainStats;
+    }
+    template<typename TPredicate, typename TStats>
+    static void EraseIf(const TPredicate& isErased, TStatsMap<TStats>* statsMap) {
+        for (auto it = statsMap->begin(); it != statsMap->end();) {
+            if (isErased(it->first)) {
+                statsMap->erase(it++);
+            } else {
+                ++it;
+            }
+        }
+    }
+    template<typename TStats>
+    TStats* GetStats(const TSplitCandidate& split, int statsCount, bool* areStatsDirty, TStatsMap<TStats>* statsMap) {
+        TVector<TStats, TPoolAllocator>* splitStats;
+        with_lock(Lock) {
+            if (statsMap->has(split) && (*statsMap)[split] != nullptr) {
+                splitStats = (*statsMap)[split].Get();
+                Y_ASSERT(splitStats->ysize() == statsCount);
+                *areStatsDirty = false;
+            } else {
+                splitStats = new TVector<TStats, TPoolAllocator>(MemoryPool.Get());
+                splitStats->yresize(statsCount);
+                (*statsMap)[split] = splitStats;
+                *areStatsDirty = true;
+            }
+        }
+        return GetDataPtr(*splitStats);
+    }
+
+    TStatsMap<TBucketStats> Stats;
+    TStatsMap<TPlainBucketStats> PlainStats;
     THolder<TMemoryPool> MemoryPool;
     TAdaptiveLock Lock;
     size_t InitialSize;
@@ -141,16 +232,27 @@ struct TCalcScoreFold {
     TUnsizedVector<float> SampleWeights;
     const TVector<TQueryInfo>* LearnQueriesInfo;
     TUnsizedVector<TBodyTail> BodyTailArr; // [tail][dim][doc]
-    bool SmallestSplitSideValue;
+    // [parent leaf] value of the last split for documents of parent leaf selected by SelectSmallestSplitSide
+    TVector<bool> SmallestSplitSideValues;
     int PermutationBlockSize = FoldPermutationBlockSizeNotSet;
+    // Documents of leaf are [LeafBounds[leaf], LeafBounds[leaf + 1]) if documents are partitioned by leaf, empty otherwise
+    TVector<int> LeafBounds;
 
-    void Create(const TVector<TFold>& folds, bool isPairwiseScoring, float sampleRate = 1.0f);
+    /*
+     * In leaf partitioned layout documents are kept ordered by leaf (and by learn permutation inside a leaf) after each UpdateIndices,
+     * so SelectSmallestSplitSide copies the smaller child of every leaf as a contiguous range.
+     * It is supported for plain boosting without pairwise scoring only.
+     */
+    void Create(const TVector<TFold>& folds, bool isPairwiseScoring, float sampleRate = 1.0f, bool isLeafPartitioned = false);
     void SelectSmallestSplitSide(int curDepth, const TCalcScoreFold& fold, NPar::TLocalExecutor* localExecutor);
     void Sample(const TFold& fold, const TVector<TIndexType>& indices, TRestorableFastRng64* rand, NPar::TLocalExecutor* localExecutor);
     void UpdateIndices(const TVector<TIndexType>& indices, NPar::TLocalExecutor* localExecutor);
     int GetDocCount() const;
     int GetBodyTailCount() const;
     int GetApproxDimension() const;
+    int GetLeafDocCount(int leaf) const {
+        return leaf + 1 < LeafBounds.ysize() ? LeafBounds[leaf + 1] - LeafBounds[leaf] : 0;
+    }
     const TVector<float>& GetLearnWeights() const { return LearnWeights; }
 
 private:
@@ -164,6 +266,8 @@ private:
     void SelectBlockFromFold(const TFoldType& fold, TSlice srcBlock, TSlice dstBlock);
     void SetSmallestSideControl(int curDepth, int docCount, const TUnsizedVector<TIndexType>& indices, NPar::TLocalExecutor* localExecutor);
     void SetSampledControl(int docCount, TRestorableFastRng64* rand);
+    void SelectSmallestLeafChildren(int curDepth, const TCalcScoreFold& fold, NPar::TLocalExecutor* localExecutor);
+    void PartitionByLeaf(const TVector<TIndexType>& indices, NPar::TLocalExecutor* localExecutor);
     TUnsizedVector<bool> Control;
     int DocCount;
     int BodyTailCount;
@@ -171,4 +275,5 @@ private:
     float BernoulliSampleRate;
     bool HasPairwiseWeights;
     bool IsPairwiseScoring;
+    bool IsLeafPartitioned = false;
 };
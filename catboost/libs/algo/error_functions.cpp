@@ -92,6 +92,194 @@ void TCrossEntropyError::CalcDersRange(
     }
 }
 
+void TPoissonError::CalcFirstDerRange(
+    int start,
+    int count,
+    const double* __restrict approxExps,
+    const double* __restrict approxDeltas,
+    const float* __restrict targets,
+    const float* __restrict weights,
+    double* __restrict ders
+) const {
+    if (approxDeltas != nullptr) {
+#pragma clang loop vectorize_width(4) interleave_count(2)
+        for (int i = start; i < start + count; ++i) {
+            ders[i] = targets[i] - approxExps[i] * approxDeltas[i];
+        }
+    } else {
+#pragma clang loop vectorize_width(4) interleave_count(2)
+        for (int i = start; i < start + count; ++i) {
+            ders[i] = targets[i] - approxExps[i];
+        }
+    }
+    if (weights != nullptr) {
+#pragma clang loop vectorize_width(4) interleave_count(2)
+        for (int i = start; i < start + count; ++i) {
+            ders[i] *= weights[i];
+        }
+    }
+}
+
+template<bool CalcThirdDer>
+static void CalcPoissonErrorDersRangeImpl(
+    int start,
+    int count,
+    const double* __restrict approxExps,
+    const double* __restrict approxDeltas,
+    const float* __restrict targets,
+    const float* __restrict weights,
+    TDers* __restrict ders
+) {
+    if (approxDeltas != nullptr) {
+#pragma clang loop vectorize_width(4) interleave_count(2)
+        for (int i = start; i < start + count; ++i) {
+            const double approxExp = approxExps[i] * approxDeltas[i];
+            ders[i].Der1 = targets[i] - approxExp;
+            ders[i].Der2 = -approxExp;
+            if (CalcThirdDer) {
+                ders[i].Der3 = -approxExp;
+            }
+        }
+    } else {
+#pragma clang loop vectorize_width(4) interleave_count(2)
+        for (int i = start; i < start + count; ++i) {
+            ders[i].Der1 = targets[i] - approxExps[i];
+            ders[i].Der2 = -approxExps[i];
+            if (CalcThirdDer) {
+                ders[i].Der3 = -approxExps[i];
+            }
+        }
+    }
+    if (weights != nullptr) {
+#pragma clang loop vectorize_width(8) interleave_count(2)
+        for (int i = start; i < start + count; ++i) {
+            ders[i].Der1 *= weights[i];
+            ders[i].Der2 *= weights[i];
+            if (CalcThirdDer) {
+                ders[i].Der3 *= weights[i];
+            }
+        }
+    }
+}
+
+void TPoissonError::CalcDersRange(
+    int start,
+    int count,
+    bool calcThirdDer,
+    const double* __restrict approxExps,
+    const double* __restrict approxDeltas,
+    const float* __restrict targets,
+    const float* __restrict weights,
+    TDers* __restrict ders
+) const {
+    if (calcThirdDer) {
+        CalcPoissonErrorDersRangeImpl<true>(start, count, approxExps, approxDeltas, targets, weights, ders);
+    } else {
+        CalcPoissonErrorDersRangeImpl<false>(start, count, approxExps, approxDeltas, targets, weights, ders);
+    }
+}
+
+// Turns [dim][doc] probabilities of a block into weighted derivatives
+static void CalcMultiClassFirstDers(
+    int start,
+    int count,
+    const double* __restrict probs,
+    const float* __restrict targets,
+    const float* __restrict weights,
+    TVector<TVector<double>>* ders
+) {
+    const int approxDimension = ders->ysize();
+    for (int dim = 0; dim < approxDimension; ++dim) {
+        double* __restrict dimDers = (*ders)[dim].data() + start;
+        const double* __restrict dimProbs = probs + dim * count;
+#pragma clang loop vectorize_width(4) interleave_count(2)
+        for (int i = 0; i < count; ++i) {
+            dimDers[i] = -dimProbs[i];
+        }
+    }
+    for (int i = 0; i < count; ++i) {
+        (*ders)[static_cast<int>(targets[start + i])][start + i] += 1;
+    }
+    if (weights != nullptr) {
+        for (int dim = 0; dim < approxDimension; ++dim) {
+            double* __restrict dimDers = (*ders)[dim].data() + start;
+#pragma clang loop vectorize_width(4) interleave_count(2)
+            for (int i = 0; i < count; ++i) {
+                dimDers[i] *= weights[start + i];
+            }
+        }
+    }
+}
+
+// Softmax of all documents of the block is calculated in a flat [dim][doc] buffer, so exponents are vectorized
+void TMultiClassError::CalcFirstDerMultiRange(
+    int start,
+    int count,
+    const TVector<TVector<double>>& approx,
+    const float* targets,
+    const float* weights,
+    TVector<TVector<double>>* ders
+) const {
+    const int approxDimension = approx.ysize();
+    TVector<double> maxApprox(approx[0].begin() + start, approx[0].begin() + start + count);
+    for (int dim = 1; dim < approxDimension; ++dim) {
+        const double* dimApprox = approx[dim].data() + start;
+        for (int i = 0; i < count; ++i) {
+            maxApprox[i] = Max(maxApprox[i], dimApprox[i]);
+        }
+    }
+    TVector<double> expApprox;
+    expApprox.yresize(approxDimension * count);
+    for (int dim = 0; dim < approxDimension; ++dim) {
+        const double* dimApprox = approx[dim].data() + start;
+        for (int i = 0; i < count; ++i) {
+            expApprox[dim * count + i] = dimApprox[i] - maxApprox[i];
+        }
+    }
+    FastExpInplace(expApprox.data(), expApprox.size());
+    TVector<double> sumExpApprox(count, 0.0);
+    for (int dim = 0; dim < approxDimension; ++dim) {
+        for (int i = 0; i < count; ++i) {
+            sumExpApprox[i] += expApprox[dim * count + i];
+        }
+    }
+    for (int dim = 0; dim < approxDimension; ++dim) {
+        for (int i = 0; i < count; ++i) {
+            expApprox[dim * count + i] /= sumExpApprox[i];
+        }
+    }
+    CalcMultiClassFirstDers(start, count, expApprox.data(), targets, weights, ders);
+}
+
+// Sigmoids of all documents of the block are calculated in a flat [dim][doc] buffer, exponents are taken of -|approx| to avoid overflow
+void TMultiClassOneVsAllError::CalcFirstDerMultiRange(
+    int start,
+    int count,
+    const TVector<TVector<double>>& approx,
+    const float* targets,
+    const float* weights,
+    TVector<TVector<double>>* ders
+) const {
+    const int approxDimension = approx.ysize();
+    TVector<double> probs;
+    probs.yresize(approxDimension * count);
+    for (int dim = 0; dim < approxDimension; ++dim) {
+        const double* dimApprox = approx[dim].data() + start;
+        for (int i = 0; i < count; ++i) {
+            probs[dim * count + i] = -Abs(dimApprox[i]);
+        }
+    }
+    FastExpInplace(probs.data(), probs.size());
+    for (int dim = 0; dim < approxDimension; ++dim) {
+        const double* dimApprox = approx[dim].data() + start;
+        for (int i = 0; i < count; ++i) {
+            const double expApprox = probs[dim * count + i];
+            probs[dim * count + i] = (dimApprox[i] > 0 ? 1 : expApprox) / (1 + expApprox);
+        }
+    }
+    CalcMultiClassFirstDers(start, count, probs.data(), targets, weights, ders);
+}
+
 void CheckDerivativeOrderForTrain(ui32 derivativeOrder, ELeavesEstimation estimationMethod) {
     if (estimationMethod == ELeavesEstimation::Newton) {
         CB_ENSURE(derivativeOrder >= 2, "Current error function doesn't support Newton leaves estimation method");
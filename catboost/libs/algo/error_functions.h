@@ -10,6 +10,7 @@
 #include <catboost/libs/helpers/eval_helpers.h>
 
 #include <library/containers/2d_array/2d_array.h>
+#include <library/fast_exp/fast_exp.h>
 #include <library/threading/local_executor/local_executor.h>
 #include <library/binsaver/bin_saver.h>
 
@@ -105,6 +106,29 @@ public:
         CB_ENSURE(false, "Not implemented");
     }
 
+    // Weighted first derivatives of documents [start, start + count), approx and ders are [dim][doc]
+    void CalcFirstDerMultiRange(
+        int start,
+        int count,
+        const TVector<TVector<double>>& approx,
+        const float* targets,
+        const float* weights,
+        TVector<TVector<double>>* ders
+    ) const {
+        const int approxDimension = approx.ysize();
+        TVector<double> curApprox(approxDimension);
+        TVector<double> curDer(approxDimension);
+        for (int doc = start; doc < start + count; ++doc) {
+            for (int dim = 0; dim < approxDimension; ++dim) {
+                curApprox[dim] = approx[dim][doc];
+            }
+            static_cast<const TChild*>(this)->CalcDersMulti(curApprox, targets[doc], weights == nullptr ? 1 : weights[doc], &curDer, nullptr);
+            for (int dim = 0; dim < approxDimension; ++dim) {
+                (*ders)[dim][doc] = curDer[dim];
+            }
+        }
+    }
+
     void CalcDersForQueries(
         int /*queryStartIndex*/,
         int /*queryEndIndex*/,
@@ -336,6 +360,27 @@ public:
             ders->Der3 = -approxExp;
         }
     }
+
+    void CalcFirstDerRange(
+        int start,
+        int count,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        double* ders
+    ) const;
+
+    void CalcDersRange(
+        int start,
+        int count,
+        bool calcThirdDer,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        TDers* ders
+    ) const;
 };
 
 class TMultiClassError : public IDerCalcer<TMultiClassError, /*StoreExpApproxParam*/ false> {
@@ -369,24 +414,24 @@ public:
     ) const {
         int approxDimension = approx.ysize();
 
-        TVector<double> softmax(approxDimension);
-        CalcSoftmax(approx, &softmax);
-
-        for (int dim = 0; dim < approxDimension; ++dim) {
-            (*der)[dim] = -softmax[dim];
-        }
-        int targetClass = static_cast<int>(target);
-        (*der)[targetClass] += 1;
+        // softmax is kept in der until the target class is accounted
+        CalcSoftmax(approx, der);
 
         if (der2 != nullptr) {
             for (int dimY = 0; dimY < approxDimension; ++dimY) {
                 for (int dimX = 0; dimX < approxDimension; ++dimX) {
-                    (*der2)[dimY][dimX] = softmax[dimY] * softmax[dimX];
+                    (*der2)[dimY][dimX] = (*der)[dimY] * (*der)[dimX];
                 }
-                (*der2)[dimY][dimY] -= softmax[dimY];
+                (*der2)[dimY][dimY] -= (*der)[dimY];
             }
         }
 
+        for (int dim = 0; dim < approxDimension; ++dim) {
+            (*der)[dim] = -(*der)[dim];
+        }
+        int targetClass = static_cast<int>(target);
+        (*der)[targetClass] += 1;
+
         if (weight != 1) {
             for (int dim = 0; dim < approxDimension; ++dim) {
                 (*der)[dim] *= weight;
@@ -400,6 +445,15 @@ public:
             }
         }
     }
+
+    void CalcFirstDerMultiRange(
+        int start,
+        int count,
+        const TVector<TVector<double>>& approx,
+        const float* targets,
+        const float* weights,
+        TVector<TVector<double>>* ders
+    ) const;
 };
 
 class TMultiClassOneVsAllError : public IDerCalcer<TMultiClassError, /*StoreExpApproxParam*/ false> {
@@ -433,24 +487,24 @@ public:
     ) const {
         int approxDimension = approx.ysize();
 
-        TVector<double> prob(approxDimension);
         for (int dim = 0; dim < approxDimension; ++dim) {
             double expApprox = exp(approx[dim]);
-            prob[dim] = expApprox / (1 + expApprox);
-            (*der)[dim] = -prob[dim];
+            (*der)[dim] = -expApprox / (1 + expApprox);
         }
-        int targetClass = static_cast<int>(target);
-        (*der)[targetClass] += 1;
 
         if (der2 != nullptr) {
             for (int dimY = 0; dimY < approxDimension; ++dimY) {
                 for (int dimX = 0; dimX < approxDimension; ++dimX) {
                     (*der2)[dimY][dimX] = 0;
                 }
-                (*der2)[dimY][dimY] = -prob[dimY] * (1 - prob[dimY]);
+                const double prob = -(*der)[dimY];
+                (*der2)[dimY][dimY] = -prob * (1 - prob);
             }
         }
 
+        int targetClass = static_cast<int>(target);
+        (*der)[targetClass] += 1;
+
         if (weight != 1) {
             for (int dim = 0; dim < approxDimension; ++dim) {
                 (*der)[dim] *= weight;
@@ -462,6 +516,15 @@ public:
             }
         }
     }
+
+    void CalcFirstDerMultiRange(
+        int start,
+        int count,
+        const TVector<TVector<double>>& approx,
+        const float* targets,
+        const float* weights,
+        TVector<TVector<double>>* ders
+    ) const;
 };
 
 class TPairLogitError : public IDerCalcer<TPairLogitError, /*StoreExpApproxParam*/ true> {
@@ -627,10 +690,11 @@ public:
         TVector<TDers>* ders
     ) const {
         int start = queriesInfo[queryStartIndex].Begin;
+        TVector<double> expApproxes;
         for (int queryIndex = queryStartIndex; queryIndex < queryEndIndex; ++queryIndex) {
             int begin = queriesInfo[queryIndex].Begin;
             int end = queriesInfo[queryIndex].End;
-            CalcDersForSingleQuery(start, begin - start, end - begin, approxes, targets, weights, ders);
+            CalcDersForSingleQuery(start, begin - start, end - begin, approxes, targets, weights, &expApproxes, ders);
         }
     }
 
@@ -650,6 +714,7 @@ private:
         const TVector<double>& approxes,
         const TVector<float>& targets,
         const TVector<float>& weights,
+        TVector<double>* expApproxes,
         TVector<TDers>* ders
     ) const {
         double maxApprox = -std::numeric_limits<double>::max();
@@ -668,9 +733,15 @@ private:
             }
         }
         if (sumWeightedTargets > 0) {
+            // exponents of the query are calculated at once, values of documents with zero weight are not used
+            expApproxes->yresize(count);
+            for (int dim = offset; dim < offset + count; ++dim) {
+                (*expApproxes)[dim - offset] = approxes[start + dim] - maxApprox;
+            }
+            FastExpInplace(expApproxes->data(), count);
             for (int dim = offset; dim < offset + count; ++dim) {
                 if (weights.empty() || weights[start + dim] > 0) {
-                    double expApprox = exp(approxes[start + dim] - maxApprox);
+                    double expApprox = (*expApproxes)[dim - offset];
                     if (!weights.empty()) {
                         expApprox *= weights[start + dim];
                     }
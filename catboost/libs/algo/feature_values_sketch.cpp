@@ -0,0 +1,113 @@
+#include "feature_values_sketch.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/ymath.h>
+
+TFeatureValuesSketch::TFeatureValuesSketch(size_t maxSize)
+    : MaxSize(maxSize)
+{
+    CB_ENSURE(MaxSize > 0, "Sketch size should be positive");
+}
+
+void TFeatureValuesSketch::Add(TConstArrayRef<float> values) {
+    TFeatureValuesSketch block(MaxSize);
+    TVector<float> sortedValues;
+    sortedValues.reserve(values.size());
+    for (float value : values) {
+        if (IsNan(value)) {
+            block.SeenNans = true;
+        } else {
+            sortedValues.push_back(value == 0.0f ? 0.0f : value); // -0.0 and 0.0 are the same point
+        }
+    }
+    Sort(sortedValues.begin(), sortedValues.end());
+    for (float value : sortedValues) {
+        if (block.Points.empty() || block.Points.back().first != value) {
+            block.Points.emplace_back(value, 0);
+        }
+        ++block.Points.back().second;
+    }
+    block.ValueCount = sortedValues.size();
+    Merge(block);
+}
+
+void TFeatureValuesSketch::Merge(const TFeatureValuesSketch& other) {
+    TVector<std::pair<float, ui64>> merged;
+    merged.reserve(Points.size() + other.Points.size());
+    auto lhs = Points.begin();
+    auto rhs = other.Points.begin();
+    while (lhs != Points.end() || rhs != other.Points.end()) {
+        std::pair<float, ui64> point;
+        if (rhs == other.Points.end() || (lhs != Points.end() && lhs->first < rhs->first)) {
+            point = *lhs++;
+        } else if (lhs == Points.end() || rhs->first < lhs->first) {
+            point = *rhs++;
+        } else {
+            point = {lhs->first, lhs->second + rhs->second};
+            ++lhs;
+            ++rhs;
+        }
+        merged.push_back(point);
+    }
+    Points.swap(merged);
+    ValueCount += other.ValueCount;
+    SeenNans |= other.SeenNans;
+    if (Points.size() > MaxSize) {
+        Compress();
+    }
+}
+
+void TFeatureValuesSketch::Compress() {
+    // heavy points and full buckets have at least `step` values each, so there are about MaxSize / 2 of them,
+    // plus at most as many partial buckets cut by heavy points
+    const ui64 step = Max<ui64>(1, 2 * ValueCount / MaxSize);
+    TVector<std::pair<float, ui64>> compressed;
+    compressed.reserve(MaxSize + 1);
+    size_t bucketBegin = 0;
+    ui64 bucketCount = 0;
+    auto flushBucket = [&] (size_t bucketEnd) {
+        if (bucketCount == 0) {
+            return;
+        }
+        // represent the bucket by its median value
+        ui64 count = 0;
+        size_t median = bucketBegin;
+        while (2 * (count + Points[median].second) < bucketCount && median + 1 < bucketEnd) {
+            count += Points[median].second;
+            ++median;
+        }
+        compressed.emplace_back(Points[median].first, bucketCount);
+        bucketCount = 0;
+    };
+    for (size_t i = 0; i < Points.size(); ++i) {
+        if (Points[i].second >= step) {
+            flushBucket(i);
+            compressed.push_back(Points[i]);
+            bucketBegin = i + 1;
+            continue;
+        }
+        bucketCount += Points[i].second;
+        if (bucketCount >= step) {
+            flushBucket(i + 1);
+            bucketBegin = i + 1;
+        }
+    }
+    flushBucket(Points.size());
+    Points.swap(compressed);
+}
+
+TVector<float> TFeatureValuesSketch::MakeSample(size_t sampleSize) const {
+    sampleSize = Min<ui64>(sampleSize, ValueCount);
+    TVector<float> sample;
+    sample.reserve(sampleSize);
+    ui64 countBefore = 0;
+    for (const auto& point : Points) {
+        const ui64 sampleBefore = countBefore * sampleSize / ValueCount;
+        countBefore += point.second;
+        const ui64 sampleAfter = countBefore * sampleSize / ValueCount;
+        sample.insert(sample.end(), sampleAfter - sampleBefore, point.first);
+    }
+    return sample;
+}
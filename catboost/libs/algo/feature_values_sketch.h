@@ -0,0 +1,45 @@
+#pragma once
+
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+#include <utility>
+
+// Mergeable summary of float feature values, used to select borders without keeping the whole column.
+// Distinct values are stored with their counts; when there are more than maxSize of them, neighbouring
+// light values are collapsed into one point, heavy values are kept exactly. Rank error of a quantile
+// is about 2 / maxSize of the value count per compression.
+class TFeatureValuesSketch {
+public:
+    explicit TFeatureValuesSketch(size_t maxSize = 200000);
+
+    // NaN values are not stored, only noted
+    void Add(TConstArrayRef<float> values);
+    void Merge(const TFeatureValuesSketch& other);
+
+    bool HasNans() const {
+        return SeenNans;
+    }
+
+    ui64 GetValueCount() const {
+        return ValueCount;
+    }
+
+    size_t GetPointCount() const {
+        return Points.size();
+    }
+
+    // Sorted sample of min(sampleSize, value count) values distributed as the added ones,
+    // reproduces added values exactly while nothing was collapsed and sampleSize is large enough
+    TVector<float> MakeSample(size_t sampleSize) const;
+
+private:
+    void Compress();
+
+private:
+    size_t MaxSize;
+    TVector<std::pair<float, ui64>> Points; // sorted by value
+    ui64 ValueCount = 0;
+    bool SeenNans = false;
+};
@@ -225,6 +225,36 @@ TFold TFold::BuildPlainFold(
     return ff;
 }
 
+size_t TFold::GetPermutedFloatHistogramsSize(const TAllFeatures& features) const {
+    if (PermutationBlockSize == LearnPermutation.ysize()) {
+        return 0;
+    }
+    size_t size = 0;
+    for (int featureIdx = 0; featureIdx < features.FloatHistograms.ysize(); ++featureIdx) {
+        size += features.HasFloatFeature(featureIdx) ? LearnPermutation.size() * sizeof(ui8) : 0;
+    }
+    return size;
+}
+
+void TFold::BuildPermutedFloatHistograms(const TAllFeatures& features, NPar::TLocalExecutor* localExecutor) {
+    PermutedFloatHistograms.resize(features.FloatHistograms.size());
+    localExecutor->ExecRange([&](int featureIdx) {
+        if (!features.HasFloatFeature(featureIdx)) {
+            return;
+        }
+        if (!features.IsFloatHistogramPacked(featureIdx) && !features.IsFloatFeatureBundled(featureIdx)) {
+            AssignPermuted(features.FloatHistograms[featureIdx], &PermutedFloatHistograms[featureIdx]);
+            return;
+        }
+        auto& permutedHistogram = PermutedFloatHistograms[featureIdx];
+        permutedHistogram.yresize(LearnPermutation.size());
+        features.VisitFloatHistogram(featureIdx, [&](const auto& histogram) {
+            for (size_t doc = 0; doc < LearnPermutation.size(); ++doc) {
+                permutedHistogram[doc] = histogram[LearnPermutation[doc]];
+            }
+        });
+    }, 0, features.FloatHistograms.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
+}
 
 void TFold::DropEmptyCTRs() {
     TVector<TProjection> emptyProjections;
@@ -12,6 +12,8 @@
 #include <catboost/libs/model/online_ctr.h>
 #include <catboost/libs/options/defaults_helper.h>
 
+#include <library/threading/local_executor/local_executor.h>
+
 #include <util/generic/vector.h>
 #include <util/random/shuffle.h>
 #include <util/generic/ymath.h>
@@ -19,6 +21,7 @@
 #include <tuple>
 
 struct TRestorableFastRng64;
+struct TAllFeatures;
 
 struct TFold {
     struct TBodyTail {
@@ -58,6 +61,8 @@ struct TFold {
     TVector<TVector<int>> LearnTargetClass;
     TVector<int> TargetClassesCount;
     int PermutationBlockSize = FoldPermutationBlockSizeNotSet;
+    // [feature][index in fold] copies of float histograms in LearnPermutation order, empty if features are read through permutation
+    TVector<TVector<ui8>> PermutedFloatHistograms;
 
     TOnlineCTRHash& GetCtrs(const TProjection& proj) {
         return proj.HasSingleFeature() ? OnlineSingleCtrs : OnlineCTR;
@@ -104,6 +109,11 @@ struct TFold {
 
     const TVector<float>& GetLearnWeights() const { return LearnWeights; }
 
+    bool HasPermutedFloatHistograms() const { return !PermutedFloatHistograms.empty(); }
+    // Memory needed for PermutedFloatHistograms, 0 if LearnPermutation is identity and copies are useless
+    size_t GetPermutedFloatHistogramsSize(const TAllFeatures& features) const;
+    void BuildPermutedFloatHistograms(const TAllFeatures& features, NPar::TLocalExecutor* localExecutor);
+
     void SaveApproxes(IOutputStream* s) const;
     void LoadApproxes(IInputStream* s);
 
@@ -8,9 +8,13 @@
 #include <util/generic/set.h>
 
 size_t TAllFeatures::GetDocCount() const {
-    for (const auto& floatHistogram : FloatHistograms) {
-        if (!floatHistogram.empty())
-            return floatHistogram.size();
+    for (int floatFeatureIdx = 0; floatFeatureIdx < FloatHistograms.ysize(); ++floatFeatureIdx) {
+        if (!FloatHistograms[floatFeatureIdx].empty())
+            return IsFloatHistogramPacked(floatFeatureIdx) ? PackedDocCount : FloatHistograms[floatFeatureIdx].size();
+    }
+    if (!FloatFeatureBundles.empty()) {
+        const auto& bundle = FloatFeatureBundles[0];
+        return bundle.IsWide() ? bundle.WideBins.size() : bundle.Bins.size();
     }
     for (const auto& catFeatures : CatFeaturesRemapped) {
         if (!catFeatures.empty())
@@ -19,6 +23,30 @@ size_t TAllFeatures::GetDocCount() const {
     return 0;
 }
 
+void PackFloatHistogram(ui8 bitsPerBinLog2, TVector<ui8>* histogram) {
+    Y_ASSERT(bitsPerBinLog2 <= 3);
+    if (bitsPerBinLog2 == 3) {
+        return;
+    }
+    const size_t docCount = histogram->size();
+    const size_t docsPerByteLog2 = 3 - bitsPerBinLog2;
+    const size_t packedSize = GetPackedFloatHistogramSize(docCount, bitsPerBinLog2);
+    ui8* data = histogram->data();
+    // byte i of packed data depends only on bytes >= i of unpacked data, so packing is done in place
+    for (size_t packedIdx = 0; packedIdx < packedSize; ++packedIdx) {
+        const size_t docBegin = packedIdx << docsPerByteLog2;
+        const size_t docEnd = Min(docBegin + (1 << docsPerByteLog2), docCount);
+        ui8 packed = 0;
+        for (size_t doc = docBegin; doc < docEnd; ++doc) {
+            Y_ASSERT(data[doc] < (1 << (1 << bitsPerBinLog2)));
+            packed |= data[doc] << ((doc - docBegin) << bitsPerBinLog2);
+        }
+        data[packedIdx] = packed;
+    }
+    histogram->resize(packedSize);
+    histogram->shrink_to_fit();
+}
+
 template <typename T>
 static inline void ClearVector(TVector<T>* dst) {
     static_assert(std::is_pod<T>::value, "T must be a pod");
@@ -26,6 +54,14 @@ static inline void ClearVector(TVector<T>* dst) {
     dst->shrink_to_fit();
 }
 
+static inline void ClearFactor(int featureIdx, TDocumentStorage* docStorage) {
+    if (docStorage->IsQuantized()) {
+        ClearVector(&docStorage->QuantizedFactors[featureIdx]);
+    } else {
+        ClearVector(&docStorage->Factors[featureIdx]);
+    }
+}
+
 template <typename TDocSelector>
 static inline bool IsConstCatValue(int featureIdx, const TDocumentStorage& docStorage, const TDocSelector& docSelector) {
     size_t docCount = docSelector.GetDocCount();
@@ -146,12 +182,35 @@ static inline void BinarizeFloatFeature(int featureIdx,
     , NPar::TLocalExecutor::WAIT_COMPLETE);
 }
 
+/// Copy bins of quantized feature `featureIdx` from `docStorage` into float feature `floatFeatureIdx` in `features`.
+template <typename TDocSelector>
+static inline void CopyQuantizedFloatFeature(int featureIdx,
+                                             const TDocumentStorage& docStorage,
+                                             const TDocSelector& docSelector,
+                                             NPar::TLocalExecutor& localExecutor,
+                                             int floatFeatureIdx,
+                                             TAllFeatures* features) {
+    size_t docCount = docSelector.GetDocCount();
+    const TVector<ui8>& src = docStorage.QuantizedFactors[featureIdx];
+    TVector<ui8>& hist = features->FloatHistograms[floatFeatureIdx];
+
+    hist.yresize(docCount);
+
+    ui8* histData = hist.data();
+    localExecutor.ExecRange([&] (int i) {
+        histData[i] = src[docSelector(i)];
+    }
+    , NPar::TLocalExecutor::TExecRangeParams(0, docCount).SetBlockSize(1000)
+    , NPar::TLocalExecutor::WAIT_COMPLETE);
+}
+
 /// Allocate binarized data holders in `features`.
 static void PrepareSlots(size_t catFeatureCount, size_t floatFeatureCount, TAllFeatures* features) {
     features->CatFeaturesRemapped.resize(catFeatureCount);
     features->OneHotValues.resize(catFeatureCount);
     features->IsOneHot.resize(catFeatureCount, true);
     features->FloatHistograms.resize(floatFeatureCount);
+    features->FloatHistogramBitsLog2.resize(floatFeatureCount, 3);
 }
 
 /// Prepare slots of `testFeatures` after that of `learnFeatures`.
@@ -261,7 +320,7 @@ namespace {
                     }
                 } else {
                     auto floatFeatureIdx = TypedFeatureIdx[featureIdx];
-                    if (learnFeatures.FloatHistograms[floatFeatureIdx].empty()) {
+                    if (!learnFeatures.HasFloatFeature(floatFeatureIdx)) {
                         IgnoredFeatures.insert(featureIdx);
                     }
                 }
@@ -275,12 +334,13 @@ namespace {
                       bool clearPool,
                       TAllFeatures* features) const {
 
+            features->PackedDocCount = selectedDocIndices.empty() ? docStorage->GetDocCount() : selectedDocIndices.size();
             auto binarizeBlockOfFeatures = [&](int blockId) {
                 int lastFeatureIdx = Min((blockId + 1) * BlockSize, FeatureCount);
                 for (int featureIdx = blockId * BlockSize; featureIdx  < lastFeatureIdx; ++featureIdx) {
                     if (IgnoredFeatures.has(featureIdx)) {
                         if (clearPool) {
-                            ClearVector(&docStorage->Factors[featureIdx]);
+                            ClearFactor(featureIdx, docStorage);
                         }
                         continue;
                     }
@@ -291,7 +351,7 @@ namespace {
                             if (IgnoreRedundantCatFeatures && IsConstCatValue(featureIdx, *docStorage, selectedDocs)) {
                                 MATRIXNET_INFO_LOG << "feature " << featureIdx << " is redundant categorical feature, skipping it" << Endl;
                                 if (clearPool) {
-                                    ClearVector(&docStorage->Factors[featureIdx]);
+                                    ClearFactor(featureIdx, docStorage);
                                 }
                                 continue;
                             }
@@ -301,7 +361,7 @@ namespace {
                             if (IgnoreRedundantCatFeatures && IsConstCatValue(featureIdx, *docStorage, selectedDocs)) {
                                 MATRIXNET_INFO_LOG << "feature " << featureIdx << " is redundant categorical feature, skipping it" << Endl;
                                 if (clearPool) {
-                                    ClearVector(&docStorage->Factors[featureIdx]);
+                                    ClearFactor(featureIdx, docStorage);
                                 }
                                 continue;
                             }
@@ -311,12 +371,23 @@ namespace {
                         int floatFeatureIdx = TypedFeatureIdx[featureIdx];
                         if (FloatFeatures[floatFeatureIdx].Borders.empty()) {
                             if (clearPool) {
-                                ClearVector(&docStorage->Factors[featureIdx]);
+                                ClearFactor(featureIdx, docStorage);
                             }
                             continue;
                         }
                         bool seenNans = false;
-                        if (selectedDocIndices.empty()) {
+                        if (docStorage->IsQuantized()) {
+                            // bins are already computed against the same borders, see SetBordersFromQuantizedPool
+                            if (selectedDocIndices.empty() && clearPool) {
+                                features->FloatHistograms[floatFeatureIdx] = std::move(docStorage->QuantizedFactors[featureIdx]);
+                            } else if (selectedDocIndices.empty()) {
+                                CopyQuantizedFloatFeature(featureIdx, *docStorage, TSelectAll(docStorage->GetDocCount()),
+                                                          LocalExecutor, floatFeatureIdx, features);
+                            } else {
+                                CopyQuantizedFloatFeature(featureIdx, *docStorage, TSelectIndices(selectedDocIndices),
+                                                          LocalExecutor, floatFeatureIdx, features);
+                            }
+                        } else if (selectedDocIndices.empty()) {
                             BinarizeFloatFeature(featureIdx, *docStorage, TSelectAll(docStorage->GetDocCount()),
                                                  FloatFeatures[floatFeatureIdx].Borders, NanMode, LocalExecutor,
                                                  floatFeatureIdx, features, &seenNans);
@@ -329,8 +400,11 @@ namespace {
                             bool mayHaveNans = FloatFeatures[floatFeatureIdx].HasNans || allowNans;
                             CB_ENSURE(mayHaveNans, "There are NaNs in test dataset (feature number " << featureIdx << ") but there were no NaNs in learn dataset");
                         }
+                        const ui8 bitsPerBinLog2 = GetFloatHistogramBitsLog2(FloatFeatures[floatFeatureIdx].Borders.size());
+                        PackFloatHistogram(bitsPerBinLog2, &features->FloatHistograms[floatFeatureIdx]);
+                        features->FloatHistogramBitsLog2[floatFeatureIdx] = bitsPerBinLog2;
                         if (clearPool) {
-                            ClearVector(&docStorage->Factors[featureIdx]);
+                            ClearFactor(featureIdx, docStorage);
                         }
                     }
                 }
@@ -401,3 +475,146 @@ void PrepareAllFeaturesTest(const THashSet<int>& categFeatures,
     binarizer.Binarize(allowNansOnlyInTest, testDocStorage, selectedDocIndices, clearPool, testFeatures);
     DumpMemUsage("Extract bools done");
 }
+
+// Features with nonzero bins in a larger share of documents are not bundled
+constexpr double MAX_BUNDLED_FEATURE_DENSITY = 0.1;
+// Limits size of bucket stats of a bundle in score calculation
+constexpr ui32 MAX_FEATURE_BUNDLE_BIN_COUNT = 1024;
+
+namespace {
+    struct TFeatureBundleBuilder {
+        TFloatFeatureBundle Bundle;
+        TVector<ui64> UsedDocs; // bit mask of documents with nonzero bin in some feature of the bundle
+    };
+}
+
+static bool HasConflicts(const TVector<ui64>& usedDocs, const TVector<ui32>& docs) {
+    for (ui32 doc : docs) {
+        if (usedDocs[doc >> 6] & (1ULL << (doc & 63))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename TBundleBin>
+static void FillBundleBins(const TAllFeatures& features,
+                           const TVector<TFloatFeatureBundlePart>& parts,
+                           const TFloatFeatureBundle& bundle,
+                           size_t docCount,
+                           TVector<TBundleBin>* bins) {
+    bins->resize(docCount);
+    for (int featureIdx : bundle.FloatFeatures) {
+        const TFloatHistogramRef histogram = features.GetFloatHistogram(featureIdx);
+        const ui32 binOffset = parts[featureIdx].BinOffset;
+        for (size_t doc = 0; doc < docCount; ++doc) {
+            const ui8 bin = histogram[doc];
+            if (bin != 0) {
+                (*bins)[doc] = binOffset + bin;
+            }
+        }
+    }
+}
+
+void BundleExclusiveFloatFeatures(const TVector<TFloatFeature>& floatFeatures,
+                                  NPar::TLocalExecutor& localExecutor,
+                                  TAllFeatures* learnFeatures) {
+    CB_ENSURE(learnFeatures->FloatFeatureBundles.empty(), "Float features are already bundled");
+    const size_t docCount = learnFeatures->GetDocCount();
+    const int floatFeatureCount = learnFeatures->FloatHistograms.ysize();
+    if (docCount == 0) {
+        return;
+    }
+    const size_t maxNonzeroCount = docCount * MAX_BUNDLED_FEATURE_DENSITY;
+    TVector<size_t> nonzeroCounts(floatFeatureCount, docCount);
+    localExecutor.ExecRange([&](int featureIdx) {
+        if (learnFeatures->FloatHistograms[featureIdx].empty()) {
+            return;
+        }
+        const TFloatHistogramRef histogram = learnFeatures->GetFloatHistogram(featureIdx);
+        size_t nonzeroCount = 0;
+        for (size_t doc = 0; doc < docCount && nonzeroCount <= maxNonzeroCount; ++doc) {
+            nonzeroCount += histogram[doc] != 0;
+        }
+        nonzeroCounts[featureIdx] = nonzeroCount;
+    }, 0, floatFeatureCount, NPar::TLocalExecutor::WAIT_COMPLETE);
+
+    TVector<int> bundleCandidates;
+    for (int featureIdx = 0; featureIdx < floatFeatureCount; ++featureIdx) {
+        if (nonzeroCounts[featureIdx] <= maxNonzeroCount && floatFeatures[featureIdx].Borders.size() < MAX_FEATURE_BUNDLE_BIN_COUNT) {
+            bundleCandidates.push_back(featureIdx);
+        }
+    }
+    if (bundleCandidates.size() < 2) {
+        return;
+    }
+    StableSort(bundleCandidates.begin(), bundleCandidates.end(), [&nonzeroCounts](int lhs, int rhs) {
+        return nonzeroCounts[lhs] > nonzeroCounts[rhs];
+    });
+
+    // greedy first fit, denser features are placed first
+    TVector<TFeatureBundleBuilder> builders;
+    TVector<TFloatFeatureBundlePart> parts(floatFeatureCount);
+    TVector<ui32> nonzeroDocs;
+    for (int featureIdx : bundleCandidates) {
+        const TFloatHistogramRef histogram = learnFeatures->GetFloatHistogram(featureIdx);
+        nonzeroDocs.clear();
+        for (size_t doc = 0; doc < docCount; ++doc) {
+            if (histogram[doc] != 0) {
+                nonzeroDocs.push_back(doc);
+            }
+        }
+        const ui32 borderCount = floatFeatures[featureIdx].Borders.size();
+        int bundleIdx = 0;
+        while (bundleIdx < builders.ysize()
+            && (builders[bundleIdx].Bundle.BinCount + borderCount > MAX_FEATURE_BUNDLE_BIN_COUNT || HasConflicts(builders[bundleIdx].UsedDocs, nonzeroDocs))) {
+            ++bundleIdx;
+        }
+        if (bundleIdx == builders.ysize()) {
+            builders.emplace_back();
+            builders.back().UsedDocs.resize((docCount + 63) / 64);
+        }
+        auto& builder = builders[bundleIdx];
+        parts[featureIdx] = {bundleIdx, builder.Bundle.BinCount - 1, borderCount};
+        builder.Bundle.FloatFeatures.push_back(featureIdx);
+        builder.Bundle.BinCount += borderCount;
+        for (ui32 doc : nonzeroDocs) {
+            builder.UsedDocs[doc >> 6] |= 1ULL << (doc & 63);
+        }
+    }
+
+    auto& bundles = learnFeatures->FloatFeatureBundles;
+    TVector<int> bundleIdxRemap(builders.size(), -1);
+    for (int builderIdx = 0; builderIdx < builders.ysize(); ++builderIdx) {
+        if (builders[builderIdx].Bundle.FloatFeatures.size() > 1) {
+            bundleIdxRemap[builderIdx] = bundles.ysize();
+            bundles.emplace_back(std::move(builders[builderIdx].Bundle));
+        }
+    }
+    builders.clear();
+    if (bundles.empty()) {
+        return;
+    }
+    size_t bundledFeatureCount = 0;
+    for (auto& part : parts) {
+        if (part.BundleIdx >= 0) {
+            part.BundleIdx = bundleIdxRemap[part.BundleIdx];
+            bundledFeatureCount += part.BundleIdx >= 0;
+        }
+    }
+
+    localExecutor.ExecRange([&](int bundleIdx) {
+        auto& bundle = bundles[bundleIdx];
+        if (bundle.IsWide()) {
+            FillBundleBins(*learnFeatures, parts, bundle, docCount, &bundle.WideBins);
+        } else {
+            FillBundleBins(*learnFeatures, parts, bundle, docCount, &bundle.Bins);
+        }
+        for (int featureIdx : bundle.FloatFeatures) {
+            ClearVector(&learnFeatures->FloatHistograms[featureIdx]);
+        }
+    }, 0, bundles.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
+    learnFeatures->FloatFeatureBundleParts = std::move(parts);
+    MATRIXNET_INFO_LOG << bundledFeatureCount << " float features are bundled into " << bundles.size() << " bundles" << Endl;
+    DumpMemUsage("Bundle float features done");
+}
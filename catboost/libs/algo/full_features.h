@@ -11,16 +11,116 @@
 #include <util/generic/ymath.h>
 
 
+/// Bins of a float feature for documents, packed by 1 << BitsPerBinLog2 bits per document.
+/// Documents are packed starting from the low bits of a byte.
+struct TFloatHistogramRef {
+    const ui8* Data = nullptr;
+    ui8 BitsPerBinLog2 = 3;
+
+    ui8 operator[](size_t doc) const {
+        const ui32 docsPerByteLog2 = 3 - BitsPerBinLog2;
+        const ui32 shift = (doc & ((1 << docsPerByteLog2) - 1)) << BitsPerBinLog2;
+        const ui8 binMask = 0xff >> (8 - (1 << BitsPerBinLog2));
+        return (Data[doc >> docsPerByteLog2] >> shift) & binMask;
+    }
+};
+
+/// Bins of a float feature stored in the column of a feature bundle.
+/// Bin b > 0 of the feature is stored as BinOffset + b, documents with other values in the column have bin 0.
+template <typename TBundleBin>
+struct TBundledFloatHistogramRef {
+    const TBundleBin* Data = nullptr;
+    ui32 BinOffset = 0;
+    ui32 BorderCount = 0;
+
+    ui8 operator[](size_t doc) const {
+        const ui32 bin = (ui32)Data[doc] - BinOffset - 1;
+        return bin < BorderCount ? bin + 1 : 0;
+    }
+};
+
+/// Float features sharing one column, a document has nonzero bin in at most one feature of a bundle.
+struct TFloatFeatureBundle {
+    TVector<int> FloatFeatures;
+    ui32 BinCount = 1; // values in the column, 0 means zero bins in all features
+    TVector<ui8> Bins; // [doc], empty if BinCount > 256
+    TVector<ui16> WideBins; // [doc], empty if BinCount <= 256
+
+    bool IsWide() const {
+        return BinCount > 256;
+    }
+    SAVELOAD(FloatFeatures, BinCount, Bins, WideBins);
+};
+
+/// Position of a float feature in TAllFeatures::FloatFeatureBundles.
+struct TFloatFeatureBundlePart {
+    int BundleIdx = -1;
+    ui32 BinOffset = 0;
+    ui32 BorderCount = 0;
+    SAVELOAD(BundleIdx, BinOffset, BorderCount);
+};
+
 struct TAllFeatures {
-    TVector<TVector<ui8>> FloatHistograms; // [featureIdx][doc]
-    // FloatHistograms[featureIdx] might be empty if feature is const.
+    TVector<TVector<ui8>> FloatHistograms; // [featureIdx][doc], packed if FloatHistogramBitsLog2[featureIdx] < 3
+    // FloatHistograms[featureIdx] might be empty if feature is const or bundled.
+    // Use HasFloatFeature to check if feature is used and VisitFloatHistogram to read features which might be packed or bundled.
+    TVector<ui8> FloatHistogramBitsLog2; // [featureIdx], empty if no feature is packed
+    size_t PackedDocCount = 0; // doc count if some float feature is packed
+    TVector<TFloatFeatureBundle> FloatFeatureBundles;
+    TVector<TFloatFeatureBundlePart> FloatFeatureBundleParts; // [featureIdx], empty if no feature is bundled
     TVector<TVector<int>> CatFeaturesRemapped; // [featureIdx][doc]
     TVector<TVector<int>> OneHotValues; // [featureIdx][valueIdx]
     TVector<bool> IsOneHot;
     size_t GetDocCount() const;
-    SAVELOAD(FloatHistograms, CatFeaturesRemapped, OneHotValues, IsOneHot);
+
+    bool IsFloatHistogramPacked(int featureIdx) const {
+        return !FloatHistogramBitsLog2.empty() && FloatHistogramBitsLog2[featureIdx] < 3;
+    }
+    bool IsFloatFeatureBundled(int featureIdx) const {
+        return !FloatFeatureBundleParts.empty() && FloatFeatureBundleParts[featureIdx].BundleIdx >= 0;
+    }
+    bool HasFloatFeature(int featureIdx) const {
+        return !FloatHistograms[featureIdx].empty() || IsFloatFeatureBundled(featureIdx);
+    }
+    TFloatHistogramRef GetFloatHistogram(int featureIdx) const {
+        Y_ASSERT(!IsFloatFeatureBundled(featureIdx));
+        return {FloatHistograms[featureIdx].data(), FloatHistogramBitsLog2.empty() ? (ui8)3 : FloatHistogramBitsLog2[featureIdx]};
+    }
+    /// Call `func` with TFloatHistogramRef or TBundledFloatHistogramRef of a used float feature.
+    template <typename TFunc>
+    void VisitFloatHistogram(int featureIdx, TFunc&& func) const {
+        if (!IsFloatFeatureBundled(featureIdx)) {
+            func(GetFloatHistogram(featureIdx));
+            return;
+        }
+        const auto& part = FloatFeatureBundleParts[featureIdx];
+        const auto& bundle = FloatFeatureBundles[part.BundleIdx];
+        if (bundle.IsWide()) {
+            func(TBundledFloatHistogramRef<ui16>{bundle.WideBins.data(), part.BinOffset, part.BorderCount});
+        } else {
+            func(TBundledFloatHistogramRef<ui8>{bundle.Bins.data(), part.BinOffset, part.BorderCount});
+        }
+    }
+    SAVELOAD(FloatHistograms, FloatHistogramBitsLog2, PackedDocCount, FloatFeatureBundles, FloatFeatureBundleParts, CatFeaturesRemapped, OneHotValues, IsOneHot);
 };
 
+inline size_t GetPackedFloatHistogramSize(size_t docCount, ui8 bitsPerBinLog2) {
+    const size_t docsPerByteLog2 = 3 - bitsPerBinLog2;
+    return (docCount + (1 << docsPerByteLog2) - 1) >> docsPerByteLog2;
+}
+
+/// Log2 of bits per document enough for bins of a float feature with `borderCount` borders.
+inline ui8 GetFloatHistogramBitsLog2(size_t borderCount) {
+    ui8 bitsPerBinLog2 = 0;
+    while (bitsPerBinLog2 < 3 && borderCount >= (1u << (1 << bitsPerBinLog2))) {
+        ++bitsPerBinLog2;
+    }
+    return bitsPerBinLog2;
+}
+
+/// Pack bins of `histogram` stored one per byte into 1 << `bitsPerBinLog2` bits per document.
+void PackFloatHistogram(ui8 bitsPerBinLog2, TVector<ui8>* histogram);
+
 inline int GetDocCount(const TAllFeatures& allFeatures) {
     return static_cast<int>(allFeatures.GetDocCount());
 }
@@ -71,3 +171,12 @@ void PrepareAllFeaturesTest(const THashSet<int>& categFeatures,
                             const TVector<size_t>& selectedDocIndices,
                             TDocumentStorage* testDocStorage,
                             TAllFeatures* testFeatures);
+
+/// Bundle mutually exclusive sparse float features of `learnFeatures` to score them in one pass over documents.
+/// Features of a bundle never have nonzero bins in the same document, their columns are replaced by one column of the bundle.
+/// @param floatFeatures - Borders for binarization
+/// @param localExecutor - Thread provider
+/// @param learnFeatures - Binarized learn features
+void BundleExclusiveFloatFeatures(const TVector<TFloatFeature>& floatFeatures,
+                                  NPar::TLocalExecutor& localExecutor,
+                                  TAllFeatures* learnFeatures);
@@ -26,8 +26,10 @@ static void AddFloatFeatures(const TDataset& learnData,
                              TLearnContext* ctx,
                              TBucketStatsCache* statsFromPrevTree,
                              TCandidateList* candList) {
-    for (int f = 0; f < learnData.AllFeatures.FloatHistograms.ysize(); ++f) {
-        if (learnData.AllFeatures.FloatHistograms[f].empty()) {
+    const auto& features = learnData.AllFeatures;
+    TVector<bool> isBundleSampled(features.FloatFeatureBundles.size(), false);
+    for (int f = 0; f < features.FloatHistograms.ysize(); ++f) {
+        if (!features.HasFloatFeature(f)) {
             continue;
         }
         TCandidateInfo split;
@@ -35,11 +37,20 @@ static void AddFloatFeatures(const TDataset& learnData,
         split.SplitCandidate.Type = ESplitType::FloatFeature;
 
         if (ctx->Rand.GenRandReal1() > ctx->Params.ObliviousTreeOptions->Rsm) {
-            statsFromPrevTree->Stats.erase(split.SplitCandidate);
+            statsFromPrevTree->Erase(split.SplitCandidate);
             continue;
         }
+        if (features.IsFloatFeatureBundled(f)) {
+            isBundleSampled[features.FloatFeatureBundleParts[f].BundleIdx] = true;
+        }
         candList->emplace_back(TCandidatesInfoList(split));
     }
+    // stats of a bundle are not updated on levels where none of its features is scored
+    for (int bundleIdx = 0; bundleIdx < isBundleSampled.ysize(); ++bundleIdx) {
+        if (!isBundleSampled[bundleIdx]) {
+            statsFromPrevTree->Erase(GetBundleStatsKey(bundleIdx));
+        }
+    }
 }
 
 static void AddOneHotFeatures(const TDataset& learnData,
@@ -56,7 +67,7 @@ static void AddOneHotFeatures(const TDataset& learnData,
         split.SplitCandidate.FeatureIdx = cf;
         split.SplitCandidate.Type = ESplitType::OneHotFeature;
         if (ctx->Rand.GenRandReal1() > ctx->Params.ObliviousTreeOptions->Rsm) {
-            statsFromPrevTree->Stats.erase(split.SplitCandidate);
+            statsFromPrevTree->Erase(split.SplitCandidate);
             continue;
         }
 
@@ -107,7 +118,7 @@ static void DropStatsForProjection(const TFold& fold,
                 TCandidateInfo split;
                 split.SplitCandidate.Type = ESplitType::OnlineCtr;
                 split.SplitCandidate.Ctr = TCtr(proj, ctrIdx, border, prior, ctrMeta.BorderCount);
-                statsFromPrevTree->Stats.erase(split.SplitCandidate);
+                statsFromPrevTree->Erase(split.SplitCandidate);
             }
         }
     }
@@ -183,17 +194,9 @@ static void AddTreeCtrs(const TDataset& learnData,
             fold->GetCtrRef(proj);
         }
     }
-    THashSet<TSplitCandidate> candidatesToErase;
-    for (auto& splitCandidate : statsFromPrevTree->Stats) {
-        if (splitCandidate.first.Type == ESplitType::OnlineCtr) {
-            if (!addedProjHash.has(splitCandidate.first.Ctr.Projection)) {
-                candidatesToErase.insert(splitCandidate.first);
-            }
-        }
-    }
-    for (const auto& splitCandidate : candidatesToErase) {
-        statsFromPrevTree->Stats.erase(splitCandidate);
-    }
+    statsFromPrevTree->EraseIf([&addedProjHash](const TSplitCandidate& splitCandidate) {
+        return splitCandidate.Type == ESplitType::OnlineCtr && !addedProjHash.has(splitCandidate.Ctr.Projection);
+    });
 }
 
 static void SelectCtrsToDropAfterCalc(size_t memoryLimit,
@@ -237,6 +240,67 @@ static void SelectCtrsToDropAfterCalc(size_t memoryLimit,
     }
 }
 
+// Float feature candidates are scored in groups, histograms of a group are built in one pass over documents.
+constexpr size_t MAX_FUSED_FLOAT_FEATURES = 32;
+// Bucket stats of a group should fit into L2 cache to keep scattered updates cheap
+constexpr size_t MAX_FUSED_FLOAT_FEATURES_STATS_SIZE = 256 * 1024;
+
+// Returns indexes in candidate list scored by one task, all candidates of a task with several indexes are float features.
+// Features of a bundle are scored by one task if bundles are used.
+static TVector<TVector<int>> GroupCandidatesForScoring(
+    const TCandidateList& candList,
+    const TAllFeatures& features,
+    const TVector<int>& splitCounts,
+    int currentDepth,
+    int threadCount,
+    bool canFuseFloatFeatures,
+    bool useBundles,
+    size_t bucketStatsSize) {
+    TVector<TVector<int>> tasks;
+    TVector<int> floatFeatureCandidates;
+    for (int id = 0; id < candList.ysize(); ++id) {
+        if (canFuseFloatFeatures && candList[id].Candidates[0].SplitCandidate.Type == ESplitType::FloatFeature) {
+            floatFeatureCandidates.push_back(id);
+        } else {
+            tasks.push_back({id});
+        }
+    }
+    const auto getBundleIdx = [&](int id) {
+        const int featureIdx = candList[id].Candidates[0].SplitCandidate.FeatureIdx;
+        return useBundles && features.IsFloatFeatureBundled(featureIdx) ? features.FloatFeatureBundleParts[featureIdx].BundleIdx : -1;
+    };
+    if (useBundles) {
+        StableSort(floatFeatureCandidates.begin(), floatFeatureCandidates.end(), [&](int lhs, int rhs) {
+            return getBundleIdx(lhs) < getBundleIdx(rhs);
+        });
+    }
+    // keep at least one group per thread
+    const size_t maxGroupSize = Min(MAX_FUSED_FLOAT_FEATURES, Max<size_t>((floatFeatureCandidates.size() + threadCount - 1) / threadCount, 1));
+    size_t groupStatsSize = 0;
+    int prevBundleIdx = -1;
+    for (int id : floatFeatureCandidates) {
+        const int bundleIdx = getBundleIdx(id);
+        if (bundleIdx >= 0 && bundleIdx == prevBundleIdx) {
+            // histogram of the bundle is already accounted in the group
+            tasks.back().push_back(id);
+            continue;
+        }
+        prevBundleIdx = bundleIdx;
+        const int featureIdx = candList[id].Candidates[0].SplitCandidate.FeatureIdx;
+        const size_t bucketCount = bundleIdx >= 0 ? features.FloatFeatureBundles[bundleIdx].BinCount : splitCounts[featureIdx] + 1;
+        const size_t statsSize = bucketStatsSize * bucketCount * (1ULL << currentDepth);
+        const bool isGroupFull = !tasks.empty() && tasks.back().size() >= maxGroupSize;
+        const bool isLastGroupFloat = !tasks.empty() && candList[tasks.back()[0]].Candidates[0].SplitCandidate.Type == ESplitType::FloatFeature;
+        if (!isLastGroupFloat || isGroupFull || groupStatsSize + statsSize > MAX_FUSED_FLOAT_FEATURES_STATS_SIZE) {
+            tasks.emplace_back();
+            groupStatsSize = 0;
+        }
+        tasks.back().push_back(id);
+        groupStatsSize += statsSize;
+    }
+    return tasks;
+}
+
 static void CalcBestScore(const TDataset& learnData,
         const TDatasetPtrs& testDataPtrs,
         const TVector<int>& splitCounts,
@@ -249,7 +313,33 @@ static void CalcBestScore(const TDataset& learnData,
     CB_ENSURE(static_cast<ui32>(ctx->LocalExecutor.GetThreadCount()) == ctx->Params.SystemOptions->NumThreads - 1);
 
     TCandidateList& candList = *candidateList;
-    ctx->LocalExecutor.ExecRange([&](int id) {
+    const bool canFuseFloatFeatures = !IsPairwiseScoring(ctx->Params.LossFunctionDescription->GetLossFunction());
+    const bool useBundles = !fold->HasPermutedFloatHistograms();
+    const auto scoringTasks = GroupCandidatesForScoring(candList, learnData.AllFeatures, splitCounts, currentDepth, ctx->Params.SystemOptions->NumThreads, canFuseFloatFeatures, useBundles,
+        GetBucketStatsSize(ctx->Params.BoostingOptions->BoostingType));
+    ctx->LocalExecutor.ExecRange([&](int taskIdx) {
+        const auto& task = scoringTasks[taskIdx];
+        if (canFuseFloatFeatures && candList[task[0]].Candidates[0].SplitCandidate.Type == ESplitType::FloatFeature) {
+            TVector<TSplitCandidate> splits;
+            for (int id : task) {
+                splits.push_back(candList[id].Candidates[0].SplitCandidate);
+            }
+            const auto scoreBins = CalcScoresForFloatFeatures(learnData.AllFeatures,
+                                                              splitCounts,
+                                                              ctx->SampledDocs,
+                                                              ctx->SmallestSplitSideDocs,
+                                                              *fold,
+                                                              ctx->Params,
+                                                              splits,
+                                                              currentDepth,
+                                                              &ctx->PrevTreeLevelStats);
+            for (size_t splitIdx = 0; splitIdx < task.size(); ++splitIdx) {
+                const int id = task[splitIdx];
+                SetBestScore(randSeed + id, {GetScores(scoreBins[splitIdx])}, scoreStDev, &candList[id].Candidates);
+            }
+            return;
+        }
+        const int id = task[0];
         auto& candidate = candList[id];
         if (candidate.Candidates[0].SplitCandidate.Type == ESplitType::OnlineCtr) {
             const auto& proj = candidate.Candidates[0].SplitCandidate.Ctr.Projection;
@@ -284,7 +374,7 @@ static void CalcBestScore(const TDataset& learnData,
             fold->GetCtrRef(candidate.Candidates[0].SplitCandidate.Ctr.Projection).Feature.clear();
         }
         SetBestScore(randSeed + id, allScores, scoreStDev, &candidate.Candidates);
-    }, 0, candList.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
+    }, 0, scoringTasks.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
 }
 
 void GreedyTensorSearch(const TDataset& learnData,
@@ -9,6 +9,17 @@
 #include <util/generic/utility.h>
 #include <util/system/mem_info.h>
 
+TVector<float> SelectBorders(TVector<float>* values, int borderCount, EBorderSelectionType borderType) {
+    THashSet<float> borderSet = BestSplit(*values, borderCount, borderType);
+    if (borderSet.has(-0.0f)) { // BestSplit might add negative zeros
+        borderSet.erase(-0.0f);
+        borderSet.insert(0.0f);
+    }
+    TVector<float> borders(borderSet.begin(), borderSet.end());
+    Sort(borders.begin(), borders.end());
+    return borders;
+}
+
 void GenerateBorders(const TPool& pool, TLearnContext* ctx, TVector<TFloatFeature>* floatFeatures) {
     auto& docStorage = pool.Docs;
     const THashSet<int>& categFeatures = ctx->CatFeatures;
@@ -84,13 +95,7 @@ void GenerateBorders(const TPool& pool, TLearnContext* ctx, TVector<TFloatFeatur
             }
         }
 
-        THashSet<float> borderSet = BestSplit(vals, borderCount, borderType);
-        if (borderSet.has(-0.0f)) { // BestSplit might add negative zeros
-            borderSet.erase(-0.0f);
-            borderSet.insert(0.0f);
-        }
-        TVector<float> bordersBlock(borderSet.begin(), borderSet.end());
-        Sort(bordersBlock.begin(), bordersBlock.end());
+        TVector<float> bordersBlock = SelectBorders(&vals, borderCount, borderType);
 
         floatFeature.HasNans = AnyOf(docStorage.Factors[floatFeatureIdx], IsNan);
         if (floatFeature.HasNans) {
@@ -123,6 +128,30 @@ void GenerateBorders(const TPool& pool, TLearnContext* ctx, TVector<TFloatFeatur
     MATRIXNET_INFO_LOG << "Borders for float features generated" << Endl;
 }
 
+void SetBordersFromQuantizedPool(const TPool& pool, ENanMode nanMode, TVector<TFloatFeature>* floatFeatures) {
+    CB_ENSURE(pool.Docs.IsQuantized(), "Pool is not quantized");
+    CB_ENSURE(nanMode != ENanMode::Max, "nan_mode=Max is not supported for quantized pools");
+    const int featureCount = pool.Docs.GetEffectiveFactorCount();
+    Y_VERIFY(pool.QuantizedFeatureBorders.ysize() == featureCount);
+    floatFeatures->resize(featureCount);
+    for (int i = 0; i < featureCount; ++i) {
+        auto& floatFeature = (*floatFeatures)[i];
+        floatFeature.FeatureIndex = i;
+        floatFeature.FlatFeatureIndex = i;
+        if (i < pool.FeatureId.ysize()) {
+            floatFeature.FeatureId = pool.FeatureId[i];
+        }
+        floatFeature.Borders = pool.QuantizedFeatureBorders[i];
+        // NaN values are quantized to the bin below the leading lowest() border, as in GenerateBorders with nan_mode=Min
+        floatFeature.HasNans = !floatFeature.Borders.empty() && floatFeature.Borders[0] == std::numeric_limits<float>::lowest();
+        if (floatFeature.HasNans) {
+            CB_ENSURE(nanMode == ENanMode::Min,
+                      "There are nan factors and nan values for float features are not allowed. Set nan_mode != Forbidden.");
+            floatFeature.NanValueTreatment = NCatBoostFbs::ENanValueTreatment_AsFalse;
+        }
+    }
+}
+
 void ConfigureMalloc() {
 #if !(defined(__APPLE__) && defined(__MACH__)) // there is no LF for MacOS
     if (!NMalloc::MallocInfo().SetParam("LB_LIMIT_TOTAL_SIZE", "1000000")) {
@@ -9,8 +9,14 @@
 #include <util/generic/vector.h>
 #include <util/generic/hash_set.h>
 
+// Sorted borders for not NaN feature values, `values` might be changed
+TVector<float> SelectBorders(TVector<float>* values, int borderCount, EBorderSelectionType borderType);
+
 void GenerateBorders(const TPool& pool, TLearnContext* ctx, TVector<TFloatFeature>* floatFeatures);
 
+// Quantized pool stores bins for borders of its quantization schema, they are used as is
+void SetBordersFromQuantizedPool(const TPool& pool, ENanMode nanMode, TVector<TFloatFeature>* floatFeatures);
+
 void ConfigureMalloc();
 
 void CalcErrors(
@@ -22,16 +22,16 @@ static inline ui8 GetFeatureSplitIdx(const TSplit& split) {
     return split.BinBorder;
 }
 
-static inline const TVector<ui8>& GetFloatHistogram(const TSplit& split, const TAllFeatures& features) {
-    return features.FloatHistograms[split.FeatureIdx];
+static inline TFloatHistogramRef GetFloatHistogram(const TSplit& split, const TAllFeatures& features) {
+    return features.GetFloatHistogram(split.FeatureIdx);
 }
 
 static inline const TVector<int>& GetRemappedCatFeatures(const TSplit& split, const TAllFeatures& features) {
     return features.CatFeaturesRemapped[split.FeatureIdx];
 }
 
-template <typename TCount, bool (*CmpOp)(TCount, TCount), int vectorWidth>
-void BuildIndicesKernel(const size_t* permutation, const TCount* histogram, TCount value, int level, TIndexType* indices) {
+template <typename TCount, bool (*CmpOp)(TCount, TCount), int vectorWidth, typename THistogram>
+void BuildIndicesKernel(const size_t* permutation, const THistogram& histogram, TCount value, int level, TIndexType* indices) {
     Y_ASSERT(vectorWidth == 4);
     const int perm0 = permutation[0];
     const int perm1 = permutation[1];
@@ -51,17 +51,24 @@ void BuildIndicesKernel(const size_t* permutation, const TCount* histogram, TCou
     indices[3] = idx3 + CmpOp(hist3, value) * level;
 }
 
-template <typename TCount, bool (*CmpOp)(TCount, TCount)>
+// permutation == nullptr if histogram is already in fold permutation order
+// histogram is a pointer to values, TFloatHistogramRef for packed or TBundledFloatHistogramRef for bundled float features
+template <typename TCount, bool (*CmpOp)(TCount, TCount), typename THistogram>
 void OfflineCtrBlock(const NPar::TLocalExecutor::TExecRangeParams& params,
                      int blockIdx,
-                     const TFold& fold,
-                     const TCount* histogram,
+                     const size_t* permutation,
+                     const THistogram& histogram,
                      TCount value,
                      int level,
                      TIndexType* indices) {
-    const size_t* permutation = fold.LearnPermutation.data();
     const int blockStart = blockIdx * params.GetBlockSize();
     const int nextBlockStart = Min<ui64>(blockStart + params.GetBlockSize(), params.LastId);
+    if (permutation == nullptr) {
+        for (int doc = blockStart; doc < nextBlockStart; ++doc) {
+            indices[doc] += CmpOp(histogram[doc], value) * level;
+        }
+        return;
+    }
     constexpr int vectorWidth = 4;
     int doc;
     for (doc = blockStart; doc + vectorWidth <= nextBlockStart; doc += vectorWidth) {
@@ -73,6 +80,27 @@ void OfflineCtrBlock(const NPar::TLocalExecutor::TExecRangeParams& params,
     }
 }
 
+static void OfflineFloatFeatureBlock(const NPar::TLocalExecutor::TExecRangeParams& params,
+                                     int blockIdx,
+                                     const TFold& fold,
+                                     const TSplit& split,
+                                     const TAllFeatures& features,
+                                     int level,
+                                     TIndexType* indices) {
+    if (fold.HasPermutedFloatHistograms()) {
+        OfflineCtrBlock<ui8, IsTrueHistogram>(params, blockIdx, /*permutation*/ nullptr, fold.PermutedFloatHistograms[split.FeatureIdx].data(),
+                                              GetFeatureSplitIdx(split), level, indices);
+    } else if (features.IsFloatHistogramPacked(split.FeatureIdx) || features.IsFloatFeatureBundled(split.FeatureIdx)) {
+        features.VisitFloatHistogram(split.FeatureIdx, [&](const auto& histogram) {
+            OfflineCtrBlock<ui8, IsTrueHistogram>(params, blockIdx, fold.LearnPermutation.data(), histogram,
+                                                  GetFeatureSplitIdx(split), level, indices);
+        });
+    } else {
+        OfflineCtrBlock<ui8, IsTrueHistogram>(params, blockIdx, fold.LearnPermutation.data(), features.FloatHistograms[split.FeatureIdx].data(),
+                                              GetFeatureSplitIdx(split), level, indices);
+    }
+}
+
 void SetPermutedIndices(const TSplit& split,
                         const TAllFeatures& features,
                         int curDepth,
@@ -89,8 +117,7 @@ void SetPermutedIndices(const TSplit& split,
     TIndexType* indicesData = indices->data();
     if (split.Type == ESplitType::FloatFeature) {
         localExecutor->ExecRange([&](int blockIdx) {
-            OfflineCtrBlock<ui8, IsTrueHistogram>(blockParams, blockIdx, fold, GetFloatHistogram(split, features).data(),
-                                                  GetFeatureSplitIdx(split), splitWeight, indicesData);
+            OfflineFloatFeatureBlock(blockParams, blockIdx, fold, split, features, splitWeight, indicesData);
         }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
     } else if (split.Type == ESplitType::OnlineCtr) {
         auto& ctr = fold.GetCtr(split.Ctr.Projection);
@@ -100,7 +127,7 @@ void SetPermutedIndices(const TSplit& split,
     } else {
         Y_ASSERT(split.Type == ESplitType::OneHotFeature);
         localExecutor->ExecRange([&] (int blockIdx) {
-            OfflineCtrBlock<int, IsTrueOneHotFeature>(blockParams, blockIdx, fold, GetRemappedCatFeatures(split, features).data(),
+            OfflineCtrBlock<int, IsTrueOneHotFeature>(blockParams, blockIdx, fold.LearnPermutation.data(), GetRemappedCatFeatures(split, features).data(),
                                                       split.BinBorder, splitWeight, indicesData);
         }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
     }
@@ -163,9 +190,7 @@ static void BuildIndicesForLearn(const TSplitTree& tree,
             const auto& split = tree.Splits[splitIdx];
             const int splitWeight = 1 << splitIdx;
             if (split.Type == ESplitType::FloatFeature) {
-                OfflineCtrBlock<ui8, IsTrueHistogram>(learnBlockParams, blockIdx, fold,
-                    GetFloatHistogram(split, learnData.AllFeatures).data(),
-                    GetFeatureSplitIdx(split), splitWeight, indices);
+                OfflineFloatFeatureBlock(learnBlockParams, blockIdx, fold, split, learnData.AllFeatures, splitWeight, indices);
             } else if (split.Type == ESplitType::OnlineCtr) {
                 const TOnlineCTR& splitOnlineCtr = *onlineCtrs[splitIdx];
                 NPar::TLocalExecutor::BlockedLoopBody(learnBlockParams, [&](int doc) {
@@ -173,7 +198,7 @@ static void BuildIndicesForLearn(const TSplitTree& tree,
                 })(blockIdx);
             } else {
                 Y_ASSERT(split.Type == ESplitType::OneHotFeature);
-                OfflineCtrBlock<int, IsTrueOneHotFeature>(learnBlockParams, blockIdx, fold,
+                OfflineCtrBlock<int, IsTrueOneHotFeature>(learnBlockParams, blockIdx, fold.LearnPermutation.data(),
                     GetRemappedCatFeatures(split, learnData.AllFeatures).data(),
                     split.BinBorder, splitWeight, indices);
             }
@@ -201,9 +226,9 @@ static void BuildIndicesForTest(const TSplitTree& tree,
             const int splitWeight = 1 << splitIdx;
             if (split.Type == ESplitType::FloatFeature) {
                 const ui8 featureSplitIdx = GetFeatureSplitIdx(split);
-                const ui8* floatHistogramData = GetFloatHistogram(split, testData.AllFeatures).data();
+                const TFloatHistogramRef floatHistogram = GetFloatHistogram(split, testData.AllFeatures);
                 NPar::TLocalExecutor::BlockedLoopBody(tailBlockParams, [&](int doc) {
-                    tailIndices[doc] += IsTrueHistogram(floatHistogramData[doc], featureSplitIdx) * splitWeight;
+                    tailIndices[doc] += IsTrueHistogram(floatHistogram[doc], featureSplitIdx) * splitWeight;
                 })(blockIdx);
             } else if (split.Type == ESplitType::OnlineCtr) {
                 const TOnlineCTR& splitOnlineCtr = *onlineCtrs[splitIdx];
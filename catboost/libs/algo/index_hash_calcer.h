@@ -69,19 +69,20 @@ inline void CalcHashes(const TProjection& proj,
     }
 
     for (const TBinFeature& feature : proj.BinFeatures) {
-        const ui8* featureValues = offset + allFeatures.FloatHistograms[feature.FloatFeature].data();
-        if (learnPermutation != nullptr) {
-            const auto& perm = *learnPermutation;
-            for (size_t i = 0; i < sampleCount; ++i) {
-                const bool isTrueFeature = IsTrueHistogram(featureValues[perm[i]], feature.SplitIdx);
-                hashArr[i] = CalcHash(hashArr[i], (ui64)isTrueFeature);
-            }
-        } else {
-            for (size_t i = 0; i < sampleCount; ++i) {
-                const bool isTrueFeature = IsTrueHistogram(featureValues[i], feature.SplitIdx);
-                hashArr[i] = CalcHash(hashArr[i], (ui64)isTrueFeature);
+        allFeatures.VisitFloatHistogram(feature.FloatFeature, [&](const auto& featureValues) {
+            if (learnPermutation != nullptr) {
+                const auto& perm = *learnPermutation;
+                for (size_t i = 0; i < sampleCount; ++i) {
+                    const bool isTrueFeature = IsTrueHistogram(featureValues[perm[i]], feature.SplitIdx);
+                    hashArr[i] = CalcHash(hashArr[i], (ui64)isTrueFeature);
+                }
+            } else {
+                for (size_t i = 0; i < sampleCount; ++i) {
+                    const bool isTrueFeature = IsTrueHistogram(featureValues[offset + i], feature.SplitIdx);
+                    hashArr[i] = CalcHash(hashArr[i], (ui64)isTrueFeature);
+                }
             }
-        }
+        });
     }
 
     for (const TOneHotSplit& feature : proj.OneHotFeatures) {
@@ -2,6 +2,7 @@
 #include "error_functions.h"
 
 #include <catboost/libs/distributed/master.h>
+#include <catboost/libs/helpers/mem_usage.h>
 #include <catboost/libs/helpers/progress_helper.h>
 #include <catboost/libs/options/defaults_helper.h>
 
@@ -59,6 +60,35 @@ static ui32 CalcFeaturesCheckSum(const TAllFeatures& allFeatures) {
     return checkSum;
 }
 
+// Folds without permuted copies of float features read them through LearnPermutation
+static void BuildPermutedFloatHistograms(
+    const TAllFeatures& features,
+    ui64 usedRamLimit,
+    NPar::TLocalExecutor* localExecutor,
+    TLearnProgress* learnProgress
+) {
+    TVector<TFold*> folds;
+    for (auto& fold : learnProgress->Folds) {
+        folds.push_back(&fold);
+    }
+    folds.push_back(&learnProgress->AveragingFold);
+    int skippedFoldCount = 0;
+    for (TFold* fold : folds) {
+        const size_t neededMemory = fold->GetPermutedFloatHistogramsSize(features);
+        if (neededMemory == 0) {
+            continue;
+        }
+        if (neededMemory > GetAvailableMemory(usedRamLimit)) {
+            ++skippedFoldCount;
+            continue;
+        }
+        fold->BuildPermutedFloatHistograms(features, localExecutor);
+    }
+    if (skippedFoldCount > 0) {
+        MATRIXNET_WARNING_LOG << "Not enough memory for permuted feature copies of " << skippedFoldCount << " of " << folds.size() << " folds" << Endl;
+    }
+}
+
 void TLearnContext::InitContext(const TDataset& learnData, const TDatasetPtrs& testDataPtrs) {
     LearnProgress.PoolCheckSum = CalcFeaturesCheckSum(learnData.AllFeatures);
     for (const TDataset* testData : testDataPtrs) {
@@ -137,6 +167,15 @@ void TLearnContext::InitContext(const TDataset& learnData, const TDatasetPtrs& t
         Rand
     );
 
+    if (Params.ObliviousTreeOptions->PermutedFeatureCopies && Params.SystemOptions->IsSingleHost()) {
+        BuildPermutedFloatHistograms(
+            learnData.AllFeatures,
+            ParseMemorySizeDescription(Params.SystemOptions->CpuUsedRamLimit),
+            &LocalExecutor,
+            &LearnProgress
+        );
+    }
+
     LearnProgress.AvrgApprox.resize(LearnProgress.ApproxDimension, TVector<double>(learnData.GetSampleCount()));
     if (!learnData.Baseline.empty()) {
         LearnProgress.AvrgApprox = learnData.Baseline;
@@ -2,6 +2,7 @@
 
 #include <catboost/libs/metrics/metric.h>
 #include <catboost/libs/helpers/query_info_helper.h>
+#include <catboost/libs/options/json_helper.h>
 #include <catboost/libs/options/loss_description.h>
 
 #include <library/threading/local_executor/local_executor.h>
@@ -267,6 +268,15 @@ TMetricsPlotCalcer CreateMetricCalcer(
     } else {
         end = Min<int>(end, model.GetTreeCount());
     }
+    if (model.ModelInfo.has("params")) {
+        const NJson::TJsonValue paramsJson = ReadTJsonValue(model.ModelInfo.at("params"));
+        if (paramsJson.Has("loss_function")) {
+            const auto objective = FromString<ELossFunction>(paramsJson["loss_function"]["type"].GetString());
+            for (const auto& metric : metrics) {
+                CheckApproxAUCObjective(*metric, objective);
+            }
+        }
+    }
 
     TMetricsPlotCalcer plotCalcer(model, metrics, executor, tmpDir, begin, end, evalPeriod, processedIterationsStep);
 
@@ -50,6 +50,9 @@ public:
                 NonAdditiveMetricsIndices.push_back(metricIndex);
                 CB_ENSURE(metric->GetErrorType() == EErrorType::PerObjectError,
                     "Error: we don't support non-additive querywise and pairwise metrics currenty");
+                MATRIXNET_WARNING_LOG << "Metric " << metric->GetDescription() << " is not additive, "
+                    << "approxes of the whole pool are stored on disk and loaded to RAM for every iteration. "
+                    << "Use AUC:approx_bins=N or MedianAbsoluteError:relative_accuracy=A to evaluate it block by block" << Endl;
             }
         }
         AdditiveMetricPlots.resize(AdditiveMetrics.ysize(), TVector<TMetricHolder>(Iterations.ysize()));
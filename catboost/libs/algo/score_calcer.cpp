@@ -21,12 +21,11 @@ int GetSplitCount(const TVector<int>& splitsCount,
     }
 }
 
-template<typename TFullIndexType, typename TIsCaching>
+template<typename TFullIndexType, typename TIsCaching, typename TStats>
 static TVector<TScoreBin> CalcScoreImpl(const TIsCaching& isCaching,
         const TVector<TFullIndexType>& singleIdx,
         const TCalcScoreFold& fold,
         const TFold& initialFold,
-        bool isPlainMode,
         bool isPairwiseScoring,
         float l2Regularizer,
         float pairwiseBucketWeightPriorReg,
@@ -34,7 +33,7 @@ static TVector<TScoreBin> CalcScoreImpl(const TIsCaching& isCaching,
         const TStatsIndexer& indexer,
         int depth,
         int splitStatsCount,
-        TBucketStats* splitStats) {
+        TStats* splitStats) {
     Y_ASSERT(!isCaching || depth > 0);
     const int approxDimension = fold.GetApproxDimension();
     const int leafCount = 1 << depth;
@@ -58,20 +57,17 @@ static TVector<TScoreBin> CalcScoreImpl(const TIsCaching& isCaching,
                     &scoreBins
                 );
             } else {
-                TBucketStats* stats = splitStats + (bodyTailIdx * approxDimension + dim) * splitStatsCount;
-                CalcStatsKernel(isCaching, singleIdx, fold, isPlainMode, indexer, depth, bt, dim, stats);
-                if (isPlainMode) {
-                    UpdateScoreBin(stats, leafCount, indexer, splitType, l2Regularizer, /*isPlainMode=*/std::true_type(), sumAllWeights, docCount, &scoreBins);
-                } else {
-                    UpdateScoreBin(stats, leafCount, indexer, splitType, l2Regularizer, /*isPlainMode=*/std::false_type(), sumAllWeights, docCount, &scoreBins);
-                }
+                TStats* stats = splitStats + (bodyTailIdx * approxDimension + dim) * splitStatsCount;
+                CalcStatsKernel(isCaching, singleIdx, fold, indexer, depth, bt, dim, stats);
+                UpdateScoreBin(stats, leafCount, indexer, splitType, l2Regularizer, sumAllWeights, docCount, &scoreBins);
             }
         }
     }
     return scoreBins;
 }
 
-TVector<TScoreBin> CalcScore(const TAllFeatures& af,
+template<typename TStats>
+static TVector<TScoreBin> CalcScoreWithStats(const TAllFeatures& af,
                           const TVector<int>& splitsCount,
                           const std::tuple<const TOnlineCTRHash&, const TOnlineCTRHash&>& allCtrs,
                           const TCalcScoreFold& fold,
@@ -86,22 +82,21 @@ TVector<TScoreBin> CalcScore(const TAllFeatures& af,
     const int bucketIndexBits = GetValueBitCount(bucketCount) + depth + 1;
     const bool isPairwiseScoring = IsPairwiseScoring(fitParams.LossFunctionDescription->GetLossFunction());
 
-    decltype(auto) SelectCalcScoreImpl = [&] (auto isCaching, const TCalcScoreFold& fold, int splitStatsCount, auto* splitStats) {
-        const bool isPlainMode = IsPlainMode(fitParams.BoostingOptions->BoostingType);
+    decltype(auto) SelectCalcScoreImpl = [&] (auto isCaching, const TCalcScoreFold& fold, int splitStatsCount, TStats* splitStats) {
         const float l2Regularizer = static_cast<const float>(fitParams.ObliviousTreeOptions->L2Reg);
         const float pairwiseBucketWeightPriorReg = static_cast<const float>(fitParams.ObliviousTreeOptions->PairwiseNonDiagReg);
         if (bucketIndexBits <= 8) {
             TVector<ui8> singleIdx;
-            BuildSingleIndex(fold, af, allCtrs, split, indexer, &singleIdx);
-            return CalcScoreImpl(isCaching, singleIdx, fold, initialFold, isPlainMode, isPairwiseScoring, l2Regularizer, pairwiseBucketWeightPriorReg, split.Type, indexer, depth, splitStatsCount, GetDataPtr(*splitStats));
+            BuildSingleIndex(fold, af, allCtrs, split, indexer, &singleIdx, initialFold.PermutedFloatHistograms);
+            return CalcScoreImpl(isCaching, singleIdx, fold, initialFold, isPairwiseScoring, l2Regularizer, pairwiseBucketWeightPriorReg, split.Type, indexer, depth, splitStatsCount, splitStats);
         } else if (bucketIndexBits <= 16) {
             TVector<ui16> singleIdx;
-            BuildSingleIndex(fold, af, allCtrs, split, indexer, &singleIdx);
-            return CalcScoreImpl(isCaching, singleIdx, fold, initialFold, isPlainMode, isPairwiseScoring, l2Regularizer, pairwiseBucketWeightPriorReg, split.Type, indexer, depth, splitStatsCount, GetDataPtr(*splitStats));
+            BuildSingleIndex(fold, af, allCtrs, split, indexer, &singleIdx, initialFold.PermutedFloatHistograms);
+            return CalcScoreImpl(isCaching, singleIdx, fold, initialFold, isPairwiseScoring, l2Regularizer, pairwiseBucketWeightPriorReg, split.Type, indexer, depth, splitStatsCount, splitStats);
         } else if (bucketIndexBits <= 32) {
             TVector<ui32> singleIdx;
-            BuildSingleIndex(fold, af, allCtrs, split, indexer, &singleIdx);
-            return CalcScoreImpl(isCaching, singleIdx, fold, initialFold, isPlainMode, isPairwiseScoring, l2Regularizer, pairwiseBucketWeightPriorReg, split.Type, indexer, depth, splitStatsCount, GetDataPtr(*splitStats));
+            BuildSingleIndex(fold, af, allCtrs, split, indexer, &singleIdx, initialFold.PermutedFloatHistograms);
+            return CalcScoreImpl(isCaching, singleIdx, fold, initialFold, isPairwiseScoring, l2Regularizer, pairwiseBucketWeightPriorReg, split.Type, indexer, depth, splitStatsCount, splitStats);
         }
         CB_ENSURE(false, "too deep or too much splitsCount for score calculation");
     };
@@ -109,21 +104,334 @@ TVector<TScoreBin> CalcScore(const TAllFeatures& af,
 
     // Pairwise scoring doesn't use statistics from previous tree level
     if (!IsSamplingPerTree(treeOptions) || isPairwiseScoring) {
-        TVector<TBucketStats> scratchSplitStats;
+        TVector<TStats> scratchSplitStats;
         const int splitStatsCount = indexer.CalcSize(depth);
         const int statsCount = splitStatsCount;
         scratchSplitStats.yresize(statsCount);
-        return SelectCalcScoreImpl(/*isCaching*/ std::false_type(), fold, /*splitStatsCount*/ 0, &scratchSplitStats);
+        return SelectCalcScoreImpl(/*isCaching*/ std::false_type(), fold, /*splitStatsCount*/ 0, GetDataPtr(scratchSplitStats));
     } else {
         const int splitStatsCount = indexer.CalcSize(treeOptions.MaxDepth);
         const int statsCount = fold.GetBodyTailCount() * fold.GetApproxDimension() * splitStatsCount;
         bool areStatsDirty;
-        TVector<TBucketStats, TPoolAllocator>& splitStats = statsFromPrevTree->GetStats(split, statsCount, &areStatsDirty); // thread-safe access
+        TStats* splitStats = statsFromPrevTree->GetStats<TStats>(split, statsCount, &areStatsDirty); // thread-safe access
         if (depth == 0 || areStatsDirty) {
-            return SelectCalcScoreImpl(/*isCaching*/ std::false_type(), fold, splitStatsCount, &splitStats);
+            return SelectCalcScoreImpl(/*isCaching*/ std::false_type(), fold, splitStatsCount, splitStats);
         } else {
-            return SelectCalcScoreImpl(/*isCaching*/ std::true_type(), prevLevelData, splitStatsCount, &splitStats);
+            return SelectCalcScoreImpl(/*isCaching*/ std::true_type(), prevLevelData, splitStatsCount, splitStats);
         }
     }
     CB_ENSURE(false, "too deep or too much splitsCount for score calculation");
 }
+
+TVector<TScoreBin> CalcScore(const TAllFeatures& af,
+                          const TVector<int>& splitsCount,
+                          const std::tuple<const TOnlineCTRHash&, const TOnlineCTRHash&>& allCtrs,
+                          const TCalcScoreFold& fold,
+                          const TCalcScoreFold& prevLevelData,
+                          const TFold& initialFold,
+                          const NCatboostOptions::TCatBoostOptions& fitParams,
+                          const TSplitCandidate& split,
+                          int depth,
+                          TBucketStatsCache* statsFromPrevTree) {
+    if (IsPlainMode(fitParams.BoostingOptions->BoostingType)) {
+        return CalcScoreWithStats<TPlainBucketStats>(af, splitsCount, allCtrs, fold, prevLevelData, initialFold, fitParams, split, depth, statsFromPrevTree);
+    } else {
+        return CalcScoreWithStats<TBucketStats>(af, splitsCount, allCtrs, fold, prevLevelData, initialFold, fitParams, split, depth, statsFromPrevTree);
+    }
+}
+
+namespace {
+    // Float feature of a bundle, bucket b > 0 of the feature is bucket BinOffset + b of the bundle
+    struct TUnbundledFeature {
+        ui32 BinOffset = 0;
+        int BucketCount = 0;
+        TVector<TScoreBin>* ScoreBins = nullptr;
+    };
+
+    // Histogram of one float feature or of a feature bundle in a group of features scored together
+    template<typename TStats>
+    struct TFloatFeatureHistogram {
+        TFloatHistogramRef Bins; // bucket of each document in learn order
+        const ui16* WideBins = nullptr; // used instead of Bins for bundles with more than 256 buckets
+        int BucketCount = 0;
+        TStats* SplitStats = nullptr; // stats of all body tails and dimensions
+        int SplitStatsCount = 0; // 0 if stats of all body tails and dimensions share the same memory
+        TVector<TScoreBin>* ScoreBins = nullptr; // nullptr for a bundle
+        TVector<TUnbundledFeature> BundledFeatures; // features of a bundle to score
+
+        ui32 GetBucket(size_t doc) const {
+            return WideBins != nullptr ? WideBins[doc] : Bins[doc];
+        }
+    };
+}
+
+// Calls updateDoc(doc, originalDocIdx) for documents [docBegin, docEnd) of fold, original indices are the same as in SetSingleIndex.
+template<typename TUpdateDoc>
+static inline void ForEachDocInPermutation(const TCalcScoreFold& fold, const size_t* docPermutation, int docBegin, int docEnd, TUpdateDoc&& updateDoc) {
+    const size_t docCount = fold.GetDocCount();
+    const size_t permBlockSize = fold.PermutationBlockSize;
+    if (docPermutation == nullptr || permBlockSize == docCount) {
+        for (int doc = docBegin; doc < docEnd; ++doc) {
+            updateDoc(doc, doc);
+        }
+    } else if (permBlockSize > 1) {
+        const size_t blockCount = (docCount + permBlockSize - 1) / permBlockSize;
+        size_t blockStart = 0;
+        while (blockStart < (size_t)docEnd) {
+            const size_t blockIdx = docPermutation[blockStart] / permBlockSize;
+            const size_t nextBlockStart = blockStart + (blockIdx + 1 == blockCount ? docCount - blockIdx * permBlockSize : permBlockSize);
+            const size_t originalBlockIdx = docPermutation[blockStart];
+            const size_t runEnd = Min(nextBlockStart, (size_t)docEnd);
+            for (size_t doc = Max(blockStart, (size_t)docBegin); doc < runEnd; ++doc) {
+                updateDoc(doc, originalBlockIdx + doc - blockStart);
+            }
+            blockStart = nextBlockStart;
+        }
+    } else {
+        for (int doc = docBegin; doc < docEnd; ++doc) {
+            updateDoc(doc, docPermutation[doc]);
+        }
+    }
+}
+
+// Not bootstraped sums of body documents, used by ordered boosting only
+template<typename TUpdateDoc>
+static inline void UpdateDeltaCountFused(const TCalcScoreFold& fold, const size_t* docPermutation, const TCalcScoreFold::TBodyTail& bt, TBucketStats* /*stats*/, TUpdateDoc&& updateDeltaCount) {
+    ForEachDocInPermutation(fold, docPermutation, 0, bt.BodyFinish, updateDeltaCount);
+}
+
+template<typename TUpdateDoc>
+static inline void UpdateDeltaCountFused(const TCalcScoreFold& /*fold*/, const size_t* /*docPermutation*/, const TCalcScoreFold::TBodyTail& /*bt*/, TPlainBucketStats* /*stats*/, TUpdateDoc&& /*updateDeltaCount*/) {
+}
+
+static inline void AddDeltaCount(double delta, double count, TBucketStats* stats) {
+    stats->SumDelta += delta;
+    stats->Count += count;
+}
+
+static inline void AddDeltaCount(double /*delta*/, double /*count*/, TPlainBucketStats* /*stats*/) {
+}
+
+// Same sums as CalcStatsKernel for every histogram, leaf index and derivatives of a document are read once for all of them
+template<typename TStats>
+static void CalcFloatFeatureStatsFused(
+    bool isCaching,
+    const TCalcScoreFold& fold,
+    bool areBinsPermuted,
+    int depth,
+    const TCalcScoreFold::TBodyTail& bt,
+    int dim,
+    TConstArrayRef<TFloatFeatureHistogram<TStats>> histograms,
+    TArrayRef<TStats*> stats) {
+    for (size_t histogramIdx = 0; histogramIdx < histograms.size(); ++histogramIdx) {
+        const TStatsIndexer indexer(histograms[histogramIdx].BucketCount);
+        Fill(stats[histogramIdx] + (isCaching ? indexer.CalcSize(depth - 1) : 0), stats[histogramIdx] + indexer.CalcSize(depth), TStats{});
+    }
+
+    const TIndexType* indices = GetDataPtr(fold.Indices);
+    const size_t* docPermutation = areBinsPermuted ? GetDataPtr(fold.IndexInFold) : GetDataPtr(fold.LearnPermutation);
+    const bool hasPairwiseWeights = !bt.PairwiseWeights.empty();
+    const float* weightsData = hasPairwiseWeights ? GetDataPtr(bt.PairwiseWeights) : GetDataPtr(fold.LearnWeights);
+    const float* sampleWeightsData = hasPairwiseWeights ? GetDataPtr(bt.SamplePairwiseWeights) : GetDataPtr(fold.SampleWeights);
+    const double* sampleWeightedDerivatives = GetDataPtr(bt.SampleWeightedDerivatives[dim]);
+    const auto updateWeighted = [&](int doc, size_t originalDocIdx) {
+        const int leaf = indices[doc];
+        for (size_t histogramIdx = 0; histogramIdx < histograms.size(); ++histogramIdx) {
+            const auto& histogram = histograms[histogramIdx];
+            TStats& leafStats = stats[histogramIdx][histogram.BucketCount * leaf + histogram.GetBucket(originalDocIdx)];
+            leafStats.SumWeightedDelta += sampleWeightedDerivatives[doc];
+            leafStats.SumWeight += sampleWeightsData[doc];
+        }
+    };
+    const double* weightedDerivatives = GetDataPtr(bt.WeightedDerivatives[dim]);
+    UpdateDeltaCountFused(fold, docPermutation, bt, stats[0], [&](int doc, size_t originalDocIdx) {
+        const int leaf = indices[doc];
+        const double count = weightsData == nullptr ? 1 : weightsData[doc];
+        for (size_t histogramIdx = 0; histogramIdx < histograms.size(); ++histogramIdx) {
+            const auto& histogram = histograms[histogramIdx];
+            AddDeltaCount(weightedDerivatives[doc], count, &stats[histogramIdx][histogram.BucketCount * leaf + histogram.GetBucket(originalDocIdx)]);
+        }
+    });
+    ForEachDocInPermutation(fold, docPermutation, GetWeightedDocBegin(bt, stats[0]), bt.TailFinish, updateWeighted);
+    if (isCaching) {
+        for (size_t histogramIdx = 0; histogramIdx < histograms.size(); ++histogramIdx) {
+            FixUpStats(depth, TStatsIndexer(histograms[histogramIdx].BucketCount), fold.SmallestSplitSideValues, stats[histogramIdx]);
+        }
+    }
+}
+
+// Stats of a bundled feature, bucket 0 of the feature collects all bundle buckets except the ones of the feature
+template<typename TStats>
+static void UnbundleStats(const TStats* bundleStats,
+                          int leafCount,
+                          int bundleBucketCount,
+                          const TUnbundledFeature& feature,
+                          TVector<TStats>* featureStats) {
+    featureStats->yresize(leafCount * feature.BucketCount);
+    const int featureBucketsBegin = feature.BinOffset + 1;
+    const int featureBucketsEnd = featureBucketsBegin + feature.BucketCount - 1;
+    for (int leaf = 0; leaf < leafCount; ++leaf) {
+        const TStats* leafBundleStats = bundleStats + leaf * bundleBucketCount;
+        TStats* leafFeatureStats = featureStats->data() + leaf * feature.BucketCount;
+        TStats defaultStats{};
+        for (int bucket = 0; bucket < featureBucketsBegin; ++bucket) {
+            defaultStats.Add(leafBundleStats[bucket]);
+        }
+        for (int bucket = featureBucketsEnd; bucket < bundleBucketCount; ++bucket) {
+            defaultStats.Add(leafBundleStats[bucket]);
+        }
+        leafFeatureStats[0] = defaultStats;
+        Copy(leafBundleStats + featureBucketsBegin, leafBundleStats + featureBucketsEnd, leafFeatureStats + 1);
+    }
+}
+
+template<typename TStats>
+static void CalcFloatFeaturesScoreFused(
+    bool isCaching,
+    const TCalcScoreFold& fold,
+    const TFold& initialFold,
+    float l2Regularizer,
+    int depth,
+    TConstArrayRef<TFloatFeatureHistogram<TStats>> histograms) {
+    if (histograms.empty()) {
+        return;
+    }
+    const int approxDimension = fold.GetApproxDimension();
+    const int leafCount = 1 << depth;
+    TVector<TStats*> stats(histograms.size());
+    TVector<TStats> featureStats;
+    for (int bodyTailIdx = 0; bodyTailIdx < fold.GetBodyTailCount(); ++bodyTailIdx) {
+        const auto& bt = fold.BodyTailArr[bodyTailIdx];
+        const double sumAllWeights = initialFold.BodyTailArr[bodyTailIdx].BodySumWeight;
+        const int docCount = initialFold.BodyTailArr[bodyTailIdx].BodyFinish;
+        for (int dim = 0; dim < approxDimension; ++dim) {
+            for (size_t histogramIdx = 0; histogramIdx < histograms.size(); ++histogramIdx) {
+                const auto& histogram = histograms[histogramIdx];
+                stats[histogramIdx] = histogram.SplitStats + (bodyTailIdx * approxDimension + dim) * histogram.SplitStatsCount;
+            }
+            CalcFloatFeatureStatsFused(isCaching, fold, initialFold.HasPermutedFloatHistograms(), depth, bt, dim, histograms, MakeArrayRef(stats));
+            const auto updateScoreBin = [&](const TStats* featureStats, int bucketCount, TVector<TScoreBin>* scoreBins) {
+                UpdateScoreBin(featureStats, leafCount, TStatsIndexer(bucketCount), ESplitType::FloatFeature, l2Regularizer, sumAllWeights, docCount, scoreBins);
+            };
+            for (size_t histogramIdx = 0; histogramIdx < histograms.size(); ++histogramIdx) {
+                const auto& histogram = histograms[histogramIdx];
+                if (histogram.ScoreBins != nullptr) {
+                    updateScoreBin(stats[histogramIdx], histogram.BucketCount, histogram.ScoreBins);
+                }
+                for (const auto& feature : histogram.BundledFeatures) {
+                    UnbundleStats(stats[histogramIdx], leafCount, histogram.BucketCount, feature, &featureStats);
+                    updateScoreBin(featureStats.data(), feature.BucketCount, feature.ScoreBins);
+                }
+            }
+        }
+    }
+}
+
+template<typename TStats>
+static TVector<TVector<TScoreBin>> CalcScoresForFloatFeaturesWithStats(
+    const TAllFeatures& af,
+    const TVector<int>& splitsCount,
+    const TCalcScoreFold& fold,
+    const TCalcScoreFold& prevLevelData,
+    const TFold& initialFold,
+    const NCatboostOptions::TCatBoostOptions& fitParams,
+    TConstArrayRef<TSplitCandidate> splits,
+    int depth,
+    TBucketStatsCache* statsFromPrevTree) {
+    CB_ENSURE(!IsPairwiseScoring(fitParams.LossFunctionDescription->GetLossFunction()), "fused float features scoring does not support pairwise scoring");
+    const float l2Regularizer = static_cast<const float>(fitParams.ObliviousTreeOptions->L2Reg);
+    const auto& treeOptions = fitParams.ObliviousTreeOptions.Get();
+    const bool isSamplingPerTree = IsSamplingPerTree(treeOptions);
+
+    // features of a bundle are scored from one histogram, unless fold has unbundled permuted copies of features
+    const bool useBundles = !af.FloatFeatureBundles.empty() && !initialFold.HasPermutedFloatHistograms();
+    TVector<TVector<TScoreBin>> scoreBins(splits.size());
+    TVector<TFloatFeatureHistogram<TStats>> allHistograms;
+    TVector<TSplitCandidate> histogramSplits; // keys of stats in statsFromPrevTree
+    THashMap<int, size_t> bundleHistogramIdx;
+    for (size_t splitIdx = 0; splitIdx < splits.size(); ++splitIdx) {
+        const auto& split = splits[splitIdx];
+        Y_ASSERT(split.Type == ESplitType::FloatFeature);
+        const int bucketCount = splitsCount[split.FeatureIdx] + 1;
+        scoreBins[splitIdx].resize(bucketCount);
+        if (useBundles && af.IsFloatFeatureBundled(split.FeatureIdx)) {
+            const auto& part = af.FloatFeatureBundleParts[split.FeatureIdx];
+            if (!bundleHistogramIdx.has(part.BundleIdx)) {
+                const auto& bundle = af.FloatFeatureBundles[part.BundleIdx];
+                bundleHistogramIdx[part.BundleIdx] = allHistograms.size();
+                TFloatFeatureHistogram<TStats> histogram;
+                if (bundle.IsWide()) {
+                    histogram.WideBins = GetDataPtr(bundle.WideBins);
+                } else {
+                    histogram.Bins = TFloatHistogramRef{GetDataPtr(bundle.Bins)};
+                }
+                histogram.BucketCount = bundle.BinCount;
+                allHistograms.push_back(histogram);
+                histogramSplits.push_back(GetBundleStatsKey(part.BundleIdx));
+            }
+            allHistograms[bundleHistogramIdx[part.BundleIdx]].BundledFeatures.push_back({part.BinOffset, bucketCount, &scoreBins[splitIdx]});
+            continue;
+        }
+        TFloatFeatureHistogram<TStats> histogram;
+        if (initialFold.HasPermutedFloatHistograms()) {
+            histogram.Bins = TFloatHistogramRef{GetDataPtr(initialFold.PermutedFloatHistograms[split.FeatureIdx])};
+        } else {
+            histogram.Bins = af.GetFloatHistogram(split.FeatureIdx);
+        }
+        histogram.BucketCount = bucketCount;
+        histogram.ScoreBins = &scoreBins[splitIdx];
+        allHistograms.push_back(histogram);
+        histogramSplits.push_back(split);
+    }
+
+    TVector<TStats> scratchStats;
+    if (!isSamplingPerTree) {
+        size_t scratchStatsCount = 0;
+        for (const auto& histogram : allHistograms) {
+            scratchStatsCount += TStatsIndexer(histogram.BucketCount).CalcSize(depth);
+        }
+        scratchStats.yresize(scratchStatsCount);
+    }
+    TVector<TFloatFeatureHistogram<TStats>> histograms;
+    TVector<TFloatFeatureHistogram<TStats>> cachedHistograms;
+    size_t scratchStatsOffset = 0;
+    for (size_t histogramIdx = 0; histogramIdx < allHistograms.size(); ++histogramIdx) {
+        auto& histogram = allHistograms[histogramIdx];
+        const TStatsIndexer indexer(histogram.BucketCount);
+        if (!isSamplingPerTree) {
+            histogram.SplitStats = scratchStats.data() + scratchStatsOffset;
+            scratchStatsOffset += indexer.CalcSize(depth);
+            histograms.push_back(std::move(histogram));
+        } else {
+            histogram.SplitStatsCount = indexer.CalcSize(treeOptions.MaxDepth);
+            const int statsCount = fold.GetBodyTailCount() * fold.GetApproxDimension() * histogram.SplitStatsCount;
+            bool areStatsDirty;
+            histogram.SplitStats = statsFromPrevTree->GetStats<TStats>(histogramSplits[histogramIdx], statsCount, &areStatsDirty); // thread-safe access
+            if (depth == 0 || areStatsDirty) {
+                histograms.push_back(std::move(histogram));
+            } else {
+                cachedHistograms.push_back(std::move(histogram));
+            }
+        }
+    }
+    CalcFloatFeaturesScoreFused<TStats>(/*isCaching*/ false, fold, initialFold, l2Regularizer, depth, histograms);
+    CalcFloatFeaturesScoreFused<TStats>(/*isCaching*/ true, prevLevelData, initialFold, l2Regularizer, depth, cachedHistograms);
+    return scoreBins;
+}
+
+TVector<TVector<TScoreBin>> CalcScoresForFloatFeatures(
+    const TAllFeatures& af,
+    const TVector<int>& splitsCount,
+    const TCalcScoreFold& fold,
+    const TCalcScoreFold& prevLevelData,
+    const TFold& initialFold,
+    const NCatboostOptions::TCatBoostOptions& fitParams,
+    TConstArrayRef<TSplitCandidate> splits,
+    int depth,
+    TBucketStatsCache* statsFromPrevTree) {
+    if (IsPlainMode(fitParams.BoostingOptions->BoostingType)) {
+        return CalcScoresForFloatFeaturesWithStats<TPlainBucketStats>(af, splitsCount, fold, prevLevelData, initialFold, fitParams, splits, depth, statsFromPrevTree);
+    } else {
+        return CalcScoresForFloatFeaturesWithStats<TBucketStats>(af, splitsCount, fold, prevLevelData, initialFold, fitParams, splits, depth, statsFromPrevTree);
+    }
+}
@@ -10,6 +10,7 @@
 
 #include <library/threading/local_executor/local_executor.h>
 
+#include <util/generic/array_ref.h>
 #include <util/generic/vector.h>
 
 // TODO(annaveronika): Currently this file has a bunch of structures and helper functions that are used for score calculation
@@ -64,6 +65,28 @@ TVector<TScoreBin> CalcScore(
     int depth,
     TBucketStatsCache* statsFromPrevTree);
 
+// Calculates score statistics for a group of float feature split candidates, results are the same as of CalcScore for each of them.
+// Histograms of all features of the group are accumulated in one pass over documents without building per-feature leaf indices.
+// Pairwise scoring is not supported.
+TVector<TVector<TScoreBin>> CalcScoresForFloatFeatures(
+    const TAllFeatures& af,
+    const TVector<int>& splitsCount,
+    const TCalcScoreFold& fold,
+    const TCalcScoreFold& prevLevelData,
+    const TFold& initialFold,
+    const NCatboostOptions::TCatBoostOptions& fitParams,
+    TConstArrayRef<TSplitCandidate> splits,
+    int depth,
+    TBucketStatsCache* statsFromPrevTree);
+
+// Key of stats of a float feature bundle in TBucketStatsCache, does not match keys of split candidates.
+inline TSplitCandidate GetBundleStatsKey(int bundleIdx) {
+    TSplitCandidate split;
+    split.Type = ESplitType::FloatFeature;
+    split.FeatureIdx = -1 - bundleIdx;
+    return split;
+}
+
 // Statistics (sums for score calculation) are stored in an array. This class helps navigating in this array.
 struct TStatsIndexer {
     const int BucketCount;
@@ -87,10 +110,11 @@ inline const TOnlineCTR& GetCtr(const std::tuple<const TOnlineCTRHash&, const TO
 
 // Helper function for calculating index of leaf for each document given a new split.
 // Calculates indices when a permutation is given.
-template<typename TBucketIndexType, typename TFullIndexType>
+// bucketIndex is a vector of bucket indices, TFloatHistogramRef for packed or TBundledFloatHistogramRef for bundled float features.
+template<typename TBucketIndex, typename TFullIndexType>
 inline void SetSingleIndex(const TCalcScoreFold& fold,
                            const TStatsIndexer& indexer,
-                           const TVector<TBucketIndexType>& bucketIndex,
+                           const TBucketIndex& bucketIndex,
                            const size_t* docPermutation,
                            TVector<TFullIndexType>* singleIdx) {
     const size_t docCount = fold.GetDocCount();
@@ -125,17 +149,27 @@ inline void SetSingleIndex(const TCalcScoreFold& fold,
 }
 
 // Calculate index of leaf for each document given a new split.
+// permutedFloatHistograms are float histograms in permutation order of the fold documents are sampled from, if they are materialized.
 template<typename TFullIndexType>
 inline void BuildSingleIndex(const TCalcScoreFold& fold,
                              const TAllFeatures& af,
                              const std::tuple<const TOnlineCTRHash&, const TOnlineCTRHash&>& allCtrs,
                              const TSplitCandidate& split,
                              const TStatsIndexer& indexer,
-                             TVector<TFullIndexType>* singleIdx) {
+                             TVector<TFullIndexType>* singleIdx,
+                             TConstArrayRef<TVector<ui8>> permutedFloatHistograms = {}) {
     if (split.Type == ESplitType::OnlineCtr) {
         const TCtr& ctr = split.Ctr;
         const size_t* docSubset = GetDataPtr(fold.IndexInFold);
         SetSingleIndex(fold, indexer, GetCtr(allCtrs, ctr.Projection).Feature[ctr.CtrIdx][ctr.TargetBorderIdx][ctr.PriorIdx], docSubset, singleIdx);
+    } else if (split.Type == ESplitType::FloatFeature && !permutedFloatHistograms.empty()) {
+        const size_t* docSubset = GetDataPtr(fold.IndexInFold);
+        SetSingleIndex(fold, indexer, permutedFloatHistograms[split.FeatureIdx], docSubset, singleIdx);
+    } else if (split.Type == ESplitType::FloatFeature && (af.IsFloatHistogramPacked(split.FeatureIdx) || af.IsFloatFeatureBundled(split.FeatureIdx))) {
+        const size_t* learnPermutation = GetDataPtr(fold.LearnPermutation);
+        af.VisitFloatHistogram(split.FeatureIdx, [&](const auto& histogram) {
+            SetSingleIndex(fold, indexer, histogram, learnPermutation, singleIdx);
+        });
     } else if (split.Type == ESplitType::FloatFeature) {
         const size_t* learnPermutation = GetDataPtr(fold.LearnPermutation);
         SetSingleIndex(fold, indexer, af.FloatHistograms[split.FeatureIdx], learnPermutation, singleIdx);
@@ -147,10 +181,10 @@ inline void BuildSingleIndex(const TCalcScoreFold& fold,
 }
 
 // Update bootstraped sums on [docBegin, docEnd) in a bucket
-template<typename TFullIndexType>
-inline void UpdateWeighted(const TVector<TFullIndexType>& singleIdx, const double* weightedDer, const float* sampleWeights, int docBegin, int docEnd, TBucketStats* stats) {
+template<typename TFullIndexType, typename TStats>
+inline void UpdateWeighted(const TVector<TFullIndexType>& singleIdx, const double* weightedDer, const float* sampleWeights, int docBegin, int docEnd, TStats* stats) {
     for (int doc = docBegin; doc < docEnd; ++doc) {
-        TBucketStats& leafStats = stats[singleIdx[doc]];
+        TStats& leafStats = stats[singleIdx[doc]];
         leafStats.SumWeightedDelta += weightedDer[doc];
         leafStats.SumWeight += sampleWeights[doc];
     }
@@ -174,50 +208,69 @@ inline void UpdateDeltaCount(const TVector<TFullIndexType>& singleIdx, const dou
     }
 }
 
+// Plain boosting has no not bootstraped sums
+template<typename TFullIndexType>
+inline void UpdateDeltaCount(const TVector<TFullIndexType>& /*singleIdx*/, const double* /*derivatives*/, const float* /*learnWeights*/, int /*docCount*/, TPlainBucketStats* /*stats*/) {
+}
+
+// First document of a body tail that goes to bootstraped sums
+inline int GetWeightedDocBegin(const TCalcScoreFold::TBodyTail& /*bt*/, const TPlainBucketStats* /*stats*/) {
+    return 0;
+}
+
+inline int GetWeightedDocBegin(const TCalcScoreFold::TBodyTail& bt, const TBucketStats* /*stats*/) {
+    return bt.BodyFinish;
+}
+
+// Calculate leaf value for the sums of a split side
+inline double CalcAverage(const TPlainBucketStats& stats, float l2Regularizer, double sumAllWeights, int allDocCount) {
+    return CalcAverage(stats.SumWeightedDelta, stats.SumWeight, l2Regularizer, sumAllWeights, allDocCount);
+}
+
+inline double CalcAverage(const TBucketStats& stats, float l2Regularizer, double sumAllWeights, int allDocCount) {
+    return CalcAverage(stats.SumDelta, stats.Count, l2Regularizer, sumAllWeights, allDocCount);
+}
+
 // Calculate score numerator summand
-inline double CountDp(double avrg, const TBucketStats& leafStats) {
+template<typename TStats>
+inline double CountDp(double avrg, const TStats& leafStats) {
     return avrg * leafStats.SumWeightedDelta;
 }
 
 // Calculate score denominator summand
-inline double CountD2(double avrg, const TBucketStats& leafStats) {
+template<typename TStats>
+inline double CountD2(double avrg, const TStats& leafStats) {
     return avrg * avrg * leafStats.SumWeight;
 }
 
 // This function calculates resulting sums for each split given statistics that are calculated for each bucket of the histogram.
-template<typename TIsPlainMode>
+// Boosting type is defined by the type of stats: TPlainBucketStats for plain boosting, TBucketStats for ordered boosting.
+template<typename TStats>
 inline void UpdateScoreBin(
-    const TBucketStats* stats,
+    const TStats* stats,
     int leafCount,
     const TStatsIndexer& indexer,
     ESplitType splitType,
     float l2Regularizer,
-    TIsPlainMode isPlainMode,
     double sumAllWeights,
     int allDocCount,
     TVector<TScoreBin>* scoreBin) {
 
     for (int leaf = 0; leaf < leafCount; ++leaf) {
-        TBucketStats allStats{0, 0, 0, 0};
+        TStats allStats{};
         for (int bucket = 0; bucket < indexer.BucketCount; ++bucket) {
-            const TBucketStats& leafStats = stats[indexer.GetIndex(leaf, bucket)];
+            const TStats& leafStats = stats[indexer.GetIndex(leaf, bucket)];
             allStats.Add(leafStats);
         }
-        TBucketStats trueStats{0, 0, 0, 0};
-        TBucketStats falseStats{0, 0, 0, 0};
+        TStats trueStats{};
+        TStats falseStats{};
         if (splitType == ESplitType::OnlineCtr || splitType == ESplitType::FloatFeature) {
             trueStats = allStats;
             for (int splitIdx = 0; splitIdx < indexer.BucketCount - 1; ++splitIdx) {
                 falseStats.Add(stats[indexer.GetIndex(leaf, splitIdx)]);
                 trueStats.Remove(stats[indexer.GetIndex(leaf, splitIdx)]);
-                double trueAvrg, falseAvrg;
-                if (isPlainMode) {
-                    trueAvrg = CalcAverage(trueStats.SumWeightedDelta, trueStats.SumWeight, l2Regularizer, sumAllWeights, allDocCount);
-                    falseAvrg = CalcAverage(falseStats.SumWeightedDelta, falseStats.SumWeight, l2Regularizer, sumAllWeights, allDocCount);
-                } else {
-                    trueAvrg = CalcAverage(trueStats.SumDelta, trueStats.Count, l2Regularizer, sumAllWeights, allDocCount);
-                    falseAvrg = CalcAverage(falseStats.SumDelta, falseStats.Count, l2Regularizer, sumAllWeights, allDocCount);
-                }
+                const double trueAvrg = CalcAverage(trueStats, l2Regularizer, sumAllWeights, allDocCount);
+                const double falseAvrg = CalcAverage(falseStats, l2Regularizer, sumAllWeights, allDocCount);
                 (*scoreBin)[splitIdx].DP += CountDp(trueAvrg, trueStats) + CountDp(falseAvrg, falseStats);
                 (*scoreBin)[splitIdx].D2 += CountD2(trueAvrg, trueStats) + CountD2(falseAvrg, falseStats);
             }
@@ -230,14 +283,8 @@ inline void UpdateScoreBin(
                 }
                 falseStats.Remove(stats[indexer.GetIndex(leaf, splitIdx)]);
                 trueStats = stats[indexer.GetIndex(leaf, splitIdx)];
-                double trueAvrg, falseAvrg;
-                if (isPlainMode) {
-                    trueAvrg = CalcAverage(trueStats.SumWeightedDelta, trueStats.SumWeight, l2Regularizer, sumAllWeights, allDocCount);
-                    falseAvrg = CalcAverage(falseStats.SumWeightedDelta, falseStats.SumWeight, l2Regularizer, sumAllWeights, allDocCount);
-                } else {
-                    trueAvrg = CalcAverage(trueStats.SumDelta, trueStats.Count, l2Regularizer, sumAllWeights, allDocCount);
-                    falseAvrg = CalcAverage(falseStats.SumDelta, falseStats.Count, l2Regularizer, sumAllWeights, allDocCount);
-                }
+                const double trueAvrg = CalcAverage(trueStats, l2Regularizer, sumAllWeights, allDocCount);
+                const double falseAvrg = CalcAverage(falseStats, l2Regularizer, sumAllWeights, allDocCount);
                 (*scoreBin)[splitIdx].DP += CountDp(trueAvrg, trueStats) + CountDp(falseAvrg, falseStats);
                 (*scoreBin)[splitIdx].D2 += CountD2(trueAvrg, trueStats) + CountD2(falseAvrg, falseStats);
             }
@@ -250,47 +297,50 @@ int GetSplitCount(const TVector<int>& splitsCount,
                   const TVector<TVector<int>>& oneHotValues,
                   const TSplitCandidate& split);
 
-inline void FixUpStats(int depth, const TStatsIndexer& indexer, bool selectedSplitValue, TBucketStats* stats) {
+// Restores stats of the larger split side of every parent leaf by subtracting the smaller side from the parent stats.
+// selectedSplitValues[leaf] is the split value of the smaller side calculated for parent leaf.
+template<typename TStats>
+inline void FixUpStats(int depth, const TStatsIndexer& indexer, const TVector<bool>& selectedSplitValues, TStats* stats) {
     const int halfOfStats = indexer.CalcSize(depth - 1);
-    if (selectedSplitValue == true) {
-        for (int statIdx = 0; statIdx < halfOfStats; ++statIdx) {
-            stats[statIdx].Remove(stats[statIdx + halfOfStats]);
-        }
-    } else {
-        for (int statIdx = 0; statIdx < halfOfStats; ++statIdx) {
-            stats[statIdx].Remove(stats[statIdx + halfOfStats]);
-            DoSwap(stats[statIdx], stats[statIdx + halfOfStats]);
+    Y_ASSERT(selectedSplitValues.ysize() == (1 << (depth - 1)));
+    for (int leaf = 0; leaf < selectedSplitValues.ysize(); ++leaf) {
+        const int leafStatsBegin = indexer.GetIndex(leaf, 0);
+        const int leafStatsEnd = leafStatsBegin + indexer.BucketCount;
+        if (selectedSplitValues[leaf] == true) {
+            for (int statIdx = leafStatsBegin; statIdx < leafStatsEnd; ++statIdx) {
+                stats[statIdx].Remove(stats[statIdx + halfOfStats]);
+            }
+        } else {
+            for (int statIdx = leafStatsBegin; statIdx < leafStatsEnd; ++statIdx) {
+                stats[statIdx].Remove(stats[statIdx + halfOfStats]);
+                DoSwap(stats[statIdx], stats[statIdx + halfOfStats]);
+            }
         }
     }
 }
 
-template<typename TFullIndexType, typename TIsCaching>
+template<typename TFullIndexType, typename TIsCaching, typename TStats>
 inline void CalcStatsKernel(const TIsCaching& isCaching,
                             const TVector<TFullIndexType>& singleIdx,
                             const TCalcScoreFold& fold,
-                            bool isPlainMode,
                             const TStatsIndexer& indexer,
                             int depth,
                             const TCalcScoreFold::TBodyTail& bt,
                             int dim,
-                            TBucketStats* stats) {
+                            TStats* stats) {
     Y_ASSERT(!isCaching || depth > 0);
     if (isCaching) {
-        Fill(stats + indexer.CalcSize(depth - 1), stats + indexer.CalcSize(depth), TBucketStats{0, 0, 0, 0});
+        Fill(stats + indexer.CalcSize(depth - 1), stats + indexer.CalcSize(depth), TStats{});
     } else {
-        Fill(stats, stats + indexer.CalcSize(depth), TBucketStats{0, 0, 0, 0});
+        Fill(stats, stats + indexer.CalcSize(depth), TStats{});
     }
 
     const bool hasPairwiseWeights = !bt.PairwiseWeights.empty();
     const float* weightsData = hasPairwiseWeights ? GetDataPtr(bt.PairwiseWeights) : GetDataPtr(fold.LearnWeights);
     const float* sampleWeightsData = hasPairwiseWeights ? GetDataPtr(bt.SamplePairwiseWeights) : GetDataPtr(fold.SampleWeights);
-    if (isPlainMode) {
-        UpdateWeighted(singleIdx, GetDataPtr(bt.SampleWeightedDerivatives[dim]), sampleWeightsData, 0, bt.TailFinish, stats);
-    } else {
-        UpdateDeltaCount(singleIdx, GetDataPtr(bt.WeightedDerivatives[dim]), weightsData, bt.BodyFinish, stats);
-        UpdateWeighted(singleIdx, GetDataPtr(bt.SampleWeightedDerivatives[dim]), sampleWeightsData, bt.BodyFinish, bt.TailFinish, stats);
-    }
+    UpdateDeltaCount(singleIdx, GetDataPtr(bt.WeightedDerivatives[dim]), weightsData, bt.BodyFinish, stats);
+    UpdateWeighted(singleIdx, GetDataPtr(bt.SampleWeightedDerivatives[dim]), sampleWeightsData, GetWeightedDocBegin(bt, stats), bt.TailFinish, stats);
     if (isCaching) {
-        FixUpStats(depth, indexer, fold.SmallestSplitSideValue, stats);
+        FixUpStats(depth, indexer, fold.SmallestSplitSideValues, stats);
     }
 }
@@ -0,0 +1,134 @@
+#include <catboost/libs/algo/error_functions.h>
+
+#include <library/unittest/registar.h>
+
+#include <util/random/fast.h>
+
+static TVector<TVector<double>> MakeApprox(int approxDimension, int docCount, double scale, TFastRng64* rng) {
+    TVector<TVector<double>> approx(approxDimension, TVector<double>(docCount));
+    for (auto& dimApprox : approx) {
+        for (auto& value : dimApprox) {
+            value = (rng->GenRandReal1() - 0.5) * scale;
+        }
+    }
+    return approx;
+}
+
+static TVector<float> MakeWeights(int docCount, TFastRng64* rng) {
+    TVector<float> weights(docCount);
+    for (auto& weight : weights) {
+        weight = rng->GenRandReal1() * 2;
+    }
+    return weights;
+}
+
+// Block derivatives calculated with vectorized exponent should match per document derivatives calculated with libc exp
+template<typename TError>
+static void CheckFirstDerMultiRange(const TError& error, int approxDimension, bool hasWeights) {
+    TFastRng64 rng(approxDimension);
+    const int docCount = 1000;
+    const auto approx = MakeApprox(approxDimension, docCount, /*scale*/ 40, &rng);
+    TVector<float> targets(docCount);
+    for (auto& target : targets) {
+        target = rng.Uniform(approxDimension);
+    }
+    const TVector<float> weights = hasWeights ? MakeWeights(docCount, &rng) : TVector<float>();
+
+    TVector<TVector<double>> ders(approxDimension, TVector<double>(docCount));
+    const int blockSize = 300;
+    for (int blockOffset = 0; blockOffset < docCount; blockOffset += blockSize) {
+        error.CalcFirstDerMultiRange(blockOffset, Min(blockSize, docCount - blockOffset), approx, targets.data(), hasWeights ? weights.data() : nullptr, &ders);
+    }
+
+    TVector<double> curApprox(approxDimension);
+    TVector<double> curDer(approxDimension);
+    for (int doc = 0; doc < docCount; ++doc) {
+        for (int dim = 0; dim < approxDimension; ++dim) {
+            curApprox[dim] = approx[dim][doc];
+        }
+        error.CalcDersMulti(curApprox, targets[doc], hasWeights ? weights[doc] : 1, &curDer, nullptr);
+        for (int dim = 0; dim < approxDimension; ++dim) {
+            UNIT_ASSERT_DOUBLES_EQUAL(ders[dim][doc], curDer[dim], 1e-12);
+        }
+    }
+}
+
+Y_UNIT_TEST_SUITE(TErrorFunctionsTest) {
+    Y_UNIT_TEST(TestMultiClassFirstDerRange) {
+        const TMultiClassError error(/*storeExpApprox*/ false);
+        CheckFirstDerMultiRange(error, /*approxDimension*/ 2, /*hasWeights*/ false);
+        CheckFirstDerMultiRange(error, /*approxDimension*/ 7, /*hasWeights*/ true);
+    }
+
+    Y_UNIT_TEST(TestMultiClassOneVsAllFirstDerRange) {
+        const TMultiClassOneVsAllError error(/*storeExpApprox*/ false);
+        CheckFirstDerMultiRange(error, /*approxDimension*/ 3, /*hasWeights*/ false);
+        CheckFirstDerMultiRange(error, /*approxDimension*/ 5, /*hasWeights*/ true);
+    }
+
+    Y_UNIT_TEST(TestPoissonDersRange) {
+        TFastRng64 rng(0);
+        const int docCount = 1000;
+        const auto approx = MakeApprox(/*approxDimension*/ 1, docCount, /*scale*/ 4, &rng);
+        TVector<double> approxExps(docCount);
+        TVector<double> approxDeltas(docCount);
+        TVector<float> targets(docCount);
+        for (int doc = 0; doc < docCount; ++doc) {
+            approxExps[doc] = exp(approx[0][doc]);
+            approxDeltas[doc] = exp(rng.GenRandReal1() - 0.5);
+            targets[doc] = rng.Uniform(10);
+        }
+        const TVector<float> weights = MakeWeights(docCount, &rng);
+        const TPoissonError error(/*storeExpApprox*/ true);
+        TVector<TDers> ders(docCount);
+        error.CalcDersRange(0, docCount, /*calcThirdDer*/ true, approxExps.data(), approxDeltas.data(), targets.data(), weights.data(), ders.data());
+        TVector<double> firstDers(docCount);
+        error.CalcFirstDerRange(0, docCount, approxExps.data(), nullptr, targets.data(), nullptr, firstDers.data());
+        for (int doc = 0; doc < docCount; ++doc) {
+            TDers expected;
+            error.CalcDers<true>(approxExps[doc] * approxDeltas[doc], targets[doc], &expected);
+            UNIT_ASSERT_DOUBLES_EQUAL(ders[doc].Der1, expected.Der1 * weights[doc], 1e-12);
+            UNIT_ASSERT_DOUBLES_EQUAL(ders[doc].Der2, expected.Der2 * weights[doc], 1e-12);
+            UNIT_ASSERT_DOUBLES_EQUAL(ders[doc].Der3, expected.Der3 * weights[doc], 1e-12);
+            UNIT_ASSERT_DOUBLES_EQUAL(firstDers[doc], targets[doc] - approxExps[doc], 1e-12);
+        }
+    }
+
+    Y_UNIT_TEST(TestQuerySoftMaxDers) {
+        TFastRng64 rng(0);
+        const int queryCount = 50;
+        TVector<TQueryInfo> queriesInfo;
+        int docCount = 0;
+        for (int queryIdx = 0; queryIdx < queryCount; ++queryIdx) {
+            const int querySize = 1 + rng.Uniform(30);
+            queriesInfo.emplace_back(docCount, docCount + querySize);
+            docCount += querySize;
+        }
+        const auto approx = MakeApprox(/*approxDimension*/ 1, docCount, /*scale*/ 20, &rng);
+        TVector<float> targets(docCount);
+        for (auto& target : targets) {
+            target = rng.Uniform(3) == 0;
+        }
+        const TQuerySoftMaxError error(/*storeExpApprox*/ false);
+        TVector<TDers> ders(docCount);
+        error.CalcDersForQueries(0, queryCount, approx[0], targets, /*weights*/ {}, queriesInfo, &ders);
+
+        for (const auto& queryInfo : queriesInfo) {
+            double maxApprox = -std::numeric_limits<double>::max();
+            double sumTargets = 0;
+            for (int doc = queryInfo.Begin; doc < queryInfo.End; ++doc) {
+                maxApprox = Max(maxApprox, approx[0][doc]);
+                sumTargets += targets[doc];
+            }
+            double sumExpApprox = 0;
+            for (int doc = queryInfo.Begin; doc < queryInfo.End; ++doc) {
+                sumExpApprox += std::exp(approx[0][doc] - maxApprox);
+            }
+            for (int doc = queryInfo.Begin; doc < queryInfo.End; ++doc) {
+                const double softmax = sumTargets > 0 ? std::exp(approx[0][doc] - maxApprox) / sumExpApprox : 0;
+                UNIT_ASSERT_DOUBLES_EQUAL(ders[doc].Der1, targets[doc] - sumTargets * softmax, 1e-12);
+                UNIT_ASSERT_DOUBLES_EQUAL(ders[doc].Der2, -sumTargets * softmax * (1 - softmax), 1e-12);
+            }
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#include <catboost/libs/algo/feature_values_sketch.h>
+
+#include <library/unittest/registar.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/ymath.h>
+#include <util/random/fast.h>
+
+Y_UNIT_TEST_SUITE(TFeatureValuesSketchTest) {
+    Y_UNIT_TEST(TestExactWhileSmall) {
+        TFeatureValuesSketch sketch(/*maxSize*/ 100);
+        sketch.Add(TVector<float>{3, 1, std::numeric_limits<float>::quiet_NaN(), 2});
+        sketch.Add(TVector<float>{2, -0.0f, 5});
+        UNIT_ASSERT(sketch.HasNans());
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetValueCount(), 6);
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetPointCount(), 5);
+        UNIT_ASSERT_EQUAL(sketch.MakeSample(100), TVector<float>({0, 1, 2, 2, 3, 5}));
+        UNIT_ASSERT_EQUAL(sketch.MakeSample(3), TVector<float>({1, 2, 5}));
+    }
+
+    Y_UNIT_TEST(TestMergedQuantiles) {
+        TFastRng64 rng(0);
+        const size_t maxSize = 1000;
+        const int blockCount = 20;
+        const int blockSize = 5000;
+        TFeatureValuesSketch sketch(maxSize);
+        TVector<float> allValues;
+        for (int block = 0; block < blockCount; ++block) {
+            TFeatureValuesSketch blockSketch(maxSize);
+            TVector<float> values(blockSize);
+            for (auto& value : values) {
+                // heavy value 0 and continuous tail
+                value = rng.Uniform(4) == 0 ? 0.0f : static_cast<float>(rng.GenRandReal1() * 100);
+            }
+            blockSketch.Add(values);
+            sketch.Merge(blockSketch);
+            allValues.insert(allValues.end(), values.begin(), values.end());
+        }
+        UNIT_ASSERT(!sketch.HasNans());
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetValueCount(), allValues.size());
+        UNIT_ASSERT(sketch.GetPointCount() <= maxSize + 1);
+
+        Sort(allValues.begin(), allValues.end());
+        const size_t sampleSize = 1000;
+        const TVector<float> sample = sketch.MakeSample(sampleSize);
+        UNIT_ASSERT_VALUES_EQUAL(sample.size(), sampleSize);
+        UNIT_ASSERT(IsSorted(sample.begin(), sample.end()));
+        for (size_t i = 0; i < sampleSize; ++i) {
+            // rank of the sample value in all values should be close to its rank in the sample
+            const double expectedRank = (i + 0.5) / sampleSize;
+            const double lowerRank = double(LowerBound(allValues.begin(), allValues.end(), sample[i]) - allValues.begin()) / allValues.size();
+            const double upperRank = double(UpperBound(allValues.begin(), allValues.end(), sample[i]) - allValues.begin()) / allValues.size();
+            UNIT_ASSERT(lowerRank - 0.01 <= expectedRank && expectedRank <= upperRank + 0.01);
+        }
+    }
+}
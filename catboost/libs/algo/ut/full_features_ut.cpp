@@ -0,0 +1,100 @@
+#include <catboost/libs/algo/full_features.h>
+
+#include <library/unittest/registar.h>
+
+#include <util/random/fast.h>
+
+Y_UNIT_TEST_SUITE(TFullFeaturesTest) {
+    Y_UNIT_TEST(TestFloatHistogramBits) {
+        UNIT_ASSERT_VALUES_EQUAL(GetFloatHistogramBitsLog2(1), 0);
+        UNIT_ASSERT_VALUES_EQUAL(GetFloatHistogramBitsLog2(2), 1);
+        UNIT_ASSERT_VALUES_EQUAL(GetFloatHistogramBitsLog2(3), 1);
+        UNIT_ASSERT_VALUES_EQUAL(GetFloatHistogramBitsLog2(4), 2);
+        UNIT_ASSERT_VALUES_EQUAL(GetFloatHistogramBitsLog2(15), 2);
+        UNIT_ASSERT_VALUES_EQUAL(GetFloatHistogramBitsLog2(16), 3);
+        UNIT_ASSERT_VALUES_EQUAL(GetFloatHistogramBitsLog2(254), 3);
+    }
+
+    Y_UNIT_TEST(TestPackFloatHistogram) {
+        TFastRng64 rng(0);
+        for (size_t docCount : {1, 7, 8, 9, 1001}) {
+            for (ui8 bitsPerBinLog2 = 0; bitsPerBinLog2 <= 3; ++bitsPerBinLog2) {
+                TVector<ui8> histogram(docCount);
+                for (auto& bin : histogram) {
+                    bin = rng.Uniform(1 << (1 << bitsPerBinLog2));
+                }
+                TVector<ui8> packed = histogram;
+                PackFloatHistogram(bitsPerBinLog2, &packed);
+                UNIT_ASSERT_VALUES_EQUAL(packed.size(), GetPackedFloatHistogramSize(docCount, bitsPerBinLog2));
+                const TFloatHistogramRef packedRef{packed.data(), bitsPerBinLog2};
+                for (size_t doc = 0; doc < docCount; ++doc) {
+                    UNIT_ASSERT_VALUES_EQUAL(packedRef[doc], histogram[doc]);
+                }
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestPackedDocCount) {
+        TAllFeatures features;
+        features.FloatHistograms.emplace_back();
+        features.FloatHistograms.emplace_back(TVector<ui8>(13, 1));
+        features.FloatHistogramBitsLog2 = {3, 0};
+        PackFloatHistogram(0, &features.FloatHistograms[1]);
+        features.PackedDocCount = 13;
+        UNIT_ASSERT(features.IsFloatHistogramPacked(1));
+        UNIT_ASSERT_VALUES_EQUAL(features.FloatHistograms[1].size(), 2);
+        UNIT_ASSERT_VALUES_EQUAL(features.GetDocCount(), 13);
+        UNIT_ASSERT_VALUES_EQUAL(features.GetFloatHistogram(1)[12], 1);
+    }
+
+    Y_UNIT_TEST(TestBundleExclusiveFloatFeatures) {
+        const size_t docCount = 1000;
+        // features 0-3 are sparse and exclusive, feature 4 is dense and feature 5 is const
+        const TVector<int> borderCounts = {1, 3, 200, 100, 10, 1};
+        TVector<TFloatFeature> floatFeatures;
+        TAllFeatures features;
+        TFastRng64 rng(0);
+        for (int featureIdx = 0; featureIdx < borderCounts.ysize(); ++featureIdx) {
+            floatFeatures.emplace_back(false, featureIdx, featureIdx, TVector<float>(borderCounts[featureIdx], 0.0f));
+            auto& histogram = features.FloatHistograms.emplace_back();
+            if (featureIdx == 5) {
+                continue;
+            }
+            histogram.resize(docCount);
+            for (size_t doc = 0; doc < docCount; ++doc) {
+                if (featureIdx == 4) {
+                    histogram[doc] = rng.Uniform(borderCounts[featureIdx] + 1);
+                } else if ((int)(doc % 20) == featureIdx) {
+                    histogram[doc] = 1 + rng.Uniform(borderCounts[featureIdx]);
+                }
+            }
+        }
+        const auto originalHistograms = features.FloatHistograms;
+
+        NPar::TLocalExecutor localExecutor;
+        BundleExclusiveFloatFeatures(floatFeatures, localExecutor, &features);
+
+        UNIT_ASSERT_VALUES_EQUAL(features.FloatFeatureBundles.size(), 1);
+        const auto& bundle = features.FloatFeatureBundles[0];
+        UNIT_ASSERT_VALUES_EQUAL(bundle.FloatFeatures, TVector<int>({0, 1, 2, 3}));
+        UNIT_ASSERT_VALUES_EQUAL(bundle.BinCount, 305);
+        UNIT_ASSERT(bundle.IsWide());
+        UNIT_ASSERT_VALUES_EQUAL(bundle.WideBins.size(), docCount);
+        UNIT_ASSERT_VALUES_EQUAL(features.GetDocCount(), docCount);
+        for (int featureIdx = 0; featureIdx < borderCounts.ysize(); ++featureIdx) {
+            UNIT_ASSERT_VALUES_EQUAL(features.IsFloatFeatureBundled(featureIdx), featureIdx < 4);
+            UNIT_ASSERT_VALUES_EQUAL(features.HasFloatFeature(featureIdx), featureIdx < 5);
+            if (featureIdx < 4) {
+                UNIT_ASSERT(features.FloatHistograms[featureIdx].empty());
+            }
+            if (!features.HasFloatFeature(featureIdx)) {
+                continue;
+            }
+            features.VisitFloatHistogram(featureIdx, [&](const auto& histogram) {
+                for (size_t doc = 0; doc < docCount; ++doc) {
+                    UNIT_ASSERT_VALUES_EQUAL(histogram[doc], originalHistograms[featureIdx][doc]);
+                }
+            });
+        }
+    }
+}
@@ -0,0 +1,433 @@
+#include <catboost/libs/algo/index_calcer.h>
+#include <catboost/libs/algo/score_calcer.h>
+
+#include <library/unittest/registar.h>
+
+#include <util/random/fast.h>
+
+static TDataset MakeFloatFeaturesDataset(const TVector<int>& splitCounts, int docCount, TFastRng64* rng) {
+    TDataset learnData;
+    learnData.Target.resize(docCount);
+    for (auto& target : learnData.Target) {
+        target = rng->GenRandReal1();
+    }
+    for (int splitCount : splitCounts) {
+        auto& histogram = learnData.AllFeatures.FloatHistograms.emplace_back(docCount);
+        for (auto& bin : histogram) {
+            bin = rng->Uniform(splitCount + 1);
+        }
+    }
+    return learnData;
+}
+
+static void FillDerivatives(TFastRng64* rng, TFold* fold) {
+    for (auto& bt : fold->BodyTailArr) {
+        bt.WeightedDerivatives.assign(1, TVector<double>(bt.BodyFinish));
+        bt.SampleWeightedDerivatives.assign(1, TVector<double>(bt.TailFinish));
+        for (auto& der : bt.WeightedDerivatives[0]) {
+            der = rng->GenRandReal1() - 0.5;
+        }
+        for (auto& der : bt.SampleWeightedDerivatives[0]) {
+            der = rng->GenRandReal1() - 0.5;
+        }
+    }
+}
+
+// Splits every leaf of previous level in two, as selected tree split does
+static void SplitLeafIndices(int depth, TFastRng64* rng, TVector<TIndexType>* indices) {
+    for (auto& index : *indices) {
+        index |= rng->Uniform(2) << (depth - 1);
+    }
+}
+
+static TVector<TSplitCandidate> MakeFloatSplits(int firstFeatureIdx, int featureCount) {
+    TVector<TSplitCandidate> splits;
+    for (int featureIdx = firstFeatureIdx; featureIdx < featureCount; ++featureIdx) {
+        splits.emplace_back();
+        splits.back().Type = ESplitType::FloatFeature;
+        splits.back().FeatureIdx = featureIdx;
+    }
+    return splits;
+}
+
+static void CheckSameScores(const TVector<TScoreBin>& expected, const TVector<TScoreBin>& actual, double eps) {
+    UNIT_ASSERT_VALUES_EQUAL(expected.size(), actual.size());
+    for (size_t binIdx = 0; binIdx < expected.size(); ++binIdx) {
+        UNIT_ASSERT_DOUBLES_EQUAL(expected[binIdx].DP, actual[binIdx].DP, eps);
+        UNIT_ASSERT_DOUBLES_EQUAL(expected[binIdx].D2, actual[binIdx].D2, eps);
+    }
+}
+
+/**
+ * Random float features dataset with a plain fold and score folds of one tree.
+ * Variants of score calculation are compared with the reference CalcScore over LearnData and Stats.
+ * LearnData can be modified before Init() call.
+ */
+struct TFloatFeaturesScoreFixture {
+    TVector<int> SplitCounts;
+    TFastRng64 Rng;
+    TDataset LearnData;
+    TVector<TFold> Folds;
+    NCatboostOptions::TCatBoostOptions Options;
+    NPar::TLocalExecutor LocalExecutor;
+    TCalcScoreFold SampledDocs;
+    TCalcScoreFold SmallestSplitSideDocs;
+    TBucketStatsCache Stats;
+    //! Leaf indices of documents for the current depth
+    TVector<TIndexType> Indices;
+
+    TFloatFeaturesScoreFixture(const TVector<int>& splitCounts, int docCount, ui64 seed)
+        : SplitCounts(splitCounts)
+        , Rng(seed)
+        , LearnData(MakeFloatFeaturesDataset(splitCounts, docCount, &Rng))
+        , Options(ETaskType::CPU)
+        , Indices(docCount, 0)
+    {
+    }
+
+    void Init(int permutationBlockSize, EBoostingType boostingType, ESamplingFrequency samplingFrequency, float sampleRate = 1.0f) {
+        TRestorableFastRng64 rand(0);
+        Folds.push_back(TFold::BuildPlainFold(LearnData, /*targetClassifiers*/ {}, /*shuffle*/ true, permutationBlockSize, /*approxDimension*/ 1, /*storeExpApproxes*/ false, /*hasPairwiseWeights*/ false, rand));
+        FillDerivatives(&Rng, &Folds[0]);
+        Options.BoostingOptions->BoostingType = boostingType;
+        Options.ObliviousTreeOptions->SamplingFrequency = samplingFrequency;
+        SampledDocs.Create(Folds, /*isPairwiseScoring*/ false, sampleRate);
+        SmallestSplitSideDocs.Create(Folds, /*isPairwiseScoring*/ false);
+        Stats = CreateStatsCache();
+    }
+
+    const TFold& GetFold() const {
+        return Folds[0];
+    }
+
+    TBucketStatsCache CreateStatsCache() const {
+        TBucketStatsCache stats;
+        stats.Create(Folds, CountNonCtrBuckets(SplitCounts, LearnData.AllFeatures.OneHotValues), Options.ObliviousTreeOptions->MaxDepth);
+        return stats;
+    }
+
+    // Samples documents on depth 0 and on every depth with PerTreeLevel sampling, otherwise moves documents to leaves of Indices
+    void UpdateScoreFolds(int depth, TCalcScoreFold* sampledDocs, TCalcScoreFold* smallestSplitSideDocs) {
+        if (depth == 0 || Options.ObliviousTreeOptions->SamplingFrequency == ESamplingFrequency::PerTreeLevel) {
+            // score folds updated on the same depth get the same sample
+            TRestorableFastRng64 sampleRand(depth);
+            sampledDocs->Sample(GetFold(), Indices, &sampleRand, &LocalExecutor);
+        } else {
+            sampledDocs->UpdateIndices(Indices, &LocalExecutor);
+            smallestSplitSideDocs->SelectSmallestSplitSide(depth, *sampledDocs, &LocalExecutor);
+        }
+    }
+
+    void UpdateScoreFolds(int depth) {
+        UpdateScoreFolds(depth, &SampledDocs, &SmallestSplitSideDocs);
+    }
+
+    TVector<TScoreBin> CalcScore(const TAllFeatures& features, const TFold& fold, const TSplitCandidate& split, int depth, TBucketStatsCache* stats) const {
+        return ::CalcScore(features, SplitCounts, fold.GetAllCtrs(), SampledDocs, SmallestSplitSideDocs, fold, Options, split, depth, stats);
+    }
+
+    TVector<TVector<TScoreBin>> CalcFusedScores(const TAllFeatures& features, const TFold& fold, TConstArrayRef<TSplitCandidate> splits, int depth, TBucketStatsCache* stats) const {
+        const auto scoreBins = CalcScoresForFloatFeatures(features, SplitCounts, SampledDocs, SmallestSplitSideDocs, fold, Options, splits, depth, stats);
+        UNIT_ASSERT_VALUES_EQUAL(scoreBins.size(), splits.size());
+        return scoreBins;
+    }
+
+    TVector<TScoreBin> CalcReferenceScore(const TSplitCandidate& split, int depth) {
+        return CalcScore(LearnData.AllFeatures, GetFold(), split, depth, &Stats);
+    }
+};
+
+static void CheckFusedFloatFeaturesScores(EBoostingType boostingType, ESamplingFrequency samplingFrequency, int permutationBlockSize) {
+    TFloatFeaturesScoreFixture fixture({1, 4, 16, 254, 7}, /*docCount*/ 1000, /*seed*/ permutationBlockSize);
+    fixture.Init(permutationBlockSize, boostingType, samplingFrequency);
+    TBucketStatsCache fusedStats = fixture.CreateStatsCache();
+    const auto splits = MakeFloatSplits(0, fixture.SplitCounts.ysize());
+    for (int depth = 0; depth < 3; ++depth) {
+        if (depth > 0) {
+            SplitLeafIndices(depth, &fixture.Rng, &fixture.Indices);
+        }
+        fixture.UpdateScoreFolds(depth);
+        const auto fusedScoreBins = fixture.CalcFusedScores(fixture.LearnData.AllFeatures, fixture.GetFold(), splits, depth, &fusedStats);
+        for (size_t splitIdx = 0; splitIdx < splits.size(); ++splitIdx) {
+            CheckSameScores(fixture.CalcReferenceScore(splits[splitIdx], depth), fusedScoreBins[splitIdx], 1e-12);
+        }
+    }
+}
+
+static void CheckLeafPartitionedLayout(const TCalcScoreFold& fold, const TVector<TIndexType>& indices, int depth) {
+    UNIT_ASSERT_VALUES_EQUAL(fold.LeafBounds.ysize(), (1 << depth) + 1);
+    UNIT_ASSERT_VALUES_EQUAL(fold.LeafBounds.front(), 0);
+    UNIT_ASSERT_VALUES_EQUAL(fold.LeafBounds.back(), fold.GetDocCount());
+    for (int leaf = 0; leaf < (1 << depth); ++leaf) {
+        for (int doc = fold.LeafBounds[leaf]; doc < fold.LeafBounds[leaf + 1]; ++doc) {
+            UNIT_ASSERT_VALUES_EQUAL(fold.Indices[doc], (TIndexType)leaf);
+            UNIT_ASSERT_VALUES_EQUAL(indices[fold.IndexInFold[doc]], (TIndexType)leaf);
+            if (doc > fold.LeafBounds[leaf]) {
+                UNIT_ASSERT(fold.IndexInFold[doc - 1] < fold.IndexInFold[doc]);
+            }
+        }
+    }
+}
+
+static void CheckLeafPartitionedScores(int permutationBlockSize, float sampleRate) {
+    TFloatFeaturesScoreFixture fixture({1, 4, 16, 254, 7}, /*docCount*/ 1000, /*seed*/ permutationBlockSize);
+    fixture.Init(permutationBlockSize, EBoostingType::Plain, ESamplingFrequency::PerTree, sampleRate);
+    TCalcScoreFold partitionedDocs;
+    partitionedDocs.Create(fixture.Folds, /*isPairwiseScoring*/ false, sampleRate, /*isLeafPartitioned*/ true);
+    TCalcScoreFold partitionedSmallestSplitSideDocs;
+    partitionedSmallestSplitSideDocs.Create(fixture.Folds, /*isPairwiseScoring*/ false);
+    TBucketStatsCache partitionedStats = fixture.CreateStatsCache();
+    for (int depth = 0; depth < 4; ++depth) {
+        if (depth > 0) {
+            SplitLeafIndices(depth, &fixture.Rng, &fixture.Indices);
+        }
+        fixture.UpdateScoreFolds(depth);
+        fixture.UpdateScoreFolds(depth, &partitionedDocs, &partitionedSmallestSplitSideDocs);
+        UNIT_ASSERT_VALUES_EQUAL(partitionedDocs.GetDocCount(), fixture.SampledDocs.GetDocCount());
+        CheckLeafPartitionedLayout(partitionedDocs, fixture.Indices, depth);
+        for (const auto& split : MakeFloatSplits(0, fixture.SplitCounts.ysize())) {
+            const auto& fold = fixture.GetFold();
+            const auto partitionedScoreBins = CalcScore(fixture.LearnData.AllFeatures, fixture.SplitCounts, fold.GetAllCtrs(), partitionedDocs, partitionedSmallestSplitSideDocs, fold, fixture.Options, split, depth, &partitionedStats);
+            CheckSameScores(fixture.CalcReferenceScore(split, depth), partitionedScoreBins, 1e-9);
+        }
+    }
+}
+
+static void CheckPermutedFloatHistogramsScores(EBoostingType boostingType, int permutationBlockSize, float sampleRate) {
+    TFloatFeaturesScoreFixture fixture({1, 4, 16, 254, 7}, /*docCount*/ 1000, /*seed*/ permutationBlockSize);
+    fixture.Init(permutationBlockSize, boostingType, ESamplingFrequency::PerTree, sampleRate);
+    const auto& features = fixture.LearnData.AllFeatures;
+    TFold permutedFold = fixture.GetFold();
+    UNIT_ASSERT(permutedFold.GetPermutedFloatHistogramsSize(features) > 0);
+    permutedFold.BuildPermutedFloatHistograms(features, &fixture.LocalExecutor);
+    UNIT_ASSERT(permutedFold.HasPermutedFloatHistograms());
+    TBucketStatsCache permutedStats = fixture.CreateStatsCache();
+    TBucketStatsCache fusedStats = fixture.CreateStatsCache();
+    const auto splits = MakeFloatSplits(0, fixture.SplitCounts.ysize());
+    TVector<TIndexType> permutedIndices(fixture.Indices.size(), 0);
+    for (int depth = 0; depth < 3; ++depth) {
+        if (depth > 0) {
+            const TSplit split(splits[depth], fixture.SplitCounts[depth] / 2);
+            SetPermutedIndices(split, features, depth, fixture.GetFold(), &fixture.Indices, &fixture.LocalExecutor);
+            SetPermutedIndices(split, features, depth, permutedFold, &permutedIndices, &fixture.LocalExecutor);
+            UNIT_ASSERT_VALUES_EQUAL(fixture.Indices, permutedIndices);
+        }
+        fixture.UpdateScoreFolds(depth);
+        const auto fusedScoreBins = fixture.CalcFusedScores(features, permutedFold, splits, depth, &fusedStats);
+        for (size_t splitIdx = 0; splitIdx < splits.size(); ++splitIdx) {
+            const auto scoreBins = fixture.CalcReferenceScore(splits[splitIdx], depth);
+            CheckSameScores(scoreBins, fixture.CalcScore(features, permutedFold, splits[splitIdx], depth, &permutedStats), 1e-12);
+            CheckSameScores(scoreBins, fusedScoreBins[splitIdx], 1e-12);
+        }
+    }
+}
+
+static TDataset PackFloatFeatures(const TDataset& learnData, const TVector<int>& splitCounts) {
+    TDataset packedData = learnData;
+    auto& features = packedData.AllFeatures;
+    features.PackedDocCount = learnData.GetSampleCount();
+    features.FloatHistogramBitsLog2.resize(splitCounts.size());
+    for (int featureIdx = 0; featureIdx < splitCounts.ysize(); ++featureIdx) {
+        features.FloatHistogramBitsLog2[featureIdx] = GetFloatHistogramBitsLog2(splitCounts[featureIdx]);
+        PackFloatHistogram(features.FloatHistogramBitsLog2[featureIdx], &features.FloatHistograms[featureIdx]);
+    }
+    return packedData;
+}
+
+static void CheckPackedFloatHistogramsScores(EBoostingType boostingType, int permutationBlockSize) {
+    TFloatFeaturesScoreFixture fixture({1, 3, 15, 254, 7}, /*docCount*/ 1001, /*seed*/ permutationBlockSize);
+    fixture.Init(permutationBlockSize, boostingType, ESamplingFrequency::PerTree);
+    const auto& features = fixture.LearnData.AllFeatures;
+    const TDataset packedData = PackFloatFeatures(fixture.LearnData, fixture.SplitCounts);
+    UNIT_ASSERT(packedData.AllFeatures.IsFloatHistogramPacked(0));
+    UNIT_ASSERT(!packedData.AllFeatures.IsFloatHistogramPacked(3));
+    UNIT_ASSERT_VALUES_EQUAL(packedData.AllFeatures.GetDocCount(), features.GetDocCount());
+    TBucketStatsCache packedStats = fixture.CreateStatsCache();
+    TBucketStatsCache fusedStats = fixture.CreateStatsCache();
+    const auto splits = MakeFloatSplits(0, fixture.SplitCounts.ysize());
+    TVector<TIndexType> packedIndices(fixture.Indices.size(), 0);
+    for (int depth = 0; depth < 3; ++depth) {
+        if (depth > 0) {
+            const TSplit split(splits[depth - 1], fixture.SplitCounts[depth - 1] / 2);
+            SetPermutedIndices(split, features, depth, fixture.GetFold(), &fixture.Indices, &fixture.LocalExecutor);
+            SetPermutedIndices(split, packedData.AllFeatures, depth, fixture.GetFold(), &packedIndices, &fixture.LocalExecutor);
+            UNIT_ASSERT_VALUES_EQUAL(fixture.Indices, packedIndices);
+        }
+        fixture.UpdateScoreFolds(depth);
+        const auto fusedScoreBins = fixture.CalcFusedScores(packedData.AllFeatures, fixture.GetFold(), splits, depth, &fusedStats);
+        for (size_t splitIdx = 0; splitIdx < splits.size(); ++splitIdx) {
+            const auto scoreBins = fixture.CalcReferenceScore(splits[splitIdx], depth);
+            CheckSameScores(scoreBins, fixture.CalcScore(packedData.AllFeatures, fixture.GetFold(), splits[splitIdx], depth, &packedStats), 1e-12);
+            CheckSameScores(scoreBins, fusedScoreBins[splitIdx], 1e-12);
+        }
+    }
+}
+
+static void CheckBundledFloatFeaturesScores(EBoostingType boostingType, ESamplingFrequency samplingFrequency) {
+    // features 0-3 are sparse and exclusive, features 4-5 are dense
+    TFloatFeaturesScoreFixture fixture({1, 3, 254, 7, 15, 4}, /*docCount*/ 1000, /*seed*/ 0);
+    const int sparseFeatureCount = 4;
+    for (int featureIdx = 0; featureIdx < sparseFeatureCount; ++featureIdx) {
+        auto& histogram = fixture.LearnData.AllFeatures.FloatHistograms[featureIdx];
+        for (int doc = 0; doc < histogram.ysize(); ++doc) {
+            histogram[doc] = doc % 16 == featureIdx ? 1 + fixture.Rng.Uniform(fixture.SplitCounts[featureIdx]) : 0;
+        }
+    }
+    fixture.Init(/*permutationBlockSize*/ 1, boostingType, samplingFrequency);
+    const auto& features = fixture.LearnData.AllFeatures;
+    TVector<TFloatFeature> floatFeatures;
+    for (int featureIdx = 0; featureIdx < fixture.SplitCounts.ysize(); ++featureIdx) {
+        floatFeatures.emplace_back(false, featureIdx, featureIdx, TVector<float>(fixture.SplitCounts[featureIdx], 0.0f));
+    }
+    TDataset bundledData = fixture.LearnData;
+    BundleExclusiveFloatFeatures(floatFeatures, fixture.LocalExecutor, &bundledData.AllFeatures);
+    UNIT_ASSERT_VALUES_EQUAL(bundledData.AllFeatures.FloatFeatureBundles.size(), 1);
+    UNIT_ASSERT(bundledData.AllFeatures.FloatFeatureBundles[0].IsWide());
+    TBucketStatsCache bundledStats = fixture.CreateStatsCache();
+    TVector<TIndexType> bundledIndices(fixture.Indices.size(), 0);
+    for (int depth = 0; depth < 3; ++depth) {
+        if (depth > 0) {
+            const TSplit split(MakeFloatSplits(depth, depth + 1)[0], 0);
+            SetPermutedIndices(split, features, depth, fixture.GetFold(), &fixture.Indices, &fixture.LocalExecutor);
+            SetPermutedIndices(split, bundledData.AllFeatures, depth, fixture.GetFold(), &bundledIndices, &fixture.LocalExecutor);
+            UNIT_ASSERT_VALUES_EQUAL(fixture.Indices, bundledIndices);
+        }
+        fixture.UpdateScoreFolds(depth);
+        // bundle is scored for a part of its features on depth 1
+        const auto splits = MakeFloatSplits(depth == 1 ? 1 : 0, fixture.SplitCounts.ysize());
+        const auto bundledScoreBins = fixture.CalcFusedScores(bundledData.AllFeatures, fixture.GetFold(), splits, depth, &bundledStats);
+        for (size_t splitIdx = 0; splitIdx < splits.size(); ++splitIdx) {
+            CheckSameScores(fixture.CalcReferenceScore(splits[splitIdx], depth), bundledScoreBins[splitIdx], 1e-9);
+        }
+    }
+}
+
+// Stats of a candidate skipped on a tree level, e.g. by rsm, are erased and calculated from scratch when it is scored again
+static void CheckSkippedCandidatesScores(EBoostingType boostingType) {
+    TFloatFeaturesScoreFixture fixture({1, 4, 16, 254, 7}, /*docCount*/ 1000, /*seed*/ 1);
+    fixture.Init(/*permutationBlockSize*/ 1, boostingType, ESamplingFrequency::PerTree);
+    TBucketStatsCache skippingStats = fixture.CreateStatsCache();
+    const auto splits = MakeFloatSplits(0, fixture.SplitCounts.ysize());
+    for (int depth = 0; depth < 4; ++depth) {
+        if (depth > 0) {
+            SplitLeafIndices(depth, &fixture.Rng, &fixture.Indices);
+        }
+        fixture.UpdateScoreFolds(depth);
+        for (size_t splitIdx = 0; splitIdx < splits.size(); ++splitIdx) {
+            // every candidate is skipped on depth 1 or 2
+            if ((depth == 1 || depth == 2) && splitIdx % 2 == depth % 2) {
+                skippingStats.Erase(splits[splitIdx]);
+                continue;
+            }
+            const auto scoreBins = fixture.CalcScore(fixture.LearnData.AllFeatures, fixture.GetFold(), splits[splitIdx], depth, &skippingStats);
+            CheckSameScores(fixture.CalcReferenceScore(splits[splitIdx], depth), scoreBins, 1e-9);
+        }
+    }
+}
+
+// Plain stats give the same scores as full stats with equal bootstraped and not bootstraped sums
+static void CheckPlainBucketStatsScores(ESplitType splitType) {
+    TFastRng64 rng(0);
+    const int depth = 3;
+    const int leafCount = 1 << depth;
+    const TStatsIndexer indexer(/*bucketCount*/ 17);
+    TVector<TPlainBucketStats> plainStats(indexer.CalcSize(depth));
+    TVector<TBucketStats> stats(indexer.CalcSize(depth));
+    for (int statsIdx = 0; statsIdx < plainStats.ysize(); ++statsIdx) {
+        const double sumWeightedDelta = rng.GenRandReal1() - 0.5;
+        const double sumWeight = rng.Uniform(10);
+        plainStats[statsIdx] = {sumWeightedDelta, sumWeight};
+        stats[statsIdx] = {sumWeightedDelta, sumWeight, sumWeightedDelta, sumWeight};
+    }
+    const float l2Regularizer = 3.0f;
+    const double sumAllWeights = 100.0;
+    const int allDocCount = 100;
+    TVector<TScoreBin> plainScoreBins(indexer.BucketCount);
+    UpdateScoreBin(plainStats.data(), leafCount, indexer, splitType, l2Regularizer, sumAllWeights, allDocCount, &plainScoreBins);
+    TVector<TScoreBin> scoreBins(indexer.BucketCount);
+    UpdateScoreBin(stats.data(), leafCount, indexer, splitType, l2Regularizer, sumAllWeights, allDocCount, &scoreBins);
+    for (int binIdx = 0; binIdx < indexer.BucketCount; ++binIdx) {
+        UNIT_ASSERT_VALUES_EQUAL(plainScoreBins[binIdx].DP, scoreBins[binIdx].DP);
+        UNIT_ASSERT_VALUES_EQUAL(plainScoreBins[binIdx].D2, scoreBins[binIdx].D2);
+    }
+}
+
+Y_UNIT_TEST_SUITE(TScoreCalcerTest) {
+    Y_UNIT_TEST(TestFusedFloatFeaturesScoresPlain) {
+        CheckFusedFloatFeaturesScores(EBoostingType::Plain, ESamplingFrequency::PerTreeLevel, /*permutationBlockSize*/ 1);
+        CheckFusedFloatFeaturesScores(EBoostingType::Plain, ESamplingFrequency::PerTreeLevel, /*permutationBlockSize*/ 32);
+    }
+
+    Y_UNIT_TEST(TestFusedFloatFeaturesScoresOrdered) {
+        CheckFusedFloatFeaturesScores(EBoostingType::Ordered, ESamplingFrequency::PerTreeLevel, /*permutationBlockSize*/ 1);
+        CheckFusedFloatFeaturesScores(EBoostingType::Ordered, ESamplingFrequency::PerTreeLevel, /*permutationBlockSize*/ 32);
+    }
+
+    Y_UNIT_TEST(TestFusedFloatFeaturesScoresWithStatsFromPrevLevel) {
+        CheckFusedFloatFeaturesScores(EBoostingType::Plain, ESamplingFrequency::PerTree, /*permutationBlockSize*/ 32);
+        CheckFusedFloatFeaturesScores(EBoostingType::Ordered, ESamplingFrequency::PerTree, /*permutationBlockSize*/ 1);
+    }
+
+    Y_UNIT_TEST(TestLeafPartitionedLayout) {
+        CheckLeafPartitionedScores(/*permutationBlockSize*/ 1, /*sampleRate*/ 1.0f);
+        CheckLeafPartitionedScores(/*permutationBlockSize*/ 32, /*sampleRate*/ 1.0f);
+        CheckLeafPartitionedScores(/*permutationBlockSize*/ 32, /*sampleRate*/ 0.5f);
+    }
+
+    Y_UNIT_TEST(TestPermutedFloatHistograms) {
+        CheckPermutedFloatHistogramsScores(EBoostingType::Plain, /*permutationBlockSize*/ 1, /*sampleRate*/ 1.0f);
+        CheckPermutedFloatHistogramsScores(EBoostingType::Plain, /*permutationBlockSize*/ 32, /*sampleRate*/ 1.0f);
+        CheckPermutedFloatHistogramsScores(EBoostingType::Ordered, /*permutationBlockSize*/ 32, /*sampleRate*/ 0.5f);
+    }
+
+    Y_UNIT_TEST(TestPackedFloatHistograms) {
+        CheckPackedFloatHistogramsScores(EBoostingType::Plain, /*permutationBlockSize*/ 1);
+        CheckPackedFloatHistogramsScores(EBoostingType::Ordered, /*permutationBlockSize*/ 32);
+    }
+
+    Y_UNIT_TEST(TestBundledFloatFeatures) {
+        CheckBundledFloatFeaturesScores(EBoostingType::Plain, ESamplingFrequency::PerTreeLevel);
+        CheckBundledFloatFeaturesScores(EBoostingType::Ordered, ESamplingFrequency::PerTree);
+    }
+
+    Y_UNIT_TEST(TestPlainBucketStats) {
+        CheckPlainBucketStatsScores(ESplitType::FloatFeature);
+        CheckPlainBucketStatsScores(ESplitType::OneHotFeature);
+    }
+
+    Y_UNIT_TEST(TestBucketStatsCache) {
+        TFold fold;
+        fold.BodyTailArr.emplace_back(/*bodyQueryFinish*/ 0, /*tailQueryFinish*/ 0, /*bodyFinish*/ 0, /*tailFinish*/ 0, /*bodySumWeight*/ 0.0);
+        fold.BodyTailArr[0].Approx.resize(1);
+        TBucketStatsCache cache;
+        cache.Create({fold}, /*bucketCount*/ 16, /*depth*/ 2, sizeof(TPlainBucketStats));
+        TSplitCandidate split;
+        split.Type = ESplitType::FloatFeature;
+        split.FeatureIdx = 0;
+        bool areStatsDirty;
+        TPlainBucketStats* stats = cache.GetStats<TPlainBucketStats>(split, /*statsCount*/ 64, &areStatsDirty);
+        UNIT_ASSERT(areStatsDirty);
+        UNIT_ASSERT(cache.Has<TPlainBucketStats>(split));
+        UNIT_ASSERT(!cache.Has<TBucketStats>(split));
+        stats[63] = {1.0, 2.0};
+        UNIT_ASSERT_EQUAL(cache.GetStats<TPlainBucketStats>(split, /*statsCount*/ 64, &areStatsDirty), stats);
+        UNIT_ASSERT(!areStatsDirty);
+        UNIT_ASSERT_VALUES_EQUAL(stats[63].SumWeight, 2.0);
+
+        TSplitCandidate otherSplit = split;
+        otherSplit.FeatureIdx = 1;
+        cache.GetStats<TPlainBucketStats>(otherSplit, /*statsCount*/ 64, &areStatsDirty);
+        cache.EraseIf([](const TSplitCandidate& candidate) { return candidate.FeatureIdx == 1; });
+        UNIT_ASSERT(cache.Has<TPlainBucketStats>(split));
+        UNIT_ASSERT(!cache.Has<TPlainBucketStats>(otherSplit));
+        cache.Erase(split);
+        UNIT_ASSERT(!cache.Has<TPlainBucketStats>(split));
+        cache.GetStats<TPlainBucketStats>(split, /*statsCount*/ 64, &areStatsDirty);
+        UNIT_ASSERT(areStatsDirty);
+    }
+
+    Y_UNIT_TEST(TestSkippedCandidatesStats) {
+        CheckSkippedCandidatesScores(EBoostingType::Plain);
+        CheckSkippedCandidatesScores(EBoostingType::Ordered);
+    }
+}
@@ -52,6 +52,37 @@ Y_UNIT_TEST_SUITE(TTrainTest) {
             }
         }
     }
+    Y_UNIT_TEST(TestTrainWithClearPool) {
+        const size_t TestDocCount = 1000;
+        const size_t FactorCount = 10;
+
+        TReallyFastRng32 rng(123);
+        TPool pool;
+        pool.Docs.Resize(TestDocCount, FactorCount, /*baseline dimension*/ 0, /*has queryId*/ false, /*has subgroupId*/ false);
+        for (size_t i = 0; i < TestDocCount; ++i) {
+            pool.Docs.Target[i] = rng.GenRandReal2();
+            for (size_t j = 0; j < FactorCount; ++j) {
+                // the last feature is constant, so it is cleared without binarization
+                pool.Docs.Factors[j][i] = j + 1 == FactorCount ? 1.0f : rng.GenRandReal2();
+            }
+        }
+        TPool poolCopy(pool);
+        NJson::TJsonValue plainFitParams;
+        plainFitParams.InsertValue("random_seed", 5);
+        plainFitParams.InsertValue("iterations", 5);
+        plainFitParams.InsertValue("train_dir", ".");
+        TEvalResult testApprox;
+        TPool testPool;
+        TFullModel model;
+        TrainModel(plainFitParams, Nothing(), Nothing(), poolCopy, /*allowClearPool*/ false, testPool, "", &model, &testApprox);
+        TFullModel modelWithClearPool;
+        TrainModel(plainFitParams, Nothing(), Nothing(), pool, /*allowClearPool*/ true, testPool, "", &modelWithClearPool, &testApprox);
+        UNIT_ASSERT_EQUAL(model, modelWithClearPool);
+        for (size_t j = 0; j < FactorCount; ++j) {
+            UNIT_ASSERT(pool.Docs.Factors[j].empty());
+        }
+    }
+
     Y_UNIT_TEST(TestFeaturesLayout) {
         {
             std::vector<int> catFeatures = {1, 5, 9};
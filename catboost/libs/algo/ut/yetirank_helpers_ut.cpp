@@ -0,0 +1,96 @@
+#include <catboost/libs/algo/yetirank_helpers.h>
+
+#include <library/unittest/registar.h>
+
+#include <util/random/fast.h>
+
+// Dense implementation of pair generation with full sort of every ranking
+static TVector<TVector<float>> GenerateYetiRankPairsDense(
+    const TVector<float>& relevs,
+    const TVector<double>& expApproxes,
+    float queryWeight,
+    int permutationCount,
+    double decaySpeed,
+    ui64 randomSeed
+) {
+    TFastRng64 rand(randomSeed);
+    const int querySize = relevs.ysize();
+    TVector<int> indices(querySize);
+    TVector<TVector<float>> competitorsWeights(querySize, TVector<float>(querySize));
+    for (int permutationIndex = 0; permutationIndex < permutationCount; ++permutationIndex) {
+        std::iota(indices.begin(), indices.end(), 0);
+        TVector<double> bootstrappedApprox(expApproxes);
+        for (int docId = 0; docId < querySize; ++docId) {
+            const float uniformValue = rand.GenRandReal1();
+            bootstrappedApprox[docId] *= uniformValue / (1.000001f - uniformValue);
+        }
+        Sort(indices, [&](int i, int j) {
+            return bootstrappedApprox[i] > bootstrappedApprox[j];
+        });
+        double decayCoefficient = 1;
+        for (int docId = 1; docId < querySize; ++docId) {
+            const int firstCandidate = indices[docId - 1];
+            const int secondCandidate = indices[docId];
+            const float pairWeight = 0.15 * decayCoefficient * Abs(relevs[firstCandidate] - relevs[secondCandidate]);
+            if (relevs[firstCandidate] > relevs[secondCandidate]) {
+                competitorsWeights[firstCandidate][secondCandidate] += pairWeight;
+            } else if (relevs[firstCandidate] < relevs[secondCandidate]) {
+                competitorsWeights[secondCandidate][firstCandidate] += pairWeight;
+            }
+            decayCoefficient *= decaySpeed;
+        }
+    }
+    for (auto& winnerWeights : competitorsWeights) {
+        for (auto& weight : winnerWeights) {
+            weight = queryWeight * weight / permutationCount;
+        }
+    }
+    return competitorsWeights;
+}
+
+static void CheckYetiRankPairs(int querySize, double decaySpeed, double tolerance) {
+    TFastRng64 rng(querySize);
+    TVector<float> relevs(querySize);
+    TVector<double> expApproxes(querySize);
+    for (int docId = 0; docId < querySize; ++docId) {
+        relevs[docId] = rng.Uniform(4);
+        expApproxes[docId] = exp(rng.GenRandReal1() - 0.5);
+    }
+    const float queryWeight = 2.0f;
+    const int permutationCount = 10;
+    const ui64 randomSeed = 42;
+    TVector<TVector<TCompetitor>> competitors;
+    GenerateYetiRankPairsForQuery(relevs.data(), expApproxes.data(), queryWeight, querySize, permutationCount, decaySpeed, randomSeed, &competitors);
+    const auto expectedWeights = GenerateYetiRankPairsDense(relevs, expApproxes, queryWeight, permutationCount, decaySpeed, randomSeed);
+
+    UNIT_ASSERT_VALUES_EQUAL(competitors.ysize(), querySize);
+    TVector<TVector<float>> weights(querySize, TVector<float>(querySize));
+    for (int winner = 0; winner < querySize; ++winner) {
+        for (int competitorIdx = 0; competitorIdx < competitors[winner].ysize(); ++competitorIdx) {
+            const auto& competitor = competitors[winner][competitorIdx];
+            if (competitorIdx > 0) {
+                UNIT_ASSERT(competitors[winner][competitorIdx - 1].Id < competitor.Id);
+            }
+            UNIT_ASSERT(competitor.Weight != 0);
+            weights[winner][competitor.Id] = competitor.Weight;
+        }
+    }
+    for (int winner = 0; winner < querySize; ++winner) {
+        for (int loser = 0; loser < querySize; ++loser) {
+            UNIT_ASSERT_DOUBLES_EQUAL(weights[winner][loser], expectedWeights[winner][loser], tolerance);
+        }
+    }
+}
+
+Y_UNIT_TEST_SUITE(TYetiRankHelpersTest) {
+    Y_UNIT_TEST(TestPairsMatchDenseGeneration) {
+        CheckYetiRankPairs(/*querySize*/ 1, /*decaySpeed*/ 0.99, /*tolerance*/ 0);
+        CheckYetiRankPairs(/*querySize*/ 50, /*decaySpeed*/ 0.99, /*tolerance*/ 0);
+        CheckYetiRankPairs(/*querySize*/ 200, /*decaySpeed*/ 1.0, /*tolerance*/ 0);
+    }
+
+    Y_UNIT_TEST(TestPairsWithNegligibleDecay) {
+        // pairs below the top positions are not generated, their summed weights are below the decay threshold
+        CheckYetiRankPairs(/*querySize*/ 300, /*decaySpeed*/ 0.5, /*tolerance*/ 1e-5);
+    }
+}
@@ -2,9 +2,40 @@
 
 #include <catboost/libs/data_types/pair.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/vector.h>
+#include <util/thread/singleton.h>
 
-static void GenerateYetiRankPairsForQuery(
+#include <tuple>
+
+namespace {
+    // Pair of adjacent documents of a bootstrapped ranking
+    struct TYetiRankPair {
+        int Winner;
+        int Loser;
+        float Weight;
+    };
+
+    // Buffers of pair generation reused by queries processed in the same thread
+    struct TYetiRankPairsBuffers {
+        TVector<int> Indices;
+        TVector<double> BootstrappedApprox;
+        TVector<TYetiRankPair> Pairs;
+    };
+}
+
+// Number of top positions of a ranking that produce pairs with weight decay not less than YETI_RANK_NEGLIGIBLE_DECAY
+static int GetYetiRankSortedCount(int querySize, double decaySpeed) {
+    int pairCount = 0;
+    double decayCoefficient = 1;
+    while (pairCount + 1 < querySize && decayCoefficient >= YETI_RANK_NEGLIGIBLE_DECAY) {
+        ++pairCount;
+        decayCoefficient *= decaySpeed;
+    }
+    return Min(pairCount + 1, querySize);
+}
+
+void GenerateYetiRankPairsForQuery(
     const float* relevs,
     const double* expApproxes,
     float queryWeight,
@@ -19,44 +50,61 @@ static void GenerateYetiRankPairsForQuery(
     competitorsRef.clear();
     competitorsRef.resize(querySize);
 
-    TVector<int> indices(querySize);
-    TVector<TVector<float>> competitorsWeights(querySize, TVector<float>(querySize));
+    auto& buffers = *FastTlsSingleton<TYetiRankPairsBuffers>();
+    TVector<int>& indices = buffers.Indices;
+    TVector<double>& bootstrappedApprox = buffers.BootstrappedApprox;
+    TVector<TYetiRankPair>& pairs = buffers.Pairs;
+    indices.yresize(querySize);
+    bootstrappedApprox.yresize(querySize);
+    pairs.clear();
+    // only pairs of the top positions are generated, the rest have negligible weights
+    const int sortedCount = GetYetiRankSortedCount(querySize, decaySpeed);
     for (int permutationIndex = 0; permutationIndex < permutationCount; ++permutationIndex) {
         std::iota(indices.begin(), indices.end(), 0);
-        TVector<double> bootstrappedApprox(expApproxes, expApproxes + querySize);
         for (int docId = 0; docId < querySize; ++docId) {
             const float uniformValue = rand.GenRandReal1();
             // TODO(nikitxskv): try to experiment with different bootstraps.
-            bootstrappedApprox[docId] *= uniformValue / (1.000001f - uniformValue);
+            bootstrappedApprox[docId] = expApproxes[docId] * (uniformValue / (1.000001f - uniformValue));
         }
 
-        Sort(indices, [&](int i, int j) {
+        const auto isBetter = [&](int i, int j) {
             return bootstrappedApprox[i] > bootstrappedApprox[j];
-        });
+        };
+        if (sortedCount < querySize) {
+            PartialSort(indices.begin(), indices.begin() + sortedCount, indices.end(), isBetter);
+        } else {
+            Sort(indices, isBetter);
+        }
 
         double decayCoefficient = 1;
-        for (int docId = 1; docId < querySize; ++docId) {
+        for (int docId = 1; docId < sortedCount; ++docId) {
             const int firstCandidate = indices[docId - 1];
             const int secondCandidate = indices[docId];
             const double magicConst = 0.15; // Like in GPU
 
             const float pairWeight = magicConst * decayCoefficient * Abs(relevs[firstCandidate] - relevs[secondCandidate]);
             if (relevs[firstCandidate] > relevs[secondCandidate]) {
-                competitorsWeights[firstCandidate][secondCandidate] += pairWeight;
+                pairs.push_back({firstCandidate, secondCandidate, pairWeight});
             } else if (relevs[firstCandidate] < relevs[secondCandidate]) {
-                competitorsWeights[secondCandidate][firstCandidate] += pairWeight;
+                pairs.push_back({secondCandidate, firstCandidate, pairWeight});
             }
             decayCoefficient *= decaySpeed;
         }
     }
 
-    // TODO(nikitxskv): Can be optimized
-    for (int winnerIndex = 0; winnerIndex < querySize; ++winnerIndex) {
-        for (int loserIndex = 0; loserIndex < querySize; ++loserIndex) {
-            const float competitorsWeight = queryWeight * competitorsWeights[winnerIndex][loserIndex] / permutationCount;
-            if (competitorsWeight != 0) {
-                competitorsRef[winnerIndex].push_back({loserIndex, competitorsWeight});
-            }
+    // weights of the same pair are summed in permutation order
+    StableSort(pairs.begin(), pairs.end(), [](const TYetiRankPair& lhs, const TYetiRankPair& rhs) {
+        return std::tie(lhs.Winner, lhs.Loser) < std::tie(rhs.Winner, rhs.Loser);
+    });
+    for (size_t pairIdx = 0; pairIdx < pairs.size();) {
+        const TYetiRankPair& pair = pairs[pairIdx];
+        float sumWeight = 0;
+        for (; pairIdx < pairs.size() && pairs[pairIdx].Winner == pair.Winner && pairs[pairIdx].Loser == pair.Loser; ++pairIdx) {
+            sumWeight += pairs[pairIdx].Weight;
+        }
+        const float competitorsWeight = queryWeight * sumWeight / permutationCount;
+        if (competitorsWeight != 0) {
+            competitorsRef[pair.Winner].push_back({pair.Loser, competitorsWeight});
         }
     }
 }
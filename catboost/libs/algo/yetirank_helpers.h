@@ -2,6 +2,23 @@
 
 #include "learn_context.h"
 
+#include <catboost/libs/data_types/pair.h>
+
+// Pairs of positions with smaller decay coefficient are not generated
+constexpr double YETI_RANK_NEGLIGIBLE_DECAY = 1e-6;
+
+// Sums weights of adjacent pairs of rankings by bootstrapped approxes, competitors of each winner are ordered by loser
+void GenerateYetiRankPairsForQuery(
+    const float* relevs,
+    const double* expApproxes,
+    float queryWeight,
+    int querySize,
+    int permutationCount,
+    double decaySpeed,
+    ui64 randomSeed,
+    TVector<TVector<TCompetitor>>* competitors
+);
+
 void YetiRankRecalculation(
     const TFold& ff,
     const TFold::TBodyTail& bt,
@@ -6,13 +6,16 @@
 
 #include <catboost/libs/column_description/cd_parser.h>
 
+#include <catboost/libs/data_util/compressed_input.h>
 #include <catboost/libs/data_util/exists_checker.h>
+#include <catboost/libs/data_util/line_ranges.h>
 
 #include <catboost/libs/helpers/mem_usage.h>
 
 #include <library/object_factory/object_factory.h>
 
 #include <util/generic/maybe.h>
+#include <util/memory/blob.h>
 #include <util/generic/strbuf.h>
 #include <util/generic/vector.h>
 
@@ -74,7 +77,7 @@ namespace NCB {
     {
     }
 
-    float TTargetConverter::operator()(const TString& word) const {
+    float TTargetConverter::operator()(TStringBuf word) const {
         if (ClassNames.empty()) {
             CB_ENSURE(!IsNanValue(word), "NaN not supported for target");
             return FromString<float>(word);
@@ -86,7 +89,7 @@ namespace NCB {
             }
         }
 
-        CB_ENSURE(false, "Unknown class name: " + word);
+        CB_ENSURE(false, "Unknown class name: " << word);
         return UNDEFINED_CLASS;
     }
 
@@ -142,7 +145,7 @@ namespace NCB {
         , FieldDelimiter(Args.DsvPoolFormatParams.Format.Delimiter)
         , ConvertTarget(Args.ClassNames)
         , LineDataReader(
-            GetLineDataReader(Args.PoolPath, Args.DsvPoolFormatParams.Format)
+            GetLineDataReader(Args.PoolPath, Args.DsvPoolFormatParams.Format, Args.LocalExecutor)
           )
     {
         CB_ENSURE(!Args.PairsFilePath.Inited() || CheckExists(Args.PairsFilePath),
@@ -213,8 +216,58 @@ namespace NCB {
         CatFeatures = GetCategFeatures(columnsDescription);
 
         InitFeatureIds(header);
+    }
+
+    void TCBDsvDataProvider::StartAsyncRead() {
+        if (!AsyncReadStarted) {
+            AsyncRowProcessor.ReadBlockAsync(GetReadFunc());
+            AsyncReadStarted = true;
+        }
+    }
+
+    void TCBDsvDataProvider::Do(IPoolBuilder* poolBuilder) {
+        const auto& scheme = Args.PoolPath.Scheme;
+        const bool isPlainFile = (scheme.empty() || scheme == "dsv" || scheme == "file") &&
+            GetInputCompression(Args.PoolPath) == EInputCompression::None;
+        // compressed pools are decompressed by the read task of AsyncRowProcessor while parsing previous block
+        if (!AsyncReadStarted && isPlainFile) {
+            DoMapped(poolBuilder);
+        } else {
+            StartAsyncRead();
+            TBase::Do(GetReadFunc(), poolBuilder);
+        }
+    }
 
-        AsyncRowProcessor.ReadBlockAsync(GetReadFunc());
+    /* Lines are split to ranges of about the same size and each range is parsed by one task,
+       the document index of a line is its index in the file, so the order does not depend on threads.
+       Fields are parsed from the mapped memory directly without copying lines.
+    */
+    void TCBDsvDataProvider::DoMapped(IPoolBuilder* poolBuilder) {
+        const TBlob file = TBlob::FromFile(Args.PoolPath.Path);
+        TStringBuf data(file.AsCharPtr(), file.Size());
+        if (Args.DsvPoolFormatParams.Format.HasHeader) {
+            const size_t headerEnd = data.find('\n');
+            data = headerEnd == TStringBuf::npos ? TStringBuf() : data.SubStr(headerEnd + 1);
+        }
+
+        // more ranges than threads to balance lines of different lengths
+        const size_t rangeCount = 16 * (Args.LocalExecutor->GetThreadCount() + 1);
+        const TVector<TLineRange> ranges = SplitToLineRanges(data, rangeCount, Args.LocalExecutor);
+        const ui64 docCount = ranges.empty() ? 0 : ranges.back().FirstLineIdx + ranges.back().LineCount;
+        CB_ENSURE(docCount <= static_cast<ui64>(Max<int>()), "Too many documents in pool: " << docCount);
+
+        StartBuilder(false, static_cast<int>(docCount), 0, poolBuilder);
+        poolBuilder->StartNextBlock(docCount);
+        Args.LocalExecutor->ExecRangeWithThrow([&](int rangeIdx) {
+            TVector<float> features;
+            features.yresize(PoolMetaInfo.FeatureCount);
+            ui64 lineIdx = ranges[rangeIdx].FirstLineIdx;
+            ForEachLine(ranges[rangeIdx].Data, [&](TStringBuf line) {
+                ParseLine(line, lineIdx, lineIdx, &features, poolBuilder);
+                ++lineIdx;
+            });
+        }, 0, ranges.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
+        FinalizeBuilder(false, poolBuilder);
     }
 
     TVector<TColumn> TCBDsvDataProvider::CreateColumnsDescription(ui32 columnsCount) {
@@ -275,111 +328,124 @@ namespace NCB {
     void TCBDsvDataProvider::ProcessBlock(IPoolBuilder* poolBuilder) {
         poolBuilder->StartNextBlock(AsyncRowProcessor.GetParseBufferSize());
 
-        auto& columnsDescription = PoolMetaInfo.ColumnsInfo->Columns;
-
         auto parseBlock = [&](TString& line, int lineIdx) {
-            ui32 featureId = 0;
-            ui32 baselineIdx = 0;
             TVector<float> features;
             features.yresize(PoolMetaInfo.FeatureCount);
+            ParseLine(line, AsyncRowProcessor.GetLinesProcessed() + lineIdx, lineIdx, &features, poolBuilder);
+        };
 
-            int tokenCount = 0;
-            TVector<TStringBuf> tokens = StringSplitter(line).Split(FieldDelimiter).ToList<TStringBuf>();
-            for (const auto& token : tokens) {
-                switch (columnsDescription[tokenCount].Type) {
-                    case EColumn::Categ: {
-                        if (!FeatureIgnored[featureId]) {
-                            if (IsNanValue(token)) {
-                                features[featureId] = poolBuilder->GetCatFeatureValue("nan");
-                            } else {
-                                features[featureId] = poolBuilder->GetCatFeatureValue(token);
-                            }
+        AsyncRowProcessor.ProcessBlock(parseBlock);
+    }
+
+    void TCBDsvDataProvider::ParseLine(TStringBuf line,
+                                       ui64 lineIdx,
+                                       ui32 localIdx,
+                                       TVector<float>* features,
+                                       IPoolBuilder* poolBuilder)
+    {
+        const auto& columnsDescription = PoolMetaInfo.ColumnsInfo->Columns;
+
+        ui32 featureId = 0;
+        ui32 baselineIdx = 0;
+
+        int tokenCount = 0;
+        ForEachField(line, FieldDelimiter, [&](TStringBuf token) {
+            CB_ENSURE(tokenCount < columnsDescription.ysize(), "wrong columns number in pool line " <<
+                      lineIdx + 1 << ": expected " << columnsDescription.ysize() << ", found more");
+            switch (columnsDescription[tokenCount].Type) {
+                case EColumn::Categ: {
+                    if (!FeatureIgnored[featureId]) {
+                        if (IsNanValue(token)) {
+                            (*features)[featureId] = poolBuilder->GetCatFeatureValue("nan");
+                        } else {
+                            (*features)[featureId] = poolBuilder->GetCatFeatureValue(token);
                         }
-                        ++featureId;
-                        break;
                     }
-                    case EColumn::Num: {
-                        if (!FeatureIgnored[featureId]) {
-                            float val;
-                            if (!TryFromString<float>(token, val)) {
-                                if (IsNanValue(token)) {
-                                    val = std::numeric_limits<float>::quiet_NaN();
-                                } else if (token.length() == 0) {
-                                    val = std::numeric_limits<float>::quiet_NaN();
-                                } else {
-                                    CB_ENSURE(false, "Factor " << featureId << " (column " << tokenCount + 1 << ") is declared `Num`," <<
-                                        " but has value '" << token << "' in row "
-                                        << AsyncRowProcessor.GetLinesProcessed() + lineIdx + 1
-                                        << " that cannot be parsed as float. Try correcting column description file.");
-                                }
+                    ++featureId;
+                    break;
+                }
+                case EColumn::Num: {
+                    if (!FeatureIgnored[featureId]) {
+                        float val;
+                        if (!TryFromString<float>(token, val)) {
+                            if (IsNanValue(token)) {
+                                val = std::numeric_limits<float>::quiet_NaN();
+                            } else if (token.length() == 0) {
+                                val = std::numeric_limits<float>::quiet_NaN();
+                            } else {
+                                CB_ENSURE(false, "Factor " << featureId << " (column " << tokenCount + 1 << ") is declared `Num`," <<
+                                    " but has value '" << token << "' in row "
+                                    << lineIdx + 1
+                                    << " that cannot be parsed as float. Try correcting column description file.");
                             }
-                            features[featureId] = val == 0.0f ? 0.0f : val; // remove negative zeros
                         }
-                        ++featureId;
-                        break;
-                    }
-                    case EColumn::Label: {
-                        CB_ENSURE(token.length() != 0, "empty values not supported for Label. Label should be float.");
-                        poolBuilder->AddTarget(lineIdx, ConvertTarget(FromString<TString>(token)));
-                        break;
-                    }
-                    case EColumn::Weight: {
-                        CB_ENSURE(token.length() != 0, "empty values not supported for weight");
-                        poolBuilder->AddWeight(lineIdx, FromString<float>(token));
-                        break;
-                    }
-                    case EColumn::Auxiliary: {
-                        break;
-                    }
-                    case EColumn::GroupId: {
-                        CB_ENSURE(token.length() != 0, "empty values not supported for GroupId");
-                        poolBuilder->AddQueryId(lineIdx, CalcGroupIdFor(token));
-                        break;
-                    }
-                    case EColumn::GroupWeight: {
-                        CB_ENSURE(token.length() != 0, "empty values not supported for GroupWeight");
-                        poolBuilder->AddWeight(lineIdx, FromString<float>(token));
-                        break;
-                    }
-                    case EColumn::SubgroupId: {
-                        CB_ENSURE(token.length() != 0, "empty values not supported for SubgroupId");
-                        poolBuilder->AddSubgroupId(lineIdx, CalcSubgroupIdFor(token));
-                        break;
-                    }
-                    case EColumn::Baseline: {
-                        CB_ENSURE(token.length() != 0, "empty values not supported for Baseline");
-                        poolBuilder->AddBaseline(lineIdx, baselineIdx, FromString<double>(token));
-                        ++baselineIdx;
-                        break;
-                    }
-                    case EColumn::DocId: {
-                        CB_ENSURE(token.length() != 0, "empty values not supported for DocId");
-                        poolBuilder->AddDocId(lineIdx, token);
-                        break;
-                    }
-                    case EColumn::Timestamp: {
-                        CB_ENSURE(token.length() != 0, "empty values not supported for Timestamp");
-                        poolBuilder->AddTimestamp(lineIdx, FromString<ui64>(token));
-                        break;
-                    }
-                    default: {
-                        CB_ENSURE(false, "wrong column type");
+                        (*features)[featureId] = val == 0.0f ? 0.0f : val; // remove negative zeros
                     }
+                    ++featureId;
+                    break;
+                }
+                case EColumn::Label: {
+                    CB_ENSURE(token.length() != 0, "empty values not supported for Label. Label should be float.");
+                    poolBuilder->AddTarget(localIdx, ConvertTarget(token));
+                    break;
+                }
+                case EColumn::Weight: {
+                    CB_ENSURE(token.length() != 0, "empty values not supported for weight");
+                    poolBuilder->AddWeight(localIdx, FromString<float>(token));
+                    break;
+                }
+                case EColumn::Auxiliary: {
+                    break;
+                }
+                case EColumn::GroupId: {
+                    CB_ENSURE(token.length() != 0, "empty values not supported for GroupId");
+                    poolBuilder->AddQueryId(localIdx, CalcGroupIdFor(token));
+                    break;
+                }
+                case EColumn::GroupWeight: {
+                    CB_ENSURE(token.length() != 0, "empty values not supported for GroupWeight");
+                    poolBuilder->AddWeight(localIdx, FromString<float>(token));
+                    break;
+                }
+                case EColumn::SubgroupId: {
+                    CB_ENSURE(token.length() != 0, "empty values not supported for SubgroupId");
+                    poolBuilder->AddSubgroupId(localIdx, CalcSubgroupIdFor(token));
+                    break;
+                }
+                case EColumn::Baseline: {
+                    CB_ENSURE(token.length() != 0, "empty values not supported for Baseline");
+                    poolBuilder->AddBaseline(localIdx, baselineIdx, FromString<double>(token));
+                    ++baselineIdx;
+                    break;
+                }
+                case EColumn::DocId: {
+                    CB_ENSURE(token.length() != 0, "empty values not supported for DocId");
+                    poolBuilder->AddDocId(localIdx, token);
+                    break;
+                }
+                case EColumn::Timestamp: {
+                    CB_ENSURE(token.length() != 0, "empty values not supported for Timestamp");
+                    poolBuilder->AddTimestamp(localIdx, FromString<ui64>(token));
+                    break;
+                }
+                default: {
+                    CB_ENSURE(false, "wrong column type");
                 }
-                ++tokenCount;
             }
-            poolBuilder->AddAllFloatFeatures(lineIdx, features);
-            CB_ENSURE(tokenCount == columnsDescription.ysize(), "wrong columns number in pool line " <<
-                      AsyncRowProcessor.GetLinesProcessed() + lineIdx + 1 << ": expected " << columnsDescription.ysize() << ", found " << tokenCount);
-        };
-
-        AsyncRowProcessor.ProcessBlock(parseBlock);
+            ++tokenCount;
+        });
+        poolBuilder->AddAllFloatFeatures(localIdx, *features);
+        CB_ENSURE(tokenCount == columnsDescription.ysize(), "wrong columns number in pool line " <<
+                  lineIdx + 1 << ": expected " << columnsDescription.ysize() << ", found " << tokenCount);
     }
 
     namespace {
 
     TDocDataProviderObjectFactory::TRegistrator<TCBDsvDataProvider> DefDataProviderReg("");
     TDocDataProviderObjectFactory::TRegistrator<TCBDsvDataProvider> CBDsvDataProviderReg("dsv");
+    TDocDataProviderObjectFactory::TRegistrator<TCBDsvDataProvider> CBGzipDsvDataProviderReg("gzip");
+    TDocDataProviderObjectFactory::TRegistrator<TCBDsvDataProvider> CBZstdDsvDataProviderReg("zstd");
+    TDocDataProviderObjectFactory::TRegistrator<TCBDsvDataProvider> CBBlockCodecsDsvDataProviderReg("blockcodecs");
 
     }
 }
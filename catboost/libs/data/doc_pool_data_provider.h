@@ -60,7 +60,7 @@ namespace NCB {
 
         explicit TTargetConverter(const TVector<TString>& classNames);
 
-        float operator()(const TString& word) const;
+        float operator()(TStringBuf word) const;
 
     private:
         TVector<TString> ClassNames;
@@ -170,11 +170,11 @@ namespace NCB {
     public:
         explicit TCBDsvDataProvider(TDocPoolDataProviderArgs&& args);
 
-        void Do(IPoolBuilder* poolBuilder) override {
-            TBase::Do(GetReadFunc(), poolBuilder);
-        }
+        // local files are memory mapped and parsed by all threads, other sources are read by lines
+        void Do(IPoolBuilder* poolBuilder) override;
 
         bool DoBlock(IPoolBuilder* poolBuilder) override {
+            StartAsyncRead();
             return TBase::DoBlock(GetReadFunc(), poolBuilder);
         }
 
@@ -191,6 +191,14 @@ namespace NCB {
 
         void ProcessBlock(IPoolBuilder* poolBuilder) override;
 
+    protected:
+        void StartAsyncRead();
+
+        void DoMapped(IPoolBuilder* poolBuilder);
+
+        // `features` is a buffer of FeatureCount size reused between lines
+        void ParseLine(TStringBuf line, ui64 lineIdx, ui32 localIdx, TVector<float>* features, IPoolBuilder* poolBuilder);
+
     protected:
         TVector<bool> FeatureIgnored; // init in process
         char FieldDelimiter;
@@ -198,6 +206,7 @@ namespace NCB {
         THolder<NCB::ILineDataReader> LineDataReader;
 
         TVector<int> CatFeatures;
+        bool AsyncReadStarted = false;
     };
 
 
@@ -29,10 +29,14 @@ namespace NCB {
             FeatureCount = poolMetaInfo.FeatureCount;
             BaselineCount = poolMetaInfo.BaselineCount;
             Pool->Docs.Resize(docCount,
-                              FeatureCount,
+                              poolMetaInfo.IsQuantized ? 0 : FeatureCount,
                               BaselineCount,
                               poolMetaInfo.HasGroupId,
                               poolMetaInfo.HasSubgroupIds);
+            if (poolMetaInfo.IsQuantized) {
+                Pool->Docs.QuantizedFactors.resize(FeatureCount);
+                Pool->QuantizedFeatureBorders.resize(FeatureCount);
+            }
             Pool->CatFeatures = catFeatureIds;
             Pool->MetaInfo = poolMetaInfo;
         }
@@ -69,6 +73,13 @@ namespace NCB {
             }
         }
 
+        void SetQuantizedFloatFeature(ui32 featureId, TVector<ui8>&& bins, const TVector<float>& borders) override {
+            CB_ENSURE(Pool->MetaInfo.IsQuantized, "Error: pool is not quantized");
+            CB_ENSURE(bins.size() == Pool->Docs.GetDocCount(), "Error: number of bins should be equal to doc count");
+            Pool->Docs.QuantizedFactors[featureId] = std::move(bins);
+            Pool->QuantizedFeatureBorders[featureId] = borders;
+        }
+
         void AddTarget(ui32 localIdx, float value) override {
             Pool->Docs.Target[Cursor + localIdx] = value;
         }
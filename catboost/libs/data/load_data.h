@@ -34,6 +34,8 @@ namespace NCB {
         virtual void AddCatFeature(ui32 localIdx, ui32 featureId, const TStringBuf& feature) = 0;
         virtual void AddFloatFeature(ui32 localIdx, ui32 featureId, float feature) = 0;
         virtual void AddAllFloatFeatures(ui32 localIdx, TConstArrayRef<float> features) = 0;
+        // Set bins of float feature for all documents of a pool with TPoolMetaInfo::IsQuantized
+        virtual void SetQuantizedFloatFeature(ui32 featureId, TVector<ui8>&& bins, const TVector<float>& borders) = 0;
         virtual void AddTarget(ui32 localIdx, float value) = 0;
         virtual void AddWeight(ui32 localIdx, float value) = 0;
         virtual void AddQueryId(ui32 localIdx, TGroupId value) = 0;
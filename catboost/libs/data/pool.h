@@ -31,6 +31,8 @@ struct TPoolMetaInfo {
     bool HasDocIds = false;
     bool HasWeights = false;
     bool HasTimestamp = false;
+    // features are read as bins of quantization borders, see TDocumentStorage::QuantizedFactors
+    bool IsQuantized = false;
 
     // set only for dsv format pools
     // TODO(akhropov): temporary, serialization details shouldn't be here
@@ -55,6 +57,9 @@ struct TDocInfo {
 
 struct TDocumentStorage {
     TVector<TVector<float>> Factors; // [factorIdx][docIdx]
+    // [factorIdx][docIdx], float factors of pools read in quantized form, Factors are empty then
+    // QuantizedFactors[factorIdx] might be empty if factor is ignored or has no borders
+    TVector<TVector<ui8>> QuantizedFactors;
     TVector<TVector<double>> Baseline; // [dim][docIdx]
     TVector<float> Target; // [docIdx]
     TVector<float> Weight; // [docIdx]
@@ -69,7 +74,11 @@ struct TDocumentStorage {
 
     /// @return the number of non-constant factors (`Factors` stores only non-constant factors).
     inline int GetEffectiveFactorCount() const {
-        return Factors.ysize();
+        return IsQuantized() ? QuantizedFactors.ysize() : Factors.ysize();
+    }
+
+    inline bool IsQuantized() const {
+        return !QuantizedFactors.empty();
     }
 
     inline size_t GetDocCount() const {
@@ -90,8 +99,8 @@ struct TDocumentStorage {
             }
         }
         return areFactorsEqual && (
-            std::tie(Baseline, Target, Weight, Id, QueryId, SubgroupId, Timestamp) ==
-            std::tie(other.Baseline, other.Target, other.Weight, other.Id, other.QueryId, other.SubgroupId, other.Timestamp)
+            std::tie(QuantizedFactors, Baseline, Target, Weight, Id, QueryId, SubgroupId, Timestamp) ==
+            std::tie(other.QuantizedFactors, other.Baseline, other.Target, other.Weight, other.Id, other.QueryId, other.SubgroupId, other.Timestamp)
         );
     }
 
@@ -101,6 +110,7 @@ struct TDocumentStorage {
 
     inline void Swap(TDocumentStorage& other) {
         Factors.swap(other.Factors);
+        QuantizedFactors.swap(other.QuantizedFactors);
         Baseline.swap(other.Baseline);
         Target.swap(other.Target);
         Weight.swap(other.Weight);
@@ -111,9 +121,14 @@ struct TDocumentStorage {
     }
 
     inline void SwapDoc(size_t doc1Idx, size_t doc2Idx) {
-        for (int factorIdx = 0; factorIdx < GetEffectiveFactorCount(); ++factorIdx) {
+        for (int factorIdx = 0; factorIdx < Factors.ysize(); ++factorIdx) {
             DoSwap(Factors[factorIdx][doc1Idx], Factors[factorIdx][doc2Idx]);
         }
+        for (auto& factor : QuantizedFactors) {
+            if (!factor.empty()) {
+                DoSwap(factor[doc1Idx], factor[doc2Idx]);
+            }
+        }
         for (int dim = 0; dim < GetBaselineDimension(); ++dim) {
             DoSwap(Baseline[dim][doc1Idx], Baseline[dim][doc2Idx]);
         }
@@ -132,6 +147,7 @@ struct TDocumentStorage {
     inline void AssignDoc(int destinationIdx, const TDocumentStorage& sourceDocs, int sourceIdx) {
         Y_ASSERT(GetEffectiveFactorCount() == sourceDocs.GetEffectiveFactorCount());
         Y_ASSERT(GetBaselineDimension() == sourceDocs.GetBaselineDimension());
+        Y_ASSERT(!IsQuantized() && !sourceDocs.IsQuantized());
         for (int factorIdx = 0; factorIdx < GetEffectiveFactorCount(); ++factorIdx) {
             Factors[factorIdx][destinationIdx] = sourceDocs.Factors[factorIdx][sourceIdx];
         }
@@ -179,6 +195,10 @@ struct TDocumentStorage {
             factor.clear();
             factor.shrink_to_fit();
         }
+        for (auto& factor : QuantizedFactors) {
+            factor.clear();
+            factor.shrink_to_fit();
+        }
         for (auto& dim : Baseline) {
             dim.clear();
             dim.shrink_to_fit();
@@ -205,6 +225,7 @@ struct TPool {
     THashMap<int, TString> CatFeaturesHashToString;
     TVector<TPair> Pairs;
     TPoolMetaInfo MetaInfo;
+    TVector<TVector<float>> QuantizedFeatureBorders; // [factorIdx], borders of Docs.QuantizedFactors
 
     bool operator==(const TPool& other) const {
         return (
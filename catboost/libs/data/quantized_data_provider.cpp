@@ -0,0 +1,216 @@
+#include "doc_pool_data_provider.h"
+
+#include "load_data.h"
+
+#include <catboost/idl/pool/flat/quantized_chunk_t.fbs.h>
+#include <catboost/idl/pool/proto/quantization_schema.pb.h>
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/logging/logging.h>
+#include <catboost/libs/quantized_pool/pool.h>
+#include <catboost/libs/quantized_pool/serialization.h>
+
+#include <library/object_factory/object_factory.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/vector.h>
+#include <util/string/cast.h>
+#include <util/system/unaligned_mem.h>
+
+
+namespace NCB {
+
+    namespace {
+
+    template <typename T, typename TAddValue>
+    void ForEachValue(const TVector<TQuantizedPool::TChunkDescription>& chunks, TAddValue&& addValue) {
+        for (const auto& chunk : chunks) {
+            CB_ENSURE(static_cast<size_t>(chunk.Chunk->BitsPerDocument()) == sizeof(T) * 8,
+                      "Unexpected bits per document in quantized pool chunk: " << static_cast<int>(chunk.Chunk->BitsPerDocument()));
+            CB_ENSURE(chunk.DocumentCount * sizeof(T) <= chunk.Chunk->Quants()->size(), "Quantized pool chunk is too small");
+            const ui8* values = chunk.Chunk->Quants()->data();
+            for (size_t i = 0; i < chunk.DocumentCount; ++i) {
+                addValue(chunk.DocumentOffset + i, ReadUnaligned<T>(values + i * sizeof(T)));
+            }
+        }
+    }
+
+    TVector<ui8> GatherBins(const TVector<TQuantizedPool::TChunkDescription>& chunks, size_t docCount, size_t borderCount) {
+        TVector<ui8> bins(docCount, 0);
+        for (const auto& chunk : chunks) {
+            const size_t bitsPerDocument = static_cast<size_t>(chunk.Chunk->BitsPerDocument());
+            CB_ENSURE(bitsPerDocument == 1 || bitsPerDocument == 2 || bitsPerDocument == 4 || bitsPerDocument == 8,
+                      "Only 1, 2, 4 and 8 bits per document are supported for numeric features of quantized pool, got " << bitsPerDocument);
+            CB_ENSURE((chunk.DocumentCount * bitsPerDocument + 7) / 8 <= chunk.Chunk->Quants()->size(), "Quantized pool chunk is too small");
+            CB_ENSURE(chunk.DocumentOffset + chunk.DocumentCount <= docCount, "Quantized pool chunk is out of document range");
+            const ui8* chunkBins = chunk.Chunk->Quants()->data();
+            if (bitsPerDocument == 8) {
+                Copy(chunkBins, chunkBins + chunk.DocumentCount, bins.begin() + chunk.DocumentOffset);
+                continue;
+            }
+            // documents are packed starting from the low bits of a byte
+            const size_t docsPerByte = 8 / bitsPerDocument;
+            const ui8 binMask = (1 << bitsPerDocument) - 1;
+            for (size_t i = 0; i < chunk.DocumentCount; ++i) {
+                const size_t shift = (i % docsPerByte) * bitsPerDocument;
+                bins[chunk.DocumentOffset + i] = (chunkBins[i / docsPerByte] >> shift) & binMask;
+            }
+        }
+        CB_ENSURE(docCount == 0 || *MaxElement(bins.begin(), bins.end()) <= borderCount, "Bin index exceeds border count in quantized pool");
+        return bins;
+    }
+
+    // Reads pools saved by SaveQuantizedPool. The file is mapped to memory, numeric features are passed
+    // to the builder as bins of quantization schema borders, so neither parsing nor binarization is needed.
+    class TCBQuantizedDataProvider : public IDocPoolDataProvider {
+    public:
+        explicit TCBQuantizedDataProvider(TDocPoolDataProviderArgs&& args)
+            : Args(std::move(args))
+        {
+            CB_ENSURE(Args.ClassNames.empty(), "Class names are not supported for quantized pools");
+            if (Args.DsvPoolFormatParams.CdFilePath.Inited()) {
+                MATRIXNET_WARNING_LOG << "Columns description of quantized pool is stored in the pool, cd file is ignored" << Endl;
+            }
+        }
+
+        void Do(IPoolBuilder* poolBuilder) override {
+            TLoadQuantizedPoolParameters loadParameters;
+            loadParameters.LockMemory = false;
+            loadParameters.Precharge = false;
+            const TQuantizedPool pool = LoadQuantizedPool(Args.PoolPath.Path, loadParameters);
+
+            TVector<size_t> columnIndices;
+            for (const auto& columnIndexAndLocalIndex : pool.TrueFeatureIndexToLocalIndex) {
+                columnIndices.push_back(columnIndexAndLocalIndex.first);
+            }
+            Sort(columnIndices.begin(), columnIndices.end());
+
+            TPoolMetaInfo poolMetaInfo;
+            poolMetaInfo.FeatureCount = 0;
+            poolMetaInfo.BaselineCount = 0;
+            poolMetaInfo.IsQuantized = true;
+            size_t docCount = 0;
+            ui32 labelColumns = 0;
+            for (size_t columnIdx : columnIndices) {
+                const size_t localIdx = pool.TrueFeatureIndexToLocalIndex.at(columnIdx);
+                switch (pool.ColumnTypes[localIdx]) {
+                    case EColumn::Num:
+                        ++poolMetaInfo.FeatureCount;
+                        break;
+                    case EColumn::Label:
+                        ++labelColumns;
+                        break;
+                    case EColumn::Baseline:
+                        ++poolMetaInfo.BaselineCount;
+                        break;
+                    case EColumn::Weight:
+                        CB_ENSURE(!poolMetaInfo.HasWeights, "Too many Weight columns.");
+                        poolMetaInfo.HasWeights = true;
+                        break;
+                    case EColumn::GroupWeight:
+                        CB_ENSURE(!poolMetaInfo.HasGroupWeight, "Too many GroupWeight columns.");
+                        poolMetaInfo.HasGroupWeight = true;
+                        break;
+                    case EColumn::GroupId:
+                        CB_ENSURE(!poolMetaInfo.HasGroupId, "Too many GroupId columns.");
+                        poolMetaInfo.HasGroupId = true;
+                        break;
+                    case EColumn::SubgroupId:
+                        CB_ENSURE(!poolMetaInfo.HasSubgroupIds, "Too many SubgroupId columns.");
+                        poolMetaInfo.HasSubgroupIds = true;
+                        break;
+                    case EColumn::DocId:
+                        CB_ENSURE(!poolMetaInfo.HasDocIds, "Too many DocId columns.");
+                        poolMetaInfo.HasDocIds = true;
+                        break;
+                    default:
+                        CB_ENSURE(false, "Unexpected column type " << pool.ColumnTypes[localIdx] << " in quantized pool");
+                }
+                for (const auto& chunk : pool.Chunks[localIdx]) {
+                    docCount = Max(docCount, chunk.DocumentOffset + chunk.DocumentCount);
+                }
+            }
+            CB_ENSURE(labelColumns <= 1, "Too many Label columns.");
+            CB_ENSURE(poolMetaInfo.FeatureCount > 0, "Pool should have at least one factor");
+            CB_ENSURE(!(poolMetaInfo.HasWeights && poolMetaInfo.HasGroupWeight), "Pool must have either Weight column or GroupWeight column");
+
+            TVector<bool> featureIgnored(poolMetaInfo.FeatureCount, false);
+            for (int featureId : Args.IgnoredFeatures) {
+                CB_ENSURE(0 <= featureId && featureId < static_cast<int>(poolMetaInfo.FeatureCount), "Invalid ignored feature id: " << featureId);
+                featureIgnored[featureId] = true;
+            }
+
+            poolBuilder->Start(poolMetaInfo, docCount, /*catFeatureIds*/ {});
+            if (!poolMetaInfo.HasDocIds) {
+                poolBuilder->GenerateDocIds(0);
+            }
+            poolBuilder->StartNextBlock(docCount);
+
+            TVector<std::pair<size_t, ui32>> featureColumns; // (column index, feature id)
+            ui32 baselineIdx = 0;
+            for (size_t columnIdx : columnIndices) {
+                const auto& chunks = pool.Chunks[pool.TrueFeatureIndexToLocalIndex.at(columnIdx)];
+                switch (pool.ColumnTypes[pool.TrueFeatureIndexToLocalIndex.at(columnIdx)]) {
+                    case EColumn::Num:
+                        featureColumns.emplace_back(columnIdx, featureColumns.size());
+                        break;
+                    case EColumn::Label:
+                        ForEachValue<float>(chunks, [&](size_t doc, float value) { poolBuilder->AddTarget(doc, value); });
+                        break;
+                    case EColumn::Baseline:
+                        ForEachValue<double>(chunks, [&](size_t doc, double value) { poolBuilder->AddBaseline(doc, baselineIdx, value); });
+                        ++baselineIdx;
+                        break;
+                    case EColumn::Weight:
+                    case EColumn::GroupWeight:
+                        ForEachValue<float>(chunks, [&](size_t doc, float value) { poolBuilder->AddWeight(doc, value); });
+                        break;
+                    case EColumn::GroupId:
+                        ForEachValue<ui64>(chunks, [&](size_t doc, ui64 value) { poolBuilder->AddQueryId(doc, value); });
+                        break;
+                    case EColumn::SubgroupId:
+                        ForEachValue<ui32>(chunks, [&](size_t doc, ui32 value) { poolBuilder->AddSubgroupId(doc, value); });
+                        break;
+                    case EColumn::DocId:
+                        ForEachValue<ui64>(chunks, [&](size_t doc, ui64 value) { poolBuilder->AddDocId(doc, ToString(value)); });
+                        break;
+                    default:
+                        Y_UNREACHABLE();
+                }
+            }
+
+            const auto& featureSchemas = pool.QuantizationSchema.GetFeatureIndexToSchema();
+            Args.LocalExecutor->ExecRangeWithThrow([&](int featureColumnIdx) {
+                const size_t columnIdx = featureColumns[featureColumnIdx].first;
+                const ui32 featureId = featureColumns[featureColumnIdx].second;
+                const auto schemaIt = featureSchemas.find(columnIdx);
+                if (featureIgnored[featureId] || schemaIt == featureSchemas.end() || schemaIt->second.GetBorders().empty()) {
+                    return;
+                }
+                const TVector<float> borders(schemaIt->second.GetBorders().begin(), schemaIt->second.GetBorders().end());
+                const auto& chunks = pool.Chunks[pool.TrueFeatureIndexToLocalIndex.at(columnIdx)];
+                poolBuilder->SetQuantizedFloatFeature(featureId, GatherBins(chunks, docCount, borders.size()), borders);
+            }, 0, featureColumns.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
+
+            if (Args.PairsFilePath.Inited()) {
+                TVector<TPair> pairs = ReadPairs(Args.PairsFilePath, docCount);
+                if (poolMetaInfo.HasGroupWeight) {
+                    WeightPairs(poolBuilder->GetWeight(), &pairs);
+                }
+                poolBuilder->SetPairs(pairs);
+            }
+            poolBuilder->Finish();
+        }
+
+        bool DoBlock(IPoolBuilder* /*poolBuilder*/) override {
+            CB_ENSURE(false, "Quantized pools can't be read by blocks");
+            return false;
+        }
+
+    private:
+        TDocPoolDataProviderArgs Args;
+    };
+
+    TDocDataProviderObjectFactory::TRegistrator<TCBQuantizedDataProvider> CBQuantizedDataProviderReg("quantized");
+
+    }
+}
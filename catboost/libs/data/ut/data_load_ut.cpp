@@ -1,4 +1,10 @@
 #include <catboost/libs/data/load_data.h>
+#include <catboost/libs/quantized_pool/pool.h>
+#include <catboost/libs/quantized_pool/serialization.h>
+
+#include <catboost/idl/pool/flat/quantized_chunk_t.fbs.h>
+
+#include <contrib/libs/flatbuffers/include/flatbuffers/flatbuffers.h>
 
 #include <library/threading/local_executor/local_executor.h>
 
@@ -12,6 +18,12 @@
 using namespace std;
 using namespace NCB;
 
+static TBlob MakeQuantizedChunkBlob(NIdl::EBitsPerDocumentFeature bitsPerDocument, const ui8* data, size_t size) {
+    flatbuffers::FlatBufferBuilder builder;
+    builder.Finish(NIdl::CreateTQuantizedFeatureChunk(builder, bitsPerDocument, builder.CreateVector(data, size)));
+    return TBlob::Copy(builder.GetBufferPointer(), builder.GetSize());
+}
+
 Y_UNIT_TEST_SUITE(TDataLoadTest) {
     //
     Y_UNIT_TEST(TestFileRead) {
@@ -58,4 +70,110 @@ Y_UNIT_TEST_SUITE(TDataLoadTest) {
             }
         }
     }
+
+    Y_UNIT_TEST(TestQuantizedFileRead) {
+        static const ui8 bins[] = {2, 0, 3};
+        static const float labels[] = {0.5, 1.5, 0};
+        TQuantizedPool quantizedPool;
+        quantizedPool.Blobs.push_back(MakeQuantizedChunkBlob(NIdl::EBitsPerDocumentFeature_BPDF_8, bins, Y_ARRAY_SIZE(bins)));
+        quantizedPool.Blobs.push_back(MakeQuantizedChunkBlob(NIdl::EBitsPerDocumentFeature_BPDF_32, reinterpret_cast<const ui8*>(labels), sizeof(labels)));
+        quantizedPool.TrueFeatureIndexToLocalIndex.emplace(1, 0);
+        quantizedPool.TrueFeatureIndexToLocalIndex.emplace(5, 1);
+        quantizedPool.ColumnTypes = {EColumn::Num, EColumn::Label};
+        {
+            NIdl::TFeatureQuantizationSchema featureSchema;
+            featureSchema.AddBorders(0.25);
+            featureSchema.AddBorders(0.5);
+            featureSchema.AddBorders(0.75);
+            quantizedPool.QuantizationSchema.MutableFeatureIndexToSchema()->insert({1, std::move(featureSchema)});
+        }
+        for (const auto& blob : quantizedPool.Blobs) {
+            quantizedPool.Chunks.push_back({TQuantizedPool::TChunkDescription(
+                0,
+                3,
+                flatbuffers::GetRoot<NIdl::TQuantizedFeatureChunk>(blob.AsCharPtr()))});
+        }
+        const TString testFileName = "sample_pool.quantized";
+        {
+            TOFStream writer(testFileName);
+            SaveQuantizedPool(quantizedPool, &writer);
+        }
+
+        TPool pool;
+        ReadPool(TPathWithScheme(testFileName, "quantized"),
+                 TPathWithScheme(),
+                 NCatboostOptions::TDsvPoolFormatParams(),
+                 /*ignoredFeatures*/ {},
+                 2,
+                 false,
+                 TVector<TString>(),
+                 &pool);
+
+        UNIT_ASSERT(pool.Docs.IsQuantized());
+        UNIT_ASSERT_VALUES_EQUAL(pool.Docs.GetDocCount(), 3);
+        UNIT_ASSERT_VALUES_EQUAL(pool.Docs.GetEffectiveFactorCount(), 1);
+        UNIT_ASSERT(pool.Docs.Factors.empty());
+        UNIT_ASSERT_EQUAL(pool.Docs.QuantizedFactors[0], TVector<ui8>(bins, bins + Y_ARRAY_SIZE(bins)));
+        UNIT_ASSERT_EQUAL(pool.QuantizedFeatureBorders[0], TVector<float>({0.25f, 0.5f, 0.75f}));
+        for (size_t i = 0; i < Y_ARRAY_SIZE(labels); ++i) {
+            UNIT_ASSERT_DOUBLES_EQUAL(pool.Docs.Target[i], labels[i], 1e-6);
+        }
+    }
+
+    Y_UNIT_TEST(TestPackedQuantizedFileRead) {
+        // feature 0 has 2 bits per document in chunks of docs [0, 3) and [3, 5), feature 1 has 1 bit per document
+        static const ui8 firstBins[] = {2 | (0 << 2) | (3 << 4)};
+        static const ui8 secondBins[] = {1 | (2 << 2)};
+        static const ui8 binaryBins[] = {1 | (0 << 1) | (1 << 2) | (1 << 3) | (0 << 4)};
+        static const float labels[] = {0.5, 1.5, 0, 1, 2};
+        TQuantizedPool quantizedPool;
+        quantizedPool.Blobs.push_back(MakeQuantizedChunkBlob(NIdl::EBitsPerDocumentFeature_BPDF_2, firstBins, Y_ARRAY_SIZE(firstBins)));
+        quantizedPool.Blobs.push_back(MakeQuantizedChunkBlob(NIdl::EBitsPerDocumentFeature_BPDF_2, secondBins, Y_ARRAY_SIZE(secondBins)));
+        quantizedPool.Blobs.push_back(MakeQuantizedChunkBlob(NIdl::EBitsPerDocumentFeature_BPDF_1, binaryBins, Y_ARRAY_SIZE(binaryBins)));
+        quantizedPool.Blobs.push_back(MakeQuantizedChunkBlob(NIdl::EBitsPerDocumentFeature_BPDF_32, reinterpret_cast<const ui8*>(labels), sizeof(labels)));
+        quantizedPool.TrueFeatureIndexToLocalIndex.emplace(0, 0);
+        quantizedPool.TrueFeatureIndexToLocalIndex.emplace(1, 1);
+        quantizedPool.TrueFeatureIndexToLocalIndex.emplace(2, 2);
+        quantizedPool.ColumnTypes = {EColumn::Num, EColumn::Num, EColumn::Label};
+        {
+            NIdl::TFeatureQuantizationSchema featureSchema;
+            featureSchema.AddBorders(0.25);
+            featureSchema.AddBorders(0.5);
+            featureSchema.AddBorders(0.75);
+            quantizedPool.QuantizationSchema.MutableFeatureIndexToSchema()->insert({0, std::move(featureSchema)});
+        }
+        {
+            NIdl::TFeatureQuantizationSchema featureSchema;
+            featureSchema.AddBorders(0.5);
+            quantizedPool.QuantizationSchema.MutableFeatureIndexToSchema()->insert({1, std::move(featureSchema)});
+        }
+        const auto getChunk = [&](size_t blobIdx) {
+            return flatbuffers::GetRoot<NIdl::TQuantizedFeatureChunk>(quantizedPool.Blobs[blobIdx].AsCharPtr());
+        };
+        quantizedPool.Chunks.push_back({TQuantizedPool::TChunkDescription(0, 3, getChunk(0)), TQuantizedPool::TChunkDescription(3, 2, getChunk(1))});
+        quantizedPool.Chunks.push_back({TQuantizedPool::TChunkDescription(0, 5, getChunk(2))});
+        quantizedPool.Chunks.push_back({TQuantizedPool::TChunkDescription(0, 5, getChunk(3))});
+        const TString testFileName = "sample_packed_pool.quantized";
+        {
+            TOFStream writer(testFileName);
+            SaveQuantizedPool(quantizedPool, &writer);
+        }
+
+        TPool pool;
+        ReadPool(TPathWithScheme(testFileName, "quantized"),
+                 TPathWithScheme(),
+                 NCatboostOptions::TDsvPoolFormatParams(),
+                 /*ignoredFeatures*/ {},
+                 2,
+                 false,
+                 TVector<TString>(),
+                 &pool);
+
+        UNIT_ASSERT(pool.Docs.IsQuantized());
+        UNIT_ASSERT_VALUES_EQUAL(pool.Docs.GetDocCount(), 5);
+        UNIT_ASSERT_VALUES_EQUAL(pool.Docs.GetEffectiveFactorCount(), 2);
+        UNIT_ASSERT_EQUAL(pool.Docs.QuantizedFactors[0], TVector<ui8>({2, 0, 3, 1, 2}));
+        UNIT_ASSERT_EQUAL(pool.Docs.QuantizedFactors[1], TVector<ui8>({1, 0, 1, 1, 0}));
+        UNIT_ASSERT_EQUAL(pool.QuantizedFeatureBorders[1], TVector<float>({0.5f}));
+    }
 }
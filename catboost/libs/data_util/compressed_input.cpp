@@ -0,0 +1,237 @@
+#include "compressed_input.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <contrib/libs/zstd/zstd.h>
+
+#include <library/blockcodecs/stream.h>
+
+#include <util/generic/buffer.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/stream/buffered.h>
+#include <util/stream/file.h>
+#include <util/stream/mem.h>
+#include <util/stream/zlib.h>
+#include <util/system/unaligned_mem.h>
+
+
+namespace NCB {
+
+    EInputCompression GetInputCompression(const TPathWithScheme& pathWithScheme) {
+        const auto& scheme = pathWithScheme.Scheme;
+        if (scheme == "gzip") {
+            return EInputCompression::Gzip;
+        }
+        if (scheme == "zstd") {
+            return EInputCompression::Zstd;
+        }
+        if (scheme == "blockcodecs") {
+            return EInputCompression::BlockCodecs;
+        }
+        if (scheme.empty() || scheme == "file" || scheme == "dsv") {
+            const TStringBuf path = pathWithScheme.Path;
+            if (path.EndsWith(".gz")) {
+                return EInputCompression::Gzip;
+            }
+            if (path.EndsWith(".zst") || path.EndsWith(".zstd")) {
+                return EInputCompression::Zstd;
+            }
+        }
+        return EInputCompression::None;
+    }
+
+
+    namespace {
+
+    class TZstdDecompress : public IInputStream {
+    public:
+        explicit TZstdDecompress(IInputStream* slave)
+            : Slave(slave)
+            , Stream(ZSTD_createDStream())
+            , InputBuffer(ZSTD_DStreamInSize())
+        {
+            CB_ENSURE(Stream != nullptr, "Can't create zstd decompression stream");
+            CheckResult(ZSTD_initDStream(Stream));
+            Input = {InputBuffer.Data(), 0, 0};
+        }
+
+        ~TZstdDecompress() override {
+            ZSTD_freeDStream(Stream);
+        }
+
+    private:
+        size_t DoRead(void* buf, size_t len) override {
+            ZSTD_outBuffer output = {buf, len, 0};
+            while (output.pos == 0) {
+                if (Input.pos == Input.size) {
+                    Input.size = Slave->Read(InputBuffer.Data(), InputBuffer.Capacity());
+                    Input.pos = 0;
+                    if (Input.size == 0) {
+                        CB_ENSURE(FrameFinished, "Truncated zstd input");
+                        return 0;
+                    }
+                }
+                // next frame is started implicitly after the end of the previous one
+                FrameFinished = CheckResult(ZSTD_decompressStream(Stream, &output, &Input)) == 0;
+            }
+            return output.pos;
+        }
+
+        static size_t CheckResult(size_t result) {
+            CB_ENSURE(!ZSTD_isError(result), "zstd decompression failed: " << ZSTD_getErrorName(result));
+            return result;
+        }
+
+    private:
+        IInputStream* Slave;
+        ZSTD_DStream* Stream;
+        TBuffer InputBuffer;
+        ZSTD_inBuffer Input;
+        bool FrameFinished = true;
+    };
+
+
+    /* Blocks of blockcodecs stream are independent, so a batch of raw blocks is read sequentially
+       and decoded by the threads of localExecutor. Each block is decoded by TDecodedInput as a one block stream.
+    */
+    class TParallelBlockCodecsDecompress : public IInputStream {
+    public:
+        TParallelBlockCodecsDecompress(IInputStream* slave, NPar::TLocalExecutor* localExecutor)
+            : Slave(slave)
+            , LocalExecutor(localExecutor)
+            , BatchSize(2 * (localExecutor ? localExecutor->GetThreadCount() + 1 : 1))
+        {}
+
+    private:
+        size_t DoRead(void* buf, size_t len) override {
+            while (BlockIdx == DecodedBlocks.size() || Position == DecodedBlocks[BlockIdx].size()) {
+                if (BlockIdx + 1 < DecodedBlocks.size()) {
+                    ++BlockIdx;
+                    Position = 0;
+                } else if (!DecodeNextBatch()) {
+                    return 0;
+                }
+            }
+            const TString& block = DecodedBlocks[BlockIdx];
+            const size_t size = Min(len, block.size() - Position);
+            memcpy(buf, block.data() + Position, size);
+            Position += size;
+            return size;
+        }
+
+        bool DecodeNextBatch() {
+            TVector<TString> rawBlocks;
+            while (!Finished && rawBlocks.size() < BatchSize) {
+                char header[HeaderSize];
+                const size_t headerSize = Slave->Load(header, HeaderSize);
+                if (headerSize == 0) {
+                    Finished = true;
+                    break;
+                }
+                CB_ENSURE(headerSize == HeaderSize, "Truncated blockcodecs input");
+                const ui64 blockLen = ReadUnaligned<ui64>(header + sizeof(ui16));
+                if (blockLen == 0) {
+                    Finished = true;
+                    break;
+                }
+                CB_ENSURE(blockLen <= MaxBlockLen, "Block size exceeds 1 GiB in blockcodecs input");
+                TString rawBlock;
+                rawBlock.ReserveAndResize(HeaderSize + blockLen + HeaderSize);
+                char* data = rawBlock.begin();
+                memcpy(data, header, HeaderSize);
+                CB_ENSURE(Slave->Load(data + HeaderSize, blockLen) == blockLen, "Truncated blockcodecs input");
+                // zero length block terminates the stream
+                memset(data + HeaderSize + blockLen, 0, HeaderSize);
+                rawBlocks.push_back(std::move(rawBlock));
+            }
+
+            DecodedBlocks.clear();
+            DecodedBlocks.resize(rawBlocks.size());
+            auto decodeBlock = [&](int blockIdx) {
+                TMemoryInput rawInput(rawBlocks[blockIdx].data(), rawBlocks[blockIdx].size());
+                NBlockCodecs::TDecodedInput decodedInput(&rawInput);
+                DecodedBlocks[blockIdx] = decodedInput.ReadAll();
+            };
+            if (LocalExecutor) {
+                // may be called from a task of the same executor, the calling thread takes part in decoding
+                LocalExecutor->ExecRangeWithThrow(decodeBlock, 0, rawBlocks.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
+            } else {
+                for (int blockIdx = 0; blockIdx < rawBlocks.ysize(); ++blockIdx) {
+                    decodeBlock(blockIdx);
+                }
+            }
+            BlockIdx = 0;
+            Position = 0;
+            return !DecodedBlocks.empty();
+        }
+
+    private:
+        static constexpr size_t HeaderSize = sizeof(ui16) + sizeof(ui64); // codec id and block length
+        static constexpr ui64 MaxBlockLen = 1024 * 1024 * 1024;
+
+        IInputStream* Slave;
+        NPar::TLocalExecutor* LocalExecutor;
+        size_t BatchSize;
+        TVector<TString> DecodedBlocks;
+        size_t BlockIdx = 0;
+        size_t Position = 0;
+        bool Finished = false;
+    };
+
+
+    class TDecompressedFileInput : public IInputStream {
+    public:
+        TDecompressedFileInput(const TString& path, EInputCompression compression, NPar::TLocalExecutor* localExecutor)
+            : File(path)
+            , Decompress(MakeDecompress(&File, compression, localExecutor))
+            , Buffered(Decompress.Get(), 1 << 16)
+        {}
+
+    private:
+        static THolder<IInputStream> MakeDecompress(IInputStream* slave,
+                                                    EInputCompression compression,
+                                                    NPar::TLocalExecutor* localExecutor) {
+            switch (compression) {
+                case EInputCompression::Gzip:
+                    return MakeHolder<TZLibDecompress>(slave, ZLib::Auto);
+                case EInputCompression::Zstd:
+                    return MakeHolder<TZstdDecompress>(slave);
+                case EInputCompression::BlockCodecs:
+                    return MakeHolder<TParallelBlockCodecsDecompress>(slave, localExecutor);
+                default:
+                    Y_UNREACHABLE();
+            }
+        }
+
+        size_t DoRead(void* buf, size_t len) override {
+            return Buffered.Read(buf, len);
+        }
+
+        size_t DoReadTo(TString& st, char ch) override {
+            return Buffered.ReadTo(st, ch);
+        }
+
+        size_t DoSkip(size_t len) override {
+            return Buffered.Skip(len);
+        }
+
+    private:
+        TUnbufferedFileInput File;
+        THolder<IInputStream> Decompress;
+        TBufferedInput Buffered;
+    };
+
+    }
+
+
+    THolder<IInputStream> OpenFileInput(const TPathWithScheme& pathWithScheme,
+                                        NPar::TLocalExecutor* localExecutor) {
+        const EInputCompression compression = GetInputCompression(pathWithScheme);
+        if (compression == EInputCompression::None) {
+            return MakeHolder<TIFStream>(pathWithScheme.Path);
+        }
+        return MakeHolder<TDecompressedFileInput>(pathWithScheme.Path, compression, localExecutor);
+    }
+
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "path_with_scheme.h"
+
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/ptr.h>
+#include <util/stream/input.h>
+
+
+namespace NCB {
+
+    enum class EInputCompression {
+        None,
+        Gzip,        // gzip or zlib, concatenated streams are supported
+        Zstd,        // zstd frames
+        BlockCodecs  // library/blockcodecs framed stream, blocks are decoded in parallel
+    };
+
+    /* compression is selected by an explicit scheme ('gzip://', 'zstd://', 'blockcodecs://')
+       or by the file extension ('.gz', '.zst', '.zstd') for '', 'file' and 'dsv' schemes
+    */
+    EInputCompression GetInputCompression(const TPathWithScheme& pathWithScheme);
+
+    /* returns buffered stream with decompressed data of the file
+       blockcodecs blocks are decoded in parallel by localExecutor, or in the calling thread if it is nullptr
+    */
+    THolder<IInputStream> OpenFileInput(const TPathWithScheme& pathWithScheme,
+                                        NPar::TLocalExecutor* localExecutor = nullptr);
+
+}
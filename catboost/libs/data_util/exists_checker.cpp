@@ -23,6 +23,10 @@ namespace NCB {
     TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSExistsCheckerReg("");
     TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSFileExistsCheckerReg("file");
     TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSDsvExistsCheckerReg("dsv");
+    TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSQuantizedExistsCheckerReg("quantized");
+    TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSGzipExistsCheckerReg("gzip");
+    TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSZstdExistsCheckerReg("zstd");
+    TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSBlockCodecsExistsCheckerReg("blockcodecs");
 
     }
 }
@@ -1,5 +1,7 @@
 #include "line_data_reader.h"
 
+#include "compressed_input.h"
+
 #include <catboost/libs/helpers/exception.h>
 
 #include <util/stream/file.h>
@@ -9,23 +11,24 @@
 namespace NCB {
 
     THolder<ILineDataReader> GetLineDataReader(const TPathWithScheme& pathWithScheme,
-                                               const TDsvFormatOptions& format)
+                                               const TDsvFormatOptions& format,
+                                               NPar::TLocalExecutor* localExecutor)
     {
         return GetProcessor<ILineDataReader, TLineDataReaderArgs>(
-            pathWithScheme, TLineDataReaderArgs{pathWithScheme, format}
+            pathWithScheme, TLineDataReaderArgs{pathWithScheme, format, localExecutor}
         );
     }
 
 
     namespace {
 
-    template <class TStr>
-    inline int CountLines(const TStr& poolFile) {
-        CB_ENSURE(NFs::Exists(TString(poolFile)), "pool file '" << TString(poolFile) << "' is not found");
-        TIFStream reader(poolFile.c_str());
+    // compressed files are decompressed once more to count lines
+    inline int CountLines(const TPathWithScheme& poolFile, NPar::TLocalExecutor* localExecutor) {
+        CB_ENSURE(NFs::Exists(poolFile.Path), "pool file '" << poolFile.Path << "' is not found");
+        THolder<IInputStream> reader = OpenFileInput(poolFile, localExecutor);
         size_t count = 0;
         TString buffer;
-        while (reader.ReadLine(buffer)) {
+        while (reader->ReadLine(buffer)) {
             ++count;
         }
         return count;
@@ -35,12 +38,12 @@ namespace NCB {
     public:
         TFileLineDataReader(const TLineDataReaderArgs& args)
             : Args(args)
-            , IFStream(args.PathWithScheme.Path)
+            , Input(OpenFileInput(args.PathWithScheme, args.LocalExecutor))
             , HeaderProcessed(!Args.Format.HasHeader)
         {}
 
         ui64 GetDataLineCount() override {
-            ui64 nLines = (ui64)CountLines(Args.PathWithScheme.Path);
+            ui64 nLines = (ui64)CountLines(Args.PathWithScheme, Args.LocalExecutor);
             if (Args.Format.HasHeader) {
                 --nLines;
             }
@@ -51,7 +54,7 @@ namespace NCB {
             if (Args.Format.HasHeader) {
                 CB_ENSURE(!HeaderProcessed, "TFileLineDataReader: multiple calls to GetHeader");
                 TString header;
-                CB_ENSURE(IFStream.ReadLine(header), "TFileLineDataReader: no header in file");
+                CB_ENSURE(Input->ReadLine(header), "TFileLineDataReader: no header in file");
                 HeaderProcessed = true;
                 return header;
             }
@@ -64,12 +67,12 @@ namespace NCB {
             if (!HeaderProcessed) {
                 GetHeader();
             }
-            return IFStream.ReadLine(*line) != 0;
+            return Input->ReadLine(*line) != 0;
         }
 
     private:
         TLineDataReaderArgs Args;
-        TIFStream IFStream;
+        THolder<IInputStream> Input;
         bool HeaderProcessed;
     };
 
@@ -77,6 +80,9 @@ namespace NCB {
     TLineDataReaderFactory::TRegistrator<TFileLineDataReader> DefLineDataReaderReg("");
     TLineDataReaderFactory::TRegistrator<TFileLineDataReader> FileLineDataReaderReg("file");
     TLineDataReaderFactory::TRegistrator<TFileLineDataReader> DsvLineDataReaderReg("dsv");
+    TLineDataReaderFactory::TRegistrator<TFileLineDataReader> GzipLineDataReaderReg("gzip");
+    TLineDataReaderFactory::TRegistrator<TFileLineDataReader> ZstdLineDataReaderReg("zstd");
+    TLineDataReaderFactory::TRegistrator<TFileLineDataReader> BlockCodecsLineDataReaderReg("blockcodecs");
 
     }
 }
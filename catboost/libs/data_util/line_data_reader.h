@@ -3,6 +3,7 @@
 #include "path_with_scheme.h"
 
 #include <library/object_factory/object_factory.h>
+#include <library/threading/local_executor/local_executor.h>
 
 #include <util/generic/maybe.h>
 #include <util/generic/string.h>
@@ -19,6 +20,7 @@ namespace NCB {
     struct TLineDataReaderArgs {
         TPathWithScheme PathWithScheme;
         TDsvFormatOptions Format;
+        NPar::TLocalExecutor* LocalExecutor = nullptr; // decodes compressed input, if it allows parallel decoding
     };
 
 
@@ -45,6 +47,7 @@ namespace NCB {
         NObjectFactory::TParametrizedObjectFactory<ILineDataReader, TString, TLineDataReaderArgs>;
 
     THolder<ILineDataReader> GetLineDataReader(const TPathWithScheme& pathWithScheme,
-                                               const TDsvFormatOptions& format = {});
+                                               const TDsvFormatOptions& format = {},
+                                               NPar::TLocalExecutor* localExecutor = nullptr);
 
 }
@@ -0,0 +1,54 @@
+#include "line_ranges.h"
+
+#include <util/generic/algorithm.h>
+
+
+namespace NCB {
+
+    static ui64 CountLines(TStringBuf data) {
+        ui64 lineCount = 0;
+        const char* begin = data.data();
+        const char* const end = data.data() + data.size();
+        // memchr is vectorized in libc, so it is much faster than a byte loop on long lines
+        while (const char* lineEnd = static_cast<const char*>(std::memchr(begin, '\n', end - begin))) {
+            ++lineCount;
+            begin = lineEnd + 1;
+        }
+        return lineCount + (begin != end);
+    }
+
+    TVector<TLineRange> SplitToLineRanges(TStringBuf data, size_t rangeCount, NPar::TLocalExecutor* localExecutor) {
+        Y_VERIFY(rangeCount > 0);
+
+        TVector<TLineRange> ranges;
+        const size_t approximateRangeSize = Max<size_t>(1, data.size() / rangeCount);
+        size_t rangeBegin = 0;
+        while (rangeBegin < data.size()) {
+            size_t rangeEnd = data.size();
+            if (data.size() - rangeBegin > approximateRangeSize) {
+                const char* const lineEnd = static_cast<const char*>(std::memchr(
+                    data.data() + rangeBegin + approximateRangeSize - 1,
+                    '\n',
+                    data.size() - rangeBegin - approximateRangeSize + 1));
+                if (lineEnd) {
+                    rangeEnd = lineEnd - data.data() + 1;
+                }
+            }
+            ranges.emplace_back();
+            ranges.back().Data = data.SubStr(rangeBegin, rangeEnd - rangeBegin);
+            rangeBegin = rangeEnd;
+        }
+
+        localExecutor->ExecRange([&](int rangeIdx) {
+            ranges[rangeIdx].LineCount = CountLines(ranges[rangeIdx].Data);
+        }, 0, ranges.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
+
+        ui64 lineCount = 0;
+        for (auto& range : ranges) {
+            range.FirstLineIdx = lineCount;
+            lineCount += range.LineCount;
+        }
+        return ranges;
+    }
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/strbuf.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+#include <cstring>
+
+
+namespace NCB {
+
+    // Part of text data consisting of whole lines
+    struct TLineRange {
+        TStringBuf Data;
+        ui64 FirstLineIdx = 0; // index of the first line of the range in the whole data
+        ui64 LineCount = 0;
+    };
+
+    /* Splits `data` at line boundaries to at most `rangeCount` ranges of about the same size
+       and counts their lines in parallel, ranges follow in the data order.
+       The last line might not end with '\n'.
+    */
+    TVector<TLineRange> SplitToLineRanges(TStringBuf data, size_t rangeCount, NPar::TLocalExecutor* localExecutor);
+
+    // Calls `onLine(TStringBuf line)` for lines of `data`, '\r' before '\n' is removed
+    template <class TOnLine>
+    inline void ForEachLine(TStringBuf data, TOnLine&& onLine) {
+        const char* begin = data.data();
+        const char* const end = data.data() + data.size();
+        while (begin != end) {
+            const char* lineEnd = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+            const char* const next = lineEnd ? lineEnd + 1 : end;
+            if (!lineEnd) {
+                lineEnd = end;
+            }
+            if (lineEnd != begin && *(lineEnd - 1) == '\r') {
+                --lineEnd;
+            }
+            onLine(TStringBuf(begin, lineEnd));
+            begin = next;
+        }
+    }
+
+    // Calls `onField(TStringBuf field)` for `delimiter` separated fields of `line` without allocations
+    template <class TOnField>
+    inline void ForEachField(TStringBuf line, char delimiter, TOnField&& onField) {
+        const char* begin = line.data();
+        const char* const end = line.data() + line.size();
+        for (;;) {
+            const char* const fieldEnd = static_cast<const char*>(std::memchr(begin, delimiter, end - begin));
+            if (!fieldEnd) {
+                onField(TStringBuf(begin, end));
+                return;
+            }
+            onField(TStringBuf(begin, fieldEnd));
+            begin = fieldEnd + 1;
+        }
+    }
+
+}
@@ -0,0 +1,115 @@
+#include <library/unittest/registar.h>
+
+#include <catboost/libs/data_util/compressed_input.h>
+#include <catboost/libs/data_util/line_data_reader.h>
+
+#include <contrib/libs/zstd/zstd.h>
+
+#include <library/blockcodecs/codecs.h>
+#include <library/blockcodecs/stream.h>
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/folder/dirut.h>
+#include <util/folder/path.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/stream/file.h>
+#include <util/stream/zlib.h>
+#include <util/string/cast.h>
+
+
+using namespace NCB;
+
+
+static TVector<TString> MakeLines() {
+    TVector<TString> lines;
+    for (int i = 0; i < 10000; ++i) {
+        lines.push_back(ToString(i) + "\t" + ToString(i % 13) + "\tfeature" + ToString(i * 7));
+    }
+    return lines;
+}
+
+static void CheckReadLines(const TPathWithScheme& pathWithScheme,
+                           const TVector<TString>& expectedLines,
+                           NPar::TLocalExecutor* localExecutor = nullptr) {
+    auto reader = GetLineDataReader(pathWithScheme, TDsvFormatOptions{/*HasHeader*/ true, '\t'}, localExecutor);
+    UNIT_ASSERT_VALUES_EQUAL(reader->GetDataLineCount(), expectedLines.size() - 1);
+    UNIT_ASSERT_VALUES_EQUAL(*reader->GetHeader(), expectedLines[0]);
+    TVector<TString> lines = {expectedLines[0]};
+    TString line;
+    while (reader->ReadLine(&line)) {
+        lines.push_back(line);
+    }
+    UNIT_ASSERT_EQUAL(lines, expectedLines);
+}
+
+
+Y_UNIT_TEST_SUITE(CompressedInput) {
+    Y_UNIT_TEST(GetInputCompression) {
+        UNIT_ASSERT_EQUAL(GetInputCompression(TPathWithScheme("pool.tsv", "dsv")), EInputCompression::None);
+        UNIT_ASSERT_EQUAL(GetInputCompression(TPathWithScheme("pool.tsv.gz", "dsv")), EInputCompression::Gzip);
+        UNIT_ASSERT_EQUAL(GetInputCompression(TPathWithScheme("pool.zst")), EInputCompression::Zstd);
+        UNIT_ASSERT_EQUAL(GetInputCompression(TPathWithScheme("gzip://pool")), EInputCompression::Gzip);
+        UNIT_ASSERT_EQUAL(GetInputCompression(TPathWithScheme("blockcodecs://pool.gz")), EInputCompression::BlockCodecs);
+        UNIT_ASSERT_EQUAL(GetInputCompression(TPathWithScheme("quantized://pool.gz")), EInputCompression::None);
+    }
+
+    Y_UNIT_TEST(ReadGzip) {
+        const auto lines = MakeLines();
+        const auto path = TFsPath(GetSystemTempDir()) / "pool.tsv.gz";
+        {
+            // concatenated gzip streams
+            TFileOutput output(path.GetPath());
+            for (size_t part = 0; part < 2; ++part) {
+                TZLibCompress compress(&output, ZLib::GZip);
+                for (size_t i = part * lines.size() / 2; i < (part + 1) * lines.size() / 2; ++i) {
+                    compress << lines[i] << '\n';
+                }
+                compress.Finish();
+            }
+        }
+        CheckReadLines(TPathWithScheme(path.GetPath(), "dsv"), lines);
+    }
+
+    Y_UNIT_TEST(ReadZstd) {
+        const auto lines = MakeLines();
+        const auto path = TFsPath(GetSystemTempDir()) / "pool.tsv";
+        {
+            // several frames
+            TFileOutput output(path.GetPath());
+            for (size_t part = 0; part < 3; ++part) {
+                TString data;
+                const size_t end = part == 2 ? lines.size() : (part + 1) * lines.size() / 3;
+                for (size_t i = part * lines.size() / 3; i < end; ++i) {
+                    data += lines[i] + "\n";
+                }
+                TString compressed;
+                compressed.ReserveAndResize(ZSTD_compressBound(data.size()));
+                const size_t size = ZSTD_compress(compressed.begin(), compressed.size(), data.data(), data.size(), 1);
+                UNIT_ASSERT(!ZSTD_isError(size));
+                output.Write(compressed.data(), size);
+            }
+        }
+        CheckReadLines(TPathWithScheme("zstd://" + path.GetPath()), lines);
+    }
+
+    Y_UNIT_TEST(ReadBlockCodecs) {
+        const auto lines = MakeLines();
+        const auto path = TFsPath(GetSystemTempDir()) / "pool.tsv.lz4";
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+        for (const auto& codecName : {"lz4", "zstd_1"}) {
+            {
+                // small blocks to decode several batches
+                TFileOutput output(path.GetPath());
+                NBlockCodecs::TCodedOutput compress(&output, NBlockCodecs::Codec(codecName), 1000);
+                for (const auto& line : lines) {
+                    compress << line << '\n';
+                }
+                compress.Finish();
+            }
+            CheckReadLines(TPathWithScheme("blockcodecs://" + path.GetPath()), lines);
+            CheckReadLines(TPathWithScheme("blockcodecs://" + path.GetPath()), lines, &localExecutor);
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#include <library/unittest/registar.h>
+
+#include <catboost/libs/data_util/line_ranges.h>
+
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/string/cast.h>
+
+
+using namespace NCB;
+
+
+Y_UNIT_TEST_SUITE(LineRanges) {
+    Y_UNIT_TEST(ForEachLineAndField) {
+        TVector<TString> lines;
+        ForEachLine("a\tb\r\n\nc\t\td", [&](TStringBuf line) { lines.push_back(TString(line)); });
+        UNIT_ASSERT_EQUAL(lines, TVector<TString>({"a\tb", "", "c\t\td"}));
+
+        TVector<TString> fields;
+        ForEachField(lines[2], '\t', [&](TStringBuf field) { fields.push_back(TString(field)); });
+        UNIT_ASSERT_EQUAL(fields, TVector<TString>({"c", "", "d"}));
+    }
+
+    Y_UNIT_TEST(SplitToLineRanges) {
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        TString data;
+        for (int i = 0; i < 1000; ++i) {
+            data += TString(i % 7, 'x') + ToString(i) + "\n";
+        }
+        data += "last";
+
+        for (size_t rangeCount : {1, 3, 16, 5000}) {
+            const auto ranges = SplitToLineRanges(data, rangeCount, &localExecutor);
+            UNIT_ASSERT(!ranges.empty() && ranges.size() <= rangeCount);
+
+            TVector<TString> lines;
+            ui64 lineIdx = 0;
+            for (const auto& range : ranges) {
+                UNIT_ASSERT_VALUES_EQUAL(range.FirstLineIdx, lineIdx);
+                ForEachLine(range.Data, [&](TStringBuf line) { lines.push_back(TString(line)); });
+                lineIdx += range.LineCount;
+                UNIT_ASSERT_VALUES_EQUAL(lines.size(), lineIdx);
+            }
+            UNIT_ASSERT_VALUES_EQUAL(lines.size(), 1001);
+            UNIT_ASSERT_VALUES_EQUAL(lines[10], "xxx10");
+            UNIT_ASSERT_VALUES_EQUAL(lines.back(), "last");
+        }
+    }
+}
@@ -37,11 +37,11 @@ public:
 };
 
 struct TStats3D {
-    TVector<TBucketStats> Stats; // [bodyTail & approxDim][leaf][bucket]
+    TVector<TPlainBucketStats> Stats; // [bodyTail & approxDim][leaf][bucket], distributed training supports plain boosting only
     int BucketCount;
     int MaxLeafCount;
     TStats3D() = default;
-    TStats3D(const TVector<TBucketStats>& stats, int bucketCount, int maxLeafCount)
+    TStats3D(const TVector<TPlainBucketStats>& stats, int bucketCount, int maxLeafCount)
     : Stats(stats)
     , BucketCount(bucketCount)
     , MaxLeafCount(maxLeafCount)
@@ -30,7 +30,8 @@ void TPlainFoldBuilder::DoMap(NPar::IUserContext* ctx, int hostId, TInput* /*unu
     localData.SmallestSplitSideDocs.Create({plainFold}, isPairwiseScoring);
     localData.PrevTreeLevelStats.Create({plainFold},
         CountNonCtrBuckets(trainData->SplitCounts, trainData->TrainData.AllFeatures.OneHotValues),
-        localData.Params.ObliviousTreeOptions->MaxDepth);
+        localData.Params.ObliviousTreeOptions->MaxDepth,
+        sizeof(TPlainBucketStats));
     localData.Indices.yresize(plainFold.LearnPermutation.ysize());
     localData.AllDocCount = trainData->AllDocCount;
     localData.SumAllWeights = trainData->SumAllWeights;
@@ -116,8 +117,8 @@ void TRemoteBinCalcer::DoReduce(TVector<TOutput>* bucketStatsFromAllWorkers, TOu
             const auto& stats = (*bucketStatsFromAllWorkers)[workerIdx][subcandidateIdx];
             const int splitStatsCount = stats.BucketCount * stats.MaxLeafCount;
             for (int statsIdx = 0; statsIdx * splitStatsCount < stats.Stats.ysize(); ++statsIdx) { // bodytail + dim
-                TBucketStats* firstStatsData = GetDataPtr((*bucketStats)[subcandidateIdx].Stats) + statsIdx * splitStatsCount;
-                const TBucketStats* statsData = GetDataPtr(stats.Stats) + statsIdx * splitStatsCount;
+                TPlainBucketStats* firstStatsData = GetDataPtr((*bucketStats)[subcandidateIdx].Stats) + statsIdx * splitStatsCount;
+                const TPlainBucketStats* statsData = GetDataPtr(stats.Stats) + statsIdx * splitStatsCount;
                 for (int bucketIdx = 0; bucketIdx < stats.BucketCount * leafCount; ++bucketIdx) { // bucket, leaf
                     firstStatsData[bucketIdx].Add(statsData[bucketIdx]);
                 }
@@ -29,9 +29,31 @@ static TVector<TVector<TData>> GetWorkerPart(const TVector<TVector<TData>>& mast
     return workerPart;
 }
 
+static TVector<ui8> GetWorkerPart(const TAllFeatures& allFeatures, int floatFeatureIdx, const std::pair<size_t, size_t>& part) {
+    if (!allFeatures.IsFloatHistogramPacked(floatFeatureIdx)) {
+        return GetWorkerPart(allFeatures.FloatHistograms[floatFeatureIdx], part);
+    }
+    const size_t docCount = allFeatures.GetDocCount();
+    if (allFeatures.FloatHistograms[floatFeatureIdx].empty() || part.first >= docCount) {
+        return TVector<ui8>();
+    }
+    const TFloatHistogramRef histogram = allFeatures.GetFloatHistogram(floatFeatureIdx);
+    TVector<ui8> workerPart;
+    for (size_t doc = part.first; doc < Min(part.second, docCount); ++doc) {
+        workerPart.push_back(histogram[doc]);
+    }
+    PackFloatHistogram(histogram.BitsPerBinLog2, &workerPart);
+    return workerPart;
+}
+
 static TAllFeatures GetWorkerPart(const TAllFeatures& allFeatures, const std::pair<size_t, size_t>& part) {
     TAllFeatures workerPart;
-    workerPart.FloatHistograms = GetWorkerPart(allFeatures.FloatHistograms, part);
+    for (int floatFeatureIdx = 0; floatFeatureIdx < allFeatures.FloatHistograms.ysize(); ++floatFeatureIdx) {
+        workerPart.FloatHistograms.emplace_back(GetWorkerPart(allFeatures, floatFeatureIdx, part));
+    }
+    workerPart.FloatHistogramBitsLog2 = allFeatures.FloatHistogramBitsLog2;
+    const size_t docCount = allFeatures.GetDocCount();
+    workerPart.PackedDocCount = part.first < docCount ? Min(part.second, docCount) - part.first : 0;
     workerPart.CatFeaturesRemapped = GetWorkerPart(allFeatures.CatFeaturesRemapped, part);
     workerPart.OneHotValues = GetWorkerPart(allFeatures.OneHotValues, part);
     workerPart.IsOneHot = allFeatures.IsOneHot;
@@ -145,8 +167,8 @@ void MapCalcScore(double scoreStDev, int depth, TCandidateList* candidateList, T
                 const auto& stats = allStatsFromAllWorkers[workerIdx].Data[candidateIdx][subcandidateIdx];
                 const int splitStatsCount = firstStats.BucketCount * firstStats.MaxLeafCount;
                 for (int statsIdx = 0; statsIdx * splitStatsCount < firstStats.Stats.ysize(); ++statsIdx) {
-                    TBucketStats* firstStatsData = GetDataPtr(firstStats.Stats) + statsIdx * splitStatsCount;
-                    const TBucketStats* statsData = GetDataPtr(stats.Stats) + statsIdx * splitStatsCount;
+                    TPlainBucketStats* firstStatsData = GetDataPtr(firstStats.Stats) + statsIdx * splitStatsCount;
+                    const TPlainBucketStats* statsData = GetDataPtr(stats.Stats) + statsIdx * splitStatsCount;
                     for (int bucketIdx = 0; bucketIdx < firstStats.BucketCount * leafCount; ++bucketIdx) {
                         firstStatsData[bucketIdx].Add(statsData[bucketIdx]);
                     }
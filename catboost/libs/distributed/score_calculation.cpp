@@ -11,15 +11,14 @@ static void CalcStatsImpl(const TIsCaching& isCaching,
         const TStatsIndexer& indexer,
         int depth,
         int splitStatsCount,
-        TBucketStats* splitStats) {
+        TPlainBucketStats* splitStats) {
     Y_ASSERT(!isCaching || depth > 0);
     const int approxDimension = fold.GetApproxDimension();
     for (int bodyTailIdx = 0; bodyTailIdx < fold.GetBodyTailCount(); ++bodyTailIdx) {
         const auto& bt = fold.BodyTailArr[bodyTailIdx];
         for (int dim = 0; dim < approxDimension; ++dim) {
-            TBucketStats* stats = splitStats + (bodyTailIdx * approxDimension + dim) * splitStatsCount;
-            const bool isPlainMode = true;
-            CalcStatsKernel(isCaching, singleIdx, fold, isPlainMode, indexer, depth, bt, dim, stats);
+            TPlainBucketStats* stats = splitStats + (bodyTailIdx * approxDimension + dim) * splitStatsCount;
+            CalcStatsKernel(isCaching, singleIdx, fold, indexer, depth, bt, dim, stats);
         }
     }
 }
@@ -37,44 +36,44 @@ TStats3D CalcStats3D(const TAllFeatures& af,
     const TStatsIndexer indexer(bucketCount);
     const int bucketIndexBits = GetValueBitCount(bucketCount) + depth + 1;
 
-    decltype(auto) SelectCalcStatsImpl = [&] (auto isCaching, const TCalcScoreFold& fold, int splitStatsCount, auto* splitStats) {
+    decltype(auto) SelectCalcStatsImpl = [&] (auto isCaching, const TCalcScoreFold& fold, int splitStatsCount, TPlainBucketStats* splitStats) {
         const bool isPlainMode = IsPlainMode(fitParams.BoostingOptions->BoostingType);
         Y_VERIFY(isPlainMode, "Only plain mode is supported for distributed training");
         if (bucketIndexBits <= 8) {
             TVector<ui8> singleIdx;
             BuildSingleIndex(fold, af, allCtrs, split, indexer, &singleIdx);
-            CalcStatsImpl(isCaching, singleIdx, fold, indexer, depth, splitStatsCount, GetDataPtr(*splitStats));
+            CalcStatsImpl(isCaching, singleIdx, fold, indexer, depth, splitStatsCount, splitStats);
         } else if (bucketIndexBits <= 16) {
             TVector<ui16> singleIdx;
             BuildSingleIndex(fold, af, allCtrs, split, indexer, &singleIdx);
-            CalcStatsImpl(isCaching, singleIdx, fold, indexer, depth, splitStatsCount, GetDataPtr(*splitStats));
+            CalcStatsImpl(isCaching, singleIdx, fold, indexer, depth, splitStatsCount, splitStats);
         } else if (bucketIndexBits <= 32) {
             TVector<ui32> singleIdx;
             BuildSingleIndex(fold, af, allCtrs, split, indexer, &singleIdx);
-            CalcStatsImpl(isCaching, singleIdx, fold, indexer, depth, splitStatsCount, GetDataPtr(*splitStats));
+            CalcStatsImpl(isCaching, singleIdx, fold, indexer, depth, splitStatsCount, splitStats);
         } else {
             CB_ENSURE(false, "too deep or too much splitsCount for score calculation");
         }
     };
     const auto& treeOptions = fitParams.ObliviousTreeOptions.Get();
     if (!IsSamplingPerTree(treeOptions)) {
-        TVector<TBucketStats> scratchSplitStats;
+        TVector<TPlainBucketStats> scratchSplitStats;
         const int splitStatsCount = indexer.CalcSize(depth);
         const int statsCount = fold.GetBodyTailCount() * fold.GetApproxDimension() * splitStatsCount;
         scratchSplitStats.yresize(statsCount);
-        SelectCalcStatsImpl(/*isCaching*/ std::false_type(), fold, splitStatsCount, &scratchSplitStats);
+        SelectCalcStatsImpl(/*isCaching*/ std::false_type(), fold, splitStatsCount, GetDataPtr(scratchSplitStats));
         return TStats3D(scratchSplitStats, bucketCount, 1U << depth);
     } else {
         const int splitStatsCount = indexer.CalcSize(treeOptions.MaxDepth);
         const int statsCount = fold.GetBodyTailCount() * fold.GetApproxDimension() * splitStatsCount;
         bool areStatsDirty;
-        TVector<TBucketStats, TPoolAllocator>& splitStats = statsFromPrevTree->GetStats(split, statsCount, &areStatsDirty); // thread-safe access
+        TPlainBucketStats* splitStats = statsFromPrevTree->GetStats<TPlainBucketStats>(split, statsCount, &areStatsDirty); // thread-safe access
         if (depth == 0 || areStatsDirty) {
-            SelectCalcStatsImpl(/*isCaching*/ std::false_type(), fold, splitStatsCount, &splitStats);
+            SelectCalcStatsImpl(/*isCaching*/ std::false_type(), fold, splitStatsCount, splitStats);
         } else {
-            SelectCalcStatsImpl(/*isCaching*/ std::true_type(), prevLevelData, splitStatsCount, &splitStats);
+            SelectCalcStatsImpl(/*isCaching*/ std::true_type(), prevLevelData, splitStatsCount, splitStats);
         }
-        return TStats3D(TVector<TBucketStats>(splitStats.begin(), splitStats.end()), bucketCount, 1U << treeOptions.MaxDepth);
+        return TStats3D(TVector<TPlainBucketStats>(splitStats, splitStats + statsCount), bucketCount, 1U << treeOptions.MaxDepth);
     }
     CB_ENSURE(false, "too deep or too much splitsCount for score calculation");
 }
@@ -86,7 +85,7 @@ TVector<TScoreBin> GetScoreBins(
         double sumAllWeights,
         int allDocCount,
         const NCatboostOptions::TCatBoostOptions& fitParams) {
-    const TVector<TBucketStats>& bucketStats = stats.Stats;
+    const TVector<TPlainBucketStats>& bucketStats = stats.Stats;
     const int splitStatsCount = stats.BucketCount * stats.MaxLeafCount;
     const int bucketCount = stats.BucketCount;
     const float l2Regularizer = static_cast<const float>(fitParams.ObliviousTreeOptions->L2Reg);
@@ -94,8 +93,8 @@ TVector<TScoreBin> GetScoreBins(
     const TStatsIndexer indexer(bucketCount);
     TVector<TScoreBin> scoreBin(bucketCount);
     for (int statsIdx = 0; statsIdx * splitStatsCount < bucketStats.ysize(); ++statsIdx) {
-        const TBucketStats* stats = GetDataPtr(bucketStats) + statsIdx * splitStatsCount;
-        UpdateScoreBin(stats, leafCount, indexer, splitType, l2Regularizer, /*isPlainMode=*/std::true_type(), sumAllWeights, allDocCount, &scoreBin);
+        const TPlainBucketStats* stats = GetDataPtr(bucketStats) + statsIdx * splitStatsCount;
+        UpdateScoreBin(stats, leafCount, indexer, splitType, l2Regularizer, sumAllWeights, allDocCount, &scoreBin);
     }
     return scoreBin;
 }
@@ -2,6 +2,7 @@
 
 #include <util/generic/array_ref.h>
 #include <util/digest/numeric.h>
+#include <util/system/compiler.h>
 
 namespace NCatboost {
 
@@ -43,6 +44,16 @@ namespace NCatboost {
             return NotFoundIndex;
         }
 
+        //! Same as GetIndex for each hash, but first bucket of every hash is prefetched before probing
+        void GetIndexes(TConstArrayRef<ui64> hashes, ui32* result) const {
+            for (const ui64 hash : hashes) {
+                Y_PREFETCH_READ(&Buckets[hash & HashMask], 3);
+            }
+            for (size_t i = 0; i < hashes.size(); ++i) {
+                result[i] = GetIndex(hashes[i]);
+            }
+        }
+
         const TConstArrayRef<TBucket> GetBuckets() const {
             return Buckets;
         }
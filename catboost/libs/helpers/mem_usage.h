@@ -2,8 +2,15 @@
 
 #include <catboost/libs/logging/logging.h>
 
+#include <util/system/mem_info.h>
 #include <util/system/rusage.h>
 
 inline void DumpMemUsage(const TString& msg) {
     MATRIXNET_DEBUG_LOG << "Mem usage: " << msg << ": " << TRusage::Get().Rss << Endl;
 }
+
+// Bytes that can be allocated before RSS of the process exceeds usedRamLimit
+inline ui64 GetAvailableMemory(ui64 usedRamLimit) {
+    const ui64 bytesUsed = NMemInfo::GetMemInfo().RSS;
+    return usedRamLimit > bytesUsed ? usedRamLimit - bytesUsed : 0;
+}
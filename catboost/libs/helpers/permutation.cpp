@@ -33,6 +33,10 @@ void ApplyPermutation(const TVector<ui64>& permutation, TPool* pool, NPar::TLoca
         localExecutor->ExecRange([&] (int factorIdx) {
             ApplyPermutation(permutation, &pool->Docs.Factors[factorIdx]);
         }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
+        NPar::TLocalExecutor::TExecRangeParams quantizedBlockParams(0, pool->Docs.QuantizedFactors.ysize());
+        localExecutor->ExecRange([&] (int factorIdx) {
+            ApplyPermutation(permutation, &pool->Docs.QuantizedFactors[factorIdx]);
+        }, quantizedBlockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
 
         for (int dim = 0; dim < pool->Docs.GetBaselineDimension(); ++dim) {
             ApplyPermutation(permutation, &pool->Docs.Baseline[dim]);
@@ -2,7 +2,10 @@
 
 #include <util/generic/algorithm.h>
 
+#include <cmath>
+
 using NMetrics::TSample;
+using NMetrics::TBinClassSample;
 
 static double MergeAndCountInversions(TVector<TSample>* samples, TVector<TSample>* aux, ui32 lo, ui32 hi, ui32 mid) {
     double result = 0;
@@ -76,3 +79,121 @@ double CalcAUC(TVector<TSample>* samples, double* outWeightSum, double* outPairW
     return (optimisticAUC + pessimisticAUC) / 2.0;
 }
 
+
+static bool ComparePredictions(const TBinClassSample& left, const TBinClassSample& right) {
+    return left.Prediction < right.Prediction;
+}
+
+// Blocks are sorted in parallel and then merged pairwise, every merge round is parallel too
+static void ParallelSortByPrediction(TVector<TBinClassSample>* samples, NPar::TLocalExecutor* executor) {
+    const int sampleCount = samples->ysize();
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, sampleCount);
+    blockParams.SetBlockCount(executor->GetThreadCount() + 1);
+    const int blockSize = blockParams.GetBlockSize();
+    if (blockSize == 0 || blockSize >= sampleCount) {
+        Sort(samples->begin(), samples->end(), ComparePredictions);
+        return;
+    }
+    auto begin = samples->begin();
+    NPar::ParallelFor(*executor, 0, blockParams.GetBlockCount(), [&](int blockId) {
+        const int from = blockId * blockSize;
+        const int to = Min(from + blockSize, sampleCount);
+        Sort(begin + from, begin + to, ComparePredictions);
+    });
+    for (int sortedSize = blockSize; sortedSize < sampleCount; sortedSize *= 2) {
+        const int mergeCount = (sampleCount + 2 * sortedSize - 1) / (2 * sortedSize);
+        NPar::ParallelFor(*executor, 0, mergeCount, [&](int mergeIdx) {
+            const int from = mergeIdx * 2 * sortedSize;
+            const int middle = Min(from + sortedSize, sampleCount);
+            const int to = Min(from + 2 * sortedSize, sampleCount);
+            std::inplace_merge(begin + from, begin + middle, begin + to, ComparePredictions);
+        });
+    }
+}
+
+static double SumWeights(const TVector<TBinClassSample>& samples) {
+    double weightSum = 0;
+    for (const auto& sample : samples) {
+        weightSum += sample.Weight;
+    }
+    return weightSum;
+}
+
+double CalcBinClassAUC(
+    TVector<TBinClassSample>* positiveSamples,
+    TVector<TBinClassSample>* negativeSamples,
+    NPar::TLocalExecutor* executor
+) {
+    const double pairWeightSum = SumWeights(*positiveSamples) * SumWeights(*negativeSamples);
+    if (pairWeightSum == 0) {
+        return 0;
+    }
+    ParallelSortByPrediction(positiveSamples, executor);
+    ParallelSortByPrediction(negativeSamples, executor);
+
+    const auto& negatives = *negativeSamples;
+    TVector<double> negativeWeightPrefix(negatives.size() + 1);
+    for (ui32 i = 0; i < negatives.size(); ++i) {
+        negativeWeightPrefix[i + 1] = negativeWeightPrefix[i] + negatives[i].Weight;
+    }
+
+    // every positive sample wins against negatives with lower prediction and counts ties as half
+    const auto& positives = *positiveSamples;
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, positives.ysize());
+    blockParams.SetBlockCount(executor->GetThreadCount() + 1);
+    const int blockSize = blockParams.GetBlockSize();
+    TVector<double> blockWinWeights(blockParams.GetBlockCount());
+    NPar::ParallelFor(*executor, 0, blockParams.GetBlockCount(), [&](int blockId) {
+        const int from = blockId * blockSize;
+        const int to = Min<int>(from + blockSize, positives.ysize());
+        auto lowerIt = LowerBound(negatives.begin(), negatives.end(), positives[from], ComparePredictions);
+        auto upperIt = lowerIt;
+        double winWeight = 0;
+        for (int i = from; i < to; ++i) {
+            const double prediction = positives[i].Prediction;
+            while (lowerIt != negatives.end() && lowerIt->Prediction < prediction) {
+                ++lowerIt;
+            }
+            if (upperIt < lowerIt) {
+                upperIt = lowerIt;
+            }
+            while (upperIt != negatives.end() && upperIt->Prediction <= prediction) {
+                ++upperIt;
+            }
+            const double lowerWeight = negativeWeightPrefix[lowerIt - negatives.begin()];
+            const double upperWeight = negativeWeightPrefix[upperIt - negatives.begin()];
+            winWeight += positives[i].Weight * (lowerWeight + (upperWeight - lowerWeight) / 2);
+        }
+        blockWinWeights[blockId] = winWeight;
+    });
+
+    double winWeightSum = 0;
+    for (double winWeight : blockWinWeights) {
+        winWeightSum += winWeight;
+    }
+    return winWeightSum / pairWeightSum;
+}
+
+ui32 GetAUCHistogramBin(double prediction, ui32 binCount) {
+    const double probability = 1 / (1 + exp(-prediction));
+    if (!(probability > 0)) {
+        return 0;
+    }
+    return Min<ui32>(static_cast<ui32>(probability * binCount), binCount - 1);
+}
+
+double CalcAUCFromHistogram(TConstArrayRef<double> histogramStats) {
+    Y_ASSERT(histogramStats.size() % 2 == 0);
+    double positiveWeightSum = 0;
+    double negativeWeightSum = 0;
+    double winWeightSum = 0;
+    for (ui32 bin = 0; bin * 2 < histogramStats.size(); ++bin) {
+        const double positiveWeight = histogramStats[2 * bin];
+        const double negativeWeight = histogramStats[2 * bin + 1];
+        winWeightSum += positiveWeight * (negativeWeightSum + negativeWeight / 2);
+        positiveWeightSum += positiveWeight;
+        negativeWeightSum += negativeWeight;
+    }
+    const double pairWeightSum = positiveWeightSum * negativeWeightSum;
+    return pairWeightSum == 0 ? 0 : winWeightSum / pairWeightSum;
+}
@@ -2,4 +2,19 @@
 
 #include "sample.h"
 
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/array_ref.h>
+
 double CalcAUC(TVector<NMetrics::TSample>* samples, double* outWeightSum = nullptr, double* outPairWeightSum = nullptr);
+
+// Exact AUC for binary targets with the same tie handling as CalcAUC, samples are sorted in place
+double CalcBinClassAUC(
+    TVector<NMetrics::TBinClassSample>* positiveSamples,
+    TVector<NMetrics::TBinClassSample>* negativeSamples,
+    NPar::TLocalExecutor* executor);
+
+// Approximate AUC is calculated from histogram of predictions which is additive across documents.
+// Histogram stats hold weights of positive and negative samples for every bin: [pos_0, neg_0, pos_1, neg_1, ...]
+ui32 GetAUCHistogramBin(double prediction, ui32 binCount);
+double CalcAUCFromHistogram(TConstArrayRef<double> histogramStats);
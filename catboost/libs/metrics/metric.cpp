@@ -424,6 +424,62 @@ void TMedianAbsoluteErrorMetric::GetBestValue(EMetricBestValue* valueType, float
     *valueType = EMetricBestValue::Min;
 }
 
+/* Approximate median absolute error */
+
+TApproxMedianAbsoluteErrorMetric::TApproxMedianAbsoluteErrorMetric(double relativeAccuracy, double minError, double maxError)
+    : RelativeAccuracy(relativeAccuracy)
+    , SketchBins(relativeAccuracy, minError, maxError)
+{
+}
+
+TMetricHolder TApproxMedianAbsoluteErrorMetric::EvalSingleThread(
+        const TVector<TVector<double>>& approx,
+        const TVector<float>& target,
+        const TVector<float>& /*weight*/,
+        const TVector<TQueryInfo>& /*queriesInfo*/,
+        int begin,
+        int end
+) const {
+    CB_ENSURE(approx.size() == 1, "Metric Median absolute error supports only single-dimensional data");
+    const auto& approxVec = approx.front();
+    Y_ASSERT(approxVec.size() == target.size());
+
+    // documents are not weighted, as in exact median absolute error
+    TMetricHolder error(SketchBins.GetBinCount());
+    for (int i = begin; i < end; ++i) {
+        error.Stats[SketchBins.GetBin(fabs(approxVec[i] - target[i]))] += 1;
+    }
+    return error;
+}
+
+double TApproxMedianAbsoluteErrorMetric::GetFinalError(const TMetricHolder& error) const {
+    return SketchBins.CalcQuantile(error.Stats, 0.5);
+}
+
+TVector<TString> TApproxMedianAbsoluteErrorMetric::GetStatDescriptions() const {
+    TVector<TString> result;
+    for (ui32 bin = 0; bin < SketchBins.GetBinCount(); ++bin) {
+        result.push_back(TStringBuilder() << "Bin" << bin << "Count");
+    }
+    return result;
+}
+
+TString TApproxMedianAbsoluteErrorMetric::GetDescription() const {
+    TStringBuilder description;
+    description << ToString(ELossFunction::MedianAbsoluteError) << ":relative_accuracy=" << RelativeAccuracy;
+    if (SketchBins.GetMinValue() != TQuantileSketchBins::DefaultMinValue) {
+        description << ";min_error=" << SketchBins.GetMinValue();
+    }
+    if (SketchBins.GetMaxValue() != TQuantileSketchBins::DefaultMaxValue) {
+        description << ";max_error=" << SketchBins.GetMaxValue();
+    }
+    return description;
+}
+
+void TApproxMedianAbsoluteErrorMetric::GetBestValue(EMetricBestValue* valueType, float*) const {
+    *valueType = EMetricBestValue::Min;
+}
+
 /* MultiClass */
 
 TMetricHolder TMultiClassMetric::EvalSingleThread(
@@ -881,6 +937,10 @@ THolder<TAUCMetric> TAUCMetric::CreateMultiClassMetric(int positiveClass) {
     return metric;
 }
 
+static inline bool IsPositiveAUCTarget(float target, bool isMultiClass, int positiveClass, double border) {
+    return isMultiClass ? target == static_cast<float>(positiveClass) : target > border;
+}
+
 TMetricHolder TAUCMetric::Eval(
         const TVector<TVector<double>>& approx,
         const TVector<float>& target,
@@ -888,39 +948,45 @@ TMetricHolder TAUCMetric::Eval(
         const TVector<TQueryInfo>& /*queriesInfo*/,
         int begin,
         int end,
-        NPar::TLocalExecutor& /* executor */
+        NPar::TLocalExecutor& executor
 ) const {
     Y_ASSERT((approx.size() > 1) == IsMultiClass);
     const auto& approxVec = approx.ysize() == 1 ? approx.front() : approx[PositiveClass];
     Y_ASSERT(approxVec.size() == target.size());
 
-    TVector<double> approxCopy(approxVec.begin() + begin, approxVec.begin() + end);
-    TVector<double> targetCopy(target.begin() + begin, target.begin() + end);
-
-    if (!IsMultiClass) {
-        for (ui32 i = 0; i < targetCopy.size(); ++i) {
-            targetCopy[i] = targetCopy[i] > Border;
+    TMetricHolder error(2);
+    error.Stats[1] = 1.0;
+    if (begin >= end) {
+        return error;
+    }
+
+    NPar::TLocalExecutor::TExecRangeParams blockParams(begin, end);
+    blockParams.SetBlockCount(executor.GetThreadCount() + 1);
+    const int blockSize = blockParams.GetBlockSize();
+    const int blockCount = blockParams.GetBlockCount();
+    TVector<TVector<NMetrics::TBinClassSample>> blockPositives(blockCount);
+    TVector<TVector<NMetrics::TBinClassSample>> blockNegatives(blockCount);
+    NPar::ParallelFor(executor, 0, blockCount, [&](int blockId) {
+        const int from = begin + blockId * blockSize;
+        const int to = Min<int>(from + blockSize, end);
+        for (int i = from; i < to; ++i) {
+            auto& samples = IsPositiveAUCTarget(target[i], IsMultiClass, PositiveClass, Border) ? blockPositives[blockId] : blockNegatives[blockId];
+            samples.emplace_back(approxVec[i], weight.empty() ? 1.0 : weight[i]);
         }
-    }
+    });
 
-    if (approx.ysize() > 1) {
-        int positiveClass = PositiveClass;
-        ForEach(targetCopy.begin(), targetCopy.end(), [positiveClass](double& x) {
-            x = (x == static_cast<double>(positiveClass));
-        });
-    }
-
-    TVector<NMetrics::TSample> samples;
-    if (weight.empty()) {
-        samples = NMetrics::TSample::FromVectors(targetCopy, approxCopy);
-    } else {
-        TVector<double> weightCopy(weight.begin() + begin, weight.begin() + end);
-        samples = NMetrics::TSample::FromVectors(targetCopy, approxCopy, weightCopy);
+    TVector<NMetrics::TBinClassSample> positives;
+    TVector<NMetrics::TBinClassSample> negatives;
+    positives.reserve(end - begin);
+    negatives.reserve(end - begin);
+    for (int blockId = 0; blockId < blockCount; ++blockId) {
+        positives.insert(positives.end(), blockPositives[blockId].begin(), blockPositives[blockId].end());
+        negatives.insert(negatives.end(), blockNegatives[blockId].begin(), blockNegatives[blockId].end());
+        TVector<NMetrics::TBinClassSample>().swap(blockPositives[blockId]);
+        TVector<NMetrics::TBinClassSample>().swap(blockNegatives[blockId]);
     }
 
-    TMetricHolder error(2);
-    error.Stats[0] = CalcAUC(&samples);
-    error.Stats[1] = 1.0;
+    error.Stats[0] = CalcBinClassAUC(&positives, &negatives, &executor);
     return error;
 }
 
@@ -936,6 +1002,77 @@ void TAUCMetric::GetBestValue(EMetricBestValue* valueType, float*) const {
     *valueType = EMetricBestValue::Max;
 }
 
+/* Approximate AUC */
+
+TApproxAUCMetric::TApproxAUCMetric(ui32 binCount)
+    : BinCount(binCount)
+{
+    CB_ENSURE(binCount > 1, "AUC histogram should have at least 2 bins");
+}
+
+THolder<TApproxAUCMetric> TApproxAUCMetric::CreateBinClassMetric(ui32 binCount, double border) {
+    auto metric = new TApproxAUCMetric(binCount);
+    metric->Border = border;
+    return metric;
+}
+
+THolder<TApproxAUCMetric> TApproxAUCMetric::CreateMultiClassMetric(ui32 binCount, int positiveClass) {
+    CB_ENSURE(positiveClass >= 0, "Class id should not be negative");
+
+    auto metric = new TApproxAUCMetric(binCount);
+    metric->PositiveClass = positiveClass;
+    metric->IsMultiClass = true;
+    return metric;
+}
+
+TMetricHolder TApproxAUCMetric::EvalSingleThread(
+        const TVector<TVector<double>>& approx,
+        const TVector<float>& target,
+        const TVector<float>& weight,
+        const TVector<TQueryInfo>& /*queriesInfo*/,
+        int begin,
+        int end
+) const {
+    Y_ASSERT((approx.size() > 1) == IsMultiClass);
+    const auto& approxVec = approx.ysize() == 1 ? approx.front() : approx[PositiveClass];
+    Y_ASSERT(approxVec.size() == target.size());
+
+    TMetricHolder error(2 * BinCount);
+    for (int i = begin; i < end; ++i) {
+        const ui32 bin = GetAUCHistogramBin(approxVec[i], BinCount);
+        const bool isPositive = IsPositiveAUCTarget(target[i], IsMultiClass, PositiveClass, Border);
+        error.Stats[2 * bin + (isPositive ? 0 : 1)] += weight.empty() ? 1 : weight[i];
+    }
+    return error;
+}
+
+double TApproxAUCMetric::GetFinalError(const TMetricHolder& error) const {
+    return CalcAUCFromHistogram(error.Stats);
+}
+
+TVector<TString> TApproxAUCMetric::GetStatDescriptions() const {
+    TVector<TString> result;
+    for (ui32 bin = 0; bin < BinCount; ++bin) {
+        result.push_back(TStringBuilder() << "Bin" << bin << "PositiveWeight");
+        result.push_back(TStringBuilder() << "Bin" << bin << "NegativeWeight");
+    }
+    return result;
+}
+
+TString TApproxAUCMetric::GetDescription() const {
+    TString description = TStringBuilder() << ToString(ELossFunction::AUC) << ":approx_bins=" << BinCount;
+    if (IsMultiClass) {
+        return TStringBuilder() << description << ";class=" << PositiveClass;
+    } else if (Border != GetDefaultClassificationBorder()) {
+        return TStringBuilder() << description << ";border=" << Border;
+    }
+    return description;
+}
+
+void TApproxAUCMetric::GetBestValue(EMetricBestValue* valueType, float*) const {
+    *valueType = EMetricBestValue::Max;
+}
+
 /* Accuracy */
 
 TMetricHolder TAccuracyMetric::EvalSingleThread(
@@ -1834,7 +1971,15 @@ static TVector<THolder<IMetric>> CreateMetric(ELossFunction metric, TMap<TString
             break;
 
         case ELossFunction::MedianAbsoluteError:
-            result.emplace_back(new TMedianAbsoluteErrorMetric());
+            if (params.has("relative_accuracy")) {
+                const double minError = params.has("min_error") ? FromString<double>(params.at("min_error")) : TQuantileSketchBins::DefaultMinValue;
+                const double maxError = params.has("max_error") ? FromString<double>(params.at("max_error")) : TQuantileSketchBins::DefaultMaxValue;
+                result.emplace_back(new TApproxMedianAbsoluteErrorMetric(FromString<double>(params.at("relative_accuracy")), minError, maxError));
+                validParams = {"relative_accuracy", "min_error", "max_error"};
+            } else {
+                validParams = {"relative_accuracy"};
+                result.emplace_back(new TMedianAbsoluteErrorMetric());
+            }
             break;
 
         case ELossFunction::MSLE:
@@ -1902,7 +2047,18 @@ static TVector<THolder<IMetric>> CreateMetric(ELossFunction metric, TMap<TString
             break;
 
         case ELossFunction::AUC: {
-            if (approxDimension == 1) {
+            if (params.has("approx_bins")) {
+                const ui32 binCount = FromString<ui32>(params.at("approx_bins"));
+                if (approxDimension == 1) {
+                    result.emplace_back(TApproxAUCMetric::CreateBinClassMetric(binCount, border));
+                    validParams = {"border", "approx_bins"};
+                } else {
+                    for (int i = 0; i < approxDimension; ++i) {
+                        result.emplace_back(TApproxAUCMetric::CreateMultiClassMetric(binCount, i));
+                    }
+                    validParams = {"approx_bins"};
+                }
+            } else if (approxDimension == 1) {
                 result.emplace_back(TAUCMetric::CreateBinClassMetric(border));
                 validParams = {"border"};
             } else {
@@ -2094,6 +2250,18 @@ TVector<THolder<IMetric>> CreateMetricFromDescription(const NCatboostOptions::TL
     return CreateMetric(metric, description.GetLossParams(), approxDimension);
 }
 
+void CheckApproxAUCObjective(const IMetric& metric, ELossFunction objective) {
+    if (dynamic_cast<const TApproxAUCMetric*>(&metric) == nullptr) {
+        return;
+    }
+    CB_ENSURE(objective == ELossFunction::Logloss ||
+              objective == ELossFunction::CrossEntropy ||
+              objective == ELossFunction::MultiClass ||
+              objective == ELossFunction::MultiClassOneVsAll,
+              "Metric " << metric.GetDescription() << " bins probabilities of logit scale approxes and can't be used with "
+              << objective << " objective, use AUC without approx_bins");
+}
+
 TVector<THolder<IMetric>> CreateMetrics(
         const NCatboostOptions::TOption<NCatboostOptions::TLossDescription>& lossFunctionOption,
         const NCatboostOptions::TOption<NCatboostOptions::TMetricOptions>& evalMetricOptions,
@@ -2129,6 +2297,9 @@ TVector<THolder<IMetric>> CreateMetrics(
             errors.push_back(std::move(metric));
         }
     }
+    for (const auto& error : errors) {
+        CheckApproxAUCObjective(*error, lossFunctionOption->GetLossFunction());
+    }
     return errors;
 }
 
@@ -3,6 +3,7 @@
 #include "metric_holder.h"
 #include "ders_holder.h"
 #include "pfound.h"
+#include "quantile_sketch.h"
 
 #include <catboost/libs/data_types/pair.h>
 #include <catboost/libs/data_types/query.h>
@@ -281,6 +282,32 @@ struct TMedianAbsoluteErrorMetric : public TNonAdditiveMetric {
     virtual void GetBestValue(EMetricBestValue* valueType, float* bestValue) const override;
 };
 
+/* Median absolute error over quantile sketch of errors, stats are additive so huge pools are evaluated block by block.
+   Errors out of (minError, maxError] are clamped to the range. Stats hold one value per sketch bin, metric plots
+   keep them for every evaluated iteration, so a narrower range or a coarser accuracy saves memory.
+*/
+struct TApproxMedianAbsoluteErrorMetric : public TAdditiveMetric<TApproxMedianAbsoluteErrorMetric> {
+    explicit TApproxMedianAbsoluteErrorMetric(
+        double relativeAccuracy,
+        double minError = TQuantileSketchBins::DefaultMinValue,
+        double maxError = TQuantileSketchBins::DefaultMaxValue);
+    TMetricHolder EvalSingleThread(
+        const TVector<TVector<double>>& approx,
+        const TVector<float>& target,
+        const TVector<float>& weight,
+        const TVector<TQueryInfo>& queriesInfo,
+        int begin,
+        int end
+    ) const;
+    virtual double GetFinalError(const TMetricHolder& error) const override;
+    virtual TVector<TString> GetStatDescriptions() const override;
+    virtual TString GetDescription() const override;
+    virtual void GetBestValue(EMetricBestValue* valueType, float* bestValue) const override;
+private:
+    double RelativeAccuracy;
+    TQuantileSketchBins SketchBins;
+};
+
 struct TMultiClassMetric : public TAdditiveMetric<TMultiClassMetric> {
     TMetricHolder EvalSingleThread(
         const TVector<TVector<double>>& approx,
@@ -452,6 +479,31 @@ private:
     explicit TAUCMetric(int positiveClass);
 };
 
+// AUC over fixed resolution histogram of predictions, stats are additive so they can be merged across threads and hosts
+struct TApproxAUCMetric: public TAdditiveMetric<TApproxAUCMetric> {
+    static THolder<TApproxAUCMetric> CreateBinClassMetric(ui32 binCount, double border = GetDefaultClassificationBorder());
+    static THolder<TApproxAUCMetric> CreateMultiClassMetric(ui32 binCount, int positiveClass);
+    TMetricHolder EvalSingleThread(
+        const TVector<TVector<double>>& approx,
+        const TVector<float>& target,
+        const TVector<float>& weight,
+        const TVector<TQueryInfo>& queriesInfo,
+        int begin,
+        int end
+    ) const;
+    virtual double GetFinalError(const TMetricHolder& error) const override;
+    virtual TVector<TString> GetStatDescriptions() const override;
+    virtual TString GetDescription() const override;
+    virtual void GetBestValue(EMetricBestValue* valueType, float* bestValue) const override;
+private:
+    ui32 BinCount;
+    int PositiveClass = 1;
+    bool IsMultiClass = false;
+    double Border = GetDefaultClassificationBorder();
+
+    explicit TApproxAUCMetric(ui32 binCount);
+};
+
 struct TAccuracyMetric : public TAdditiveMetric<TAccuracyMetric> {
     explicit TAccuracyMetric(double border = GetDefaultClassificationBorder())
         : Border(border)
@@ -849,6 +901,9 @@ TVector<THolder<IMetric>> CreateMetricsFromDescription(const TVector<TString>& d
 
 TVector<THolder<IMetric>> CreateMetricFromDescription(const NCatboostOptions::TLossDescription& description, int approxDimension);
 
+// AUC:approx_bins bins sigmoid of approxes, so it is allowed only for objectives with logit scale approxes
+void CheckApproxAUCObjective(const IMetric& metric, ELossFunction objective);
+
 TVector<THolder<IMetric>> CreateMetrics(
     const NCatboostOptions::TOption<NCatboostOptions::TLossDescription>& lossFunctionOption,
     const NCatboostOptions::TOption<NCatboostOptions::TMetricOptions>& evalMetricOptions,
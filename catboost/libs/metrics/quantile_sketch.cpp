@@ -0,0 +1,59 @@
+#include "quantile_sketch.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/ymath.h>
+#include <util/system/yassert.h>
+
+#include <cmath>
+
+constexpr double TQuantileSketchBins::DefaultMinValue;
+constexpr double TQuantileSketchBins::DefaultMaxValue;
+
+TQuantileSketchBins::TQuantileSketchBins(double relativeAccuracy, double minValue, double maxValue)
+    : MinValue(minValue)
+    , MaxValue(maxValue)
+{
+    CB_ENSURE(relativeAccuracy > 0 && relativeAccuracy < 1, "Relative accuracy should be in (0, 1)");
+    CB_ENSURE(minValue > 0 && minValue < maxValue, "Sketch range should satisfy 0 < min < max, got (" << minValue << ", " << maxValue << "]");
+    LogGamma = log((1 + relativeAccuracy) / (1 - relativeAccuracy));
+    BinCount = 1 + static_cast<ui32>(ceil(log(MaxValue / MinValue) / LogGamma));
+}
+
+ui32 TQuantileSketchBins::GetBin(double value) const {
+    if (!(value > MinValue)) {
+        return 0;
+    }
+    // bin i > 0 holds values in (MinValue * gamma^(i - 1), MinValue * gamma^i]
+    const double bin = ceil(log(value / MinValue) / LogGamma);
+    return bin < BinCount - 1 ? Max<ui32>(static_cast<ui32>(bin), 1) : BinCount - 1;
+}
+
+double TQuantileSketchBins::GetValue(ui32 bin) const {
+    if (bin == 0) {
+        return 0;
+    }
+    // harmonic center of bin is within relative accuracy from both bin borders
+    const double gamma = exp(LogGamma);
+    return MinValue * exp(LogGamma * bin) * 2 / (1 + gamma);
+}
+
+double TQuantileSketchBins::CalcQuantile(TConstArrayRef<double> binWeights, double quantile) const {
+    Y_ASSERT(binWeights.size() == BinCount);
+    double weightSum = 0;
+    for (double weight : binWeights) {
+        weightSum += weight;
+    }
+    if (weightSum == 0) {
+        return 0;
+    }
+    const double quantileWeight = quantile * weightSum;
+    double accumulatedWeight = 0;
+    for (ui32 bin = 0; bin < BinCount; ++bin) {
+        accumulatedWeight += binWeights[bin];
+        if (accumulatedWeight >= quantileWeight && binWeights[bin] > 0) {
+            return GetValue(bin);
+        }
+    }
+    return GetValue(BinCount - 1);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <util/generic/array_ref.h>
+#include <util/system/types.h>
+
+// Histogram of non-negative values with log-spaced bins: bins of different document blocks are merged by
+// summation and every value in (minValue, maxValue] is restored from its bin with relative error not
+// greater than relativeAccuracy. Smaller values fall into the zero bin, larger ones into the last bin.
+// Bin count is about ln(maxValue / minValue) / (2 * relativeAccuracy), e.g. 2000 for the default range and 0.01.
+class TQuantileSketchBins {
+public:
+    static constexpr double DefaultMinValue = 1e-9;
+    static constexpr double DefaultMaxValue = 1e9;
+
+    explicit TQuantileSketchBins(double relativeAccuracy, double minValue = DefaultMinValue, double maxValue = DefaultMaxValue);
+
+    ui32 GetBinCount() const {
+        return BinCount;
+    }
+    double GetMinValue() const {
+        return MinValue;
+    }
+    double GetMaxValue() const {
+        return MaxValue;
+    }
+    ui32 GetBin(double value) const;
+    double GetValue(ui32 bin) const;
+
+    // Smallest restored value such that weight of values not greater than it is at least quantile of total weight
+    double CalcQuantile(TConstArrayRef<double> binWeights, double quantile) const;
+
+private:
+    double MinValue;
+    double MaxValue;
+    double LogGamma;
+    ui32 BinCount;
+};
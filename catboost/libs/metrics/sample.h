@@ -19,4 +19,15 @@ struct TSample {
     static TVector<TSample> FromVectors(
         const TVector<double>& targets, const TVector<double>& predictions, const TVector<double>& weights);
 };
+
+// Sample of a binarized target, the class is defined by the container it is stored in
+struct TBinClassSample {
+    double Prediction;
+    double Weight;
+
+    TBinClassSample(double prediction, double weight = 1)
+        : Prediction(prediction)
+        , Weight(weight)
+    {}
+};
 }  // NMetrics
@@ -0,0 +1,97 @@
+#include <library/unittest/registar.h>
+
+#include <catboost/libs/metrics/auc.h>
+#include <catboost/libs/metrics/metric.h>
+#include <catboost/libs/metrics/metric_holder.h>
+
+#include <util/random/fast.h>
+
+static void MakeBinClassData(int docCount, int distinctPredictions, TFastRng64* rng, TVector<TVector<double>>* approx, TVector<float>* target, TVector<float>* weight) {
+    approx->assign(1, TVector<double>(docCount));
+    target->resize(docCount);
+    weight->resize(docCount);
+    for (int i = 0; i < docCount; ++i) {
+        (*target)[i] = rng->Uniform(2);
+        // few distinct predictions produce many ties
+        (*approx)[0][i] = static_cast<double>(rng->Uniform(distinctPredictions)) / distinctPredictions * 8 - 4 + (*target)[i];
+        (*weight)[i] = rng->GenRandReal1() * 2;
+    }
+}
+
+Y_UNIT_TEST_SUITE(AUCMetricTest) {
+    Y_UNIT_TEST(ParallelAUCMatchesCalcAUC) {
+        NPar::TLocalExecutor executor;
+        executor.RunAdditionalThreads(3);
+        TFastRng64 rng(0);
+        for (int distinctPredictions : {5, 1000, 1000000}) {
+            for (bool hasWeights : {false, true}) {
+                TVector<TVector<double>> approx;
+                TVector<float> target;
+                TVector<float> weight;
+                MakeBinClassData(10000, distinctPredictions, &rng, &approx, &target, &weight);
+                if (!hasWeights) {
+                    weight.clear();
+                }
+
+                TVector<double> targetCopy(target.begin(), target.end());
+                auto samples = hasWeights
+                    ? NMetrics::TSample::FromVectors(targetCopy, approx[0], TVector<double>(weight.begin(), weight.end()))
+                    : NMetrics::TSample::FromVectors(targetCopy, approx[0]);
+                const double expected = CalcAUC(&samples);
+
+                auto metric = TAUCMetric::CreateBinClassMetric();
+                const TMetricHolder score = metric->Eval(approx, target, weight, {}, 0, target.size(), executor);
+                UNIT_ASSERT_DOUBLES_EQUAL(metric->GetFinalError(score), expected, 1e-9);
+            }
+        }
+    }
+
+    Y_UNIT_TEST(ParallelAUCSingleClass) {
+        NPar::TLocalExecutor executor;
+        executor.RunAdditionalThreads(3);
+        TVector<TVector<double>> approx{{0.1, 0.5, -0.3, 2}};
+        TVector<float> target{1, 1, 1, 1};
+        auto metric = TAUCMetric::CreateBinClassMetric();
+        const TMetricHolder score = metric->Eval(approx, target, {}, {}, 0, target.size(), executor);
+        UNIT_ASSERT_DOUBLES_EQUAL(metric->GetFinalError(score), 0, 1e-12);
+    }
+
+    Y_UNIT_TEST(ApproxAUC) {
+        NPar::TLocalExecutor executor;
+        executor.RunAdditionalThreads(3);
+        TFastRng64 rng(0);
+        TVector<TVector<double>> approx;
+        TVector<float> target;
+        TVector<float> weight;
+        MakeBinClassData(10000, 1000000, &rng, &approx, &target, &weight);
+
+        auto exactMetric = TAUCMetric::CreateBinClassMetric();
+        const double exactAUC = exactMetric->GetFinalError(exactMetric->Eval(approx, target, weight, {}, 0, target.size(), executor));
+
+        auto approxMetric = TApproxAUCMetric::CreateBinClassMetric(/*binCount*/ 4096);
+        const TMetricHolder score = approxMetric->Eval(approx, target, weight, {}, 0, target.size(), executor);
+        UNIT_ASSERT_DOUBLES_EQUAL(approxMetric->GetFinalError(score), exactAUC, 1e-3);
+
+        // histograms of document subsets merge into histogram of the whole set
+        TMetricHolder mergedScore = approxMetric->EvalSingleThread(approx, target, weight, {}, 0, 3000);
+        mergedScore.Add(approxMetric->EvalSingleThread(approx, target, weight, {}, 3000, target.size()));
+        UNIT_ASSERT_VALUES_EQUAL(mergedScore.Stats.size(), score.Stats.size());
+        UNIT_ASSERT_DOUBLES_EQUAL(approxMetric->GetFinalError(mergedScore), approxMetric->GetFinalError(score), 1e-12);
+    }
+
+    Y_UNIT_TEST(ApproxAUCDescription) {
+        UNIT_ASSERT_VALUES_EQUAL(TApproxAUCMetric::CreateBinClassMetric(256)->GetDescription(), "AUC:approx_bins=256");
+        UNIT_ASSERT_VALUES_EQUAL(TApproxAUCMetric::CreateBinClassMetric(256, 0.3)->GetDescription(), "AUC:approx_bins=256;border=0.3");
+        UNIT_ASSERT_VALUES_EQUAL(TApproxAUCMetric::CreateMultiClassMetric(256, 2)->GetDescription(), "AUC:approx_bins=256;class=2");
+    }
+
+    Y_UNIT_TEST(ApproxAUCObjective) {
+        const auto approxMetric = TApproxAUCMetric::CreateBinClassMetric(256);
+        CheckApproxAUCObjective(*approxMetric, ELossFunction::Logloss);
+        CheckApproxAUCObjective(*TApproxAUCMetric::CreateMultiClassMetric(256, 1), ELossFunction::MultiClass);
+        UNIT_ASSERT_EXCEPTION(CheckApproxAUCObjective(*approxMetric, ELossFunction::RMSE), TCatboostException);
+        UNIT_ASSERT_EXCEPTION(CheckApproxAUCObjective(*approxMetric, ELossFunction::YetiRank), TCatboostException);
+        // exact AUC does not depend on the scale of approxes
+        CheckApproxAUCObjective(*TAUCMetric::CreateBinClassMetric(), ELossFunction::RMSE);
+    }
+}
@@ -2,6 +2,8 @@
 #include <catboost/libs/metrics/metric.h>
 #include <catboost/libs/metrics/metric_holder.h>
 
+#include <util/random/fast.h>
+
 //The benchmark value was calculated by sklearn.metrics.median_absolute_error
 Y_UNIT_TEST_SUITE(MedianAbsoluteErrorMetricTest) {
 Y_UNIT_TEST(MedianAbsoluteErrorTest) {
@@ -42,4 +44,38 @@ Y_UNIT_TEST(MedianAbsoluteErrorTest) {
         UNIT_ASSERT_DOUBLES_EQUAL(metric.GetFinalError(score), 4.2598, 1e-4);
     }
 }
+
+Y_UNIT_TEST(ApproxMedianAbsoluteErrorTest) {
+    TFastRng64 rng(0);
+    const int docCount = 10001;
+    TVector<TVector<double>> approx(1, TVector<double>(docCount));
+    TVector<float> target(docCount);
+    for (int i = 0; i < docCount; ++i) {
+        approx[0][i] = rng.GenRandReal1() * 100;
+        target[i] = rng.GenRandReal1() * 100;
+    }
+    TVector<TQueryInfo> q;
+    NPar::TLocalExecutor executor;
+    executor.RunAdditionalThreads(3);
+
+    TMedianAbsoluteErrorMetric exactMetric;
+    const double exactMedian = exactMetric.GetFinalError(exactMetric.Eval(approx, target, {}, q, 0, docCount, executor));
+
+    const double relativeAccuracy = 0.01;
+    TApproxMedianAbsoluteErrorMetric metric(relativeAccuracy);
+    TMetricHolder score = metric.Eval(approx, target, {}, q, 0, docCount, executor);
+    UNIT_ASSERT_DOUBLES_EQUAL(metric.GetFinalError(score), exactMedian, exactMedian * relativeAccuracy);
+
+    TMetricHolder mergedScore = metric.EvalSingleThread(approx, target, {}, q, 0, 1234);
+    mergedScore.Add(metric.EvalSingleThread(approx, target, {}, q, 1234, docCount));
+    UNIT_ASSERT_VALUES_EQUAL(mergedScore.Stats, score.Stats);
+    UNIT_ASSERT_VALUES_EQUAL(metric.GetDescription(), "MedianAbsoluteError:relative_accuracy=0.01");
+
+    TApproxMedianAbsoluteErrorMetric boundedMetric(relativeAccuracy, 1e-2, 1e3);
+    TMetricHolder boundedScore = boundedMetric.Eval(approx, target, {}, q, 0, docCount, executor);
+    UNIT_ASSERT(boundedScore.Stats.size() * 3 < score.Stats.size());
+    UNIT_ASSERT_DOUBLES_EQUAL(boundedMetric.GetFinalError(boundedScore), exactMedian, exactMedian * relativeAccuracy);
+    UNIT_ASSERT_VALUES_EQUAL(boundedMetric.GetDescription(), "MedianAbsoluteError:relative_accuracy=0.01;min_error=0.01;max_error=1000");
+    UNIT_ASSERT_EXCEPTION(TApproxMedianAbsoluteErrorMetric(relativeAccuracy, 1, 1), TCatboostException);
+}
 }
@@ -0,0 +1,224 @@
+#include <catboost/libs/model/formula_evaluator.h>
+
+#include <library/testing/benchmark/bench.h>
+
+#include <util/generic/singleton.h>
+#include <util/generic/vector.h>
+#include <util/random/fast.h>
+#include <util/stream/output.h>
+
+/*
+ * Model apply throughput for synthetic reference models on each supported SIMD level, with doc-major or selected tiled loop order
+ * and with double or float leaf values,
+ * and float binarization throughput of linear scan and binary search for different border counts.
+ * One benchmark iteration is one document, so reported iterations per second are documents per second.
+ */
+
+namespace {
+    constexpr size_t POOL_DOC_COUNT = 4096;
+
+    class TReferenceData {
+    public:
+        TReferenceData(int featureCount, int borderCount, int treeCount, int treeDepth) {
+            TFastRng64 rng(featureCount * treeCount);
+            for (int featureIdx = 0; featureIdx < featureCount; ++featureIdx) {
+                TVector<float> borders;
+                for (int borderIdx = 0; borderIdx < borderCount; ++borderIdx) {
+                    borders.push_back((borderIdx + 1.0f) / (borderCount + 1));
+                }
+                Model.ObliviousTrees.FloatFeatures.emplace_back(false, featureIdx, featureIdx, borders);
+            }
+            for (int treeIdx = 0; treeIdx < treeCount; ++treeIdx) {
+                TVector<int> tree;
+                for (int depth = 0; depth < treeDepth; ++depth) {
+                    tree.push_back(rng.Uniform(featureCount * borderCount));
+                }
+                Model.ObliviousTrees.AddBinTree(tree);
+                for (int leafIdx = 0; leafIdx < (1 << treeDepth); ++leafIdx) {
+                    Model.ObliviousTrees.LeafValues.push_back(rng.GenRandReal1() - 0.5);
+                }
+            }
+            Model.UpdateDynamicData();
+
+            Features.resize(POOL_DOC_COUNT);
+            for (auto& docFeatures : Features) {
+                for (int featureIdx = 0; featureIdx < featureCount; ++featureIdx) {
+                    docFeatures.push_back(rng.GenRandReal1());
+                }
+            }
+        }
+
+    public:
+        TFullModel Model;
+        TVector<TVector<float>> Features;
+    };
+
+    template <size_t BorderCount>
+    struct TBinarizationData {
+        TBinarizationData() {
+            TFastRng64 rng(BorderCount);
+            for (size_t docId = 0; docId < FORMULA_EVALUATION_BLOCK_SIZE; ++docId) {
+                Values.push_back(rng.GenRandReal1());
+            }
+            for (size_t borderIdx = 0; borderIdx < BorderCount; ++borderIdx) {
+                Borders.push_back((borderIdx + 1.0f) / (BorderCount + 1));
+            }
+        }
+
+        TVector<float> Values;
+        TVector<float> Borders;
+    };
+
+    struct TSmallModelData: public TReferenceData {
+        TSmallModelData()
+            : TReferenceData(/*featureCount*/ 20, /*borderCount*/ 32, /*treeCount*/ 100, /*treeDepth*/ 6)
+        {
+        }
+    };
+
+    struct TMediumModelData: public TReferenceData {
+        TMediumModelData()
+            : TReferenceData(/*featureCount*/ 100, /*borderCount*/ 128, /*treeCount*/ 1000, /*treeDepth*/ 6)
+        {
+        }
+    };
+
+    struct TLargeModelData: public TReferenceData {
+        TLargeModelData()
+            : TReferenceData(/*featureCount*/ 300, /*borderCount*/ 254, /*treeCount*/ 4000, /*treeDepth*/ 8)
+        {
+        }
+    };
+
+    struct THugeModelData: public TReferenceData {
+        THugeModelData()
+            : TReferenceData(/*featureCount*/ 100, /*borderCount*/ 64, /*treeCount*/ 20000, /*treeDepth*/ 6)
+        {
+        }
+    };
+}
+
+template <class TData>
+static void ApplyReferenceModel(ESimdLevel simdLevel, size_t docCount) {
+    if (!IsSimdLevelSupported(simdLevel)) {
+        Cerr << "SIMD level " << simdLevel << " is not supported by CPU, skipping" << Endl;
+        return;
+    }
+    const auto& data = *Singleton<TData>();
+    const auto& features = data.Features;
+    TVector<double> results(POOL_DOC_COUNT);
+    for (size_t processed = 0; processed < docCount; processed += POOL_DOC_COUNT) {
+        const size_t batchDocCount = Min(POOL_DOC_COUNT, docCount - processed);
+        CalcGeneric(
+            data.Model,
+            [&features](const TFloatFeature& floatFeature, size_t index) -> float {
+                return features[index][floatFeature.FlatFeatureIndex];
+            },
+            [](const TCatFeature&, size_t) -> int {
+                return 0;
+            },
+            batchDocCount,
+            0,
+            data.Model.GetTreeCount(),
+            MakeArrayRef(results.data(), batchDocCount),
+            simdLevel
+        );
+        Y_DO_NOT_OPTIMIZE_AWAY(results[0]);
+    }
+}
+
+#define Y_MODEL_APPLY_BENCHMARK(modelName, simdLevel)                                                  \
+    Y_CPU_BENCHMARK(modelName##Model_##simdLevel, iface) {                                             \
+        ApplyReferenceModel<T##modelName##ModelData>(ESimdLevel::simdLevel, iface.Iterations());       \
+    }
+
+Y_MODEL_APPLY_BENCHMARK(Small, Sse2)
+Y_MODEL_APPLY_BENCHMARK(Small, Avx2)
+Y_MODEL_APPLY_BENCHMARK(Small, Avx512)
+
+Y_MODEL_APPLY_BENCHMARK(Medium, Sse2)
+Y_MODEL_APPLY_BENCHMARK(Medium, Avx2)
+Y_MODEL_APPLY_BENCHMARK(Medium, Avx512)
+
+Y_MODEL_APPLY_BENCHMARK(Large, Sse2)
+Y_MODEL_APPLY_BENCHMARK(Large, Avx2)
+Y_MODEL_APPLY_BENCHMARK(Large, Avx512)
+
+#undef Y_MODEL_APPLY_BENCHMARK
+
+template <class TData>
+static void ApplyReferenceModelTiled(bool useSelectedTiling, size_t docCount) {
+    auto& data = *Singleton<TData>();
+    const auto& trees = data.Model.ObliviousTrees;
+    data.Model.SetEvaluationTiling(useSelectedTiling ? SelectEvaluationTiling(trees, GetL2CacheSize()) : TEvaluationTiling());
+    ApplyReferenceModel<TData>(GetBestSimdLevel(), docCount);
+}
+
+#define Y_MODEL_TILING_BENCHMARK(modelName)                                          \
+    Y_CPU_BENCHMARK(modelName##Model_DocMajor, iface) {                              \
+        ApplyReferenceModelTiled<T##modelName##ModelData>(false, iface.Iterations()); \
+    }                                                                                \
+    Y_CPU_BENCHMARK(modelName##Model_SelectedTiling, iface) {                        \
+        ApplyReferenceModelTiled<T##modelName##ModelData>(true, iface.Iterations());  \
+    }
+
+Y_MODEL_TILING_BENCHMARK(Small)
+Y_MODEL_TILING_BENCHMARK(Medium)
+Y_MODEL_TILING_BENCHMARK(Large)
+Y_MODEL_TILING_BENCHMARK(Huge)
+
+#undef Y_MODEL_TILING_BENCHMARK
+
+template <class TData>
+static void ApplyReferenceModelFloatLeafValues(bool useFloatLeafValues, size_t docCount) {
+    auto& data = *Singleton<TData>();
+    data.Model.SetFloatLeafValuesMode(useFloatLeafValues);
+    ApplyReferenceModel<TData>(GetBestSimdLevel(), docCount);
+    // other benchmarks apply models in default mode
+    data.Model.SetFloatLeafValuesMode(false);
+}
+
+#define Y_MODEL_LEAF_VALUES_BENCHMARK(modelName)                                                  \
+    Y_CPU_BENCHMARK(modelName##Model_DoubleLeafValues, iface) {                                  \
+        ApplyReferenceModelFloatLeafValues<T##modelName##ModelData>(false, iface.Iterations());  \
+    }                                                                                            \
+    Y_CPU_BENCHMARK(modelName##Model_FloatLeafValues, iface) {                                   \
+        ApplyReferenceModelFloatLeafValues<T##modelName##ModelData>(true, iface.Iterations());   \
+    }
+
+Y_MODEL_LEAF_VALUES_BENCHMARK(Medium)
+Y_MODEL_LEAF_VALUES_BENCHMARK(Large)
+Y_MODEL_LEAF_VALUES_BENCHMARK(Huge)
+
+#undef Y_MODEL_LEAF_VALUES_BENCHMARK
+
+template <size_t BorderCount>
+static void BinarizeBlocks(bool useBinarySearch, size_t docCount) {
+    const auto& data = *Singleton<TBinarizationData<BorderCount>>();
+    const auto& kernels = GetEvaluationKernels();
+    const auto kernel = useBinarySearch ? kernels.BinarizeFloatsBinarySearch : kernels.BinarizeFloats;
+    ui8 result[FORMULA_EVALUATION_BLOCK_SIZE];
+    for (size_t processed = 0; processed < docCount; processed += FORMULA_EVALUATION_BLOCK_SIZE) {
+        const size_t blockDocCount = Min(FORMULA_EVALUATION_BLOCK_SIZE, docCount - processed);
+        kernel(data.Values.data(), blockDocCount, data.Borders.data(), BorderCount, result);
+        Y_DO_NOT_OPTIMIZE_AWAY(result[0]);
+    }
+}
+
+#define Y_BINARIZATION_BENCHMARK(borderCount)                        \
+    Y_CPU_BENCHMARK(BinarizeLinear_##borderCount, iface) {           \
+        BinarizeBlocks<borderCount>(false, iface.Iterations());      \
+    }                                                                \
+    Y_CPU_BENCHMARK(BinarizeBinarySearch_##borderCount, iface) {     \
+        BinarizeBlocks<borderCount>(true, iface.Iterations());       \
+    }
+
+Y_BINARIZATION_BENCHMARK(8)
+Y_BINARIZATION_BENCHMARK(16)
+Y_BINARIZATION_BENCHMARK(32)
+Y_BINARIZATION_BENCHMARK(64)
+Y_BINARIZATION_BENCHMARK(96)
+Y_BINARIZATION_BENCHMARK(128)
+Y_BINARIZATION_BENCHMARK(254)
+
+#undef Y_BINARIZATION_BENCHMARK
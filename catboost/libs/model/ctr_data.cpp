@@ -1,5 +1,6 @@
 #include <catboost/libs/helpers/exception.h>
 #include "ctr_data.h"
+#include "flatbuffers_serializer_helper.h"
 #include <util/generic/set.h>
 
 
@@ -28,3 +29,53 @@ void TCtrData::Load(IInputStream* s) {
         LearnCtrs[ctrBase] = std::move(table);
     }
 }
+
+void TCtrData::LoadThin(TMemoryInput* in) {
+    const size_t cnt = ::LoadSize(in);
+    LearnCtrs.reserve(cnt);
+
+    for (size_t i = 0; i != cnt; ++i) {
+        TCtrValueTable table;
+        table.LoadThin(in);
+        TModelCtrBase ctrBase = table.ModelCtrBase;
+        LearnCtrs[ctrBase] = std::move(table);
+    }
+}
+
+void TPrecomputedCtrValues::Save(IOutputStream* s) const {
+    TModelPartsCachingSerializer serializer;
+    auto precomputedCtrValues = NCatBoostFbs::CreateTPrecomputedCtrValues(
+        serializer.FlatbufBuilder,
+        serializer.GetOffset(Ctr),
+        serializer.FlatbufBuilder.CreateVector(Values.data(), Values.size()),
+        EmptyValue,
+        Borders.empty() ? 0 : serializer.FlatbufBuilder.CreateVector(Borders.data(), Borders.size()),
+        Bins.empty() ? 0 : serializer.FlatbufBuilder.CreateVector(Bins.data(), Bins.size()),
+        EmptyBin);
+    serializer.FlatbufBuilder.Finish(precomputedCtrValues);
+    SaveSize(s, serializer.FlatbufBuilder.GetSize());
+    s->Write(serializer.FlatbufBuilder.GetBufferPointer(), serializer.FlatbufBuilder.GetSize());
+}
+
+void TPrecomputedCtrValues::Load(IInputStream* s) {
+    const ui32 size = LoadSize(s);
+    TArrayHolder<ui8> arrayHolder = new ui8[size];
+    s->LoadOrFail(arrayHolder.Get(), size);
+    {
+        flatbuffers::Verifier verifier(arrayHolder.Get(), size);
+        CB_ENSURE(verifier.VerifyBuffer<NCatBoostFbs::TPrecomputedCtrValues>(nullptr), "Flatbuffers precomputed ctr values verification failed");
+    }
+    auto precomputedCtrValues = flatbuffers::GetRoot<NCatBoostFbs::TPrecomputedCtrValues>(arrayHolder.Get());
+    Ctr.FBDeserialize(precomputedCtrValues->Ctr());
+    Values.assign(precomputedCtrValues->Values()->begin(), precomputedCtrValues->Values()->end());
+    EmptyValue = precomputedCtrValues->EmptyValue();
+    Borders.clear();
+    if (precomputedCtrValues->Borders()) {
+        Borders.assign(precomputedCtrValues->Borders()->begin(), precomputedCtrValues->Borders()->end());
+    }
+    Bins.clear();
+    if (precomputedCtrValues->Bins()) {
+        Bins.assign(precomputedCtrValues->Bins()->begin(), precomputedCtrValues->Bins()->end());
+    }
+    EmptyBin = precomputedCtrValues->EmptyBin();
+}
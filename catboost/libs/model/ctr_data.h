@@ -18,6 +18,36 @@ struct TCtrData {
     void Save(IOutputStream* s) const;
 
     void Load(IInputStream* s);
+
+    //! Loads value tables as views into stream memory, see TCtrValueTable::LoadThin
+    void LoadThin(TMemoryInput* in);
+};
+
+/**
+ * Ctr value for every bucket index of the value table of Ctr.Base, so model apply gets ctr value by one array access.
+ * Values[i] is the ctr for bucket index i of table index hash, EmptyValue is the ctr for hashes missing in the table.
+ * Bins are the same values binarized by ctr feature Borders, they are empty if ctr feature borders were not known.
+ */
+struct TPrecomputedCtrValues {
+    TModelCtr Ctr;
+    TVector<float> Values;
+    float EmptyValue = 0.0f;
+    TVector<float> Borders;
+    TVector<ui8> Bins;
+    ui8 EmptyBin = 0;
+
+    bool operator==(const TPrecomputedCtrValues& other) const {
+        return std::tie(Ctr, Values, EmptyValue, Borders, Bins, EmptyBin) ==
+            std::tie(other.Ctr, other.Values, other.EmptyValue, other.Borders, other.Bins, other.EmptyBin);
+    }
+
+    bool HasBins() const {
+        return Bins.size() == Values.size();
+    }
+
+    void Save(IOutputStream* s) const;
+
+    void Load(IInputStream* s);
 };
 
 struct TCtrDataStreamWriter {
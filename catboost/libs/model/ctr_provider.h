@@ -7,6 +7,39 @@
 #include <util/generic/array_ref.h>
 
 
+/**
+ * Ctr calculation for a fixed list of needed ctrs with all model and provider lookups resolved in advance.
+ * Plan keeps raw pointers to provider data, so it is valid only while provider is alive and not modified.
+ */
+class ICtrCalcPlan : public TThrRefBase {
+public:
+    virtual ~ICtrCalcPlan() {
+    }
+
+    virtual void CalcCtrs(
+        const TConstArrayRef<ui8>& binarizedFeatures, // vector of binarized float & one hot features
+        const TConstArrayRef<int>& hashedCatFeatures,
+        size_t docCount,
+        TArrayRef<float> result) const = 0;
+
+    //! True if plan can write binarized ctr features with CalcCtrBins
+    virtual bool CanCalcCtrBins() const {
+        return false;
+    }
+
+    /**
+     * Same as CalcCtrs followed by binarization of ctr values by ctr feature borders.
+     * result can be a part of binarizedFeatures buffer that doesn't overlap with float & one hot features.
+     */
+    virtual void CalcCtrBins(
+        const TConstArrayRef<ui8>& /*binarizedFeatures*/,
+        const TConstArrayRef<int>& /*hashedCatFeatures*/,
+        size_t /*docCount*/,
+        TArrayRef<ui8> /*result*/) const {
+        ythrow yexception() << "Ctr bins calculation is not supported by this plan";
+    }
+};
+
 class ICtrProvider : public TThrRefBase {
 public:
     virtual ~ICtrProvider() {
@@ -26,6 +59,15 @@ public:
         const TVector<TOneHotFeature>& oheFeatures,
         const TVector<TCatFeature>& catFeatures) = 0;
 
+    /**
+     * Should be called after SetupBinFeatureIndexes.
+     * @return plan that calculates same values as CalcCtrs for ctrs of ctrFeatures or nullptr if provider has no such optimization
+     */
+    virtual TIntrusivePtr<ICtrCalcPlan> CreateCalcPlan(const TVector<TCtrFeature>& ctrFeatures) const {
+        Y_UNUSED(ctrFeatures);
+        return nullptr;
+    }
+
     virtual void AddCtrCalcerData(TCtrValueTable&& valueTable) = 0;
     virtual bool IsSerializable() const {
         return false;
@@ -39,6 +81,14 @@ public:
         throw yexception() << "Deserialization not allowed";
     };
 
+    /**
+     * Same as Load but provider data references stream memory instead of copying it.
+     * @param dataHolder owner of stream memory, provider keeps it alive
+     */
+    virtual void LoadNonOwning(TMemoryInput* , TIntrusivePtr<TThrRefBase> ) {
+        throw yexception() << "Deserialization not allowed";
+    };
+
     // can use this later for complex model deserialization logic
     virtual TString ModelPartIdentifier() const = 0;
 };
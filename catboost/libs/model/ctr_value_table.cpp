@@ -1,6 +1,8 @@
 #include "ctr_value_table.h"
 #include "flatbuffers_serializer_helper.h"
 #include <catboost/libs/model/flatbuffers/model.fbs.h>
+#include <catboost/libs/helpers/exception.h>
+#include <util/generic/bitops.h>
 #include <util/stream/input.h>
 #include <util/ysaveload.h>
 
@@ -62,3 +64,83 @@ void TCtrValueTable::LoadSolid(void* buf, size_t length) {
     solid.CTRBlob.assign(ctrValueTable->CTRBlob()->data(),
                          ctrValueTable->CTRBlob()->data() + ctrValueTable->CTRBlob()->size());
 }
+
+void TCtrValueTable::LoadThin(TMemoryInput* in) {
+    const ui32 size = LoadSize(in);
+    CB_ENSURE(in->Avail() >= size, "Unexpected end of ctr value table data");
+    const void* buf = in->Buf();
+    in->Skip(size);
+
+    auto ctrValueTable = flatbuffers::GetRoot<NCatBoostFbs::TCtrValueTable>(buf);
+    const ui8* ctrBlob = ctrValueTable->CTRBlob()->data();
+    if (reinterpret_cast<uintptr_t>(ctrBlob) % alignof(int) != 0) {
+        // ctr blob is read as int and float arrays, so misaligned tables are copied
+        LoadSolid(const_cast<void*>(buf), size);
+        return;
+    }
+    ModelCtrBase.FBDeserialize(ctrValueTable->ModelCtrBase());
+    CounterDenominator = ctrValueTable->CounterDenominator();
+    TargetClassesCount = ctrValueTable->TargetClassesCount();
+    TThinTable thin;
+    thin.IndexBuckets = MakeArrayRef(
+        reinterpret_cast<const NCatboost::TBucket*>(ctrValueTable->IndexHashRaw()->data()),
+        ctrValueTable->IndexHashRaw()->size() / sizeof(NCatboost::TBucket));
+    thin.CTRBlob = MakeArrayRef(ctrBlob, ctrValueTable->CTRBlob()->size());
+    Impl = thin;
+}
+
+size_t TCtrValueTable::GetStatsSize() const {
+    switch (ModelCtrBase.CtrType) {
+        case ECtrType::BinarizedTargetMeanValue:
+        case ECtrType::FloatTargetMeanValue:
+            return sizeof(TCtrMeanHistory);
+        case ECtrType::Counter:
+        case ECtrType::FeatureFreq:
+            return sizeof(int);
+        default:
+            return sizeof(int) * TargetClassesCount;
+    }
+}
+
+TCtrInlineTable::TCtrInlineTable(const TCtrValueTable& table) {
+    const auto indexBuckets = table.GetIndexHashViewer().GetBuckets();
+    const auto blob = table.GetTypedArrayRefForBlobData<ui8>();
+    const size_t statsSize = table.GetStatsSize();
+    BucketSize = FastClp2(sizeof(ui64) + statsSize);
+    HashMask = indexBuckets.size() - 1;
+    Storage.resize(indexBuckets.size() * BucketSize + CacheLineSize);
+    StorageOffset = (CacheLineSize - reinterpret_cast<uintptr_t>(Storage.data()) % CacheLineSize) % CacheLineSize;
+    ui8* buckets = Storage.data() + StorageOffset;
+    for (size_t slot = 0; slot < indexBuckets.size(); ++slot) {
+        const auto& indexBucket = indexBuckets[slot];
+        ui8* bucket = buckets + slot * BucketSize;
+        *reinterpret_cast<ui64*>(bucket) = indexBucket.Hash;
+        if (indexBucket.Hash != NCatboost::TBucket::InvalidHashValue) {
+            const size_t blobOffset = (size_t)indexBucket.IndexValue * statsSize;
+            CB_ENSURE(blobOffset + statsSize <= blob.size(), "Ctr value table index is out of blob bounds");
+            memcpy(bucket + sizeof(ui64), blob.data() + blobOffset, statsSize);
+        }
+    }
+}
+
+void TCtrInlineTable::GetStats(TConstArrayRef<ui64> hashes, const ui8** result) const {
+    const ui8* buckets = GetBuckets();
+    for (const ui64 hash : hashes) {
+        Y_PREFETCH_READ(buckets + (hash & HashMask) * BucketSize, 3);
+    }
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        const ui64 hash = hashes[i];
+        result[i] = nullptr;
+        for (ui64 slot = hash & HashMask; ; slot = (slot + 1) & HashMask) {
+            const ui8* bucket = buckets + slot * BucketSize;
+            const ui64 bucketHash = *reinterpret_cast<const ui64*>(bucket);
+            if (bucketHash == NCatboost::TBucket::InvalidHashValue) {
+                break;
+            }
+            if (bucketHash == hash) {
+                result[i] = bucket + sizeof(ui64);
+                break;
+            }
+        }
+    }
+}
@@ -8,6 +8,7 @@
 #include <util/generic/variant.h>
 #include <tuple>
 #include <util/stream/input.h>
+#include <util/stream/mem.h>
 #include <util/stream/output.h>
 
 class TCtrValueTable {
@@ -88,11 +89,25 @@ public:
 
     void LoadSolid(void* buf, size_t length);
 
+    /**
+     * Same as Load but table data is not copied and references memory of the stream,
+     * that memory should outlive the table.
+     */
+    void LoadThin(TMemoryInput* in);
+
     bool operator==(const TCtrValueTable& other) const {
         return std::tie(CounterDenominator, TargetClassesCount, Impl) ==
                std::tie(other.CounterDenominator, other.TargetClassesCount, other.Impl);
     }
 
+    //! False if table references memory it doesn't own, see LoadThin
+    bool IsSolid() const {
+        return Impl.Is<TSolidTable>();
+    }
+
+    //! Size in bytes of blob data stored for one hash value
+    size_t GetStatsSize() const;
+
 public:
     TModelCtrBase ModelCtrBase;
     int CounterDenominator = 0;
@@ -100,3 +115,39 @@ public:
 private:
     TVariant<TSolidTable, TThinTable> Impl;
 };
+
+/**
+ * Read only copy of TCtrValueTable with layout tuned for model apply.
+ * Blob data of each hash is stored in the hash bucket right after the hash, buckets are padded to a power of two
+ * and storage is aligned to cache line, so one lookup usually touches a single cache line instead of
+ * a bucket in index hash and a random place in blob.
+ * Buckets are placed in the same slots as in index hash of the source table.
+ */
+class TCtrInlineTable {
+public:
+    static constexpr size_t CacheLineSize = 64;
+
+    TCtrInlineTable() = default;
+    explicit TCtrInlineTable(const TCtrValueTable& table);
+
+    /**
+     * For each hash writes pointer to its blob data or nullptr if there is no such hash in table.
+     * Buckets of all hashes are prefetched before probing, so pass blocks of hashes to hide memory latency.
+     */
+    void GetStats(TConstArrayRef<ui64> hashes, const ui8** result) const;
+
+    size_t GetBucketSize() const {
+        return BucketSize;
+    }
+
+private:
+    const ui8* GetBuckets() const {
+        return Storage.data() + StorageOffset;
+    }
+
+private:
+    size_t BucketSize = 0;
+    ui64 HashMask = 0;
+    TVector<ui8> Storage;
+    size_t StorageOffset = 0;
+};
@@ -1,6 +1,11 @@
 #include "formula_evaluator.h"
 
 #include <util/stream/format.h>
+#include <util/system/cpu_id.h>
+
+#if defined(_unix_)
+#include <unistd.h>
+#endif
 
 #include <emmintrin.h>
 #include <pmmintrin.h>
@@ -9,20 +14,28 @@ void TFeatureCachedTreeEvaluator::Calc(size_t treeStart, size_t treeEnd, TArrayR
     CB_ENSURE(results.size() == DocCount * Model.ObliviousTrees.ApproxDimension);
     Fill(results.begin(), results.end(), 0.0);
 
-    TVector<TCalcerIndexType> indexesVec(BlockSize);
-    int id = 0;
-    for (size_t blockStart = 0; blockStart < DocCount; blockStart += BlockSize) {
-        const auto docCountInBlock = Min(BlockSize, DocCount - blockStart);
-        CalcFunction(
-                Model,
-                BinFeatures[id].data(),
-                docCountInBlock,
-                indexesVec.data(),
-                treeStart,
-                treeEnd,
-                results.data() + blockStart * Model.ObliviousTrees.ApproxDimension
-        );
-        ++id;
+    const auto& tiling = Model.GetEvaluationTiling();
+    const size_t blocksInGroup = Max<size_t>(tiling.DocBlocksInGroup, 1);
+    const size_t treesInChunk = blocksInGroup > 1 && tiling.TreesInChunk > 0 ? tiling.TreesInChunk : Max<size_t>(treeEnd - treeStart, 1);
+    TTreeCalcerBuffers calcerBuffers(Model.ObliviousTrees, BlockSize);
+    for (size_t groupStartId = 0; groupStartId < BinFeatures.size(); groupStartId += blocksInGroup) {
+        const size_t groupEndId = Min(BinFeatures.size(), groupStartId + blocksInGroup);
+        for (size_t chunkStart = treeStart; chunkStart < treeEnd; chunkStart += treesInChunk) {
+            const size_t chunkEnd = Min(treeEnd, chunkStart + treesInChunk);
+            for (size_t id = groupStartId; id < groupEndId; ++id) {
+                const size_t blockStart = id * BlockSize;
+                const auto docCountInBlock = Min(BlockSize, DocCount - blockStart);
+                CalcFunction(
+                        Model,
+                        BinFeatures[id].data(),
+                        docCountInBlock,
+                        &calcerBuffers,
+                        chunkStart,
+                        chunkEnd,
+                        results.data() + blockStart * Model.ObliviousTrees.ApproxDimension
+                );
+            }
+        }
     }
 }
 
@@ -219,6 +232,174 @@ Y_FORCE_INLINE void CalcIndexesSse(
 #undef STORE_16_DOCS_RESULT
 }
 
+void CalcIndexesSse2(
+    bool needXorMask,
+    const ui8* binFeatures,
+    size_t docCountInBlock,
+    ui8* indexesVec,
+    const TRepackedBin* treeSplitsCurPtr,
+    int curTreeSize) {
+#define CALC_INDEXES_SSE_CASE(blockCount) \
+    case blockCount: \
+        if (needXorMask) { \
+            CalcIndexesSse<true, blockCount>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize); \
+        } else { \
+            CalcIndexesSse<false, blockCount>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize); \
+        } \
+        break;
+
+    // CalcIndexesSse with 8 blocks has no tail processing, so it is used only for full evaluation blocks
+    const size_t sseBlockCount = docCountInBlock == FORMULA_EVALUATION_BLOCK_SIZE ? 8 : docCountInBlock / SSE_BLOCK_SIZE;
+    switch (sseBlockCount) {
+    CALC_INDEXES_SSE_CASE(0)
+    CALC_INDEXES_SSE_CASE(1)
+    CALC_INDEXES_SSE_CASE(2)
+    CALC_INDEXES_SSE_CASE(3)
+    CALC_INDEXES_SSE_CASE(4)
+    CALC_INDEXES_SSE_CASE(5)
+    CALC_INDEXES_SSE_CASE(6)
+    CALC_INDEXES_SSE_CASE(7)
+    CALC_INDEXES_SSE_CASE(8)
+    default:
+        // more than FORMULA_EVALUATION_BLOCK_SIZE documents, no need for register blocking here
+        if (needXorMask) {
+            CalcIndexesBasic<true, 0>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+        } else {
+            CalcIndexesBasic<false, 0>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+        }
+    }
+#undef CALC_INDEXES_SSE_CASE
+}
+
+#ifdef NO_SSE
+void BinarizeFloatsSse2(const float* values, size_t docCount, const float* borders, size_t borderCount, ui8* result) {
+    const auto docCount8 = (docCount | 0x7) ^ 0x7;
+    for (size_t docId = 0; docId < docCount8; docId += 8) {
+        const float* val = values + docId;
+        ui32 packed[2] = {0, 0};
+        for (size_t borderId = 0; borderId < borderCount; ++borderId) {
+            const float border = borders[borderId];
+            packed[0] += (val[0] > border) + ((val[1] > border) << 8) + ((val[2] > border) << 16) + ((val[3] > border) << 24);
+            packed[1] += (val[4] > border) + ((val[5] > border) << 8) + ((val[6] > border) << 16) + ((val[7] > border) << 24);
+        }
+        memcpy(result + docId, packed, sizeof(packed));
+    }
+    for (size_t docId = docCount8; docId < docCount; ++docId) {
+        ui8 binIdx = 0;
+        for (size_t borderId = 0; borderId < borderCount; ++borderId) {
+            binIdx += (ui8)(values[docId] > borders[borderId]);
+        }
+        result[docId] = binIdx;
+    }
+}
+
+#else
+void BinarizeFloatsSse2(const float* values, size_t docCount, const float* borders, size_t borderCount, ui8* result) {
+    const __m128i mask = _mm_set1_epi8(1);
+    const auto docCount16 = (docCount | 0xf) ^ 0xf;
+    for (size_t docId = 0; docId < docCount16; docId += 16) {
+        const __m128 floats0 = _mm_loadu_ps(values + docId + 0);
+        const __m128 floats1 = _mm_loadu_ps(values + docId + 4);
+        const __m128 floats2 = _mm_loadu_ps(values + docId + 8);
+        const __m128 floats3 = _mm_loadu_ps(values + docId + 12);
+        __m128i resultVec = _mm_setzero_si128();
+        for (size_t borderId = 0; borderId < borderCount; ++borderId) {
+            const __m128 borderVec = _mm_set1_ps(borders[borderId]);
+            const __m128i r0 = _mm_castps_si128(_mm_cmpgt_ps(floats0, borderVec));
+            const __m128i r1 = _mm_castps_si128(_mm_cmpgt_ps(floats1, borderVec));
+            const __m128i r2 = _mm_castps_si128(_mm_cmpgt_ps(floats2, borderVec));
+            const __m128i r3 = _mm_castps_si128(_mm_cmpgt_ps(floats3, borderVec));
+            const __m128i packed = _mm_packs_epi16(_mm_packs_epi32(r0, r1), _mm_packs_epi32(r2, r3));
+            resultVec = _mm_add_epi8(resultVec, _mm_and_si128(packed, mask));
+        }
+        _mm_storeu_si128((__m128i*)(result + docId), resultVec);
+    }
+    for (size_t docId = docCount16; docId < docCount; ++docId) {
+        ui8 binIdx = 0;
+        for (size_t borderId = 0; borderId < borderCount; ++borderId) {
+            binIdx += (ui8)(values[docId] > borders[borderId]);
+        }
+        result[docId] = binIdx;
+    }
+}
+
+#endif
+
+/**
+ * Branchless lower bound search for GroupSize values at once: all values share the same sequence of range lengths,
+ * so loads of different documents are independent and are issued in parallel.
+ */
+template<size_t GroupSize>
+Y_FORCE_INLINE void BinarySearchBorders(const float* __restrict values, const float* __restrict borders, size_t borderCount, ui8* __restrict result) {
+    size_t positions[GroupSize] = {0};
+    size_t length = borderCount;
+    while (length > 1) {
+        const size_t half = length / 2;
+        for (size_t i = 0; i < GroupSize; ++i) {
+            positions[i] += (values[i] > borders[positions[i] + half - 1]) ? half : 0;
+        }
+        length -= half;
+    }
+    for (size_t i = 0; i < GroupSize; ++i) {
+        result[i] = (ui8)(positions[i] + (length == 1 && values[i] > borders[positions[i]]));
+    }
+}
+
+void BinarizeFloatsBinarySearch(const float* values, size_t docCount, const float* borders, size_t borderCount, ui8* result) {
+    const auto docCount8 = (docCount | 0x7) ^ 0x7;
+    for (size_t docId = 0; docId < docCount8; docId += 8) {
+        BinarySearchBorders<8>(values + docId, borders, borderCount, result + docId);
+    }
+    for (size_t docId = docCount8; docId < docCount; ++docId) {
+        BinarySearchBorders<1>(values + docId, borders, borderCount, result + docId);
+    }
+}
+
+bool IsSimdLevelSupported(ESimdLevel simdLevel) {
+    switch (simdLevel) {
+        case ESimdLevel::Sse2:
+            return true;
+        case ESimdLevel::Avx2:
+            return NX86::CachedHaveAVX2();
+        case ESimdLevel::Avx512:
+            return NX86::CachedHaveAVX512F() && NX86::CachedHaveAVX512BW();
+    }
+    Y_UNREACHABLE();
+}
+
+ESimdLevel GetBestSimdLevel() {
+    static const ESimdLevel bestSimdLevel = [] {
+        for (auto simdLevel : {ESimdLevel::Avx512, ESimdLevel::Avx2}) {
+            if (IsSimdLevelSupported(simdLevel)) {
+                return simdLevel;
+            }
+        }
+        return ESimdLevel::Sse2;
+    }();
+    return bestSimdLevel;
+}
+
+constexpr size_t SSE2_BINARY_SEARCH_MIN_BORDERS = 80;
+constexpr size_t AVX2_BINARY_SEARCH_MIN_BORDERS = 80;
+constexpr size_t AVX512_BINARY_SEARCH_MIN_BORDERS = 96;
+
+const TEvaluationKernels& GetEvaluationKernels(ESimdLevel simdLevel) {
+    // binary search thresholds are crossover points measured with catboost/libs/model/benchmark
+    static const TEvaluationKernels sse2Kernels = {BinarizeFloatsSse2, BinarizeFloatsBinarySearch, SSE2_BINARY_SEARCH_MIN_BORDERS, CalcIndexesSse2};
+    static const TEvaluationKernels avx2Kernels = {BinarizeFloatsAvx2, BinarizeFloatsBinarySearchAvx2, AVX2_BINARY_SEARCH_MIN_BORDERS, CalcIndexesAvx2};
+    static const TEvaluationKernels avx512Kernels = {BinarizeFloatsAvx512, BinarizeFloatsBinarySearchAvx2, AVX512_BINARY_SEARCH_MIN_BORDERS, CalcIndexesAvx512};
+    CB_ENSURE(IsSimdLevelSupported(simdLevel), "SIMD level " << simdLevel << " is not supported by CPU");
+    switch (simdLevel) {
+        case ESimdLevel::Sse2:
+            return sse2Kernels;
+        case ESimdLevel::Avx2:
+            return avx2Kernels;
+        case ESimdLevel::Avx512:
+            return avx512Kernels;
+    }
+    Y_UNREACHABLE();
+}
+
 template<typename TIndexType>
 Y_FORCE_INLINE void CalculateLeafValues(const size_t docCountInBlock, const double* __restrict treeLeafPtr, const TIndexType* __restrict indexesPtr, double* __restrict writePtr) {
     Y_PREFETCH_READ(treeLeafPtr, 3);
@@ -320,7 +501,26 @@ Y_FORCE_INLINE void CalculateLeafValuesMulti(const size_t docCountInBlock, const
     }
 }
 
-template<bool IsSingleClassModel, bool NeedXorMask, int SSEBlockCount>
+template<ESimdLevel SimdLevel, bool NeedXorMask, int SSEBlockCount>
+Y_FORCE_INLINE void CalcIndexesDispatched(
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    ui8* __restrict indexesVec,
+    const TRepackedBin* __restrict treeSplitsCurPtr,
+    int curTreeSize) {
+    switch (SimdLevel) {
+        case ESimdLevel::Avx512:
+            CalcIndexesAvx512(NeedXorMask, binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+            break;
+        case ESimdLevel::Avx2:
+            CalcIndexesAvx2(NeedXorMask, binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+            break;
+        default:
+            CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+    }
+}
+
+template<ESimdLevel SimdLevel, bool IsSingleClassModel, bool NeedXorMask, int SSEBlockCount>
 Y_FORCE_INLINE void CalcTreesBlockedImpl(
     const TFullModel& model,
     const ui8* __restrict binFeatures,
@@ -352,18 +552,19 @@ Y_FORCE_INLINE void CalcTreesBlockedImpl(
                 resultsTmpArray.yresize(docCountInBlock * model.ObliviousTrees.ApproxDimension);
                 alignedResultsPtr = resultsTmpArray.data();
             }
-            memset(alignedResultsPtr, 0, neededMemory);
+            // trees are added to results, they can already contain approxes of previous trees
+            memcpy(alignedResultsPtr, resultsPtr, neededMemory);
         }
         auto treeEnd4 = treeStart + (((treeEnd - treeStart) | 0x3) ^ 0x3);
         for (size_t treeId = treeStart; treeId < treeEnd4; treeId += 4) {
             memset(indexesVec, 0, sizeof(ui32) * docCountInBlock);
-            CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 0, treeSplitsCurPtr, model.ObliviousTrees.TreeSizes[treeId]);
+            CalcIndexesDispatched<SimdLevel, NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 0, treeSplitsCurPtr, model.ObliviousTrees.TreeSizes[treeId]);
             treeSplitsCurPtr += model.ObliviousTrees.TreeSizes[treeId];
-            CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 1, treeSplitsCurPtr, model.ObliviousTrees.TreeSizes[treeId + 1]);
+            CalcIndexesDispatched<SimdLevel, NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 1, treeSplitsCurPtr, model.ObliviousTrees.TreeSizes[treeId + 1]);
             treeSplitsCurPtr += model.ObliviousTrees.TreeSizes[treeId + 1];
-            CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 2, treeSplitsCurPtr, model.ObliviousTrees.TreeSizes[treeId + 2]);
+            CalcIndexesDispatched<SimdLevel, NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 2, treeSplitsCurPtr, model.ObliviousTrees.TreeSizes[treeId + 2]);
             treeSplitsCurPtr += model.ObliviousTrees.TreeSizes[treeId + 2];
-            CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 3, treeSplitsCurPtr, model.ObliviousTrees.TreeSizes[treeId + 3]);
+            CalcIndexesDispatched<SimdLevel, NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 3, treeSplitsCurPtr, model.ObliviousTrees.TreeSizes[treeId + 3]);
             treeSplitsCurPtr += model.ObliviousTrees.TreeSizes[treeId + 3];
 
             CalculateLeafValues4<SSEBlockCount>(
@@ -388,7 +589,7 @@ Y_FORCE_INLINE void CalcTreesBlockedImpl(
         auto curTreeSize = model.ObliviousTrees.TreeSizes[treeId];
         memset(indexesVec, 0, sizeof(ui32) * docCountInBlock);
         if (curTreeSize <= 8) {
-            CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+            CalcIndexesDispatched<SimdLevel, NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
             if (IsSingleClassModel) { // single class model
                 CalculateLeafValues(docCountInBlock, treeLeafPtr + firstLeafOffsetsPtr[treeId], indexesVec, resultsPtr);
             } else { // mutliclass model
@@ -406,42 +607,42 @@ Y_FORCE_INLINE void CalcTreesBlockedImpl(
     }
 }
 
-template<bool IsSingleClassModel, bool NeedXorMask>
+template<ESimdLevel SimdLevel, bool IsSingleClassModel, bool NeedXorMask>
 inline void CalcTreesBlocked(
     const TFullModel& model,
     const ui8* __restrict binFeatures,
     size_t docCountInBlock,
-    TCalcerIndexType* __restrict indexesVec,
+    TTreeCalcerBuffers* buffers,
     size_t treeStart,
     size_t treeEnd,
     double* __restrict resultsPtr) {
     switch (docCountInBlock / SSE_BLOCK_SIZE) {
     case 0:
-        CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 0>(model, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr);
+        CalcTreesBlockedImpl<SimdLevel, IsSingleClassModel, NeedXorMask, 0>(model, binFeatures, docCountInBlock, buffers->IndexesVec, treeStart, treeEnd, resultsPtr);
         break;
     case 1:
-        CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 1>(model, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr);
+        CalcTreesBlockedImpl<SimdLevel, IsSingleClassModel, NeedXorMask, 1>(model, binFeatures, docCountInBlock, buffers->IndexesVec, treeStart, treeEnd, resultsPtr);
         break;
     case 2:
-        CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 2>(model, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr);
+        CalcTreesBlockedImpl<SimdLevel, IsSingleClassModel, NeedXorMask, 2>(model, binFeatures, docCountInBlock, buffers->IndexesVec, treeStart, treeEnd, resultsPtr);
         break;
     case 3:
-        CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 3>(model, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr);
+        CalcTreesBlockedImpl<SimdLevel, IsSingleClassModel, NeedXorMask, 3>(model, binFeatures, docCountInBlock, buffers->IndexesVec, treeStart, treeEnd, resultsPtr);
         break;
     case 4:
-        CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 4>(model, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr);
+        CalcTreesBlockedImpl<SimdLevel, IsSingleClassModel, NeedXorMask, 4>(model, binFeatures, docCountInBlock, buffers->IndexesVec, treeStart, treeEnd, resultsPtr);
         break;
     case 5:
-        CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 5>(model, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr);
+        CalcTreesBlockedImpl<SimdLevel, IsSingleClassModel, NeedXorMask, 5>(model, binFeatures, docCountInBlock, buffers->IndexesVec, treeStart, treeEnd, resultsPtr);
         break;
     case 6:
-        CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 6>(model, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr);
+        CalcTreesBlockedImpl<SimdLevel, IsSingleClassModel, NeedXorMask, 6>(model, binFeatures, docCountInBlock, buffers->IndexesVec, treeStart, treeEnd, resultsPtr);
         break;
     case 7:
-        CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 7>(model, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr);
+        CalcTreesBlockedImpl<SimdLevel, IsSingleClassModel, NeedXorMask, 7>(model, binFeatures, docCountInBlock, buffers->IndexesVec, treeStart, treeEnd, resultsPtr);
         break;
     case 8:
-        CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 8>(model, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr);
+        CalcTreesBlockedImpl<SimdLevel, IsSingleClassModel, NeedXorMask, 8>(model, binFeatures, docCountInBlock, buffers->IndexesVec, treeStart, treeEnd, resultsPtr);
         break;
     default:
         Y_UNREACHABLE();
@@ -453,7 +654,7 @@ inline void CalcTreesSingleDocImpl(
     const TFullModel& model,
     const ui8* __restrict binFeatures,
     size_t,
-    TCalcerIndexType* __restrict,
+    TTreeCalcerBuffers*,
     size_t treeStart,
     size_t treeEnd,
     double* __restrict results)
@@ -491,9 +692,112 @@ inline void CalcTreesSingleDocImpl(
     }
 }
 
-TTreeCalcFunction GetCalcTreesFunction(const TFullModel& model, size_t docCountInBlock) {
-    const bool hasOneHots = !model.ObliviousTrees.OneHotFeatures.empty();
-    if (model.ObliviousTrees.ApproxDimension == 1) {
+template<bool IsSingleClassModel, typename TIndexType>
+Y_FORCE_INLINE void AddLeafValuesCompensated(
+    const size_t docCountInBlock,
+    const float* __restrict treeLeafPtr,
+    const TIndexType* __restrict indexesPtr,
+    const int approxDimension,
+    float* __restrict sums,
+    float* __restrict compensations)
+{
+    // Kahan summation: compensations keep low order bits lost in float sums
+    const int dimension = IsSingleClassModel ? 1 : approxDimension;
+    for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+        const float* leafValuePtr = treeLeafPtr + indexesPtr[docId] * dimension;
+        for (int classId = 0; classId < dimension; ++classId) {
+            const float addition = leafValuePtr[classId] - compensations[classId];
+            const float sum = sums[classId] + addition;
+            compensations[classId] = (sum - sums[classId]) - addition;
+            sums[classId] = sum;
+        }
+        sums += dimension;
+        compensations += dimension;
+    }
+}
+
+template<ESimdLevel SimdLevel>
+Y_FORCE_INLINE void CalcIndexesForSimdLevel(
+    bool needXorMask,
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    ui8* __restrict indexesVec,
+    const TRepackedBin* __restrict treeSplitsCurPtr,
+    int curTreeSize) {
+    switch (SimdLevel) {
+        case ESimdLevel::Avx512:
+            CalcIndexesAvx512(needXorMask, binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+            break;
+        case ESimdLevel::Avx2:
+            CalcIndexesAvx2(needXorMask, binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+            break;
+        default:
+            CalcIndexesSse2(needXorMask, binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+    }
+}
+
+/**
+ * Tree calcer of float leaf values mode: leaf values of trees [treeStart, treeEnd) are gathered from
+ * TObliviousTrees::GetFloatLeafValues() and accumulated in float with compensated summation,
+ * block sums are added to double results once per call.
+ */
+template<ESimdLevel SimdLevel, bool IsSingleClassModel, bool NeedXorMask>
+void CalcTreesFloatLeafValues(
+    const TFullModel& model,
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    TTreeCalcerBuffers* buffers,
+    size_t treeStart,
+    size_t treeEnd,
+    double* __restrict resultsPtr)
+{
+    const auto& trees = model.ObliviousTrees;
+    const size_t resultCount = docCountInBlock * trees.ApproxDimension;
+    TCalcerIndexType* __restrict indexesVecUI32 = buffers->IndexesVec;
+    float* sums = buffers->FloatLeafSums;
+    float* compensations = sums + resultCount;
+    std::fill(sums, sums + 2 * resultCount, 0.0f);
+
+    const TRepackedBin* treeSplitsCurPtr = trees.GetRepackedBins().data() + trees.TreeStartOffsets[treeStart];
+    const float* treeLeafPtr = trees.GetFloatLeafValues().data();
+    const auto firstLeafOffsetsPtr = trees.GetFirstLeafOffsets().data();
+    ui8* __restrict indexesVec = (ui8*)indexesVecUI32;
+    for (size_t treeId = treeStart; treeId < treeEnd; ++treeId) {
+        const auto curTreeSize = trees.TreeSizes[treeId];
+        memset(indexesVecUI32, 0, sizeof(ui32) * docCountInBlock);
+        if (curTreeSize <= 8) {
+            CalcIndexesForSimdLevel<SimdLevel>(NeedXorMask, binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+            AddLeafValuesCompensated<IsSingleClassModel>(docCountInBlock, treeLeafPtr + firstLeafOffsetsPtr[treeId], indexesVec, trees.ApproxDimension, sums, compensations);
+        } else {
+            CalcIndexesBasic<NeedXorMask, 0>(binFeatures, docCountInBlock, indexesVecUI32, treeSplitsCurPtr, curTreeSize);
+            AddLeafValuesCompensated<IsSingleClassModel>(docCountInBlock, treeLeafPtr + firstLeafOffsetsPtr[treeId], indexesVecUI32, trees.ApproxDimension, sums, compensations);
+        }
+        treeSplitsCurPtr += curTreeSize;
+    }
+    for (size_t i = 0; i < resultCount; ++i) {
+        resultsPtr[i] += (double)sums[i] - (double)compensations[i];
+    }
+}
+
+template<ESimdLevel SimdLevel>
+static TTreeCalcFunction GetCalcTreesFunctionImpl(const TObliviousTrees& trees, size_t docCountInBlock) {
+    const bool hasOneHots = !trees.OneHotFeatures.empty();
+    if (trees.IsFloatLeafValuesMode()) {
+        if (trees.ApproxDimension == 1) {
+            if (hasOneHots) {
+                return CalcTreesFloatLeafValues<SimdLevel, true, true>;
+            } else {
+                return CalcTreesFloatLeafValues<SimdLevel, true, false>;
+            }
+        } else {
+            if (hasOneHots) {
+                return CalcTreesFloatLeafValues<SimdLevel, false, true>;
+            } else {
+                return CalcTreesFloatLeafValues<SimdLevel, false, false>;
+            }
+        }
+    }
+    if (trees.ApproxDimension == 1) {
         if (docCountInBlock == 1) {
             if (hasOneHots) {
                 return CalcTreesSingleDocImpl<true, true>;
@@ -502,9 +806,9 @@ TTreeCalcFunction GetCalcTreesFunction(const TFullModel& model, size_t docCountI
             }
         } else {
             if (hasOneHots) {
-                return CalcTreesBlocked<true, true>;
+                return CalcTreesBlocked<SimdLevel, true, true>;
             } else {
-                return CalcTreesBlocked<true, false>;
+                return CalcTreesBlocked<SimdLevel, true, false>;
             }
         }
     } else {
@@ -516,10 +820,60 @@ TTreeCalcFunction GetCalcTreesFunction(const TFullModel& model, size_t docCountI
             }
         } else {
             if (hasOneHots) {
-                return CalcTreesBlocked<false, true>;
+                return CalcTreesBlocked<SimdLevel, false, true>;
             } else {
-                return CalcTreesBlocked<false, false>;
+                return CalcTreesBlocked<SimdLevel, false, false>;
             }
         }
     }
 }
+
+TTreeCalcFunction GetCalcTreesFunction(const TObliviousTrees& trees, size_t docCountInBlock, ESimdLevel simdLevel) {
+    CB_ENSURE(IsSimdLevelSupported(simdLevel), "SIMD level " << simdLevel << " is not supported by CPU");
+    switch (simdLevel) {
+        case ESimdLevel::Sse2:
+            return GetCalcTreesFunctionImpl<ESimdLevel::Sse2>(trees, docCountInBlock);
+        case ESimdLevel::Avx2:
+            return GetCalcTreesFunctionImpl<ESimdLevel::Avx2>(trees, docCountInBlock);
+        case ESimdLevel::Avx512:
+            return GetCalcTreesFunctionImpl<ESimdLevel::Avx512>(trees, docCountInBlock);
+    }
+    Y_UNREACHABLE();
+}
+
+size_t GetL2CacheSize() {
+    static const size_t l2CacheSize = [] {
+        long size = 0;
+#if defined(_unix_) && defined(_SC_LEVEL2_CACHE_SIZE)
+        size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+        // typical L2 size if it is unknown
+        return size > 0 ? (size_t)size : (size_t)256 * 1024;
+    }();
+    return l2CacheSize;
+}
+
+// binarized features of a group of blocks should stay in last level cache
+constexpr size_t MAX_TILED_GROUP_BINARIZED_SIZE = 4 << 20;
+constexpr size_t MAX_DOC_BLOCKS_IN_GROUP = 64;
+
+TEvaluationTiling SelectEvaluationTiling(const TObliviousTrees& trees, size_t cacheSize) {
+    TEvaluationTiling tiling;
+    const size_t treeCount = trees.TreeSizes.size();
+    if (treeCount == 0) {
+        return tiling;
+    }
+    const size_t leafValueSize = trees.IsFloatLeafValuesMode() ? sizeof(float) : sizeof(double);
+    const size_t treeDataSize = trees.LeafValues.size() * leafValueSize + trees.GetRepackedBins().size() * sizeof(TRepackedBin);
+    // the other half of cache is left for binarized features, indexes and results of a block
+    const size_t treeDataBudget = cacheSize / 2;
+    if (treeDataSize <= treeDataBudget) {
+        return tiling;
+    }
+    const size_t averageTreeDataSize = Max<size_t>(treeDataSize / treeCount, 1);
+    // multiple of 4 to keep 4 trees at once evaluation of shallow trees
+    tiling.TreesInChunk = Max<size_t>(treeDataBudget / averageTreeDataSize / 4 * 4, 4);
+    const size_t binarizedBlockSize = Max<size_t>(trees.GetEffectiveBinaryFeaturesBucketsCount(), 1) * FORMULA_EVALUATION_BLOCK_SIZE;
+    tiling.DocBlocksInGroup = Max<size_t>(Min(MAX_TILED_GROUP_BINARIZED_SIZE / binarizedBlockSize, MAX_DOC_BLOCKS_IN_GROUP), 1);
+    return tiling;
+}
@@ -1,20 +1,51 @@
 #pragma once
 
 #include "model.h"
+#include "formula_evaluator_kernels.h"
+
 #include <catboost/libs/helpers/exception.h>
+#include <util/generic/noncopyable.h>
 #include <util/generic/ymath.h>
 #include <emmintrin.h>
 
 constexpr size_t FORMULA_EVALUATION_BLOCK_SIZE = 128;
 
+/**
+ * Scratch memory of tree calcers for blocks of up to blockSize documents, created once per apply call.
+ * Float leaf values mode calcer keeps sums and compensations of blockSize * ApproxDimension approxes in FloatLeafSums,
+ * buffer is allocated on heap only for multiclass models.
+ */
+struct TTreeCalcerBuffers : private TNonCopyable {
+    TCalcerIndexType IndexesVec[FORMULA_EVALUATION_BLOCK_SIZE];
+    float* FloatLeafSums = nullptr;
+
+    TTreeCalcerBuffers(const TObliviousTrees& trees, size_t blockSize) {
+        if (!trees.IsFloatLeafValuesMode()) {
+            return;
+        }
+        const size_t sumsSize = 2 * blockSize * trees.ApproxDimension;
+        if (sumsSize <= Y_ARRAY_SIZE(FloatLeafSumsBuffer)) {
+            FloatLeafSums = FloatLeafSumsBuffer;
+        } else {
+            FloatLeafSumsHolder.yresize(sumsSize);
+            FloatLeafSums = FloatLeafSumsHolder.data();
+        }
+    }
+
+private:
+    alignas(64) float FloatLeafSumsBuffer[2 * FORMULA_EVALUATION_BLOCK_SIZE];
+    TVector<float> FloatLeafSumsHolder;
+};
+
 inline void OneHotBinsFromTransposedCatFeatures(
     const TVector<TOneHotFeature>& OneHotFeatures,
-    const THashMap<int, int> catFeaturePackedIndex,
+    const TConstArrayRef<int> catFeaturePackedIndexes,
     const size_t docCount,
     ui8*& result,
-    TVector<int>& transposedHash) {
-    for (const auto& oheFeature : OneHotFeatures) {
-        const auto catIdx = catFeaturePackedIndex.at(oheFeature.CatFeatureIndex);
+    const TConstArrayRef<int> transposedHash) {
+    for (size_t oheFeatureIdx = 0; oheFeatureIdx < OneHotFeatures.size(); ++oheFeatureIdx) {
+        const auto& oheFeature = OneHotFeatures[oheFeatureIdx];
+        const auto catIdx = catFeaturePackedIndexes[oheFeatureIdx];
         for (size_t docId = 0; docId < docCount; ++docId) {
             const auto val = transposedHash[catIdx * docCount + docId];
             for (size_t borderIdx = 0; borderIdx < oheFeature.Values.size(); ++borderIdx) {
@@ -25,56 +56,9 @@ inline void OneHotBinsFromTransposedCatFeatures(
     }
 }
 
-#ifdef NO_SSE
-template<bool UseNanSubstitution, typename TFloatFeatureAccessor>
-Y_FORCE_INLINE void BinarizeFloats(
-    const size_t docCount,
-    TFloatFeatureAccessor floatAccessor,
-    const TConstArrayRef<float> borders,
-    size_t start,
-    ui8*& result,
-    float nanSubstitutionValue=0.0f
-) {
-    const auto docCount8 = (docCount | 0x7) ^ 0x7;
-    for (size_t docId = 0; docId < docCount8; docId += 8) {
-        float val[8] = {
-            floatAccessor(start + docId + 0),
-            floatAccessor(start + docId + 1),
-            floatAccessor(start + docId + 2),
-            floatAccessor(start + docId + 3),
-            floatAccessor(start + docId + 4),
-            floatAccessor(start + docId + 5),
-            floatAccessor(start + docId + 6),
-            floatAccessor(start + docId + 7)
-        };
-        if (UseNanSubstitution) {
-            for (size_t i = 0; i < 8; ++i) {
-                if (IsNan(val[i])) {
-                    val[i] = nanSubstitutionValue;
-                }
-            }
-        }
-        auto writePtr = (ui32*)(result + docId);
-        for (const auto border : borders) {
-            writePtr[0] += (val[0] > border) + ((val[1] > border) << 8) + ((val[2] > border) << 16) + ((val[3] > border) << 24);
-            writePtr[1] += (val[4] > border) + ((val[5] > border) << 8) + ((val[6] > border) << 16) + ((val[7] > border) << 24);
-        }
-    }
-    for (size_t docId = docCount8; docId < docCount; ++docId) {
-        float val = floatAccessor(start + docId);
-        if (UseNanSubstitution) {
-            if (IsNan(val)) {
-                val = nanSubstitutionValue;
-            }
-        }
-        for (const auto border : borders) {
-            result[docId] += (ui8)(val > border);
-        }
-    }
-    result += docCount;
-}
-
-#else
+/**
+ * Gathers feature values with accessor in small chunks and binarizes them with SIMD kernel.
+ */
 template<bool UseNanSubstitution, typename TFloatFeatureAccessor>
 Y_FORCE_INLINE void BinarizeFloats(
     const size_t docCount,
@@ -82,82 +66,26 @@ Y_FORCE_INLINE void BinarizeFloats(
     const TConstArrayRef<float> borders,
     size_t start,
     ui8*& result,
+    const TBinarizeFloatsKernel binarizeKernel,
     const float nanSubstitutionValue = 0.0f
 ) {
-    const __m128 substitutionValVec = _mm_set1_ps(nanSubstitutionValue);
-    const auto docCount16 = (docCount | 0xf) ^ 0xf;
-    for (size_t docId = 0; docId < docCount16; docId += 16) {
-        const float val[16] = {
-            floatAccessor(start + docId + 0),
-            floatAccessor(start + docId + 1),
-            floatAccessor(start + docId + 2),
-            floatAccessor(start + docId + 3),
-            floatAccessor(start + docId + 4),
-            floatAccessor(start + docId + 5),
-            floatAccessor(start + docId + 6),
-            floatAccessor(start + docId + 7),
-            floatAccessor(start + docId + 8),
-            floatAccessor(start + docId + 9),
-            floatAccessor(start + docId + 10),
-            floatAccessor(start + docId + 11),
-            floatAccessor(start + docId + 12),
-            floatAccessor(start + docId + 13),
-            floatAccessor(start + docId + 14),
-            floatAccessor(start + docId + 15)
-        };
-        const __m128i mask = _mm_set1_epi8(1);
-        __m128 floats0 = _mm_load_ps(val);
-        __m128 floats1 = _mm_load_ps(val + 4);
-        __m128 floats2 = _mm_load_ps(val + 8);
-        __m128 floats3 = _mm_load_ps(val + 12);
-        __m128i resultVec = _mm_setzero_si128();
-
-        if (UseNanSubstitution) {
-            {
-                const __m128 masks = _mm_cmpunord_ps(floats0, floats0);
-                floats0 = _mm_or_ps(_mm_andnot_ps(masks, floats0), _mm_and_ps(masks, substitutionValVec));
-            }
-            {
-                const __m128 masks = _mm_cmpunord_ps(floats1, floats1);
-                floats1 = _mm_or_ps(_mm_andnot_ps(masks, floats1), _mm_and_ps(masks, substitutionValVec));
-            }
-            {
-                const __m128 masks = _mm_cmpunord_ps(floats2, floats2);
-                floats2 = _mm_or_ps(_mm_andnot_ps(masks, floats2), _mm_and_ps(masks, substitutionValVec));
-            }
-            {
-                const __m128 masks = _mm_cmpunord_ps(floats3, floats3);
-                floats3 = _mm_or_ps(_mm_andnot_ps(masks, floats3), _mm_and_ps(masks, substitutionValVec));
-            }
-        }
-
-        for (const auto border : borders) {
-            const __m128 borderVec = _mm_set1_ps(border);
-            const __m128i r0 = _mm_castps_si128(_mm_cmpgt_ps(floats0, borderVec));
-            const __m128i r1 = _mm_castps_si128(_mm_cmpgt_ps(floats1, borderVec));
-            const __m128i r2 = _mm_castps_si128(_mm_cmpgt_ps(floats2, borderVec));
-            const __m128i r3 = _mm_castps_si128(_mm_cmpgt_ps(floats3, borderVec));
-            const __m128i packed = _mm_packs_epi16(_mm_packs_epi32(r0, r1), _mm_packs_epi32(r2, r3));
-            resultVec = _mm_add_epi8(resultVec, _mm_and_si128(packed, mask));
-        }
-        _mm_storeu_si128((__m128i*)(result + docId), resultVec);
-    }
-    for (size_t docId = docCount16; docId < docCount; ++docId) {
-        float val = floatAccessor(start + docId);
-        if (UseNanSubstitution) {
-            if (IsNan(val)) {
-                val = nanSubstitutionValue;
+    alignas(64) float values[FORMULA_EVALUATION_BLOCK_SIZE];
+    for (size_t chunkStart = 0; chunkStart < docCount; chunkStart += FORMULA_EVALUATION_BLOCK_SIZE) {
+        const auto docCountInChunk = Min(FORMULA_EVALUATION_BLOCK_SIZE, docCount - chunkStart);
+        for (size_t docId = 0; docId < docCountInChunk; ++docId) {
+            float val = floatAccessor(start + chunkStart + docId);
+            if (UseNanSubstitution) {
+                if (IsNan(val)) {
+                    val = nanSubstitutionValue;
+                }
             }
+            values[docId] = val;
         }
-        for (const auto border : borders) {
-            result[docId] += (ui8)(val > border);
-        }
+        binarizeKernel(values, docCountInChunk, borders.data(), borders.size(), result + chunkStart);
     }
     result += docCount;
 }
 
-#endif
-
 /**
 * This function binarizes
 */
@@ -169,8 +97,9 @@ inline void BinarizeFeatures(
     size_t start,
     size_t end,
     TArrayRef<ui8> result,
-    TVector<int>& transposedHash,
-    TVector<float>& ctrs
+    TArrayRef<int> transposedHash,
+    TArrayRef<float> ctrs,
+    const TEvaluationKernels& kernels = GetEvaluationKernels()
 ) {
     const auto docCount = end - start;
     ui8* resultPtr = result.data();
@@ -182,7 +111,8 @@ inline void BinarizeFeatures(
                 [&floatFeature, floatAccessor](size_t index) { return floatAccessor(floatFeature, index); },
                 floatFeature.Borders,
                 start,
-                resultPtr);
+                resultPtr,
+                kernels.GetBinarizeFloatsKernel(floatFeature.Borders.size()));
         } else {
             const float infinity = std::numeric_limits<float>::infinity();
             if (floatFeature.NanValueTreatment == NCatBoostFbs::ENanValueTreatment_AsFalse) {
@@ -192,6 +122,7 @@ inline void BinarizeFeatures(
                     floatFeature.Borders,
                     start,
                     resultPtr,
+                    kernels.GetBinarizeFloatsKernel(floatFeature.Borders.size()),
                     -infinity);
             } else {
                 Y_ASSERT(floatFeature.NanValueTreatment == NCatBoostFbs::ENanValueTreatment_AsTrue);
@@ -201,6 +132,7 @@ inline void BinarizeFeatures(
                     floatFeature.Borders,
                     start,
                     resultPtr,
+                    kernels.GetBinarizeFloatsKernel(floatFeature.Borders.size()),
                     infinity);
             }
         }
@@ -214,42 +146,41 @@ inline void BinarizeFeatures(
                 idx += docCount;
             }
         }
-        THashMap<int, int> catFeaturePackedIndexes;
-        for (int i = 0; i < model.ObliviousTrees.CatFeatures.ysize(); ++i) {
-            catFeaturePackedIndexes[model.ObliviousTrees.CatFeatures[i].FeatureIndex] = i;
-        }
-        OneHotBinsFromTransposedCatFeatures(model.ObliviousTrees.OneHotFeatures, catFeaturePackedIndexes, docCount, resultPtr, transposedHash);
-        model.CtrProvider->CalcCtrs(
-            model.ObliviousTrees.GetUsedModelCtrs(),
-            result,
-            transposedHash,
+        OneHotBinsFromTransposedCatFeatures(
+            model.ObliviousTrees.OneHotFeatures,
+            model.ObliviousTrees.GetOneHotFeaturesPackedCatIndexes(),
             docCount,
-            ctrs
-        );
+            resultPtr,
+            transposedHash);
+        const auto* ctrCalcPlan = model.ObliviousTrees.GetCtrCalcPlan();
+        if (ctrCalcPlan && ctrCalcPlan->CanCalcCtrBins()) {
+            // ctr bins follow float and one hot features, plan reads only these
+            ctrCalcPlan->CalcCtrBins(
+                result,
+                transposedHash,
+                docCount,
+                MakeArrayRef(resultPtr, model.ObliviousTrees.CtrFeatures.size() * docCount));
+            return;
+        }
+        if (ctrCalcPlan) {
+            ctrCalcPlan->CalcCtrs(result, transposedHash, docCount, ctrs);
+        } else if (!model.ObliviousTrees.GetUsedModelCtrs().empty()) {
+            model.CtrProvider->CalcCtrs(
+                model.ObliviousTrees.GetUsedModelCtrs(),
+                result,
+                transposedHash,
+                docCount,
+                ctrs
+            );
+        }
         for (size_t i = 0; i < model.ObliviousTrees.CtrFeatures.size(); ++i) {
             const auto& ctr = model.ObliviousTrees.CtrFeatures[i];
-            auto ctrFloatsPtr = &ctrs[i * docCount];
-            BinarizeFloats<false>(
-                docCount,
-                [ctrFloatsPtr](size_t index) { return ctrFloatsPtr[index]; },
-                ctr.Borders,
-                0,
-                resultPtr);
+            kernels.GetBinarizeFloatsKernel(ctr.Borders.size())(&ctrs[i * docCount], docCount, ctr.Borders.data(), ctr.Borders.size(), resultPtr);
+            resultPtr += docCount;
         }
     }
 }
 
-using TCalcerIndexType = ui32;
-
-using TTreeCalcFunction = std::function<void(
-    const TFullModel& model,
-    const ui8* __restrict binFeatures,
-    size_t docCountInBlock,
-    TCalcerIndexType* __restrict indexesVec,
-    size_t treeStart,
-    size_t treeEnd,
-    double* __restrict results)>;
-
 void CalcIndexes(
     bool needXorMask,
     const ui8* __restrict binFeatures,
@@ -258,7 +189,28 @@ void CalcIndexes(
     const TRepackedBin* __restrict treeSplitsCurPtr,
     int curTreeSize);
 
-TTreeCalcFunction GetCalcTreesFunction(const TFullModel& model, size_t docCountInBlock);
+TTreeCalcFunction GetCalcTreesFunction(const TObliviousTrees& trees, size_t docCountInBlock, ESimdLevel simdLevel);
+
+inline TTreeCalcFunction GetCalcTreesFunction(const TFullModel& model, size_t docCountInBlock, ESimdLevel simdLevel) {
+    if (simdLevel == GetBestSimdLevel()) {
+        return model.ObliviousTrees.GetTreeCalcer(docCountInBlock);
+    }
+    return GetCalcTreesFunction(model.ObliviousTrees, docCountInBlock, simdLevel);
+}
+
+//! L2 data cache size of the CPU, detected once
+size_t GetL2CacheSize();
+
+/**
+ * Doc-major order if trees data fits into a half of cache, otherwise trees are split into chunks of that size
+ * and are applied to groups of document blocks.
+ */
+TEvaluationTiling SelectEvaluationTiling(const TObliviousTrees& trees, size_t cacheSize);
+
+//! Returns tree calcer selected for the model in TObliviousTrees::UpdateMetadata()
+inline TTreeCalcFunction GetCalcTreesFunction(const TFullModel& model, size_t docCountInBlock) {
+    return model.ObliviousTrees.GetTreeCalcer(docCountInBlock);
+}
 
 template<class X>
 inline X* GetAligned(X* val) {
@@ -275,25 +227,47 @@ inline void CalcGeneric(
     size_t docCount,
     size_t treeStart,
     size_t treeEnd,
-    TArrayRef<double> results)
+    TArrayRef<double> results,
+    ESimdLevel simdLevel = GetBestSimdLevel())
 {
     size_t blockSize = FORMULA_EVALUATION_BLOCK_SIZE;
     blockSize = Min(blockSize, docCount);
-    const size_t binSlots = blockSize * model.ObliviousTrees.GetEffectiveBinaryFeaturesBucketsCount();
+    const auto& tiling = model.GetEvaluationTiling();
+    const size_t blockCount = blockSize > 0 ? (docCount + blockSize - 1) / blockSize : 0;
+    const size_t blocksInGroup = Max<size_t>(Min(tiling.DocBlocksInGroup, blockCount), 1);
+    const size_t blockBinSlots = blockSize * model.ObliviousTrees.GetEffectiveBinaryFeaturesBucketsCount();
+    // binarized features of all blocks in group
+    const size_t binSlots = blockBinSlots * blocksInGroup;
     TArrayRef<ui8> binFeatures;
     TVector<ui8> binFeaturesHolder;
     if (binSlots < 65536) { // 65KB of stack maximum
         binFeatures = MakeArrayRef(GetAligned((ui8*)(alloca(binSlots + 0x20))), binSlots);
     } else {
-        binFeaturesHolder.yresize(blockSize * model.ObliviousTrees.GetEffectiveBinaryFeaturesBucketsCount());
+        binFeaturesHolder.yresize(binSlots);
         binFeatures = binFeaturesHolder;
     }
-    auto calcTrees = GetCalcTreesFunction(model, blockSize);
+    const size_t transposedHashSize = blockSize * model.ObliviousTrees.CatFeatures.size();
+    const auto* ctrCalcPlan = model.ObliviousTrees.GetCtrCalcPlan();
+    // float ctr values are not needed if plan writes ctr bins directly
+    const size_t ctrsSize = ctrCalcPlan && ctrCalcPlan->CanCalcCtrBins() ? 0 : blockSize * model.ObliviousTrees.GetUsedModelCtrs().size();
+    TArrayRef<int> transposedHash;
+    TArrayRef<float> ctrs;
+    TVector<int> transposedHashHolder;
+    TVector<float> ctrsHolder;
+    if (transposedHashSize + ctrsSize < 4096) { // 16KB of stack maximum
+        transposedHash = MakeArrayRef((int*)alloca(transposedHashSize * sizeof(int) + 1), transposedHashSize);
+        ctrs = MakeArrayRef((float*)alloca(ctrsSize * sizeof(float) + 1), ctrsSize);
+    } else {
+        transposedHashHolder.yresize(transposedHashSize);
+        ctrsHolder.yresize(ctrsSize);
+        transposedHash = transposedHashHolder;
+        ctrs = ctrsHolder;
+    }
+    auto calcTrees = GetCalcTreesFunction(model, blockSize, simdLevel);
+    const auto& kernels = GetEvaluationKernels(simdLevel);
     if (docCount == 1) {
         CB_ENSURE((int)results.size() == model.ObliviousTrees.ApproxDimension);
         std::fill(results.begin(), results.end(), 0.0);
-        TVector<int> transposedHash(model.ObliviousTrees.CatFeatures.size());
-        TVector<float> ctrs(model.ObliviousTrees.GetUsedModelCtrs().size());
         BinarizeFeatures(
             model,
             floatFeatureAccessor,
@@ -302,13 +276,15 @@ inline void CalcGeneric(
             1,
             binFeatures,
             transposedHash,
-            ctrs
+            ctrs,
+            kernels
         );
+        TTreeCalcerBuffers calcerBuffers(model.ObliviousTrees, 1);
         calcTrees(
                 model,
                 binFeatures.data(),
                 1,
-                nullptr,
+                &calcerBuffers,
                 treeStart,
                 treeEnd,
                 results.data()
@@ -318,30 +294,39 @@ inline void CalcGeneric(
 
     CB_ENSURE(results.size() == docCount * model.ObliviousTrees.ApproxDimension);
     std::fill(results.begin(), results.end(), 0.0);
-    TVector<TCalcerIndexType> indexesVec(blockSize);
-    TVector<int> transposedHash(blockSize * model.ObliviousTrees.CatFeatures.size());
-    TVector<float> ctrs(model.ObliviousTrees.GetUsedModelCtrs().size() * blockSize);
-    for (size_t blockStart = 0; blockStart < docCount; blockStart += blockSize) {
-        const auto docCountInBlock = Min(blockSize, docCount - blockStart);
-        BinarizeFeatures(
-            model,
-            floatFeatureAccessor,
-            catFeaturesAccessor,
-            blockStart,
-            blockStart + docCountInBlock,
-            binFeatures,
-            transposedHash,
-            ctrs
-        );
-        calcTrees(
-            model,
-            binFeatures.data(),
-            docCountInBlock,
-            indexesVec.data(),
-            treeStart,
-            treeEnd,
-            results.data() + blockStart * model.ObliviousTrees.ApproxDimension
-        );
+    TTreeCalcerBuffers calcerBuffers(model.ObliviousTrees, blockSize);
+    const size_t treesInChunk = blocksInGroup > 1 && tiling.TreesInChunk > 0 ? tiling.TreesInChunk : Max<size_t>(treeEnd - treeStart, 1);
+    const size_t groupSize = blockSize * blocksInGroup;
+    for (size_t groupStart = 0; groupStart < docCount; groupStart += groupSize) {
+        const size_t groupEnd = Min(docCount, groupStart + groupSize);
+        for (size_t blockStart = groupStart; blockStart < groupEnd; blockStart += blockSize) {
+            const auto docCountInBlock = Min(blockSize, groupEnd - blockStart);
+            BinarizeFeatures(
+                model,
+                floatFeatureAccessor,
+                catFeaturesAccessor,
+                blockStart,
+                blockStart + docCountInBlock,
+                binFeatures.Slice((blockStart - groupStart) / blockSize * blockBinSlots, blockBinSlots),
+                transposedHash,
+                ctrs,
+                kernels
+            );
+        }
+        for (size_t chunkStart = treeStart; chunkStart < treeEnd; chunkStart += treesInChunk) {
+            const size_t chunkEnd = Min(treeEnd, chunkStart + treesInChunk);
+            for (size_t blockStart = groupStart; blockStart < groupEnd; blockStart += blockSize) {
+                calcTrees(
+                    model,
+                    binFeatures.data() + (blockStart - groupStart) / blockSize * blockBinSlots,
+                    Min(blockSize, groupEnd - blockStart),
+                    &calcerBuffers,
+                    chunkStart,
+                    chunkEnd,
+                    results.data() + blockStart * model.ObliviousTrees.ApproxDimension
+                );
+            }
+        }
     }
 }
 
@@ -392,26 +377,42 @@ private:
     ui64 BlockSize;
 };
 
+/**
+ * Staged model evaluation. Each block of documents is binarized once and trees are applied in order starting from treeStart,
+ * after trees [treeStart, stageTreeEnds[stageIdx]) are applied cumulative approxes are written for stage stageIdx.
+ * results layout is [stageIdx * docCount * ApproxDimension + docId * ApproxDimension + classId].
+ */
 template<typename TFloatFeatureAccessor, typename TCatFeatureAccessor>
-inline TVector<TVector<double>> CalcTreeIntervalsGeneric(
+inline void CalcTreeStagesGeneric(
     const TFullModel& model,
     TFloatFeatureAccessor floatFeatureAccessor,
     TCatFeatureAccessor catFeaturesAccessor,
     size_t docCount,
-    size_t incrementStep)
+    size_t treeStart,
+    TConstArrayRef<size_t> stageTreeEnds,
+    TArrayRef<double> results)
 {
+    const size_t approxDimension = model.ObliviousTrees.ApproxDimension;
+    CB_ENSURE(results.size() == stageTreeEnds.size() * docCount * approxDimension,
+              "Staged results size should be " << stageTreeEnds.size() * docCount * approxDimension << " got " << results.size());
+    size_t prevStageEnd = treeStart;
+    for (const size_t stageEnd : stageTreeEnds) {
+        CB_ENSURE(prevStageEnd <= stageEnd && stageEnd <= model.ObliviousTrees.TreeSizes.size(),
+                  "Stage tree ends should be non-decreasing and not greater than tree count");
+        prevStageEnd = stageEnd;
+    }
+    if (docCount == 0) {
+        return;
+    }
     size_t blockSize = FORMULA_EVALUATION_BLOCK_SIZE;
     blockSize = Min(blockSize, docCount);
-    auto treeStepCount = (model.ObliviousTrees.TreeSizes.size() + incrementStep - 1) / incrementStep;
-    TVector<TVector<double>> results(docCount, TVector<double>(treeStepCount));
-    CB_ENSURE(model.ObliviousTrees.ApproxDimension == 1);
     TVector<ui8> binFeatures(model.ObliviousTrees.GetEffectiveBinaryFeaturesBucketsCount() * blockSize);
-    TVector<TCalcerIndexType> indexesVec(blockSize);
+    TTreeCalcerBuffers calcerBuffers(model.ObliviousTrees, blockSize);
     TVector<int> transposedHash(blockSize * model.ObliviousTrees.CatFeatures.size());
     TVector<float> ctrs(model.ObliviousTrees.GetUsedModelCtrs().size() * blockSize);
-    TVector<double> tmpResult(docCount);
-    TArrayRef<double> tmpResultRef(tmpResult);
+    TVector<double> blockApprox(blockSize * approxDimension);
     auto calcTrees = GetCalcTreesFunction(model, blockSize);
+    const size_t stageResultSize = docCount * approxDimension;
     for (size_t blockStart = 0; blockStart < docCount; blockStart += blockSize) {
         const auto docCountInBlock = Min(blockSize, docCount - blockStart);
         BinarizeFeatures(
@@ -424,19 +425,47 @@ inline TVector<TVector<double>> CalcTreeIntervalsGeneric(
             transposedHash,
             ctrs
         );
-        for (size_t stepIdx = 0; stepIdx < treeStepCount; ++stepIdx) {
+        Fill(blockApprox.begin(), blockApprox.end(), 0.0);
+        size_t stageStart = treeStart;
+        for (size_t stageIdx = 0; stageIdx < stageTreeEnds.size(); ++stageIdx) {
             calcTrees(
                 model,
                 binFeatures.data(),
                 docCountInBlock,
-                indexesVec.data(),
-                stepIdx * incrementStep,
-                Min((stepIdx + 1) * incrementStep, model.ObliviousTrees.TreeSizes.size()),
-                tmpResultRef.data() + blockStart * model.ObliviousTrees.ApproxDimension
+                &calcerBuffers,
+                stageStart,
+                stageTreeEnds[stageIdx],
+                blockApprox.data()
             );
-            for (size_t i = 0; i < docCountInBlock; ++i) {
-                results[blockStart + i][stepIdx] = tmpResult[i];
-            }
+            stageStart = stageTreeEnds[stageIdx];
+            Copy(
+                blockApprox.begin(),
+                blockApprox.begin() + docCountInBlock * approxDimension,
+                results.begin() + stageIdx * stageResultSize + blockStart * approxDimension);
+        }
+    }
+}
+
+template<typename TFloatFeatureAccessor, typename TCatFeatureAccessor>
+inline TVector<TVector<double>> CalcTreeIntervalsGeneric(
+    const TFullModel& model,
+    TFloatFeatureAccessor floatFeatureAccessor,
+    TCatFeatureAccessor catFeaturesAccessor,
+    size_t docCount,
+    size_t incrementStep)
+{
+    const size_t approxDimension = model.ObliviousTrees.ApproxDimension;
+    const TVector<size_t> stageTreeEnds = GetStageTreeEnds(0, model.ObliviousTrees.TreeSizes.size(), incrementStep);
+    TVector<double> stagedResults(stageTreeEnds.size() * docCount * approxDimension);
+    CalcTreeStagesGeneric(model, floatFeatureAccessor, catFeaturesAccessor, docCount, 0, stageTreeEnds, stagedResults);
+    TVector<TVector<double>> results(docCount, TVector<double>(stageTreeEnds.size() * approxDimension));
+    for (size_t stageIdx = 0; stageIdx < stageTreeEnds.size(); ++stageIdx) {
+        const double* stageResults = stagedResults.data() + stageIdx * docCount * approxDimension;
+        for (size_t docId = 0; docId < docCount; ++docId) {
+            Copy(
+                stageResults + docId * approxDimension,
+                stageResults + (docId + 1) * approxDimension,
+                results[docId].begin() + stageIdx * approxDimension);
         }
     }
     return results;
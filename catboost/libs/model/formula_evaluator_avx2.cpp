@@ -0,0 +1,178 @@
+#include "formula_evaluator_kernels.h"
+
+#ifdef AVX2_STUB
+
+#include <util/system/yassert.h>
+
+void BinarizeFloatsAvx2(const float*, size_t, const float*, size_t, ui8*) {
+    Y_FAIL("AVX2 kernels are not available on this platform");
+}
+
+void BinarizeFloatsBinarySearchAvx2(const float*, size_t, const float*, size_t, ui8*) {
+    Y_FAIL("AVX2 kernels are not available on this platform");
+}
+
+void CalcIndexesAvx2(bool, const ui8*, size_t, ui8*, const TRepackedBin*, int) {
+    Y_FAIL("AVX2 kernels are not available on this platform");
+}
+
+#else
+
+#include <util/system/compiler.h>
+
+#include <immintrin.h>
+
+constexpr size_t AVX2_BLOCK_SIZE = 32;
+
+void BinarizeFloatsAvx2(const float* values, size_t docCount, const float* borders, size_t borderCount, ui8* result) {
+    // _mm256_packs_* work inside 128-bit lanes, so packed compare results are stored in dword order 0,2,4,6,1,3,5,7
+    const __m256i lanesPermutation = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    const auto docCount32 = (docCount | 0x1f) ^ 0x1f;
+    for (size_t docId = 0; docId < docCount32; docId += AVX2_BLOCK_SIZE) {
+        const __m256 floats0 = _mm256_loadu_ps(values + docId + 0);
+        const __m256 floats1 = _mm256_loadu_ps(values + docId + 8);
+        const __m256 floats2 = _mm256_loadu_ps(values + docId + 16);
+        const __m256 floats3 = _mm256_loadu_ps(values + docId + 24);
+        __m256i resultVec = _mm256_setzero_si256();
+        for (size_t borderId = 0; borderId < borderCount; ++borderId) {
+            const __m256 borderVec = _mm256_set1_ps(borders[borderId]);
+            const __m256i r0 = _mm256_castps_si256(_mm256_cmp_ps(floats0, borderVec, _CMP_GT_OQ));
+            const __m256i r1 = _mm256_castps_si256(_mm256_cmp_ps(floats1, borderVec, _CMP_GT_OQ));
+            const __m256i r2 = _mm256_castps_si256(_mm256_cmp_ps(floats2, borderVec, _CMP_GT_OQ));
+            const __m256i r3 = _mm256_castps_si256(_mm256_cmp_ps(floats3, borderVec, _CMP_GT_OQ));
+            const __m256i packed = _mm256_packs_epi16(_mm256_packs_epi32(r0, r1), _mm256_packs_epi32(r2, r3));
+            // packed bytes are 0xff for borders less than value
+            resultVec = _mm256_sub_epi8(resultVec, packed);
+        }
+        _mm256_storeu_si256((__m256i*)(result + docId), _mm256_permutevar8x32_epi32(resultVec, lanesPermutation));
+    }
+    for (size_t docId = docCount32; docId < docCount; ++docId) {
+        ui8 binIdx = 0;
+        for (size_t borderId = 0; borderId < borderCount; ++borderId) {
+            binIdx += (ui8)(values[docId] > borders[borderId]);
+        }
+        result[docId] = binIdx;
+    }
+}
+
+void BinarizeFloatsBinarySearchAvx2(const float* values, size_t docCount, const float* borders, size_t borderCount, ui8* result) {
+    const __m256i lanesPermutation = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    const auto docCount32 = (docCount | 0x1f) ^ 0x1f;
+    for (size_t docId = 0; docId < docCount32; docId += AVX2_BLOCK_SIZE) {
+        const __m256 floats0 = _mm256_loadu_ps(values + docId + 0);
+        const __m256 floats1 = _mm256_loadu_ps(values + docId + 8);
+        const __m256 floats2 = _mm256_loadu_ps(values + docId + 16);
+        const __m256 floats3 = _mm256_loadu_ps(values + docId + 24);
+        __m256i positions0 = _mm256_setzero_si256();
+        __m256i positions1 = _mm256_setzero_si256();
+        __m256i positions2 = _mm256_setzero_si256();
+        __m256i positions3 = _mm256_setzero_si256();
+#define SEARCH_STEP(reg, probePtr, stepVec) \
+        positions##reg = _mm256_add_epi32( \
+            positions##reg, \
+            _mm256_and_si256( \
+                _mm256_castps_si256(_mm256_cmp_ps(floats##reg, _mm256_i32gather_ps((probePtr), positions##reg, 4), _CMP_GT_OQ)), \
+                stepVec));
+
+        size_t length = borderCount;
+        while (length > 1) {
+            const size_t half = length / 2;
+            const __m256i halfVec = _mm256_set1_epi32(half);
+            const float* probePtr = borders + half - 1;
+            SEARCH_STEP(0, probePtr, halfVec);
+            SEARCH_STEP(1, probePtr, halfVec);
+            SEARCH_STEP(2, probePtr, halfVec);
+            SEARCH_STEP(3, probePtr, halfVec);
+            length -= half;
+        }
+        if (length == 1) {
+            const __m256i oneVec = _mm256_set1_epi32(1);
+            SEARCH_STEP(0, borders, oneVec);
+            SEARCH_STEP(1, borders, oneVec);
+            SEARCH_STEP(2, borders, oneVec);
+            SEARCH_STEP(3, borders, oneVec);
+        }
+#undef SEARCH_STEP
+        const __m256i packed = _mm256_packus_epi16(_mm256_packus_epi32(positions0, positions1), _mm256_packus_epi32(positions2, positions3));
+        _mm256_storeu_si256((__m256i*)(result + docId), _mm256_permutevar8x32_epi32(packed, lanesPermutation));
+    }
+    if (docCount32 < docCount) {
+        BinarizeFloatsBinarySearch(values + docCount32, docCount - docCount32, borders, borderCount, result + docCount32);
+    }
+}
+
+static Y_FORCE_INLINE __m256i CmpGeEpu8(__m256i a, __m256i b) {
+    return _mm256_cmpeq_epi8(_mm256_max_epu8(a, b), a);
+}
+
+template <bool NeedXorMask, size_t RegisterCount>
+static Y_FORCE_INLINE void CalcIndexesAvx2Block(
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    size_t docOffset,
+    ui8* __restrict indexesVec,
+    const TRepackedBin* __restrict treeSplitsCurPtr,
+    int curTreeSize) {
+    __m256i indexes[RegisterCount];
+    for (size_t regId = 0; regId < RegisterCount; ++regId) {
+        indexes[regId] = _mm256_setzero_si256();
+    }
+    __m256i depthBit = _mm256_set1_epi8(0x01);
+    for (int depth = 0; depth < curTreeSize; ++depth) {
+        const ui8* __restrict binFeaturePtr = binFeatures + treeSplitsCurPtr[depth].FeatureIndex * docCountInBlock + docOffset;
+        const __m256i borderValVec = _mm256_set1_epi8(treeSplitsCurPtr[depth].SplitIdx);
+        const __m256i xorMaskVec = _mm256_set1_epi8(treeSplitsCurPtr[depth].XorMask);
+        for (size_t regId = 0; regId < RegisterCount; ++regId) {
+            __m256i val = _mm256_loadu_si256((const __m256i*)(binFeaturePtr + AVX2_BLOCK_SIZE * regId));
+            if (NeedXorMask) {
+                val = _mm256_xor_si256(val, xorMaskVec);
+            }
+            indexes[regId] = _mm256_or_si256(indexes[regId], _mm256_and_si256(CmpGeEpu8(val, borderValVec), depthBit));
+        }
+        depthBit = _mm256_add_epi8(depthBit, depthBit);
+    }
+    for (size_t regId = 0; regId < RegisterCount; ++regId) {
+        _mm256_storeu_si256((__m256i*)(indexesVec + docOffset + AVX2_BLOCK_SIZE * regId), indexes[regId]);
+    }
+}
+
+template <bool NeedXorMask>
+static void CalcIndexesAvx2Impl(
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    ui8* __restrict indexesVec,
+    const TRepackedBin* __restrict treeSplitsCurPtr,
+    int curTreeSize) {
+    size_t docId = 0;
+    for (; docId + 4 * AVX2_BLOCK_SIZE <= docCountInBlock; docId += 4 * AVX2_BLOCK_SIZE) {
+        CalcIndexesAvx2Block<NeedXorMask, 4>(binFeatures, docCountInBlock, docId, indexesVec, treeSplitsCurPtr, curTreeSize);
+    }
+    for (; docId + AVX2_BLOCK_SIZE <= docCountInBlock; docId += AVX2_BLOCK_SIZE) {
+        CalcIndexesAvx2Block<NeedXorMask, 1>(binFeatures, docCountInBlock, docId, indexesVec, treeSplitsCurPtr, curTreeSize);
+    }
+    const size_t tailStart = docId;
+    for (int depth = 0; depth < curTreeSize; ++depth) {
+        const ui8* __restrict binFeaturePtr = binFeatures + treeSplitsCurPtr[depth].FeatureIndex * docCountInBlock;
+        const ui8 borderVal = treeSplitsCurPtr[depth].SplitIdx;
+        const ui8 xorMask = NeedXorMask ? treeSplitsCurPtr[depth].XorMask : 0;
+        for (docId = tailStart; docId < docCountInBlock; ++docId) {
+            indexesVec[docId] |= ((binFeaturePtr[docId] ^ xorMask) >= borderVal) << depth;
+        }
+    }
+}
+
+void CalcIndexesAvx2(
+    bool needXorMask,
+    const ui8* binFeatures,
+    size_t docCountInBlock,
+    ui8* indexesVec,
+    const TRepackedBin* treeSplitsCurPtr,
+    int curTreeSize) {
+    if (needXorMask) {
+        CalcIndexesAvx2Impl<true>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+    } else {
+        CalcIndexesAvx2Impl<false>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+    }
+}
+
+#endif
@@ -0,0 +1,122 @@
+#include "formula_evaluator_kernels.h"
+
+#ifdef AVX512_STUB
+
+#include <util/system/yassert.h>
+
+void BinarizeFloatsAvx512(const float*, size_t, const float*, size_t, ui8*) {
+    Y_FAIL("AVX-512 kernels are not available on this platform");
+}
+
+void CalcIndexesAvx512(bool, const ui8*, size_t, ui8*, const TRepackedBin*, int) {
+    Y_FAIL("AVX-512 kernels are not available on this platform");
+}
+
+#else
+
+#include <util/system/compiler.h>
+
+#include <immintrin.h>
+
+constexpr size_t AVX512_BLOCK_SIZE = 64;
+
+void BinarizeFloatsAvx512(const float* values, size_t docCount, const float* borders, size_t borderCount, ui8* result) {
+    const __m512i one = _mm512_set1_epi8(1);
+    const auto docCount64 = (docCount | 0x3f) ^ 0x3f;
+    for (size_t docId = 0; docId < docCount64; docId += AVX512_BLOCK_SIZE) {
+        const __m512 floats0 = _mm512_loadu_ps(values + docId + 0);
+        const __m512 floats1 = _mm512_loadu_ps(values + docId + 16);
+        const __m512 floats2 = _mm512_loadu_ps(values + docId + 32);
+        const __m512 floats3 = _mm512_loadu_ps(values + docId + 48);
+        __m512i resultVec = _mm512_setzero_si512();
+        for (size_t borderId = 0; borderId < borderCount; ++borderId) {
+            const __m512 borderVec = _mm512_set1_ps(borders[borderId]);
+            const __mmask64 greaterMask =
+                ((__mmask64)_mm512_cmp_ps_mask(floats0, borderVec, _CMP_GT_OQ) << 0) |
+                ((__mmask64)_mm512_cmp_ps_mask(floats1, borderVec, _CMP_GT_OQ) << 16) |
+                ((__mmask64)_mm512_cmp_ps_mask(floats2, borderVec, _CMP_GT_OQ) << 32) |
+                ((__mmask64)_mm512_cmp_ps_mask(floats3, borderVec, _CMP_GT_OQ) << 48);
+            resultVec = _mm512_mask_add_epi8(resultVec, greaterMask, resultVec, one);
+        }
+        _mm512_storeu_si512((void*)(result + docId), resultVec);
+    }
+    for (size_t docId = docCount64; docId < docCount; ++docId) {
+        ui8 binIdx = 0;
+        for (size_t borderId = 0; borderId < borderCount; ++borderId) {
+            binIdx += (ui8)(values[docId] > borders[borderId]);
+        }
+        result[docId] = binIdx;
+    }
+}
+
+template <bool NeedXorMask, size_t RegisterCount>
+static Y_FORCE_INLINE void CalcIndexesAvx512Block(
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    size_t docOffset,
+    ui8* __restrict indexesVec,
+    const TRepackedBin* __restrict treeSplitsCurPtr,
+    int curTreeSize) {
+    __m512i indexes[RegisterCount];
+    for (size_t regId = 0; regId < RegisterCount; ++regId) {
+        indexes[regId] = _mm512_setzero_si512();
+    }
+    for (int depth = 0; depth < curTreeSize; ++depth) {
+        const ui8* __restrict binFeaturePtr = binFeatures + treeSplitsCurPtr[depth].FeatureIndex * docCountInBlock + docOffset;
+        const __m512i borderValVec = _mm512_set1_epi8(treeSplitsCurPtr[depth].SplitIdx);
+        const __m512i xorMaskVec = _mm512_set1_epi8(treeSplitsCurPtr[depth].XorMask);
+        const __m512i depthBit = _mm512_set1_epi8((char)(1 << depth));
+        for (size_t regId = 0; regId < RegisterCount; ++regId) {
+            __m512i val = _mm512_loadu_si512((const void*)(binFeaturePtr + AVX512_BLOCK_SIZE * regId));
+            if (NeedXorMask) {
+                val = _mm512_xor_si512(val, xorMaskVec);
+            }
+            const __mmask64 geMask = _mm512_cmpge_epu8_mask(val, borderValVec);
+            indexes[regId] = _mm512_or_si512(indexes[regId], _mm512_maskz_mov_epi8(geMask, depthBit));
+        }
+    }
+    for (size_t regId = 0; regId < RegisterCount; ++regId) {
+        _mm512_storeu_si512((void*)(indexesVec + docOffset + AVX512_BLOCK_SIZE * regId), indexes[regId]);
+    }
+}
+
+template <bool NeedXorMask>
+static void CalcIndexesAvx512Impl(
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    ui8* __restrict indexesVec,
+    const TRepackedBin* __restrict treeSplitsCurPtr,
+    int curTreeSize) {
+    size_t docId = 0;
+    for (; docId + 2 * AVX512_BLOCK_SIZE <= docCountInBlock; docId += 2 * AVX512_BLOCK_SIZE) {
+        CalcIndexesAvx512Block<NeedXorMask, 2>(binFeatures, docCountInBlock, docId, indexesVec, treeSplitsCurPtr, curTreeSize);
+    }
+    for (; docId + AVX512_BLOCK_SIZE <= docCountInBlock; docId += AVX512_BLOCK_SIZE) {
+        CalcIndexesAvx512Block<NeedXorMask, 1>(binFeatures, docCountInBlock, docId, indexesVec, treeSplitsCurPtr, curTreeSize);
+    }
+    const size_t tailStart = docId;
+    for (int depth = 0; depth < curTreeSize; ++depth) {
+        const ui8* __restrict binFeaturePtr = binFeatures + treeSplitsCurPtr[depth].FeatureIndex * docCountInBlock;
+        const ui8 borderVal = treeSplitsCurPtr[depth].SplitIdx;
+        const ui8 xorMask = NeedXorMask ? treeSplitsCurPtr[depth].XorMask : 0;
+        for (docId = tailStart; docId < docCountInBlock; ++docId) {
+            indexesVec[docId] |= ((binFeaturePtr[docId] ^ xorMask) >= borderVal) << depth;
+        }
+    }
+}
+
+void CalcIndexesAvx512(
+    bool needXorMask,
+    const ui8* binFeatures,
+    size_t docCountInBlock,
+    ui8* indexesVec,
+    const TRepackedBin* treeSplitsCurPtr,
+    int curTreeSize) {
+    if (needXorMask) {
+        CalcIndexesAvx512Impl<true>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+    } else {
+        CalcIndexesAvx512Impl<false>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+    }
+}
+
+#endif
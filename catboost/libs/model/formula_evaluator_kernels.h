@@ -0,0 +1,125 @@
+#pragma once
+
+#include "repacked_bin.h"
+
+#include <util/system/types.h>
+
+#include <cstddef>
+
+struct TFullModel;
+
+/**
+ * Instruction set used by model apply kernels.
+ * Best supported level is detected once by CPUID, see GetBestSimdLevel().
+ */
+enum class ESimdLevel {
+    Sse2,
+    Avx2,
+    Avx512
+};
+
+/**
+ * Writes to result[i] count of borders that are less than values[i].
+ * Values should already have nan substitution applied, borders must be sorted and there should be less than 256 of them.
+ */
+using TBinarizeFloatsKernel = void (*)(
+    const float* values,
+    size_t docCount,
+    const float* borders,
+    size_t borderCount,
+    ui8* result);
+
+/**
+ * Calculates leaf indexes of one tree with depth <= 8 for docCountInBlock documents.
+ * binFeatures layout is [binFeatureIdx * docCountInBlock + docId], indexesVec should be zero-filled.
+ */
+using TCalcIndexesKernel = void (*)(
+    bool needXorMask,
+    const ui8* binFeatures,
+    size_t docCountInBlock,
+    ui8* indexesVec,
+    const TRepackedBin* treeSplitsCurPtr,
+    int curTreeSize);
+
+using TCalcerIndexType = ui32;
+
+struct TTreeCalcerBuffers;
+
+/**
+ * Adds approxes of trees [treeStart, treeEnd) to results for docCountInBlock binarized documents.
+ * buffers are scratch memory of the calcer, see TTreeCalcerBuffers.
+ */
+using TTreeCalcFunction = void (*)(
+    const TFullModel& model,
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    TTreeCalcerBuffers* buffers,
+    size_t treeStart,
+    size_t treeEnd,
+    double* __restrict results);
+
+struct TEvaluationKernels {
+    //! Linear scan over all borders
+    TBinarizeFloatsKernel BinarizeFloats = nullptr;
+    //! Branchless binary search over borders, same results as BinarizeFloats
+    TBinarizeFloatsKernel BinarizeFloatsBinarySearch = nullptr;
+    //! Features with at least this many borders are binarized with BinarizeFloatsBinarySearch
+    size_t BinarySearchMinBorderCount = 0;
+    TCalcIndexesKernel CalcIndexes = nullptr;
+
+    TBinarizeFloatsKernel GetBinarizeFloatsKernel(size_t borderCount) const {
+        return borderCount >= BinarySearchMinBorderCount ? BinarizeFloatsBinarySearch : BinarizeFloats;
+    }
+};
+
+/**
+ * Loop order of model apply on blocks of documents.
+ * Documents are split into groups of DocBlocksInGroup blocks, trees are applied to a group by chunks of TreesInChunk trees
+ * and every chunk is applied to all blocks of the group before the next one,
+ * so tree splits and leaf values of a chunk are loaded to cache once per group instead of once per block.
+ * DocBlocksInGroup == 1 is the doc-major order, every block is evaluated on all trees.
+ */
+struct TEvaluationTiling {
+    size_t DocBlocksInGroup = 1;
+    //! 0 means all trees in one chunk
+    size_t TreesInChunk = 0;
+};
+
+bool IsSimdLevelSupported(ESimdLevel simdLevel);
+
+ESimdLevel GetBestSimdLevel();
+
+const TEvaluationKernels& GetEvaluationKernels(ESimdLevel simdLevel);
+
+inline const TEvaluationKernels& GetEvaluationKernels() {
+    return GetEvaluationKernels(GetBestSimdLevel());
+}
+
+void BinarizeFloatsSse2(const float* values, size_t docCount, const float* borders, size_t borderCount, ui8* result);
+void BinarizeFloatsAvx2(const float* values, size_t docCount, const float* borders, size_t borderCount, ui8* result);
+void BinarizeFloatsAvx512(const float* values, size_t docCount, const float* borders, size_t borderCount, ui8* result);
+
+void BinarizeFloatsBinarySearch(const float* values, size_t docCount, const float* borders, size_t borderCount, ui8* result);
+void BinarizeFloatsBinarySearchAvx2(const float* values, size_t docCount, const float* borders, size_t borderCount, ui8* result);
+
+void CalcIndexesSse2(
+    bool needXorMask,
+    const ui8* binFeatures,
+    size_t docCountInBlock,
+    ui8* indexesVec,
+    const TRepackedBin* treeSplitsCurPtr,
+    int curTreeSize);
+void CalcIndexesAvx2(
+    bool needXorMask,
+    const ui8* binFeatures,
+    size_t docCountInBlock,
+    ui8* indexesVec,
+    const TRepackedBin* treeSplitsCurPtr,
+    int curTreeSize);
+void CalcIndexesAvx512(
+    bool needXorMask,
+    const ui8* binFeatures,
+    size_t docCountInBlock,
+    ui8* indexesVec,
+    const TRepackedBin* treeSplitsCurPtr,
+    int curTreeSize);
@@ -15,10 +15,13 @@
 
 #include <library/json/json_reader.h>
 
+#include <util/generic/ymath.h>
 #include <util/string/builder.h>
 #include <util/stream/buffer.h>
 #include <util/stream/str.h>
 #include <util/stream/file.h>
+#include <util/stream/mem.h>
+#include <util/system/filemap.h>
 
 static const char MODEL_FILE_DESCRIPTOR_CHARS[4] = {'C', 'B', 'M', '1'};
 
@@ -50,13 +53,17 @@ static NJson::TJsonValue RemoveInvalidParams(const NJson::TJsonValue& params) {
     return result;
 }
 
+static void RemoveInvalidModelParams(TFullModel* model) {
+    NJson::TJsonValue paramsJson = ReadTJsonValue(model->ModelInfo.at("params"));
+    paramsJson["flat_params"] = RemoveInvalidParams(paramsJson["flat_params"]);
+    model->ModelInfo["params"] = ToString<NJson::TJsonValue>(paramsJson);
+}
+
 TFullModel ReadModel(IInputStream* modelStream, EModelType format) {
     TFullModel model;
     if (format == EModelType::CatboostBinary) {
         Load(modelStream, model);
-        NJson::TJsonValue paramsJson = ReadTJsonValue(model.ModelInfo.at("params"));
-        paramsJson["flat_params"] = RemoveInvalidParams(paramsJson["flat_params"]);
-        model.ModelInfo["params"] = ToString<NJson::TJsonValue>(paramsJson);
+        RemoveInvalidModelParams(&model);
     } else {
         CoreML::Specification::Model coreMLModel;
         CB_ENSURE(coreMLModel.ParseFromString(modelStream->ReadAll()), "coreml model deserialization failed");
@@ -76,6 +83,62 @@ TFullModel ReadModel(const void* binaryBuffer, size_t binaryBufferSize, EModelTy
     return ReadModel(&bs, format);
 }
 
+namespace {
+    class TMappedModelFile: public TThrRefBase {
+    public:
+        explicit TMappedModelFile(const TString& modelFile)
+            : FileMap(modelFile)
+        {
+            FileMap.Map(0, FileMap.Length());
+        }
+
+        const void* Data() const {
+            return FileMap.Ptr();
+        }
+
+        size_t Size() const {
+            return FileMap.MappedSize();
+        }
+
+    private:
+        TFileMap FileMap;
+    };
+}
+
+TFullModel ReadModelMapped(const TString& modelFile) {
+    TIntrusivePtr<TMappedModelFile> mappedFile = MakeIntrusive<TMappedModelFile>(modelFile);
+    TFullModel model;
+    model.InitNonOwning(mappedFile->Data(), mappedFile->Size(), mappedFile);
+    RemoveInvalidModelParams(&model);
+    return model;
+}
+
+TVector<size_t> GetStageTreeEnds(size_t treeStart, size_t treeEnd, size_t evalPeriod) {
+    CB_ENSURE(treeStart <= treeEnd, "Tree start " << treeStart << " is greater than tree end " << treeEnd);
+    if (evalPeriod == 0) {
+        evalPeriod = Max<size_t>(treeEnd - treeStart, 1);
+    }
+    TVector<size_t> stageTreeEnds;
+    for (size_t stageStart = treeStart; stageStart < treeEnd; stageStart += evalPeriod) {
+        stageTreeEnds.push_back(Min(stageStart + evalPeriod, treeEnd));
+    }
+    return stageTreeEnds;
+}
+
+void PrecomputeCtrValues(TFullModel* model) {
+    if (!model->CtrProvider || model->ObliviousTrees.GetUsedModelCtrs().empty()) {
+        return;
+    }
+    const auto* staticProvider = dynamic_cast<const TStaticCtrProvider*>(model->CtrProvider.Get());
+    CB_ENSURE(staticProvider, "Ctr values can be precomputed only for models with static ctr provider");
+    CB_ENSURE(model->HasValidCtrProvider(), "Model ctr provider has no data for model ctrs");
+    // provider can be shared with other model copies, so values are added to provider copy
+    TIntrusivePtr<TStaticCtrProvider> provider = new TStaticCtrProvider(*staticProvider);
+    provider->PrecomputeCtrValues(model->ObliviousTrees.CtrFeatures);
+    model->CtrProvider = provider;
+    model->UpdateDynamicData();
+}
+
 void OutputModelCoreML(const TFullModel& model, const TString& modelFile, const NJson::TJsonValue& userParameters) {
     CoreML::Specification::Model outModel;
     outModel.set_specificationversion(1);
@@ -95,11 +158,29 @@ void OutputModelCoreML(const TFullModel& model, const TString& modelFile, const
     out.Write(data);
 }
 
+static bool NeedPrecomputeCtrValues(const TString& userParametersJSON) {
+    if (userParametersJSON.empty()) {
+        return false;
+    }
+    TStringInput is(userParametersJSON);
+    NJson::TJsonValue params;
+    NJson::ReadJsonTree(&is, &params);
+    for (const auto& param : params.GetMapSafe()) {
+        CB_ENSURE(param.first == "precompute_ctr_values", "Unsupported JSON user param for CatBoost model export: " << param.first);
+    }
+    return params["precompute_ctr_values"].GetBooleanSafe();
+}
+
 void ExportModel(const TFullModel& model, const TString& modelFile, const EModelType format, const TString& userParametersJSON, bool addFileFormatExtension) {
     switch (format) {
         case EModelType::CatboostBinary:
-            CB_ENSURE(userParametersJSON.empty(), "JSON user params for CatBoost model export are not supported");
-            OutputModel(model, addFileFormatExtension ? modelFile + ".bin" : modelFile);
+            if (NeedPrecomputeCtrValues(userParametersJSON)) {
+                TFullModel precomputedModel = model;
+                PrecomputeCtrValues(&precomputedModel);
+                OutputModel(precomputedModel, addFileFormatExtension ? modelFile + ".bin" : modelFile);
+            } else {
+                OutputModel(model, addFileFormatExtension ? modelFile + ".bin" : modelFile);
+            }
             break;
         case EModelType::AppleCoreML:
             {
@@ -277,6 +358,32 @@ void TObliviousTrees::UpdateMetadata() const {
         }
         ref.RepackedBins.push_back(rb);
     }
+    THashMap<int, int> catFeaturePackedIndexes;
+    for (int i = 0; i < CatFeatures.ysize(); ++i) {
+        catFeaturePackedIndexes[CatFeatures[i].FeatureIndex] = i;
+    }
+    for (const auto& oheFeature : OneHotFeatures) {
+        ref.OneHotFeaturesPackedCatIndexes.push_back(catFeaturePackedIndexes.at(oheFeature.CatFeatureIndex));
+    }
+    ref.SingleDocTreeCalcer = GetCalcTreesFunction(*this, 1, GetBestSimdLevel());
+    ref.BlockTreeCalcer = GetCalcTreesFunction(*this, FORMULA_EVALUATION_BLOCK_SIZE, GetBestSimdLevel());
+    ref.EvaluationTiling = SelectEvaluationTiling(*this, GetL2CacheSize());
+}
+
+void TObliviousTrees::SetFloatLeafValuesMode(bool enabled) {
+    Y_ENSURE(MetaData.Defined(), "metadata should be initialized");
+    auto& ref = MetaData.GetRef();
+    ref.UseFloatLeafValues = enabled;
+    if (enabled) {
+        ref.FloatLeafValues.assign(LeafValues.begin(), LeafValues.end());
+    } else {
+        TVector<float>().swap(ref.FloatLeafValues);
+    }
+    ref.SingleDocTreeCalcer = GetCalcTreesFunction(*this, 1, GetBestSimdLevel());
+    ref.BlockTreeCalcer = GetCalcTreesFunction(*this, FORMULA_EVALUATION_BLOCK_SIZE, GetBestSimdLevel());
+    if (!ref.EvaluationTilingIsSet) {
+        ref.EvaluationTiling = SelectEvaluationTiling(*this, GetL2CacheSize());
+    }
 }
 
 void TFullModel::CalcFlat(const TVector<TConstArrayRef<float>>& features,
@@ -433,6 +540,57 @@ TVector<TVector<double>> TFullModel::CalcTreeIntervals(
         incrementStep
     );
 }
+void TFullModel::CalcFlatStaged(
+    const TVector<TConstArrayRef<float>>& features,
+    size_t treeStart,
+    TConstArrayRef<size_t> stageTreeEnds,
+    TArrayRef<double> results) const {
+    const auto expectedFlatVecSize = ObliviousTrees.GetFlatFeatureVectorExpectedSize();
+    for (const auto& flatFeaturesVec : features) {
+        CB_ENSURE(flatFeaturesVec.size() >= expectedFlatVecSize,
+                  "insufficient flat features vector size: " << flatFeaturesVec.size()
+                                                             << " expected: " << expectedFlatVecSize);
+    }
+    CalcTreeStagesGeneric(
+        *this,
+        [&features](const TFloatFeature& floatFeature, size_t index) -> float {
+            return features[index][floatFeature.FlatFeatureIndex];
+        },
+        [&features](const TCatFeature& catFeature, size_t index) -> int {
+            return ConvertFloatCatFeatureToIntHash(features[index][catFeature.FlatFeatureIndex]);
+        },
+        features.size(),
+        treeStart,
+        stageTreeEnds,
+        results
+    );
+}
+
+void TFullModel::SetCtrInlineTablesMode(bool enabled) {
+    const auto* staticProvider = dynamic_cast<const TStaticCtrProvider*>(CtrProvider.Get());
+    if (!staticProvider || !staticProvider->HasNeededCtrs(ObliviousTrees.GetUsedModelCtrs())) {
+        return;
+    }
+    ObliviousTrees.SetCtrCalcPlan(staticProvider->CreateCalcPlan(ObliviousTrees.CtrFeatures, enabled));
+}
+
+double TFullModel::CalcFloatLeafValuesMaxDeviation(const TVector<TConstArrayRef<float>>& features) {
+    const bool wasFloatLeafValuesMode = IsFloatLeafValuesMode();
+    const size_t resultSize = features.size() * ObliviousTrees.ApproxDimension;
+    TVector<double> doubleResults(resultSize);
+    TVector<double> floatResults(resultSize);
+    SetFloatLeafValuesMode(false);
+    CalcFlat(features, doubleResults);
+    SetFloatLeafValuesMode(true);
+    CalcFlat(features, floatResults);
+    SetFloatLeafValuesMode(wasFloatLeafValuesMode);
+    double maxDeviation = 0.0;
+    for (size_t i = 0; i < resultSize; ++i) {
+        maxDeviation = Max(maxDeviation, Abs(doubleResults[i] - floatResults[i]));
+    }
+    return maxDeviation;
+}
+
 TVector<TVector<double>> TFullModel::CalcTreeIntervalsFlat(
     const TVector<TConstArrayRef<float>>& features,
     size_t incrementStep) const {
@@ -493,6 +651,15 @@ void TFullModel::Save(IOutputStream* s) const {
     }
 }
 
+//! Returns true for static_provider_v2 part with precomputed ctr values
+static bool CheckStaticProviderPartIdentifier(const TString& modelPart) {
+    CB_ENSURE(
+        modelPart == "static_provider_v1" || modelPart == "static_provider_v2",
+        "only static ctr models supported"
+    );
+    return modelPart == "static_provider_v2";
+}
+
 void TFullModel::Load(IInputStream* s) {
     using namespace flatbuffers;
     using namespace NCatBoostFbs;
@@ -503,11 +670,52 @@ void TFullModel::Load(IInputStream* s) {
     TArrayHolder<ui8> arrayHolder = new ui8[coreSize];
     s->LoadOrFail(arrayHolder.Get(), coreSize);
 
+    const TVector<TString> modelParts = LoadCore(arrayHolder.Get(), coreSize);
+    if (!modelParts.empty()) {
+        CB_ENSURE(modelParts.size() == 1, "only single part model supported now");
+        const bool hasPrecomputedCtrValues = CheckStaticProviderPartIdentifier(modelParts[0]);
+        TIntrusivePtr<TStaticCtrProvider> staticProvider = new TStaticCtrProvider;
+        staticProvider->Load(s);
+        if (hasPrecomputedCtrValues) {
+            staticProvider->LoadPrecomputedCtrValues(s);
+        }
+        CtrProvider = staticProvider;
+    }
+    UpdateDynamicData();
+}
+
+void TFullModel::InitNonOwning(const void* binaryBuffer, size_t binarySize, TIntrusivePtr<TThrRefBase> dataHolder) {
+    TMemoryInput in(binaryBuffer, binarySize);
+    ui32 fileDescriptor;
+    ::Load(&in, fileDescriptor);
+    CB_ENSURE(fileDescriptor == GetModelFormatDescriptor(), "Incorrect model file descriptor");
+    auto coreSize = ::LoadSize(&in);
+    CB_ENSURE(in.Avail() >= coreSize, "Unexpected end of model data");
+    const void* coreData = in.Buf();
+    in.Skip(coreSize);
+
+    const TVector<TString> modelParts = LoadCore(coreData, coreSize);
+    if (!modelParts.empty()) {
+        CB_ENSURE(modelParts.size() == 1, "only single part model supported now");
+        const bool hasPrecomputedCtrValues = CheckStaticProviderPartIdentifier(modelParts[0]);
+        TIntrusivePtr<TStaticCtrProvider> staticProvider = new TStaticCtrProvider;
+        staticProvider->LoadNonOwning(&in, std::move(dataHolder));
+        if (hasPrecomputedCtrValues) {
+            staticProvider->LoadPrecomputedCtrValues(&in);
+        }
+        CtrProvider = staticProvider;
+    }
+    UpdateDynamicData();
+}
+
+TVector<TString> TFullModel::LoadCore(const void* coreData, size_t coreSize) {
+    using namespace flatbuffers;
+    using namespace NCatBoostFbs;
     {
-        flatbuffers::Verifier verifier(arrayHolder.Get(), coreSize);
+        flatbuffers::Verifier verifier(static_cast<const ui8*>(coreData), coreSize);
         CB_ENSURE(VerifyTModelCoreBuffer(verifier), "Flatbuffers model verification failed");
     }
-    auto fbModelCore = GetTModelCore(arrayHolder.Get());
+    auto fbModelCore = GetTModelCore(coreData);
     CB_ENSURE(
         fbModelCore->FormatVersion() && fbModelCore->FormatVersion()->str() == CURRENT_CORE_FORMAT_STRING,
         "Unsupported model format: " << fbModelCore->FormatVersion()->str()
@@ -527,13 +735,7 @@ void TFullModel::Load(IInputStream* s) {
             modelParts.emplace_back(part->str());
         }
     }
-    if (!modelParts.empty()) {
-        CB_ENSURE(modelParts.size() == 1, "only single part model supported now");
-        CtrProvider = new TStaticCtrProvider;
-        CB_ENSURE(modelParts[0] == CtrProvider->ModelPartIdentifier(), "only static ctr models supported");
-        CtrProvider->Load(s);
-    }
-    UpdateDynamicData();
+    return modelParts;
 }
 
 TVector<TString> GetModelUsedFeaturesNames(const TFullModel& model) {
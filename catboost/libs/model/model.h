@@ -1,6 +1,8 @@
 #pragma once
 
 #include "features.h"
+#include "formula_evaluator_kernels.h"
+#include "repacked_bin.h"
 #include "split.h"
 
 #include "static_ctr_provider.h"
@@ -40,11 +42,6 @@ class TModelPartsCachingSerializer;
     - TreeSizes - holds tree depth.
     - TreeStartOffsets - holds offset of first tree split in TreeSplits vector
 */
-struct TRepackedBin {
-    ui16 FeatureIndex = 0;
-    ui8 XorMask = 0;
-    ui8 SplitIdx = 0;
-};
 struct TObliviousTrees {
 
     /**
@@ -78,6 +75,29 @@ struct TObliviousTrees {
 
         //! Offset of first tree leaf in flat tree leafs array
         TVector<size_t> TreeFirstLeafOffsets;
+
+        //! Index of categorical feature for each one hot feature in transposed hashed cat features block
+        TVector<int> OneHotFeaturesPackedCatIndexes;
+
+        //! Tree calcers for single document and for blocks of documents, selected for best SIMD level supported by CPU
+        TTreeCalcFunction SingleDocTreeCalcer = nullptr;
+        TTreeCalcFunction BlockTreeCalcer = nullptr;
+
+        //! Loop order for block apply, selected from model size and CPU cache size
+        TEvaluationTiling EvaluationTiling;
+        //! EvaluationTiling was set by SetEvaluationTiling() and is not reselected
+        bool EvaluationTilingIsSet = false;
+
+        //! Float leaf values mode, see TObliviousTrees::SetFloatLeafValuesMode()
+        bool UseFloatLeafValues = false;
+        //! LeafValues converted to float, empty unless UseFloatLeafValues is set
+        TVector<float> FloatLeafValues;
+
+        /**
+         * Precompiled calculation of UsedModelCtrs, built by TFullModel::UpdateDynamicData().
+         * Can be nullptr, then ctrs are calculated by ICtrProvider::CalcCtrs.
+         */
+        TIntrusivePtr<ICtrCalcPlan> CtrCalcPlan;
     };
 
     //! Number of classes in model, in most cases equals to 1.
@@ -230,6 +250,63 @@ struct TObliviousTrees {
         return MetaData->BinFeatures;
     }
 
+    const TVector<int>& GetOneHotFeaturesPackedCatIndexes() const {
+        Y_ENSURE(MetaData.Defined(), "metadata should be initialized");
+        return MetaData->OneHotFeaturesPackedCatIndexes;
+    }
+
+    TTreeCalcFunction GetTreeCalcer(size_t docCountInBlock) const {
+        Y_ENSURE(MetaData.Defined(), "metadata should be initialized");
+        return docCountInBlock == 1 ? MetaData->SingleDocTreeCalcer : MetaData->BlockTreeCalcer;
+    }
+
+    const TEvaluationTiling& GetEvaluationTiling() const {
+        Y_ENSURE(MetaData.Defined(), "metadata should be initialized");
+        return MetaData->EvaluationTiling;
+    }
+
+    /**
+     * Overrides selected tiling, it is reset with the rest of metadata by UpdateMetadata().
+     * Not thread-safe: it should not be called concurrently with model apply.
+     */
+    void SetEvaluationTiling(const TEvaluationTiling& evaluationTiling) {
+        Y_ENSURE(MetaData.Defined(), "metadata should be initialized");
+        MetaData->EvaluationTiling = evaluationTiling;
+        MetaData->EvaluationTilingIsSet = true;
+    }
+
+    /**
+     * Opt-in inference mode with leaf values converted to float and accumulated in float with compensated summation.
+     * It halves leaf values memory traffic at the cost of precision, see TFullModel::CalcFloatLeafValuesMaxDeviation().
+     * Switching the mode reselects tree calcers and evaluation tiling unless it was set by SetEvaluationTiling(),
+     * so it is not thread-safe and should not be done concurrently with model apply.
+     * Mode is reset to double leaf values with the rest of metadata by UpdateMetadata()
+     */
+    void SetFloatLeafValuesMode(bool enabled);
+
+    bool IsFloatLeafValuesMode() const {
+        Y_ENSURE(MetaData.Defined(), "metadata should be initialized");
+        return MetaData->UseFloatLeafValues;
+    }
+
+    //! Leaf values in LeafValues layout, defined only in float leaf values mode
+    const TVector<float>& GetFloatLeafValues() const {
+        Y_ENSURE(MetaData.Defined(), "metadata should be initialized");
+        Y_ENSURE(MetaData->UseFloatLeafValues, "float leaf values mode is not enabled");
+        return MetaData->FloatLeafValues;
+    }
+
+    const ICtrCalcPlan* GetCtrCalcPlan() const {
+        Y_ENSURE(MetaData.Defined(), "metadata should be initialized");
+        return MetaData->CtrCalcPlan.Get();
+    }
+
+    //! Plan is reset with the rest of metadata by UpdateMetadata()
+    void SetCtrCalcPlan(TIntrusivePtr<ICtrCalcPlan> ctrCalcPlan) const {
+        Y_ENSURE(MetaData.Defined(), "metadata should be initialized");
+        MetaData->CtrCalcPlan = std::move(ctrCalcPlan);
+    }
+
     const TVector<TRepackedBin>& GetRepackedBins() const {
         Y_ENSURE(MetaData.Defined(), "metadata should be initialized");
         return MetaData->RepackedBins;
@@ -352,6 +429,52 @@ struct TFullModel {
      */
     void Load(IInputStream* s);
 
+    /**
+     * Deserialize model from memory buffer without copying ctr value tables, they reference buffer memory.
+     * Buffer should outlive the model and all its copies, pass buffer owner as dataHolder to make the model keep it alive.
+     * @param binaryBuffer serialized model
+     * @param binarySize buffer size in bytes
+     * @param dataHolder owner of buffer memory or nullptr
+     */
+    void InitNonOwning(const void* binaryBuffer, size_t binarySize, TIntrusivePtr<TThrRefBase> dataHolder = nullptr);
+
+    /**
+     * Loop order of trees and documents used by Calc* methods for blocks of documents.
+     * It is selected in UpdateDynamicData() from model size and CPU cache size.
+     */
+    const TEvaluationTiling& GetEvaluationTiling() const {
+        return ObliviousTrees.GetEvaluationTiling();
+    }
+
+    //! Overrides selected evaluation tiling until next UpdateDynamicData() call, not thread-safe, see TObliviousTrees::SetEvaluationTiling()
+    void SetEvaluationTiling(const TEvaluationTiling& evaluationTiling) {
+        ObliviousTrees.SetEvaluationTiling(evaluationTiling);
+    }
+
+    //! Enables or disables float leaf values inference mode until next UpdateDynamicData() call, see TObliviousTrees::SetFloatLeafValuesMode()
+    void SetFloatLeafValuesMode(bool enabled) {
+        ObliviousTrees.SetFloatLeafValuesMode(enabled);
+    }
+
+    bool IsFloatLeafValuesMode() const {
+        return ObliviousTrees.IsFloatLeafValuesMode();
+    }
+
+    /**
+     * Opt-in ctr apply mode with statistics of ctr value tables copied to cache line aligned inline tables, see TCtrInlineTable.
+     * It speeds up ctr lookups for models with large ctr tables at the cost of a second copy of ctr data in memory,
+     * tables that reference mapped model file are not copied. Models without static ctr provider are not changed.
+     * Not thread-safe: it should not be called concurrently with model apply. Mode is reset by UpdateDynamicData()
+     */
+    void SetCtrInlineTablesMode(bool enabled);
+
+    /**
+     * Applies model to features with double and float leaf values and returns max absolute difference of predictions,
+     * current leaf values mode is kept. Like SetFloatLeafValuesMode() it should not be called concurrently with model apply.
+     * @param features flat features vectors of validation documents
+     */
+    double CalcFloatLeafValuesMaxDeviation(const TVector<TConstArrayRef<float>>& features);
+
     //! Check if TFullModel instance has valid CTR provider. If no ctr features present it will also return false
     bool HasValidCtrProvider() const {
         if (!CtrProvider) {
@@ -419,7 +542,7 @@ struct TFullModel {
      * @param[in] floatFeatures vector of float features values array references
      * @param[in] catFeatures vector of hashed categorical features values array references
      * @param[in] incrementStep tree count on each prediction stage
-     * @return vector of vector of double - first index is for stage id, second is for [objectIndex * ApproxDimension + classId]
+     * @return vector of vector of double - first index is for object index, second is for [stageId * ApproxDimension + classId]
      */
     TVector<TVector<double>> CalcTreeIntervals(
         const TVector<TConstArrayRef<float>>& floatFeatures,
@@ -434,6 +557,20 @@ struct TFullModel {
     TVector<TVector<double>> CalcTreeIntervalsFlat(
         const TVector<TConstArrayRef<float>>& mixedFeatures,
         size_t incrementStep) const;
+    /**
+     * Staged evaluation on **flat** feature vectors. Features are binarized once and trees are applied in order,
+     * so all stages cost as much as one evaluation on trees [treeStart, stageTreeEnds.back()).
+     * @param[in] features
+     * @param[in] treeStart first tree of the first stage
+     * @param[in] stageTreeEnds non-decreasing tree ends of stages, see GetStageTreeEnds()
+     * @param[out] results cumulative approxes of trees [treeStart, stageTreeEnds[stageId]),
+     * indexation is [stageId * objectCount * ApproxDimension + objectIndex * ApproxDimension + classId]
+     */
+    void CalcFlatStaged(
+        const TVector<TConstArrayRef<float>>& features,
+        size_t treeStart,
+        TConstArrayRef<size_t> stageTreeEnds,
+        TArrayRef<double> results) const;
     /**
      * Evaluate raw formula predictions on user data. Uses model trees for interval [treeStart, treeEnd)
      * @param[in] floatFeatures
@@ -504,6 +641,7 @@ struct TFullModel {
     TFullModel CopyTreeRange(size_t begin, size_t end) const {
         TFullModel result = *this;
         result.ObliviousTrees.Truncate(begin, end);
+        result.UpdateCtrCalcPlan();
         return result;
     }
 
@@ -519,6 +657,17 @@ struct TFullModel {
                 ObliviousTrees.OneHotFeatures,
                 ObliviousTrees.CatFeatures);
         }
+        UpdateCtrCalcPlan();
+    }
+
+private:
+    //! Deserializes trees and model info from flatbuffers model core, returns model part identifiers
+    TVector<TString> LoadCore(const void* coreData, size_t coreSize);
+
+    void UpdateCtrCalcPlan() {
+        if (CtrProvider && CtrProvider->HasNeededCtrs(ObliviousTrees.GetUsedModelCtrs())) {
+            ObliviousTrees.SetCtrCalcPlan(CtrProvider->CreateCalcPlan(ObliviousTrees.CtrFeatures));
+        }
     }
 };
 
@@ -526,12 +675,35 @@ void OutputModel(const TFullModel& model, const TString& modelFile);
 TFullModel ReadModel(const TString& modelFile, EModelType format = EModelType::CatboostBinary);
 TFullModel ReadModel(const void* binaryBuffer, size_t binaryBufferSize, EModelType format = EModelType::CatboostBinary);
 
+/**
+ * Read CatBoost binary model with memory mapping.
+ * CTR value tables are not copied to memory and reference the mapping, which is kept until the model and all its copies are destroyed,
+ * so processes that load one model file share its memory through page cache.
+ * @param modelFile path to model file
+ * @return loaded model
+ */
+TFullModel ReadModelMapped(const TString& modelFile);
+
+/**
+ * Tree ends of evaluation stages with evalPeriod trees in each stage: treeStart + evalPeriod, treeStart + 2 * evalPeriod, ..., treeEnd.
+ * Last stage can be shorter. evalPeriod equal to 0 means single stage.
+ */
+TVector<size_t> GetStageTreeEnds(size_t treeStart, size_t treeEnd, size_t evalPeriod);
+
+/**
+ * Precompute ctr values and their bins for all value table buckets of model ctrs,
+ * so model apply calculates each binarized ctr feature with one array access.
+ * Saved model gets static_provider_v2 ctr provider part and takes more space, models without ctrs are not changed.
+ * @param model
+ */
+void PrecomputeCtrValues(TFullModel* model);
+
 /**
  * Export model in our binary or protobuf CoreML format
  * @param model
  * @param modelFile
  * @param format
- * @param userParametersJSON
+ * @param userParametersJSON JSON export params, for CatboostBinary format only {"precompute_ctr_values": true} is supported, see PrecomputeCtrValues()
  * @param addFileFormatExtension
  */
 void ExportModel(const TFullModel& model,
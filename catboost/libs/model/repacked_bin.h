@@ -0,0 +1,10 @@
+#pragma once
+
+#include <util/system/types.h>
+
+//! Binary split in the form used by model apply kernels, see TObliviousTrees::TMetaData::RepackedBins
+struct TRepackedBin {
+    ui16 FeatureIndex = 0;
+    ui8 XorMask = 0;
+    ui8 SplitIdx = 0;
+};
@@ -1,136 +1,401 @@
 #include "static_ctr_provider.h"
+#include "formula_evaluator_kernels.h"
 
 #include <catboost/libs/helpers/exception.h>
 
-struct TCompressedModelCtr {
-    const TFeatureCombination* Projection;
-    TVector<const TModelCtr*> ModelCtrs;
-};
+#include <util/generic/algorithm.h>
 
-void TStaticCtrProvider::CalcCtrs(const TVector<TModelCtr>& neededCtrs,
-                                  const TConstArrayRef<ui8>& binarizedFeatures,
-                                  const TConstArrayRef<int>& hashedCatFeatures,
-                                  size_t docCount,
-                                  TArrayRef<float> result) {
-    if (neededCtrs.empty()) {
-        return;
+namespace {
+    constexpr size_t CTR_CALC_BLOCK_SIZE = 128;
+
+    struct TCompiledModelCtr {
+        TModelCtr Ctr;
+        const TCtrValueTable* LearnCtr = nullptr;
+        //! If not nullptr, LearnCtr data is looked up in this table
+        const TCtrInlineTable* InlineTable = nullptr;
+        //! If not nullptr, ctr values are gathered from it by LearnCtr indexes
+        const TPrecomputedCtrValues* PrecomputedValues = nullptr;
+    };
+
+    struct TCompiledProjection {
+        TVector<int> TransposedCatFeatureIndexes;
+        TVector<TBinFeatureIndexValue> BinarizedIndexes;
+        TVector<TCompiledModelCtr> ModelCtrs;
+    };
+
+    class TStaticCtrCalcPlan : public ICtrCalcPlan {
+    public:
+        TStaticCtrCalcPlan(
+            const TVector<TModelCtr>& neededCtrs,
+            const TCtrData& ctrData,
+            const THashMap<TFloatSplit, TBinFeatureIndexValue>& floatFeatureIndexes,
+            const THashMap<int, int>& catFeatureIndex,
+            const THashMap<TOneHotSplit, TBinFeatureIndexValue>& oneHotFeatureIndexes,
+            const THashMap<TModelCtr, TPrecomputedCtrValues>& precomputedCtrValues,
+            TConstArrayRef<TCtrFeature> ctrFeatures,
+            bool buildInlineTables);
+
+        void CalcCtrs(
+            const TConstArrayRef<ui8>& binarizedFeatures,
+            const TConstArrayRef<int>& hashedCatFeatures,
+            size_t docCount,
+            TArrayRef<float> result) const override;
+
+        bool CanCalcCtrBins() const override {
+            return HasAllCtrBins;
+        }
+
+        void CalcCtrBins(
+            const TConstArrayRef<ui8>& binarizedFeatures,
+            const TConstArrayRef<int>& hashedCatFeatures,
+            size_t docCount,
+            TArrayRef<ui8> result) const override;
+
+    private:
+        TVector<TCompiledProjection> Projections;
+        THashMap<TModelCtrBase, TCtrInlineTable> InlineTables;
+        //! All ctrs have precomputed bins for borders of ctr features the plan was built for
+        bool HasAllCtrBins = false;
+    };
+}
+
+TStaticCtrCalcPlan::TStaticCtrCalcPlan(
+    const TVector<TModelCtr>& neededCtrs,
+    const TCtrData& ctrData,
+    const THashMap<TFloatSplit, TBinFeatureIndexValue>& floatFeatureIndexes,
+    const THashMap<int, int>& catFeatureIndex,
+    const THashMap<TOneHotSplit, TBinFeatureIndexValue>& oneHotFeatureIndexes,
+    const THashMap<TModelCtr, TPrecomputedCtrValues>& precomputedCtrValues,
+    TConstArrayRef<TCtrFeature> ctrFeatures,
+    bool buildInlineTables)
+    : HasAllCtrBins(!ctrFeatures.empty())
+{
+    Y_ASSERT(ctrFeatures.empty() || ctrFeatures.size() == neededCtrs.size());
+    for (size_t i = 0; i < neededCtrs.size(); ++i) {
+        const auto& ctr = neededCtrs[i];
+        if (i == 0 || neededCtrs[i - 1].Base.Projection != ctr.Base.Projection) {
+            Y_ASSERT(i == 0 || neededCtrs[i - 1] < ctr); // needed ctrs should be sorted
+            auto& compiledProjection = Projections.emplace_back();
+            for (const auto feature : ctr.Base.Projection.CatFeatures) {
+                compiledProjection.TransposedCatFeatureIndexes.push_back(catFeatureIndex.at(feature));
+            }
+            for (const auto feature : ctr.Base.Projection.BinFeatures) {
+                compiledProjection.BinarizedIndexes.push_back(floatFeatureIndexes.at(feature));
+            }
+            for (const auto feature : ctr.Base.Projection.OneHotFeatures) {
+                compiledProjection.BinarizedIndexes.push_back(oneHotFeatureIndexes.at(feature));
+            }
+        }
+        const TCtrValueTable& learnCtr = ctrData.LearnCtrs.at(ctr.Base);
+        const TPrecomputedCtrValues* precomputedValues = precomputedCtrValues.FindPtr(ctr);
+        if (HasAllCtrBins) {
+            Y_ASSERT(ctrFeatures[i].Ctr == ctr);
+            HasAllCtrBins = precomputedValues && precomputedValues->HasBins() && precomputedValues->Borders == ctrFeatures[i].Borders;
+        }
+        const TCtrInlineTable* inlineTable = nullptr;
+        // tables referencing memory they don't own are kept in place to share memory with model file mapping
+        if (buildInlineTables && !precomputedValues && learnCtr.IsSolid()) {
+            if (!InlineTables.has(ctr.Base)) {
+                InlineTables.emplace(ctr.Base, TCtrInlineTable(learnCtr));
+            }
+            inlineTable = &InlineTables.at(ctr.Base);
+        }
+        Projections.back().ModelCtrs.push_back(TCompiledModelCtr{ctr, &learnCtr, inlineTable, precomputedValues});
     }
-    TVector<TCompressedModelCtr> compressedModelCtrs;
-    compressedModelCtrs.emplace_back(TCompressedModelCtr{&neededCtrs[0].Base.Projection, {&neededCtrs[0]}});
-    for (size_t i = 1; i < neededCtrs.size(); ++i) {
-        Y_ASSERT(neededCtrs[i - 1] < neededCtrs[i]); // needed ctrs should be sorted
-        if (*(compressedModelCtrs.back().Projection) != neededCtrs[i].Base.Projection) {
-            compressedModelCtrs.emplace_back(TCompressedModelCtr{&neededCtrs[i].Base.Projection, {}});
-        }
-        compressedModelCtrs.back().ModelCtrs.push_back(&neededCtrs[i]);
+}
+
+// same as CalcHashes from ctr_provider.h but for documents [docOffset, docOffset + blockSize) of docCount
+static void CalcProjectionHashes(
+    const TCompiledProjection& projection,
+    const TConstArrayRef<ui8>& binarizedFeatures,
+    const TConstArrayRef<int>& hashedCatFeatures,
+    size_t docCount,
+    size_t docOffset,
+    size_t blockSize,
+    ui64* result) {
+    std::fill(result, result + blockSize, 0);
+    for (const int featureIdx : projection.TransposedCatFeatureIndexes) {
+        const int* valPtr = &hashedCatFeatures[featureIdx * docCount + docOffset];
+        for (size_t i = 0; i < blockSize; ++i) {
+            result[i] = CalcHash(result[i], (ui64)valPtr[i]);
+        }
     }
-    size_t samplesCount = docCount;
-    TVector<ui64> ctrHashes(samplesCount);
-    TVector<ui64> buckets(samplesCount);
-    size_t resultIdx = 0;
-    float* resultPtr = result.data();
-    TVector<int> transposedCatFeatureIndexes;
-    TVector<TBinFeatureIndexValue> binarizedIndexes;
-    for (size_t i = 0; i < compressedModelCtrs.size(); ++i) {
-        auto& proj = *compressedModelCtrs[i].Projection;
-        binarizedIndexes.clear();
-        transposedCatFeatureIndexes.clear();
-        for (const auto feature : proj.CatFeatures) {
-            transposedCatFeatureIndexes.push_back(CatFeatureIndex.at(feature));
-        }
-        for (const auto feature : proj.BinFeatures ) {
-            binarizedIndexes.push_back(FloatFeatureIndexes.at(feature));
-        }
-        for (const auto feature : proj.OneHotFeatures ) {
-            binarizedIndexes.push_back(OneHotFeatureIndexes.at(feature));
-        }
-        CalcHashes(binarizedFeatures, hashedCatFeatures, transposedCatFeatureIndexes, binarizedIndexes, docCount, &ctrHashes);
-        for (size_t j = 0; j < compressedModelCtrs[i].ModelCtrs.size(); ++j) {
-            auto& ctr = *compressedModelCtrs[i].ModelCtrs[j];
-            auto& learnCtr = CtrData.LearnCtrs.at(ctr.Base);
-            auto hashIndexResolver = learnCtr.GetIndexHashViewer();
-            const ECtrType ctrType = ctr.Base.CtrType;
-            auto ptrBuckets = buckets.data();
-            for (size_t docId = 0; docId < samplesCount; ++docId) {
-                ptrBuckets[docId] = hashIndexResolver.GetIndex(ctrHashes[docId]);
+    for (const auto& binFeatureIndex : projection.BinarizedIndexes) {
+        const ui8* binFPtr = &binarizedFeatures[binFeatureIndex.BinIndex * docCount + docOffset];
+        if (!binFeatureIndex.CheckValueEqual) {
+            for (size_t i = 0; i < blockSize; ++i) {
+                result[i] = CalcHash(result[i], (ui64)(binFPtr[i] >= binFeatureIndex.Value));
             }
-            if (ctrType == ECtrType::BinarizedTargetMeanValue || ctrType == ECtrType::FloatTargetMeanValue) {
-                const auto emptyVal = ctr.Calc(0.f, 0.f);
-                auto ctrMean = learnCtr.GetTypedArrayRefForBlobData<TCtrMeanHistory>();
-                for (size_t doc = 0; doc < samplesCount; ++doc) {
-                    if (ptrBuckets[doc] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
-                        const TCtrMeanHistory& ctrMeanHistory = ctrMean[ptrBuckets[doc]];
-                        resultPtr[doc + resultIdx] = ctr.Calc(ctrMeanHistory.Sum, ctrMeanHistory.Count);
-                    } else {
-                        resultPtr[doc + resultIdx] = emptyVal;
-                    }
+        } else {
+            for (size_t i = 0; i < blockSize; ++i) {
+                result[i] = CalcHash(result[i], (ui64)(binFPtr[i] == binFeatureIndex.Value));
+            }
+        }
+    }
+}
+
+static void GetStats(
+    const TCtrValueTable& learnCtr,
+    TConstArrayRef<ui64> hashes,
+    ui32* indexes,
+    const ui8** result) {
+    learnCtr.GetIndexHashViewer().GetIndexes(hashes, indexes);
+    const ui8* blob = learnCtr.GetTypedArrayRefForBlobData<ui8>().data();
+    const size_t statsSize = learnCtr.GetStatsSize();
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        if (indexes[i] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
+            result[i] = blob + (size_t)indexes[i] * statsSize;
+            Y_PREFETCH_READ(result[i], 3);
+        } else {
+            result[i] = nullptr;
+        }
+    }
+}
+
+// stats[doc] points to value table blob data for document hash or is nullptr if hash was not found
+static void CalcCtrValues(
+    const TModelCtr& ctr,
+    const TCtrValueTable& learnCtr,
+    const ui8* const* stats,
+    size_t samplesCount,
+    float* resultPtr) {
+    const ECtrType ctrType = ctr.Base.CtrType;
+    if (ctrType == ECtrType::BinarizedTargetMeanValue || ctrType == ECtrType::FloatTargetMeanValue) {
+        const auto emptyVal = ctr.Calc(0.f, 0.f);
+        for (size_t doc = 0; doc < samplesCount; ++doc) {
+            if (stats[doc]) {
+                const TCtrMeanHistory& ctrMeanHistory = *reinterpret_cast<const TCtrMeanHistory*>(stats[doc]);
+                resultPtr[doc] = ctr.Calc(ctrMeanHistory.Sum, ctrMeanHistory.Count);
+            } else {
+                resultPtr[doc] = emptyVal;
+            }
+        }
+    } else if (ctrType == ECtrType::Counter || ctrType == ECtrType::FeatureFreq) {
+        const int denominator = learnCtr.CounterDenominator;
+        auto emptyVal = ctr.Calc(0, denominator);
+        for (size_t doc = 0; doc < samplesCount; ++doc) {
+            if (stats[doc]) {
+                resultPtr[doc] = ctr.Calc(*reinterpret_cast<const int*>(stats[doc]), denominator);
+            } else {
+                resultPtr[doc] = emptyVal;
+            }
+        }
+    } else if (ctrType == ECtrType::Buckets) {
+        const int targetClassesCount = learnCtr.TargetClassesCount;
+        auto emptyVal = ctr.Calc(0, 0);
+        for (size_t doc = 0; doc < samplesCount; ++doc) {
+            if (stats[doc]) {
+                int goodCount = 0;
+                int totalCount = 0;
+                auto ctrHistory = MakeArrayRef(reinterpret_cast<const int*>(stats[doc]), targetClassesCount);
+                goodCount = ctrHistory[ctr.TargetBorderIdx];
+                for (int classId = 0; classId < targetClassesCount; ++classId) {
+                    totalCount += ctrHistory[classId];
                 }
-            } else if (ctrType == ECtrType::Counter || ctrType == ECtrType::FeatureFreq) {
-                TConstArrayRef<int> ctrTotal = learnCtr.GetTypedArrayRefForBlobData<int>();
-                const int denominator = learnCtr.CounterDenominator;
-                auto emptyVal = ctr.Calc(0, denominator);
-                for (size_t doc = 0; doc < samplesCount; ++doc) {
-                    if (ptrBuckets[doc] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
-                        resultPtr[doc + resultIdx] = ctr.Calc(ctrTotal[ptrBuckets[doc]], denominator);
-                    } else {
-                        resultPtr[doc + resultIdx] = emptyVal;
+                resultPtr[doc] = ctr.Calc(goodCount, totalCount);
+            } else {
+                resultPtr[doc] = emptyVal;
+            }
+        }
+    } else {
+        const int targetClassesCount = learnCtr.TargetClassesCount;
+
+        auto emptyVal = ctr.Calc(0, 0);
+        if (targetClassesCount > 2) {
+            for (size_t doc = 0; doc < samplesCount; ++doc) {
+                int goodCount = 0;
+                int totalCount = 0;
+                if (stats[doc]) {
+                    auto ctrHistory = MakeArrayRef(reinterpret_cast<const int*>(stats[doc]), targetClassesCount);
+                    for (int classId = 0; classId < ctr.TargetBorderIdx + 1; ++classId) {
+                        totalCount += ctrHistory[classId];
                     }
-                }
-            } else if (ctrType == ECtrType::Buckets) {
-                auto ctrIntArray = learnCtr.GetTypedArrayRefForBlobData<int>();
-                const int targetClassesCount = learnCtr.TargetClassesCount;
-                auto emptyVal = ctr.Calc(0, 0);
-                for (size_t doc = 0; doc < samplesCount; ++doc) {
-                    if (ptrBuckets[doc] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
-                        int goodCount = 0;
-                        int totalCount = 0;
-                        auto ctrHistory = MakeArrayRef(ctrIntArray.data() + ptrBuckets[doc] * targetClassesCount, targetClassesCount);
-                        goodCount = ctrHistory[ctr.TargetBorderIdx];
-                        for (int classId = 0; classId < targetClassesCount; ++classId) {
-                            totalCount += ctrHistory[classId];
-                        }
-                        resultPtr[doc + resultIdx] = ctr.Calc(goodCount, totalCount);
-                    } else {
-                        resultPtr[doc + resultIdx] = emptyVal;
+                    for (int classId = ctr.TargetBorderIdx + 1; classId < targetClassesCount; ++classId) {
+                        goodCount += ctrHistory[classId];
                     }
+                    totalCount += goodCount;
                 }
-            } else {
-                auto ctrIntArray = learnCtr.GetTypedArrayRefForBlobData<int>();
-                const int targetClassesCount = learnCtr.TargetClassesCount;
-
-                auto emptyVal = ctr.Calc(0, 0);
-                if (targetClassesCount > 2) {
-                    for (size_t doc = 0; doc < samplesCount; ++doc) {
-                        int goodCount = 0;
-                        int totalCount = 0;
-                        if (ptrBuckets[doc] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
-                            auto ctrHistory = MakeArrayRef(ctrIntArray.data() + ptrBuckets[doc] * targetClassesCount, targetClassesCount);
-                            for (int classId = 0; classId < ctr.TargetBorderIdx + 1; ++classId) {
-                                totalCount += ctrHistory[classId];
-                            }
-                            for (int classId = ctr.TargetBorderIdx + 1; classId < targetClassesCount; ++classId) {
-                                goodCount += ctrHistory[classId];
-                            }
-                            totalCount += goodCount;
-                        }
-                        resultPtr[doc + resultIdx] = ctr.Calc(goodCount, totalCount);
-                    }
+                resultPtr[doc] = ctr.Calc(goodCount, totalCount);
+            }
+        } else {
+            for (size_t doc = 0; doc < samplesCount; ++doc) {
+                if (stats[doc]) {
+                    const int* ctrHistory = reinterpret_cast<const int*>(stats[doc]);
+                    resultPtr[doc] = ctr.Calc(ctrHistory[1], ctrHistory[0] + ctrHistory[1]);
                 } else {
-                    for (size_t doc = 0; doc < samplesCount; ++doc) {
-                        if (ptrBuckets[doc] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
-                            const int* ctrHistory = &ctrIntArray[ptrBuckets[doc] * 2];
-                            resultPtr[doc + resultIdx] = ctr.Calc(ctrHistory[1], ctrHistory[0] + ctrHistory[1]);
-                        } else {
-                            resultPtr[doc + resultIdx] = emptyVal;
-                        }
+                    resultPtr[doc] = emptyVal;
+                }
+            }
+        }
+    }
+}
+
+void TStaticCtrCalcPlan::CalcCtrs(
+    const TConstArrayRef<ui8>& binarizedFeatures,
+    const TConstArrayRef<int>& hashedCatFeatures,
+    size_t docCount,
+    TArrayRef<float> result) const {
+    ui64 ctrHashes[CTR_CALC_BLOCK_SIZE];
+    ui32 indexes[CTR_CALC_BLOCK_SIZE];
+    const ui8* stats[CTR_CALC_BLOCK_SIZE];
+    for (size_t blockStart = 0; blockStart < docCount; blockStart += CTR_CALC_BLOCK_SIZE) {
+        const size_t blockSize = Min(CTR_CALC_BLOCK_SIZE, docCount - blockStart);
+        float* resultPtr = result.data() + blockStart;
+        for (const auto& projection : Projections) {
+            CalcProjectionHashes(projection, binarizedFeatures, hashedCatFeatures, docCount, blockStart, blockSize, ctrHashes);
+            const auto blockHashes = MakeArrayRef(ctrHashes, blockSize);
+            for (const auto& compiledCtr : projection.ModelCtrs) {
+                if (compiledCtr.PrecomputedValues) {
+                    const auto& precomputed = *compiledCtr.PrecomputedValues;
+                    compiledCtr.LearnCtr->GetIndexHashViewer().GetIndexes(blockHashes, indexes);
+                    for (size_t i = 0; i < blockSize; ++i) {
+                        resultPtr[i] = indexes[i] != NCatboost::TDenseIndexHashView::NotFoundIndex ?
+                            precomputed.Values[indexes[i]] : precomputed.EmptyValue;
                     }
+                    resultPtr += docCount;
+                    continue;
                 }
+                if (compiledCtr.InlineTable) {
+                    compiledCtr.InlineTable->GetStats(blockHashes, stats);
+                } else {
+                    GetStats(*compiledCtr.LearnCtr, blockHashes, indexes, stats);
+                }
+                CalcCtrValues(compiledCtr.Ctr, *compiledCtr.LearnCtr, stats, blockSize, resultPtr);
+                resultPtr += docCount;
             }
-            resultIdx += docCount;
         }
     }
 }
 
+void TStaticCtrCalcPlan::CalcCtrBins(
+    const TConstArrayRef<ui8>& binarizedFeatures,
+    const TConstArrayRef<int>& hashedCatFeatures,
+    size_t docCount,
+    TArrayRef<ui8> result) const {
+    Y_ASSERT(HasAllCtrBins);
+    ui64 ctrHashes[CTR_CALC_BLOCK_SIZE];
+    ui32 indexes[CTR_CALC_BLOCK_SIZE];
+    for (size_t blockStart = 0; blockStart < docCount; blockStart += CTR_CALC_BLOCK_SIZE) {
+        const size_t blockSize = Min(CTR_CALC_BLOCK_SIZE, docCount - blockStart);
+        ui8* resultPtr = result.data() + blockStart;
+        for (const auto& projection : Projections) {
+            CalcProjectionHashes(projection, binarizedFeatures, hashedCatFeatures, docCount, blockStart, blockSize, ctrHashes);
+            for (const auto& compiledCtr : projection.ModelCtrs) {
+                const auto& precomputed = *compiledCtr.PrecomputedValues;
+                compiledCtr.LearnCtr->GetIndexHashViewer().GetIndexes(MakeArrayRef(ctrHashes, blockSize), indexes);
+                for (size_t i = 0; i < blockSize; ++i) {
+                    resultPtr[i] = indexes[i] != NCatboost::TDenseIndexHashView::NotFoundIndex ?
+                        precomputed.Bins[indexes[i]] : precomputed.EmptyBin;
+                }
+                resultPtr += docCount;
+            }
+        }
+    }
+}
+
+TIntrusivePtr<ICtrCalcPlan> TStaticCtrProvider::CreateCalcPlan(const TVector<TCtrFeature>& ctrFeatures, bool buildInlineTables) const {
+    TVector<TModelCtr> neededCtrs;
+    for (const auto& ctrFeature : ctrFeatures) {
+        neededCtrs.push_back(ctrFeature.Ctr);
+    }
+    return MakeIntrusive<TStaticCtrCalcPlan>(
+        neededCtrs,
+        CtrData,
+        FloatFeatureIndexes,
+        CatFeatureIndex,
+        OneHotFeatureIndexes,
+        PrecomputedCtrValues,
+        ctrFeatures,
+        buildInlineTables);
+}
+
+void TStaticCtrProvider::CalcCtrs(const TVector<TModelCtr>& neededCtrs,
+                                  const TConstArrayRef<ui8>& binarizedFeatures,
+                                  const TConstArrayRef<int>& hashedCatFeatures,
+                                  size_t docCount,
+                                  TArrayRef<float> result) {
+    TStaticCtrCalcPlan(
+        neededCtrs,
+        CtrData,
+        FloatFeatureIndexes,
+        CatFeatureIndex,
+        OneHotFeatureIndexes,
+        PrecomputedCtrValues,
+        /*ctrFeatures*/ {},
+        /*buildInlineTables*/ false).CalcCtrs(
+        binarizedFeatures,
+        hashedCatFeatures,
+        docCount,
+        result);
+}
+
+void TStaticCtrProvider::Save(IOutputStream* out) const {
+    ::Save(out, CtrData);
+    if (!PrecomputedCtrValues.empty()) {
+        TVector<const TPrecomputedCtrValues*> sortedValues;
+        for (const auto& ctrValues : PrecomputedCtrValues) {
+            sortedValues.push_back(&ctrValues.second);
+        }
+        Sort(sortedValues.begin(), sortedValues.end(), [](const TPrecomputedCtrValues* lhs, const TPrecomputedCtrValues* rhs) {
+            return lhs->Ctr < rhs->Ctr;
+        });
+        SaveSize(out, sortedValues.size());
+        for (const auto* ctrValues : sortedValues) {
+            ctrValues->Save(out);
+        }
+    }
+}
+
+void TStaticCtrProvider::LoadPrecomputedCtrValues(IInputStream* inp) {
+    PrecomputedCtrValues.clear();
+    const size_t count = LoadSize(inp);
+    for (size_t i = 0; i < count; ++i) {
+        TPrecomputedCtrValues ctrValues;
+        ctrValues.Load(inp);
+        const auto& learnCtr = CtrData.LearnCtrs.at(ctrValues.Ctr.Base);
+        CB_ENSURE(
+            ctrValues.Values.size() * learnCtr.GetStatsSize() == learnCtr.GetTypedArrayRefForBlobData<ui8>().size(),
+            "Precomputed ctr values count doesn't match value table size"
+        );
+        const TModelCtr ctr = ctrValues.Ctr;
+        PrecomputedCtrValues[ctr] = std::move(ctrValues);
+    }
+}
+
+void TStaticCtrProvider::PrecomputeCtrValues(const TVector<TCtrFeature>& ctrFeatures) {
+    for (const auto& ctrFeature : ctrFeatures) {
+        const TModelCtr& ctr = ctrFeature.Ctr;
+        CB_ENSURE(ctrFeature.Borders.size() < 256, "Ctr feature should have less than 256 borders");
+        const TCtrValueTable& learnCtr = CtrData.LearnCtrs.at(ctr.Base);
+        const auto blob = learnCtr.GetTypedArrayRefForBlobData<ui8>();
+        const size_t statsSize = learnCtr.GetStatsSize();
+        if (statsSize == 0) {
+            // table without target classes has no stats to precompute, ctr is calculated per document
+            continue;
+        }
+        const size_t bucketCount = blob.size() / statsSize;
+        // last element is nullptr to get value for hashes missing in table
+        TVector<const ui8*> stats(bucketCount + 1, nullptr);
+        for (size_t bucket = 0; bucket < bucketCount; ++bucket) {
+            stats[bucket] = blob.data() + bucket * statsSize;
+        }
+        TVector<float> values(bucketCount + 1);
+        CalcCtrValues(ctr, learnCtr, stats.data(), stats.size(), values.data());
+        TVector<ui8> bins(values.size());
+        GetEvaluationKernels().BinarizeFloats(values.data(), values.size(), ctrFeature.Borders.data(), ctrFeature.Borders.size(), bins.data());
+
+        auto& precomputed = PrecomputedCtrValues[ctr];
+        precomputed.Ctr = ctr;
+        precomputed.EmptyValue = values.back();
+        values.pop_back();
+        precomputed.Values = std::move(values);
+        precomputed.Borders = ctrFeature.Borders;
+        precomputed.EmptyBin = bins.back();
+        bins.pop_back();
+        precomputed.Bins = std::move(bins);
+    }
+}
+
 bool TStaticCtrProvider::HasNeededCtrs(const TVector<TModelCtr>& neededCtrs) const {
     for (const auto& ctr : neededCtrs) {
         if (!CtrData.LearnCtrs.has(ctr.Base)) {
@@ -27,6 +27,17 @@ public:
         const TVector<TFloatFeature>& floatFeatures,
         const TVector<TOneHotFeature>& oheFeatures,
         const TVector<TCatFeature>& catFeatures) override;
+
+    TIntrusivePtr<ICtrCalcPlan> CreateCalcPlan(const TVector<TCtrFeature>& ctrFeatures) const override {
+        return CreateCalcPlan(ctrFeatures, /*buildInlineTables*/ false);
+    }
+
+    /**
+     * With buildInlineTables statistics of value tables that own their data are copied to TCtrInlineTable
+     * for faster lookups, plan keeps the copy, so ctr data takes twice as much memory while plan is alive.
+     */
+    TIntrusivePtr<ICtrCalcPlan> CreateCalcPlan(const TVector<TCtrFeature>& ctrFeatures, bool buildInlineTables) const;
+
     bool IsSerializable() const override {
         return true;
     }
@@ -35,18 +46,31 @@ public:
         CtrData.LearnCtrs[ctrBase] = std::move(valueTable);
     }
 
-    void Save(IOutputStream* out) const override {
-        ::Save(out, CtrData);
-    }
+    void Save(IOutputStream* out) const override;
 
     void Load(IInputStream* inp) override {
         ::Load(inp, CtrData);
     }
 
+    //! Loads values saved after CtrData by static_provider_v2 providers
+    void LoadPrecomputedCtrValues(IInputStream* inp);
+
+    void LoadNonOwning(TMemoryInput* in, TIntrusivePtr<TThrRefBase> dataHolder) override {
+        CtrData.LoadThin(in);
+        DataHolder = std::move(dataHolder);
+    }
+
     TString ModelPartIdentifier() const override {
-        return "static_provider_v1";
+        return PrecomputedCtrValues.empty() ? "static_provider_v1" : "static_provider_v2";
     }
 
+    /**
+     * Calculates ctr values and their bins by ctr feature borders for all buckets of value tables,
+     * after that binarized ctr features are calculated by one array access per document.
+     * Model with precomputed values is saved with static_provider_v2 part identifier.
+     */
+    void PrecomputeCtrValues(const TVector<TCtrFeature>& ctrFeatures);
+
     const THashMap<TFloatSplit, TBinFeatureIndexValue>& GetFloatFeatureIndexes() const {
         return FloatFeatureIndexes;
     }
@@ -61,10 +85,13 @@ public:
 
     ~TStaticCtrProvider() override {}
     TCtrData CtrData;
+    THashMap<TModelCtr, TPrecomputedCtrValues> PrecomputedCtrValues;
 private:
     THashMap<TFloatSplit, TBinFeatureIndexValue> FloatFeatureIndexes;
     THashMap<int, int> CatFeatureIndex;
     THashMap<TOneHotSplit, TBinFeatureIndexValue> OneHotFeatureIndexes;
+    //! Owner of memory referenced by value tables loaded with LoadNonOwning
+    TIntrusivePtr<TThrRefBase> DataHolder;
 };
 
 struct TStaticCtrOnFlightSerializationProvider: public ICtrProvider {
@@ -0,0 +1,52 @@
+#include <catboost/libs/model/ctr_value_table.h>
+
+#include <library/unittest/registar.h>
+
+#include <util/random/fast.h>
+
+Y_UNIT_TEST_SUITE(TCtrInlineTableTest) {
+    Y_UNIT_TEST(TestSameLookupResults) {
+        TFastRng64 rng(0);
+        for (ECtrType ctrType : {ECtrType::Borders, ECtrType::Buckets, ECtrType::Counter, ECtrType::BinarizedTargetMeanValue}) {
+            for (int targetClassesCount : {2, 3, 13}) {
+                TCtrValueTable table;
+                table.ModelCtrBase.CtrType = ctrType;
+                table.TargetClassesCount = targetClassesCount;
+                const size_t uniqueValuesCount = 1000;
+                const size_t statsSize = table.GetStatsSize();
+                TVector<ui64> hashes;
+                auto hashBuilder = table.GetIndexHashBuilder(uniqueValuesCount);
+                for (size_t i = 0; i < uniqueValuesCount; ++i) {
+                    hashes.push_back(rng.GenRand());
+                    hashBuilder.AddIndex(hashes.back());
+                }
+                auto blob = table.AllocateBlobAndGetArrayRef<ui8>(uniqueValuesCount * statsSize);
+                for (auto& byte : blob) {
+                    byte = rng.Uniform(256);
+                }
+                for (size_t i = 0; i < uniqueValuesCount; ++i) {
+                    hashes.push_back(rng.GenRand());
+                }
+                hashes.push_back(NCatboost::TBucket::InvalidHashValue);
+
+                TCtrInlineTable inlineTable(table);
+                UNIT_ASSERT_EQUAL(inlineTable.GetBucketSize() % sizeof(ui64), 0);
+                TVector<const ui8*> stats(hashes.size());
+                inlineTable.GetStats(hashes, stats.data());
+                const auto hashViewer = table.GetIndexHashViewer();
+                TVector<ui32> indexes(hashes.size());
+                hashViewer.GetIndexes(hashes, indexes.data());
+                for (size_t i = 0; i < hashes.size(); ++i) {
+                    const ui32 index = hashViewer.GetIndex(hashes[i]);
+                    UNIT_ASSERT_EQUAL(indexes[i], index);
+                    if (index == NCatboost::TDenseIndexHashView::NotFoundIndex) {
+                        UNIT_ASSERT(stats[i] == nullptr);
+                    } else {
+                        UNIT_ASSERT(stats[i] != nullptr);
+                        UNIT_ASSERT_EQUAL(memcmp(stats[i], blob.data() + index * statsSize, statsSize), 0);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -1,7 +1,12 @@
+#include "model_test_helpers.h"
+
 #include <catboost/libs/model/model.h>
 #include <catboost/libs/model/formula_evaluator.h>
 #include <library/unittest/registar.h>
 
+#include <util/generic/ymath.h>
+#include <util/random/fast.h>
+
 using namespace std;
 
 TFullModel SimpleFloatModel() {
@@ -63,6 +68,30 @@ TFullModel MultiValueFloatModel() {
     return model;
 }
 
+TFullModel RandomFloatModel(int featureCount, int borderCount, int treeCount, int treeDepth, int approxDimension, TFastRng64& rng) {
+    TFullModel model;
+    for (int featureIdx = 0; featureIdx < featureCount; ++featureIdx) {
+        TVector<float> borders;
+        for (int borderIdx = 0; borderIdx < borderCount; ++borderIdx) {
+            borders.push_back(borderIdx + 0.5f);
+        }
+        model.ObliviousTrees.FloatFeatures.emplace_back(false, featureIdx, featureIdx, borders);
+    }
+    for (int treeIdx = 0; treeIdx < treeCount; ++treeIdx) {
+        TVector<int> tree;
+        for (int depth = 0; depth < treeDepth; ++depth) {
+            tree.push_back(rng.Uniform(featureCount * borderCount));
+        }
+        model.ObliviousTrees.AddBinTree(tree);
+        for (int leafIdx = 0; leafIdx < (approxDimension << treeDepth); ++leafIdx) {
+            model.ObliviousTrees.LeafValues.push_back(rng.GenRandReal1());
+        }
+    }
+    model.ObliviousTrees.ApproxDimension = approxDimension;
+    model.UpdateDynamicData();
+    return model;
+}
+
 Y_UNIT_TEST_SUITE(TObliviousTreeModel) {
     Y_UNIT_TEST(TestFlatCalcFloat) {
         auto modelCalcer = SimpleFloatModel();
@@ -105,4 +134,240 @@ Y_UNIT_TEST_SUITE(TObliviousTreeModel) {
         };
         UNIT_ASSERT_EQUAL(canonVals, result);
     }
+
+    Y_UNIT_TEST(TestSimdLevelsGiveSameResults) {
+        TFastRng64 rng(42);
+        const int featureCount = 10;
+        const int borderCount = 40;
+        const size_t docCount = 1000;
+        TVector<TVector<float>> features(docCount);
+        for (auto& docFeatures : features) {
+            for (int featureIdx = 0; featureIdx < featureCount; ++featureIdx) {
+                docFeatures.push_back(rng.GenRandReal1() * (borderCount + 1));
+            }
+        }
+        for (int approxDimension : {1, 3}) {
+            for (int treeDepth : {6, 10}) {
+                const auto model = RandomFloatModel(featureCount, borderCount, 50, treeDepth, approxDimension, rng);
+                auto calc = [&](ESimdLevel simdLevel) {
+                    TVector<double> result(docCount * approxDimension);
+                    CalcGeneric(
+                        model,
+                        [&features](const TFloatFeature& floatFeature, size_t index) -> float {
+                            return features[index][floatFeature.FlatFeatureIndex];
+                        },
+                        [](const TCatFeature&, size_t) -> int {
+                            return 0;
+                        },
+                        docCount,
+                        0,
+                        model.GetTreeCount(),
+                        result,
+                        simdLevel
+                    );
+                    return result;
+                };
+                const auto sse2Result = calc(ESimdLevel::Sse2);
+                for (auto simdLevel : {ESimdLevel::Avx2, ESimdLevel::Avx512}) {
+                    if (IsSimdLevelSupported(simdLevel)) {
+                        UNIT_ASSERT_EQUAL(sse2Result, calc(simdLevel));
+                    }
+                }
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestBinarySearchBinarizationIsExact) {
+        TFastRng64 rng(17);
+        const size_t docCount = 300;
+        TVector<float> values;
+        for (size_t docId = 0; docId < docCount; ++docId) {
+            values.push_back(docId % 37 == 0 ? std::numeric_limits<float>::quiet_NaN() : rng.Uniform(100) / 4.0f);
+        }
+        for (size_t borderCount : {0, 1, 2, 3, 7, 64, 100, 255}) {
+            TVector<float> borders;
+            for (size_t borderIdx = 0; borderIdx < borderCount; ++borderIdx) {
+                borders.push_back(rng.Uniform(100) / 4.0f);
+            }
+            Sort(borders.begin(), borders.end());
+            TVector<ui8> canonBins(docCount);
+            for (size_t docId = 0; docId < docCount; ++docId) {
+                for (float border : borders) {
+                    canonBins[docId] += (ui8)(values[docId] > border);
+                }
+            }
+            for (auto simdLevel : {ESimdLevel::Sse2, ESimdLevel::Avx2, ESimdLevel::Avx512}) {
+                if (!IsSimdLevelSupported(simdLevel)) {
+                    continue;
+                }
+                const auto& kernels = GetEvaluationKernels(simdLevel);
+                for (auto kernel : {kernels.BinarizeFloats, kernels.BinarizeFloatsBinarySearch}) {
+                    TVector<ui8> bins(docCount);
+                    kernel(values.data(), docCount, borders.data(), borders.size(), bins.data());
+                    UNIT_ASSERT_EQUAL(canonBins, bins);
+                }
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestCtrCalcPlanGivesSameResults) {
+        TFullModel model = TrainCatOnlyCatboostModel();
+        UNIT_ASSERT(!model.ObliviousTrees.GetUsedModelCtrs().empty());
+        UNIT_ASSERT(model.ObliviousTrees.GetCtrCalcPlan() != nullptr);
+        TFullModel modelWithoutPlan = model;
+        modelWithoutPlan.ObliviousTrees.SetCtrCalcPlan(nullptr);
+
+        TFastRng64 rng(0);
+        // more documents than in one ctr calculation block
+        const size_t docCount = 300;
+        TVector<TVector<float>> features(docCount);
+        TVector<TConstArrayRef<float>> featuresRefs;
+        for (auto& docFeatures : features) {
+            for (int featureIdx = 0; featureIdx < 3; ++featureIdx) {
+                docFeatures.push_back(ConvertCatFeatureHashToFloat(CalcCatFeatureHash(ToString(rng.Uniform(6)))));
+            }
+            featuresRefs.emplace_back(docFeatures);
+        }
+        auto checkSameResults = [&featuresRefs] (const TFullModel& model, const TFullModel& modelWithoutPlan) {
+            TVector<double> results(featuresRefs.size());
+            TVector<double> resultsWithoutPlan(featuresRefs.size());
+            model.CalcFlat(featuresRefs, results);
+            modelWithoutPlan.CalcFlat(featuresRefs, resultsWithoutPlan);
+            UNIT_ASSERT_EQUAL(results, resultsWithoutPlan);
+            for (size_t docId = 0; docId < featuresRefs.size(); ++docId) {
+                double singleResult = 0;
+                model.CalcFlatSingle(featuresRefs[docId], MakeArrayRef(&singleResult, 1));
+                UNIT_ASSERT_DOUBLES_EQUAL(singleResult, results[docId], 1e-9);
+            }
+        };
+        checkSameResults(model, modelWithoutPlan);
+
+        TFullModel truncatedModel = model.CopyTreeRange(2, 5);
+        UNIT_ASSERT(truncatedModel.ObliviousTrees.GetCtrCalcPlan() != nullptr);
+        TFullModel truncatedModelWithoutPlan = truncatedModel;
+        truncatedModelWithoutPlan.ObliviousTrees.SetCtrCalcPlan(nullptr);
+        checkSameResults(truncatedModel, truncatedModelWithoutPlan);
+    }
+
+    Y_UNIT_TEST(TestCalcFlatStaged) {
+        TFullModel model = TrainMultiClassFloatCatboostModel();
+        const size_t approxDimension = model.ObliviousTrees.ApproxDimension;
+        UNIT_ASSERT_EQUAL(approxDimension, 3);
+        UNIT_ASSERT_EQUAL(model.GetTreeCount(), 7);
+
+        TFastRng64 rng(0);
+        // more documents than in one evaluation block
+        const size_t docCount = 300;
+        TVector<TVector<float>> features(docCount);
+        TVector<TConstArrayRef<float>> featuresRefs;
+        for (auto& docFeatures : features) {
+            for (int featureIdx = 0; featureIdx < 3; ++featureIdx) {
+                docFeatures.push_back(rng.GenRandReal1());
+            }
+            featuresRefs.emplace_back(docFeatures);
+        }
+
+        const TVector<size_t> stageTreeEnds = GetStageTreeEnds(1, 7, 2);
+        UNIT_ASSERT_EQUAL(stageTreeEnds, TVector<size_t>({3, 5, 7}));
+        TVector<double> stagedResults(stageTreeEnds.size() * docCount * approxDimension);
+        model.CalcFlatStaged(featuresRefs, 1, stageTreeEnds, stagedResults);
+        for (size_t stageIdx = 0; stageIdx < stageTreeEnds.size(); ++stageIdx) {
+            TVector<double> results(docCount * approxDimension);
+            model.CalcFlat(featuresRefs, 1, stageTreeEnds[stageIdx], results);
+            for (size_t i = 0; i < results.size(); ++i) {
+                UNIT_ASSERT_DOUBLES_EQUAL(stagedResults[stageIdx * docCount * approxDimension + i], results[i], 1e-9);
+            }
+        }
+
+        const auto intervals = model.CalcTreeIntervalsFlat(featuresRefs, 3);
+        TVector<double> results(docCount * approxDimension);
+        model.CalcFlat(featuresRefs, 0, 6, results);
+        for (size_t docId = 0; docId < docCount; ++docId) {
+            UNIT_ASSERT_EQUAL(intervals[docId].size(), 3 * approxDimension);
+            for (size_t dim = 0; dim < approxDimension; ++dim) {
+                UNIT_ASSERT_DOUBLES_EQUAL(intervals[docId][approxDimension + dim], results[docId * approxDimension + dim], 1e-9);
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestEvaluationTiling) {
+        TFullModel model = TrainMultiClassFloatCatboostModel();
+        const auto docMajorTiling = SelectEvaluationTiling(model.ObliviousTrees, /*cacheSize*/ 1 << 30);
+        UNIT_ASSERT_EQUAL(docMajorTiling.DocBlocksInGroup, 1);
+        const auto smallCacheTiling = SelectEvaluationTiling(model.ObliviousTrees, /*cacheSize*/ 256);
+        UNIT_ASSERT(smallCacheTiling.DocBlocksInGroup > 1);
+        UNIT_ASSERT(smallCacheTiling.TreesInChunk >= 4 && smallCacheTiling.TreesInChunk % 4 == 0);
+
+        TFastRng64 rng(0);
+        const size_t docCount = 1000;
+        TVector<TVector<float>> features(docCount);
+        TVector<TConstArrayRef<float>> featuresRefs;
+        for (auto& docFeatures : features) {
+            for (int featureIdx = 0; featureIdx < 3; ++featureIdx) {
+                docFeatures.push_back(rng.GenRandReal1());
+            }
+            featuresRefs.emplace_back(docFeatures);
+        }
+        TVector<double> docMajorResults(docCount * model.ObliviousTrees.ApproxDimension);
+        model.SetEvaluationTiling(docMajorTiling);
+        model.CalcFlat(featuresRefs, docMajorResults);
+        TVector<double> tiledResults(docMajorResults.size());
+        model.SetEvaluationTiling(TEvaluationTiling{/*DocBlocksInGroup*/ 3, /*TreesInChunk*/ 2});
+        model.CalcFlat(featuresRefs, tiledResults);
+        for (size_t i = 0; i < docMajorResults.size(); ++i) {
+            UNIT_ASSERT_DOUBLES_EQUAL(docMajorResults[i], tiledResults[i], 1e-9);
+        }
+    }
+
+    Y_UNIT_TEST(TestFloatLeafValuesMode) {
+        TFastRng64 rng(0);
+        for (int approxDimension : {1, 3}) {
+            TFullModel model = RandomFloatModel(/*featureCount*/ 10, /*borderCount*/ 8, /*treeCount*/ 301, /*treeDepth*/ 6, approxDimension, rng);
+            const size_t docCount = 300;
+            TVector<TVector<float>> features(docCount);
+            TVector<TConstArrayRef<float>> featuresRefs;
+            for (auto& docFeatures : features) {
+                for (int featureIdx = 0; featureIdx < 10; ++featureIdx) {
+                    docFeatures.push_back(rng.Uniform(10));
+                }
+                featuresRefs.emplace_back(docFeatures);
+            }
+            TVector<double> doubleResults(docCount * approxDimension);
+            model.CalcFlat(featuresRefs, doubleResults);
+
+            UNIT_ASSERT(!model.IsFloatLeafValuesMode());
+            model.SetFloatLeafValuesMode(true);
+            UNIT_ASSERT(model.IsFloatLeafValuesMode());
+            TVector<double> floatResults(doubleResults.size());
+            model.CalcFlat(featuresRefs, floatResults);
+            TVector<double> singleDocResults(approxDimension);
+            model.CalcFlatSingle(featuresRefs[0], singleDocResults);
+            for (int dim = 0; dim < approxDimension; ++dim) {
+                UNIT_ASSERT_DOUBLES_EQUAL(floatResults[dim], singleDocResults[dim], 1e-9);
+            }
+            double maxDeviation = 0.0;
+            for (size_t i = 0; i < doubleResults.size(); ++i) {
+                maxDeviation = Max(maxDeviation, Abs(doubleResults[i] - floatResults[i]));
+                UNIT_ASSERT_DOUBLES_EQUAL(doubleResults[i], floatResults[i], 1e-4);
+            }
+            UNIT_ASSERT_DOUBLES_EQUAL(model.CalcFloatLeafValuesMaxDeviation(featuresRefs), maxDeviation, 1e-12);
+            UNIT_ASSERT(model.IsFloatLeafValuesMode());
+
+            // explicitly set tiling is kept by mode switch
+            const TEvaluationTiling tiling{/*DocBlocksInGroup*/ 3, /*TreesInChunk*/ 8};
+            model.SetEvaluationTiling(tiling);
+            model.SetFloatLeafValuesMode(false);
+            model.SetFloatLeafValuesMode(true);
+            UNIT_ASSERT_VALUES_EQUAL(model.GetEvaluationTiling().DocBlocksInGroup, tiling.DocBlocksInGroup);
+            UNIT_ASSERT_VALUES_EQUAL(model.GetEvaluationTiling().TreesInChunk, tiling.TreesInChunk);
+            TVector<double> tiledFloatResults(floatResults.size());
+            model.CalcFlat(featuresRefs, tiledFloatResults);
+            for (size_t i = 0; i < floatResults.size(); ++i) {
+                UNIT_ASSERT_DOUBLES_EQUAL(floatResults[i], tiledFloatResults[i], 1e-9);
+            }
+
+            model.UpdateDynamicData();
+            UNIT_ASSERT(!model.IsFloatLeafValuesMode());
+        }
+    }
 }
@@ -23,4 +23,110 @@ Y_UNIT_TEST_SUITE(TModelSerialization) {
         UNIT_ASSERT_EQUAL(trainedModel.ObliviousTrees.LeafValues, deserializedModel.ObliviousTrees.LeafValues);
         UNIT_ASSERT_EQUAL(trainedModel.ObliviousTrees.TreeSplits, deserializedModel.ObliviousTrees.TreeSplits);
     }
+
+    Y_UNIT_TEST(TestReadModelMapped) {
+        TFullModel trainedModel = TrainCatOnlyCatboostModel();
+        OutputModel(trainedModel, "cat_model.bin");
+        TFullModel mappedModel = ReadModelMapped("cat_model.bin");
+        UNIT_ASSERT_EQUAL(trainedModel, mappedModel);
+        UNIT_ASSERT(mappedModel.HasValidCtrProvider());
+
+        TVector<TVector<float>> features;
+        TVector<TConstArrayRef<float>> featuresRefs;
+        for (int value = 0; value < 6; ++value) {
+            const float hash = ConvertCatFeatureHashToFloat(CalcCatFeatureHash(ToString(value)));
+            features.push_back({hash, hash, hash});
+        }
+        for (const auto& docFeatures : features) {
+            featuresRefs.emplace_back(docFeatures);
+        }
+        TVector<double> trainedModelResults(features.size());
+        TVector<double> mappedModelResults(features.size());
+        trainedModel.CalcFlat(featuresRefs, trainedModelResults);
+        {
+            // model copy should keep the mapping alive
+            TFullModel mappedModelCopy = mappedModel;
+            mappedModel = TFullModel();
+            mappedModelCopy.CalcFlat(featuresRefs, mappedModelResults);
+        }
+        UNIT_ASSERT_EQUAL(trainedModelResults, mappedModelResults);
+    }
+
+    Y_UNIT_TEST(TestCtrInlineTablesMode) {
+        TFullModel trainedModel = TrainCatOnlyCatboostModel();
+        OutputModel(trainedModel, "cat_model.bin");
+        TFullModel mappedModel = ReadModelMapped("cat_model.bin");
+
+        TVector<TVector<float>> features;
+        TVector<TConstArrayRef<float>> featuresRefs;
+        // values 0..4 are in learn set, 5 is missing in ctr value tables
+        for (int value = 0; value < 6; ++value) {
+            const float hash = ConvertCatFeatureHashToFloat(CalcCatFeatureHash(ToString(value)));
+            features.push_back({hash, hash, hash});
+        }
+        for (const auto& docFeatures : features) {
+            featuresRefs.emplace_back(docFeatures);
+        }
+        TVector<double> expectedResults(features.size());
+        trainedModel.CalcFlat(featuresRefs, expectedResults);
+        for (auto* model : {&trainedModel, &mappedModel}) {
+            model->SetCtrInlineTablesMode(true);
+            TVector<double> results(features.size());
+            model->CalcFlat(featuresRefs, results);
+            UNIT_ASSERT_EQUAL(expectedResults, results);
+            model->SetCtrInlineTablesMode(false);
+            model->CalcFlat(featuresRefs, results);
+            UNIT_ASSERT_EQUAL(expectedResults, results);
+        }
+    }
+
+    Y_UNIT_TEST(TestPrecomputedCtrValues) {
+        TFullModel trainedModel = TrainCatOnlyCatboostModel();
+        TFullModel precomputedModel = trainedModel;
+        PrecomputeCtrValues(&precomputedModel);
+        UNIT_ASSERT_EQUAL(trainedModel.CtrProvider->ModelPartIdentifier(), "static_provider_v1");
+        UNIT_ASSERT_EQUAL(precomputedModel.CtrProvider->ModelPartIdentifier(), "static_provider_v2");
+        OutputModel(precomputedModel, "precomputed_cat_model.bin");
+        TFullModel loadedModel = ReadModel("precomputed_cat_model.bin");
+        TFullModel mappedModel = ReadModelMapped("precomputed_cat_model.bin");
+        UNIT_ASSERT_EQUAL(trainedModel, loadedModel);
+        UNIT_ASSERT_EQUAL(loadedModel.CtrProvider->ModelPartIdentifier(), "static_provider_v2");
+        UNIT_ASSERT(!trainedModel.ObliviousTrees.GetCtrCalcPlan()->CanCalcCtrBins());
+        UNIT_ASSERT(precomputedModel.ObliviousTrees.GetCtrCalcPlan()->CanCalcCtrBins());
+        UNIT_ASSERT(loadedModel.ObliviousTrees.GetCtrCalcPlan()->CanCalcCtrBins());
+        UNIT_ASSERT(mappedModel.ObliviousTrees.GetCtrCalcPlan()->CanCalcCtrBins());
+
+        TVector<TVector<float>> features;
+        TVector<TConstArrayRef<float>> featuresRefs;
+        // values 0..4 are in learn set, 5 is missing in ctr value tables
+        for (int value0 = 0; value0 < 6; ++value0) {
+            for (int value1 = 0; value1 < 6; ++value1) {
+                const float hash0 = ConvertCatFeatureHashToFloat(CalcCatFeatureHash(ToString(value0)));
+                const float hash1 = ConvertCatFeatureHashToFloat(CalcCatFeatureHash(ToString(value1)));
+                features.push_back({hash0, hash1, hash0});
+            }
+        }
+        for (const auto& docFeatures : features) {
+            featuresRefs.emplace_back(docFeatures);
+        }
+        TVector<double> trainedModelResults(features.size());
+        trainedModel.CalcFlat(featuresRefs, trainedModelResults);
+        for (const auto* model : {&precomputedModel, &loadedModel, &mappedModel}) {
+            TVector<double> results(features.size());
+            model->CalcFlat(featuresRefs, results);
+            UNIT_ASSERT_EQUAL(trainedModelResults, results);
+        }
+    }
+
+    Y_UNIT_TEST(TestExportModelWithPrecomputedCtrValues) {
+        TFullModel trainedModel = TrainCatOnlyCatboostModel();
+        ExportModel(trainedModel, "exported_cat_model.bin", EModelType::CatboostBinary, "{\"precompute_ctr_values\": true}");
+        UNIT_ASSERT_EQUAL(trainedModel.CtrProvider->ModelPartIdentifier(), "static_provider_v1");
+        TFullModel loadedModel = ReadModel("exported_cat_model.bin");
+        UNIT_ASSERT_EQUAL(trainedModel, loadedModel);
+        UNIT_ASSERT_EQUAL(loadedModel.CtrProvider->ModelPartIdentifier(), "static_provider_v2");
+        UNIT_ASSERT_EXCEPTION(
+            ExportModel(trainedModel, "exported_cat_model.bin", EModelType::CatboostBinary, "{\"prediction_type\": \"raw\"}"),
+            TCatboostException);
+    }
 }
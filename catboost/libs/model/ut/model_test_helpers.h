@@ -1,8 +1,11 @@
 #pragma once
 
 #include <catboost/libs/train_lib/train_model.h>
+#include <catboost/libs/cat_feature/cat_feature.h>
 
-TFullModel TrainFloatCatboostModel() {
+#include <util/random/fast.h>
+
+inline TFullModel TrainFloatCatboostModel() {
     TPool pool;
     pool.Docs.Resize(/*doc count*/3, /*factors count*/ 3, /*baseline dimension*/ 0, /*has queryId*/ false, /*has subgroupId*/ false);
     pool.Docs.Factors[0] = {+0.5f, +1.5f, -2.5f};
@@ -18,3 +21,52 @@ TFullModel TrainFloatCatboostModel() {
 
     return model;
 }
+
+//! Model with ctr features, all features are categorical with 5 different values
+inline TFullModel TrainCatOnlyCatboostModel() {
+    const size_t docCount = 50;
+    const size_t factorCount = 3;
+    TPool pool;
+    pool.Docs.Resize(docCount, factorCount, /*baseline dimension*/ 0, /*has queryId*/ false, /*has subgroupId*/ false);
+    pool.CatFeatures = {0, 1, 2};
+    TFastRng64 rng(0);
+    for (size_t docId = 0; docId < docCount; ++docId) {
+        for (size_t factorId = 0; factorId < factorCount; ++factorId) {
+            const auto value = ToString(rng.Uniform(5));
+            pool.Docs.Factors[factorId][docId] = ConvertCatFeatureHashToFloat(CalcCatFeatureHash(value));
+        }
+        pool.Docs.Target[docId] = (pool.Docs.Factors[0][docId] == pool.Docs.Factors[1][docId]) + rng.GenRandReal1() * 0.1;
+    }
+
+    TFullModel model;
+    TEvalResult evalResult;
+    NJson::TJsonValue params;
+    params.InsertValue("iterations", 10);
+    TrainModel(params, Nothing(), Nothing(), pool, false, pool, "", &model, &evalResult);
+
+    return model;
+}
+
+//! Multiclass model on 3 float features with 3 classes
+inline TFullModel TrainMultiClassFloatCatboostModel() {
+    const size_t docCount = 30;
+    const size_t factorCount = 3;
+    TPool pool;
+    pool.Docs.Resize(docCount, factorCount, /*baseline dimension*/ 0, /*has queryId*/ false, /*has subgroupId*/ false);
+    TFastRng64 rng(0);
+    for (size_t docId = 0; docId < docCount; ++docId) {
+        for (size_t factorId = 0; factorId < factorCount; ++factorId) {
+            pool.Docs.Factors[factorId][docId] = rng.GenRandReal1();
+        }
+        pool.Docs.Target[docId] = docId % 3;
+    }
+
+    TFullModel model;
+    TEvalResult evalResult;
+    NJson::TJsonValue params;
+    params.InsertValue("iterations", 7);
+    params.InsertValue("loss_function", "MultiClass");
+    TrainModel(params, Nothing(), Nothing(), pool, false, pool, "", &model, &evalResult);
+
+    return model;
+}
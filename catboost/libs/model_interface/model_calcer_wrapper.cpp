@@ -45,6 +45,17 @@ EXPORT bool LoadFullModelFromFile(ModelCalcerHandle* modelHandle, const char* fi
     return true;
 }
 
+EXPORT bool LoadFullModelFromFileMapped(ModelCalcerHandle* modelHandle, const char* filename) {
+    try {
+        *FULL_MODEL_PTR(modelHandle) = ReadModelMapped(filename);
+    } catch (...) {
+        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        return false;
+    }
+
+    return true;
+}
+
 EXPORT bool LoadFullModelFromBuffer(ModelCalcerHandle* modelHandle, const void* binaryBuffer, size_t binaryBufferSize) {
     try {
         *FULL_MODEL_PTR(modelHandle) = ReadModel(binaryBuffer, binaryBufferSize);
@@ -74,6 +85,29 @@ EXPORT bool CalcModelPredictionFlat(ModelCalcerHandle* modelHandle, size_t docCo
     return true;
 }
 
+EXPORT bool CalcModelPredictionFlatStaged(
+        ModelCalcerHandle* modelHandle,
+        size_t docCount,
+        const float** floatFeatures, size_t floatFeaturesSize,
+        size_t treeStart, size_t treeEnd, size_t evalPeriod,
+        double* result, size_t resultSize) {
+    try {
+        TVector<TConstArrayRef<float>> featuresVec(docCount);
+        for (size_t i = 0; i < docCount; ++i) {
+            featuresVec[i] = TConstArrayRef<float>(floatFeatures[i], floatFeaturesSize);
+        }
+        FULL_MODEL_PTR(modelHandle)->CalcFlatStaged(
+            featuresVec,
+            treeStart,
+            GetStageTreeEnds(treeStart, treeEnd, evalPeriod),
+            TArrayRef<double>(result, resultSize));
+    } catch (...) {
+        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        return false;
+    }
+    return true;
+}
+
 EXPORT bool CalcModelPrediction(
         ModelCalcerHandle* modelHandle,
         size_t docCount,
@@ -154,4 +188,12 @@ EXPORT size_t GetCatFeaturesCount(ModelCalcerHandle* modelHandle) {
     return FULL_MODEL_PTR(modelHandle)->GetNumCatFeatures();
 }
 
+EXPORT size_t GetTreeCount(ModelCalcerHandle* modelHandle) {
+    return FULL_MODEL_PTR(modelHandle)->GetTreeCount();
+}
+
+EXPORT size_t GetDimensionsCount(ModelCalcerHandle* modelHandle) {
+    return FULL_MODEL_PTR(modelHandle)->ObliviousTrees.ApproxDimension;
+}
+
 }
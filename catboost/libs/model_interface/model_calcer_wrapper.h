@@ -47,6 +47,18 @@ EXPORT bool LoadFullModelFromFile(
     ModelCalcerHandle* calcer,
     const char* filename);
 
+/**
+ * Load model from file into given model handle using memory mapping.
+ * CTR tables are not copied into process memory, so processes loading same model file share it through page cache.
+ * Model file should not be modified while model handle is alive.
+ * @param calcer
+ * @param filename
+ * @return false if error occured
+ */
+EXPORT bool LoadFullModelFromFileMapped(
+    ModelCalcerHandle* calcer,
+    const char* filename);
+
 /**
  * Load model from memory buffer into given model handle
  * @param calcer
@@ -78,6 +90,29 @@ EXPORT bool CalcModelPredictionFlat(
     const float** floatFeatures, size_t floatFeaturesSize,
     double* result, size_t resultSize);
 
+/**
+ * **Use this method only if you really understand what you want.**
+ * Staged raw model predictions on flat feature vectors.
+ * Stage i contains predictions of trees [treeStart, min(treeStart + (i + 1) * evalPeriod, treeEnd)),
+ * so stage count is ceil((treeEnd - treeStart) / evalPeriod). Features are binarized once for all stages.
+ * @param calcer model handle
+ * @param docCount number of objects
+ * @param floatFeatures array of array of float (first dimension is object index, second if feature index)
+ * @param floatFeaturesSize float values array size
+ * @param treeStart first tree of the first stage
+ * @param treeEnd tree end of the last stage, should not be greater than GetTreeCount(calcer)
+ * @param evalPeriod tree count in one stage, 0 means single stage
+ * @param result pointer to user allocated results vector with indexation [(stageIdx * docCount + docIdx) * modelApproxDimension + classId]
+ * @param resultSize result size should be equal to stageCount * docCount * modelApproxDimension
+ * @return false if error occured
+ */
+EXPORT bool CalcModelPredictionFlatStaged(
+    ModelCalcerHandle* calcer,
+    size_t docCount,
+    const float** floatFeatures, size_t floatFeaturesSize,
+    size_t treeStart, size_t treeEnd, size_t evalPeriod,
+    double* result, size_t resultSize);
+
 /**
  * Calculate raw model predictions on float features and string categorical feature values
  * @param calcer model handle
@@ -168,6 +203,18 @@ EXPORT size_t GetFloatFeaturesCount(ModelCalcerHandle* calcer);
  */
 EXPORT size_t GetCatFeaturesCount(ModelCalcerHandle* calcer);
 
+/**
+ * Get number of trees in model
+ * @param calcer model handle
+ */
+EXPORT size_t GetTreeCount(ModelCalcerHandle* calcer);
+
+/**
+ * Get number of dimensions in model (modelApproxDimension), it is greater than 1 for multiclass models
+ * @param calcer model handle
+ */
+EXPORT size_t GetDimensionsCount(ModelCalcerHandle* calcer);
+
 #if defined(__cplusplus)
 }
 #endif
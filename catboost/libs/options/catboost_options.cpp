@@ -358,6 +358,16 @@ void TCatboostOptions::Validate() const {
     if (GetTaskType() == ETaskType::CPU) {
         CB_ENSURE(!(IsPairwiseScoring(lossFunction) && leavesEstimation == ELeavesEstimation::Newton),
                   "This leaf estimation method is not supported for querywise error for CPU learning");
+        if (ObliviousTreeOptions->LeafPartitionedLayout.Get()) {
+            CB_ENSURE(BoostingOptions->BoostingType == EBoostingType::Plain, "Leaf partitioned layout is supported for Plain boosting type only");
+            CB_ENSURE(ObliviousTreeOptions->SamplingFrequency.Get() == ESamplingFrequency::PerTree,
+                      "Leaf partitioned layout is supported for PerTree sampling frequency only");
+            CB_ENSURE(!IsPairwiseScoring(lossFunction), "Leaf partitioned layout is not supported for " << lossFunction << " loss function");
+            CB_ENSURE(SystemOptions->IsSingleHost(), "Leaf partitioned layout is not supported for distributed learning");
+        }
+        if (ObliviousTreeOptions->ExclusiveFeatureBundling.Get()) {
+            CB_ENSURE(SystemOptions->IsSingleHost(), "Exclusive feature bundling is not supported for distributed learning");
+        }
     }
 
     ValidateCtrs(CatFeatureParams->SimpleCtrs, lossFunction, false);
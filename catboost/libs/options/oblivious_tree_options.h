@@ -23,6 +23,9 @@ namespace NCatboostOptions {
             , BootstrapConfig("bootstrap", TBootstrapConfig(taskType))
             , Rsm("rsm", 1.0, taskType)
             , SamplingFrequency("sampling_frequency", ESamplingFrequency::PerTreeLevel, taskType)
+            , LeafPartitionedLayout("dev_leaf_partitioned_layout", false, taskType)
+            , PermutedFeatureCopies("dev_permuted_feature_copies", false, taskType)
+            , ExclusiveFeatureBundling("dev_exclusive_feature_bundling", false, taskType)
             , ModelSizeReg("model_size_reg", 0.5, taskType)
             , ObservationsToBootstrap("observations_to_bootstrap", EObservationsToBootstrap::TestOnly, taskType) //it's specific for fold-based scheme, so here and not in bootstrap options
             , FoldSizeLossNormalization("fold_size_loss_normalization", false, taskType)
@@ -33,6 +36,9 @@ namespace NCatboostOptions {
         {
             Rsm.ChangeLoadUnimplementedPolicy(ELoadUnimplementedPolicy::ExceptionOnChange);
             SamplingFrequency.ChangeLoadUnimplementedPolicy(ELoadUnimplementedPolicy::ExceptionOnChange);
+            LeafPartitionedLayout.ChangeLoadUnimplementedPolicy(ELoadUnimplementedPolicy::SkipWithWarning);
+            PermutedFeatureCopies.ChangeLoadUnimplementedPolicy(ELoadUnimplementedPolicy::SkipWithWarning);
+            ExclusiveFeatureBundling.ChangeLoadUnimplementedPolicy(ELoadUnimplementedPolicy::SkipWithWarning);
 
             FoldSizeLossNormalization.ChangeLoadUnimplementedPolicy(ELoadUnimplementedPolicy::ExceptionOnChange);
             AddRidgeToTargetFunctionFlag.ChangeLoadUnimplementedPolicy(ELoadUnimplementedPolicy::ExceptionOnChange);
@@ -52,7 +58,10 @@ namespace NCatboostOptions {
                         &ObservationsToBootstrap,
                         &PairwiseNonDiagReg,
                         &LeavesEstimationBacktrackingType,
-                        &SamplingFrequency);
+                        &SamplingFrequency,
+                        &LeafPartitionedLayout,
+                        &PermutedFeatureCopies,
+                        &ExclusiveFeatureBundling);
 
             Validate();
         }
@@ -64,19 +73,22 @@ namespace NCatboostOptions {
                        ScoreFunction,
                        PairwiseNonDiagReg,
                        LeavesEstimationBacktrackingType,
-                       MaxCtrComplexityForBordersCaching, Rsm, ObservationsToBootstrap, SamplingFrequency);
+                       MaxCtrComplexityForBordersCaching, Rsm, ObservationsToBootstrap, SamplingFrequency,
+                       LeafPartitionedLayout, PermutedFeatureCopies, ExclusiveFeatureBundling);
         }
 
         bool operator==(const TObliviousTreeLearnerOptions& rhs) const {
             return std::tie(MaxDepth, LeavesEstimationIterations, LeavesEstimationMethod, L2Reg, ModelSizeReg, RandomStrength,
                             BootstrapConfig, Rsm, SamplingFrequency, ObservationsToBootstrap, FoldSizeLossNormalization,
                             AddRidgeToTargetFunctionFlag, ScoreFunction, MaxCtrComplexityForBordersCaching,
-                            PairwiseNonDiagReg, LeavesEstimationBacktrackingType
+                            PairwiseNonDiagReg, LeavesEstimationBacktrackingType, LeafPartitionedLayout,
+                            PermutedFeatureCopies, ExclusiveFeatureBundling
             ) ==
                    std::tie(rhs.MaxDepth, rhs.LeavesEstimationIterations, rhs.LeavesEstimationMethod, rhs.L2Reg, rhs.ModelSizeReg,
                             rhs.RandomStrength, rhs.BootstrapConfig, rhs.Rsm, rhs.SamplingFrequency,
                             rhs.ObservationsToBootstrap, rhs.FoldSizeLossNormalization, rhs.AddRidgeToTargetFunctionFlag,
-                            rhs.ScoreFunction, rhs.MaxCtrComplexityForBordersCaching, rhs.PairwiseNonDiagReg, rhs.LeavesEstimationBacktrackingType);
+                            rhs.ScoreFunction, rhs.MaxCtrComplexityForBordersCaching, rhs.PairwiseNonDiagReg, rhs.LeavesEstimationBacktrackingType,
+                            rhs.LeafPartitionedLayout, rhs.PermutedFeatureCopies, rhs.ExclusiveFeatureBundling);
         }
 
         bool operator!=(const TObliviousTreeLearnerOptions& rhs) const {
@@ -104,6 +116,12 @@ namespace NCatboostOptions {
 
         TCpuOnlyOption<float> Rsm;
         TCpuOnlyOption<ESamplingFrequency> SamplingFrequency;
+        // Keep sampled documents ordered by leaf during tree search, supported for plain boosting with PerTree sampling only
+        TCpuOnlyOption<bool> LeafPartitionedLayout;
+        // Copy float features of every fold in its permutation order while they fit into used_ram_limit
+        TCpuOnlyOption<bool> PermutedFeatureCopies;
+        // Merge mutually exclusive sparse float features into shared columns scored in one pass
+        TCpuOnlyOption<bool> ExclusiveFeatureBundling;
         TCpuOnlyOption<float> ModelSizeReg;
 
         TGpuOnlyOption<EObservationsToBootstrap> ObservationsToBootstrap;
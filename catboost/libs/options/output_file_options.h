@@ -19,6 +19,7 @@ namespace NCatboostOptions {
             , ProfileLogPath("profile_log", "catboost_profile.log")
             , LearnErrorLogPath("learn_error_log", "learn_error.tsv")
             , ModelFormats("model_format", {EModelType::CatboostBinary})
+            , PrecomputeCtrValuesFlag("precompute_ctr_values", false)
             , TestErrorLogPath("test_error_log", "test_error.tsv")
             , TimeLeftLog("time_left_log", "time_left.tsv")
             , SnapshotPath("snapshot_file", "experiment.cbsnapshot")
@@ -81,6 +82,10 @@ namespace NCatboostOptions {
             return ModelFormats.Get();
         }
 
+        bool PrecomputeCtrValues() const {
+            return PrecomputeCtrValuesFlag.Get();
+        }
+
         const TString& GetJsonLogFilename() const {
             return JsonLogPath.Get();
         }
@@ -151,10 +156,10 @@ namespace NCatboostOptions {
 
         bool operator==(const TOutputFilesOptions& rhs) const {
             return std::tie(TrainDir, Name, MetaFile, JsonLogPath, ProfileLogPath, LearnErrorLogPath, TestErrorLogPath, TimeLeftLog, ResultModelPath,
-                            SnapshotPath, ModelFormats, SaveSnapshotFlag, AllowWriteFilesFlag, FinalCtrComputationMode, UseBestModel, SnapshotSaveIntervalSeconds,
+                            SnapshotPath, ModelFormats, PrecomputeCtrValuesFlag, SaveSnapshotFlag, AllowWriteFilesFlag, FinalCtrComputationMode, UseBestModel, SnapshotSaveIntervalSeconds,
                             EvalFileName, FstrRegularFileName, FstrInternalFileName, OutputBordersFileName) ==
                    std::tie(rhs.TrainDir, rhs.Name, rhs.MetaFile, rhs.JsonLogPath, rhs.ProfileLogPath, rhs.LearnErrorLogPath, rhs.TestErrorLogPath,
-                            rhs.TimeLeftLog, rhs.ResultModelPath, rhs.SnapshotPath, rhs.ModelFormats, rhs.SaveSnapshotFlag,
+                            rhs.TimeLeftLog, rhs.ResultModelPath, rhs.SnapshotPath, rhs.ModelFormats, rhs.PrecomputeCtrValuesFlag, rhs.SaveSnapshotFlag,
                             rhs.AllowWriteFilesFlag, rhs.FinalCtrComputationMode, rhs.UseBestModel, rhs.SnapshotSaveIntervalSeconds,
                             rhs.EvalFileName, rhs.FstrRegularFileName, rhs.FstrInternalFileName, rhs.OutputBordersFileName);
         }
@@ -167,7 +172,7 @@ namespace NCatboostOptions {
             CheckedLoad(options,
                         &TrainDir, &Name, &MetaFile, &JsonLogPath, &ProfileLogPath, &LearnErrorLogPath, &TestErrorLogPath, &TimeLeftLog,
                         &ResultModelPath,
-                        &SnapshotPath, &ModelFormats, &SaveSnapshotFlag, &AllowWriteFilesFlag, &FinalCtrComputationMode, &UseBestModel, &SnapshotSaveIntervalSeconds,
+                        &SnapshotPath, &ModelFormats, &PrecomputeCtrValuesFlag, &SaveSnapshotFlag, &AllowWriteFilesFlag, &FinalCtrComputationMode, &UseBestModel, &SnapshotSaveIntervalSeconds,
                         &EvalFileName, &OutputColumns, &FstrRegularFileName, &FstrInternalFileName, &MetricPeriod, &VerbosePeriod, &PredictionTypes, &OutputBordersFileName);
             if (!VerbosePeriod.IsSet()) {
                 VerbosePeriod.Set(MetricPeriod.Get());
@@ -178,7 +183,7 @@ namespace NCatboostOptions {
         void Save(NJson::TJsonValue* options) const {
             SaveFields(options,
                        TrainDir, Name, MetaFile, JsonLogPath, ProfileLogPath, LearnErrorLogPath, TestErrorLogPath, TimeLeftLog, ResultModelPath,
-                       SnapshotPath, ModelFormats, SaveSnapshotFlag, AllowWriteFilesFlag, FinalCtrComputationMode, UseBestModel, SnapshotSaveIntervalSeconds,
+                       SnapshotPath, ModelFormats, PrecomputeCtrValuesFlag, SaveSnapshotFlag, AllowWriteFilesFlag, FinalCtrComputationMode, UseBestModel, SnapshotSaveIntervalSeconds,
                        EvalFileName, OutputColumns, FstrRegularFileName, FstrInternalFileName, MetricPeriod, VerbosePeriod, PredictionTypes, OutputBordersFileName);
         }
 
@@ -214,6 +219,7 @@ namespace NCatboostOptions {
         TOption<TString> ProfileLogPath;
         TOption<TString> LearnErrorLogPath;
         TOption<TVector<EModelType>> ModelFormats;
+        TOption<bool> PrecomputeCtrValuesFlag;
         TOption<TString> TestErrorLogPath;
         TOption<TString> TimeLeftLog;
         TOption<TString> SnapshotPath;
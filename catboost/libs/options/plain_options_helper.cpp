@@ -112,6 +112,7 @@ namespace NCatboostOptions {
         CopyOption(plainOptions, "fstr_regular_file", &outputFilesJson, &seenKeys);
         CopyOption(plainOptions, "fstr_internal_file", &outputFilesJson, &seenKeys);
         CopyOption(plainOptions, "model_format",  &outputFilesJson, &seenKeys);
+        CopyOption(plainOptions, "precompute_ctr_values",  &outputFilesJson, &seenKeys);
         CopyOption(plainOptions, "output_borders",  &outputFilesJson, &seenKeys);
 
 
@@ -152,6 +153,9 @@ namespace NCatboostOptions {
         CopyOption(plainOptions, "fold_size_loss_normalization", &treeOptions, &seenKeys);
         CopyOption(plainOptions, "add_ridge_penalty_to_loss_function", &treeOptions, &seenKeys);
         CopyOption(plainOptions, "sampling_frequency", &treeOptions, &seenKeys);
+        CopyOption(plainOptions, "dev_leaf_partitioned_layout", &treeOptions, &seenKeys);
+        CopyOption(plainOptions, "dev_permuted_feature_copies", &treeOptions, &seenKeys);
+        CopyOption(plainOptions, "dev_exclusive_feature_bundling", &treeOptions, &seenKeys);
         CopyOption(plainOptions, "dev_max_ctr_complexity_for_border_cache", &treeOptions, &seenKeys);
         CopyOption(plainOptions, "observations_to_bootstrap", &treeOptions, &seenKeys);
 
@@ -100,18 +100,19 @@ namespace {
 }
 
 static void WriteChunk(
-    const NCB::TQuantizedPool::TChunkDescription& chunk,
+    const NCB::NIdl::EBitsPerDocumentFeature bitsPerDocument,
+    const TConstArrayRef<ui8> quants,
+    const size_t documentOffset,
+    const size_t documentCount,
     TCountingOutput* const output,
     TDeque<TChunkInfo>* const chunkInfos,
     flatbuffers::FlatBufferBuilder* const builder) {
 
     builder->Clear();
 
-    const auto quantsOffset = builder->CreateVector(
-        chunk.Chunk->Quants()->data(),
-        chunk.Chunk->Quants()->size());
+    const auto quantsOffset = builder->CreateVector(quants.data(), quants.size());
     NCB::NIdl::TQuantizedFeatureChunkBuilder chunkBuilder(*builder);
-    chunkBuilder.add_BitsPerDocument(chunk.Chunk->BitsPerDocument());
+    chunkBuilder.add_BitsPerDocument(bitsPerDocument);
     chunkBuilder.add_Quants(quantsOffset);
     builder->Finish(chunkBuilder.Finish());
 
@@ -120,7 +121,7 @@ static void WriteChunk(
     const auto chunkOffset = output->Counter();
     output->Write(builder->GetBufferPointer(), builder->GetSize());
 
-    chunkInfos->emplace_back(builder->GetSize(), chunkOffset, chunk.DocumentOffset, chunk.DocumentCount);
+    chunkInfos->emplace_back(builder->GetSize(), chunkOffset, documentOffset, documentCount);
 }
 
 static void WriteHeader(TCountingOutput* const output) {
@@ -183,64 +184,131 @@ static TColumnsInfo MakeColumnsInfo(
     return columnsInfo;
 }
 
-static void WriteAsOneFile(const NCB::TQuantizedPool& pool, IOutputStream* slave) {
-    TCountingOutput output{slave};
+class NCB::TQuantizedPoolWriter::TImpl {
+public:
+    explicit TImpl(IOutputStream* const slave)
+        : Output{slave} {
+        WriteHeader(&Output);
+        ChunksOffset = Output.Counter();
+    }
 
-    WriteHeader(&output);
+    void AddColumn(const size_t trueFeatureIndex, const EColumn columnType) {
+        CB_ENSURE(!TrueFeatureIndexToLocalIndex.has(trueFeatureIndex), "column " << trueFeatureIndex << " is already added");
+        TrueFeatureIndexToLocalIndex.emplace(trueFeatureIndex, ColumnTypes.size());
+        ColumnTypes.push_back(columnType);
+        PerFeatureChunkInfos.emplace_back();
+    }
 
-    const auto chunksOffset = output.Counter();
+    void WriteChunk(
+        const size_t trueFeatureIndex,
+        const NCB::NIdl::EBitsPerDocumentFeature bitsPerDocument,
+        const size_t documentOffset,
+        const size_t documentCount,
+        const TConstArrayRef<ui8> quants) {
+
+        const auto localIndex = TrueFeatureIndexToLocalIndex.at(trueFeatureIndex);
+        ::WriteChunk(
+            bitsPerDocument,
+            quants,
+            documentOffset,
+            documentCount,
+            &Output,
+            &PerFeatureChunkInfos[localIndex],
+            &Builder);
+    }
 
-    const auto sortedTrueFeatureIndices = CollectAndSortKeys(pool.TrueFeatureIndexToLocalIndex);
-    TDeque<TDeque<TChunkInfo>> perFeatureChunkInfos;
-    perFeatureChunkInfos.resize(pool.TrueFeatureIndexToLocalIndex.size());
-    {
-        flatbuffers::FlatBufferBuilder builder;
-        for (const auto trueFeatureIndex : sortedTrueFeatureIndices) {
-            const auto localIndex = pool.TrueFeatureIndexToLocalIndex.at(trueFeatureIndex);
-            auto* const chunkInfos = &perFeatureChunkInfos[localIndex];
-            for (const auto& chunk : pool.Chunks[localIndex]) {
-                WriteChunk(chunk, &output, chunkInfos, &builder);
+    void Finish(const TPoolQuantizationSchema& quantizationSchema) {
+        const ui64 columnsInfoSizeOffset = Output.Counter();
+        {
+            const auto columnsInfo = MakeColumnsInfo(
+                TrueFeatureIndexToLocalIndex,
+                ColumnTypes);
+            const ui32 columnsInfoSize = columnsInfo.ByteSizeLong();
+            WriteLittleEndian(columnsInfoSize, &Output);
+            columnsInfo.SerializeToStream(&Output);
+        }
+
+        const ui64 quantizationSchemaSizeOffset = Output.Counter();
+        const ui32 quantizationSchemaSize = quantizationSchema.ByteSizeLong();
+        WriteLittleEndian(quantizationSchemaSize, &Output);
+        quantizationSchema.SerializeToStream(&Output);
+
+        const ui64 featureCountOffset = Output.Counter();
+        const auto sortedTrueFeatureIndices = CollectAndSortKeys(TrueFeatureIndexToLocalIndex);
+        const ui32 featureCount = sortedTrueFeatureIndices.size();
+        WriteLittleEndian(featureCount, &Output);
+        for (const ui32 trueFeatureIndex : sortedTrueFeatureIndices) {
+            const auto localIndex = TrueFeatureIndexToLocalIndex.at(trueFeatureIndex);
+            const ui32 chunkCount = PerFeatureChunkInfos[localIndex].size();
+
+            WriteLittleEndian(trueFeatureIndex, &Output);
+            WriteLittleEndian(chunkCount, &Output);
+            for (const auto& chunkInfo : PerFeatureChunkInfos[localIndex]) {
+                WriteLittleEndian(chunkInfo.Size, &Output);
+                WriteLittleEndian(chunkInfo.Offset, &Output);
+                WriteLittleEndian(chunkInfo.DocumentOffset, &Output);
+                WriteLittleEndian(chunkInfo.DocumentsInChunkCount, &Output);
             }
         }
-    }
 
-    const ui64 columnsInfoSizeOffset = output.Counter();
-    {
-        const auto columnsInfo = MakeColumnsInfo(
-            pool.TrueFeatureIndexToLocalIndex,
-            pool.ColumnTypes);
-        const ui32 columnsInfoSize = columnsInfo.ByteSizeLong();
-        WriteLittleEndian(columnsInfoSize, &output);
-        columnsInfo.SerializeToStream(&output);
+        WriteLittleEndian(ChunksOffset, &Output);
+        WriteLittleEndian(columnsInfoSizeOffset, &Output);
+        WriteLittleEndian(quantizationSchemaSizeOffset, &Output);
+        WriteLittleEndian(featureCountOffset, &Output);
+        Output.Write(MagicEnd, MagicEndSize);
     }
 
-    const ui64 quantizationSchemaSizeOffset = output.Counter();
-    const ui32 quantizationSchemaSize = pool.QuantizationSchema.ByteSizeLong();
-    WriteLittleEndian(quantizationSchemaSize, &output);
-    pool.QuantizationSchema.SerializeToStream(&output);
+private:
+    TCountingOutput Output;
+    ui64 ChunksOffset{0};
+    flatbuffers::FlatBufferBuilder Builder;
+    THashMap<size_t, size_t> TrueFeatureIndexToLocalIndex;
+    TVector<EColumn> ColumnTypes;
+    TDeque<TDeque<TChunkInfo>> PerFeatureChunkInfos;
+};
+
+NCB::TQuantizedPoolWriter::TQuantizedPoolWriter(IOutputStream* const output)
+    : Impl{MakeHolder<TImpl>(output)} {
+}
+
+NCB::TQuantizedPoolWriter::~TQuantizedPoolWriter() = default;
 
-    const ui64 featureCountOffset = output.Counter();
-    const ui32 featureCount = sortedTrueFeatureIndices.size();
-    WriteLittleEndian(featureCount, &output);
-    for (const ui32 trueFeatureIndex : sortedTrueFeatureIndices) {
+void NCB::TQuantizedPoolWriter::AddColumn(const size_t trueFeatureIndex, const EColumn columnType) {
+    Impl->AddColumn(trueFeatureIndex, columnType);
+}
+
+void NCB::TQuantizedPoolWriter::WriteChunk(
+    const size_t trueFeatureIndex,
+    const NIdl::EBitsPerDocumentFeature bitsPerDocument,
+    const size_t documentOffset,
+    const size_t documentCount,
+    const TConstArrayRef<ui8> quants) {
+
+    Impl->WriteChunk(trueFeatureIndex, bitsPerDocument, documentOffset, documentCount, quants);
+}
+
+void NCB::TQuantizedPoolWriter::Finish(const NIdl::TPoolQuantizationSchema& quantizationSchema) {
+    Impl->Finish(quantizationSchema);
+}
+
+static void WriteAsOneFile(const NCB::TQuantizedPool& pool, IOutputStream* slave) {
+    NCB::TQuantizedPoolWriter writer{slave};
+
+    const auto sortedTrueFeatureIndices = CollectAndSortKeys(pool.TrueFeatureIndexToLocalIndex);
+    for (const auto trueFeatureIndex : sortedTrueFeatureIndices) {
         const auto localIndex = pool.TrueFeatureIndexToLocalIndex.at(trueFeatureIndex);
-        const ui32 chunkCount = perFeatureChunkInfos[localIndex].size();
-
-        WriteLittleEndian(trueFeatureIndex, &output);
-        WriteLittleEndian(chunkCount, &output);
-        for (const auto& chunkInfo : perFeatureChunkInfos[localIndex]) {
-            WriteLittleEndian(chunkInfo.Size, &output);
-            WriteLittleEndian(chunkInfo.Offset, &output);
-            WriteLittleEndian(chunkInfo.DocumentOffset, &output);
-            WriteLittleEndian(chunkInfo.DocumentsInChunkCount, &output);
+        writer.AddColumn(trueFeatureIndex, pool.ColumnTypes[localIndex]);
+        for (const auto& chunk : pool.Chunks[localIndex]) {
+            writer.WriteChunk(
+                trueFeatureIndex,
+                chunk.Chunk->BitsPerDocument(),
+                chunk.DocumentOffset,
+                chunk.DocumentCount,
+                MakeArrayRef(chunk.Chunk->Quants()->data(), chunk.Chunk->Quants()->size()));
         }
     }
 
-    WriteLittleEndian(chunksOffset, &output);
-    WriteLittleEndian(columnsInfoSizeOffset, &output);
-    WriteLittleEndian(quantizationSchemaSizeOffset, &output);
-    WriteLittleEndian(featureCountOffset, &output);
-    output.Write(MagicEnd, MagicEndSize);
+    writer.Finish(pool.QuantizationSchema);
 }
 
 void NCB::SaveQuantizedPool(const TQuantizedPool& pool, IOutputStream* const output) {
@@ -1,7 +1,13 @@
 #pragma once
 
+#include <catboost/idl/pool/flat/quantized_chunk_t.fbs.h>
+#include <catboost/libs/column_description/column.h>
+
+#include <util/generic/array_ref.h>
 #include <util/generic/fwd.h>
+#include <util/generic/ptr.h>
 #include <util/stream/fwd.h>
+#include <util/system/types.h>
 
 namespace NCB {
     struct TQuantizedPool;
@@ -15,6 +21,27 @@ namespace NCB {
 namespace NCB {
     void SaveQuantizedPool(const TQuantizedPool& pool, IOutputStream* output);
 
+    // Writes quantized pool in the same format as `SaveQuantizedPool` without holding its chunks in
+    // memory: chunks are written as they come and only their offsets are kept until `Finish`.
+    class TQuantizedPoolWriter {
+    public:
+        explicit TQuantizedPoolWriter(IOutputStream* output);
+        ~TQuantizedPoolWriter();
+
+        void AddColumn(size_t trueFeatureIndex, EColumn columnType);
+        void WriteChunk(
+            size_t trueFeatureIndex,
+            NIdl::EBitsPerDocumentFeature bitsPerDocument,
+            size_t documentOffset,
+            size_t documentCount,
+            TConstArrayRef<ui8> quants);
+        void Finish(const NIdl::TPoolQuantizationSchema& quantizationSchema);
+
+    private:
+        class TImpl;
+        THolder<TImpl> Impl;
+    };
+
     struct TLoadQuantizedPoolParameters {
         bool LockMemory{true};
         bool Precharge{true};
@@ -153,6 +153,34 @@ Y_UNIT_TEST_SUITE(SerializationTests) {
         UNIT_ASSERT_VALUES_EQUAL(loadedPoolAsText, poolAsText);
     }
 
+    Y_UNIT_TEST(TestStreamingWriter) {
+        const auto pool = MakeQuantizedPool();
+        const auto path = TFsPath(GetSystemTempDir()) / "quantized_pool.bin";
+
+        {
+            TFileOutput output(path.GetPath());
+            NCB::TQuantizedPoolWriter writer(&output);
+            for (const auto& kv : pool.TrueFeatureIndexToLocalIndex) {
+                writer.AddColumn(kv.first, pool.ColumnTypes[kv.second]);
+            }
+            for (const auto& kv : pool.TrueFeatureIndexToLocalIndex) {
+                for (const auto& chunk : pool.Chunks[kv.second]) {
+                    writer.WriteChunk(
+                        kv.first,
+                        chunk.Chunk->BitsPerDocument(),
+                        chunk.DocumentOffset,
+                        chunk.DocumentCount,
+                        MakeArrayRef(chunk.Chunk->Quants()->data(), chunk.Chunk->Quants()->size()));
+                }
+            }
+            writer.Finish(pool.QuantizationSchema);
+        }
+
+        const auto loadedPool = NCB::LoadQuantizedPool(path.GetPath(), {false, false});
+
+        UNIT_ASSERT_VALUES_EQUAL(QuantizedPoolToString(loadedPool), QuantizedPoolToString(pool));
+    }
+
     Y_UNIT_TEST(TestLoadQuantizationSchema) {
         const auto pool = MakeQuantizedPool();
         const auto path = TFsPath(GetSystemTempDir()) / "quantized_pool.bin";
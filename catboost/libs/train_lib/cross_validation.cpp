@@ -172,6 +172,10 @@ static void PrepareFolds(
             &testData.AllFeatures
         );
 
+        if (contexts[foldIdx]->Params.ObliviousTreeOptions->ExclusiveFeatureBundling) {
+            BundleExclusiveFloatFeatures(contexts[foldIdx]->LearnProgress.FloatFeatures, contexts[foldIdx]->LocalExecutor, &learnData.AllFeatures);
+        }
+
         CheckLearnConsistency(lossDescription, allowConstLabel, learnData);
         CheckTestConsistency(lossDescription, learnData, testData);
 
@@ -330,13 +334,15 @@ void CrossValidate(
             ctx.PrevTreeLevelStats.Create(
                 ctx.LearnProgress.Folds,
                 CountNonCtrBuckets(CountSplits(ctx.LearnProgress.FloatFeatures), learnFolds[foldIdx].AllFeatures.OneHotValues),
-                static_cast<int>(ctx.Params.ObliviousTreeOptions->MaxDepth)
+                static_cast<int>(ctx.Params.ObliviousTreeOptions->MaxDepth),
+                GetBucketStatsSize(ctx.Params.BoostingOptions->BoostingType)
             );
         }
         ctx.SampledDocs.Create(
             ctx.LearnProgress.Folds,
             isPairwiseScoring,
-            GetBernoulliSampleRate(ctx.Params.ObliviousTreeOptions->BootstrapConfig)
+            GetBernoulliSampleRate(ctx.Params.ObliviousTreeOptions->BootstrapConfig),
+            ctx.Params.ObliviousTreeOptions->LeafPartitionedLayout
         ); // TODO(espetrov): create only if sample rate < 1
     }
 
@@ -89,6 +89,7 @@ static void LoadPools(
     const auto& cvParams = loadOptions.CvParams;
     if (cvParams.FoldCount != 0) {
         CB_ENSURE(loadOptions.TestSetPaths.empty(), "Test files are not supported in cross-validation mode");
+        CB_ENSURE(loadOptions.LearnSetPath.Scheme != "quantized", "Cross-validation is not supported for quantized pools");
         Y_VERIFY(cvParams.FoldIdx != -1);
 
         testPools->resize(1);
@@ -205,13 +206,15 @@ static void Train(
         ctx->PrevTreeLevelStats.Create(
             ctx->LearnProgress.Folds,
             CountNonCtrBuckets(CountSplits(ctx->LearnProgress.FloatFeatures), learnData.AllFeatures.OneHotValues),
-            static_cast<int>(ctx->Params.ObliviousTreeOptions->MaxDepth)
+            static_cast<int>(ctx->Params.ObliviousTreeOptions->MaxDepth),
+            GetBucketStatsSize(ctx->Params.BoostingOptions->BoostingType)
         );
     }
     ctx->SampledDocs.Create(
         ctx->LearnProgress.Folds,
         isPairwiseScoring,
-        GetBernoulliSampleRate(ctx->Params.ObliviousTreeOptions->BootstrapConfig)
+        GetBernoulliSampleRate(ctx->Params.ObliviousTreeOptions->BootstrapConfig),
+        ctx->Params.ObliviousTreeOptions->LeafPartitionedLayout
     ); // TODO(espetrov): create only if sample rate < 1
 
     for (ui32 iter = ctx->LearnProgress.TreeStruct.ysize(); iter < ctx->Params.BoostingOptions->IterationCount; ++iter) {
@@ -449,7 +452,14 @@ class TCPUModelTrainer : public IModelTrainer {
 
         ctx.OutputMeta();
 
-        GenerateBorders(learnPool, &ctx, &ctx.LearnProgress.FloatFeatures);
+        if (learnPool.Docs.IsQuantized()) {
+            SetBordersFromQuantizedPool(
+                learnPool,
+                ctx.Params.DataProcessingOptions->FloatFeaturesBinarization->NanMode,
+                &ctx.LearnProgress.FloatFeatures);
+        } else {
+            GenerateBorders(learnPool, &ctx, &ctx.LearnProgress.FloatFeatures);
+        }
 
         const auto& catFeatureParams = ctx.Params.CatFeatureParams.Get();
 
@@ -470,6 +480,16 @@ class TCPUModelTrainer : public IModelTrainer {
         for (size_t testIdx = 0; testIdx < testDataPtrs.size(); ++testIdx) {
             auto& testPool = *testPoolPtrs[testIdx];
             auto& testData = testDatasets[testIdx];
+            if (testPool.Docs.IsQuantized()) {
+                CB_ENSURE(testPool.QuantizedFeatureBorders.size() == ctx.LearnProgress.FloatFeatures.size(),
+                          "Quantized test pool should have the same features as learn pool");
+                for (const auto& floatFeature : ctx.LearnProgress.FloatFeatures) {
+                    CB_ENSURE(
+                        floatFeature.Borders.empty() || testPool.QuantizedFeatureBorders[floatFeature.FlatFeatureIndex] == floatFeature.Borders,
+                        "Quantized test pool should have the same borders as learn pool (feature " << floatFeature.FlatFeatureIndex << ")"
+                    );
+                }
+            }
             PrepareAllFeaturesTest(
                 ctx.CatFeatures,
                 ctx.LearnProgress.FloatFeatures,
@@ -484,6 +504,10 @@ class TCPUModelTrainer : public IModelTrainer {
             );
         }
 
+        if (ctx.Params.ObliviousTreeOptions->ExclusiveFeatureBundling) {
+            BundleExclusiveFloatFeatures(ctx.LearnProgress.FloatFeatures, ctx.LocalExecutor, &learnData.AllFeatures);
+        }
+
         ctx.InitContext(learnData, testDataPtrs);
 
         if (allowClearPool) {
@@ -618,7 +642,8 @@ class TCPUModelTrainer : public IModelTrainer {
             if (ctx.OutputOptions.GetFinalCtrComputationMode() == EFinalCtrComputationMode::Default) {
                 TVector<TModelCtrBase> usedCtrBases = Model.ObliviousTrees.GetUsedModelCtrBases();
 
-                bool exportRequiresStaticCtrProvider = AnyOf(
+                // precomputed ctr values are calculated from ctr tables kept in memory
+                bool exportRequiresStaticCtrProvider = updatedOutputOptions.PrecomputeCtrValues() || AnyOf(
                         updatedOutputOptions.GetModelFormats().cbegin(),
                         updatedOutputOptions.GetModelFormats().cend(),
                         [](EModelType format) {
@@ -641,7 +666,8 @@ class TCPUModelTrainer : public IModelTrainer {
                 outputFile = outputFile.substr(0, outputFile.length() - 4);
             }
             for (const auto& format : updatedOutputOptions.GetModelFormats()) {
-                ExportModel(Model, outputFile, format, "", addFileFormatExtension);
+                const bool precomputeCtrValues = format == EModelType::CatboostBinary && updatedOutputOptions.PrecomputeCtrValues();
+                ExportModel(Model, outputFile, format, precomputeCtrValues ? "{\"precompute_ctr_values\": true}" : "", addFileFormatExtension);
             }
         }
     }
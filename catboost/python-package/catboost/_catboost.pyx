@@ -7,10 +7,17 @@ from copy import deepcopy
 from collections import Sequence, defaultdict
 import numpy
 
+try:
+    from pandas import DataFrame
+except ImportError:
+    DataFrame = None
+
+cimport cython
 from cython.operator cimport dereference
 
 from libc.math cimport isnan
 from libc.stdint cimport uint32_t
+from libc.string cimport memcpy
 from libcpp cimport bool as bool_t
 from libcpp.map cimport map as cmap
 from libcpp.vector cimport vector
@@ -21,6 +28,7 @@ from util.generic.string cimport TStringBuf
 from util.generic.vector cimport TVector
 from util.generic.maybe cimport TMaybe
 from util.generic.hash cimport THashMap
+from util.system.types cimport i64, ui64
 
 
 class _NumpyAwareEncoder(JSONEncoder):
@@ -69,6 +77,44 @@ cdef extern from "catboost/python-package/catboost/helpers.h":
         const TString& tmpDir
     ) nogil except +ProcessException
 
+    cdef void SetFloatFeatures(
+        const float* data,
+        size_t docCount,
+        Py_ssize_t docStride,
+        Py_ssize_t featureStride,
+        const TVector[int]& featureIndices,
+        int threadCount,
+        TDocumentStorage* docs
+    ) nogil except +ProcessException
+
+    cdef void SetFloatFeatures(
+        const double* data,
+        size_t docCount,
+        Py_ssize_t docStride,
+        Py_ssize_t featureStride,
+        const TVector[int]& featureIndices,
+        int threadCount,
+        TDocumentStorage* docs
+    ) nogil except +ProcessException
+
+    cdef void SetFloatFeature(const float* column, size_t docCount, Py_ssize_t stride, TVector[float]* factor) nogil except +ProcessException
+    cdef void SetFloatFeature(const double* column, size_t docCount, Py_ssize_t stride, TVector[float]* factor) nogil except +ProcessException
+
+    cdef void SetCatFeature(
+        const TVector[TString]& values,
+        int threadCount,
+        TVector[float]* factor,
+        THashMap[int, TString]* hashToString
+    ) nogil except +ProcessException
+
+    cdef void SetCatFeature(
+        const i64* values,
+        size_t docCount,
+        int threadCount,
+        TVector[float]* factor,
+        THashMap[int, TString]* hashToString
+    ) nogil except +ProcessException
+
     cdef TVector[TString] GetMetricNames(
         const TFullModel& model,
         const TVector[TString]& metricsDescription
@@ -110,7 +156,7 @@ cdef extern from "catboost/libs/data/pool.h":
         TVector[float] Target
         TVector[float] Weight
         TVector[TString] Id
-        TVector[uint32_t] QueryId
+        TVector[ui64] QueryId
         TVector[uint32_t] SubgroupId
         int GetBaselineDimension() except +ProcessException const
         int GetEffectiveFactorCount() except +ProcessException const
@@ -181,6 +227,7 @@ cdef extern from "catboost/libs/model/model.h":
         TString FeatureId
 
     cdef cppclass TObliviousTrees:
+        int ApproxDimension
         TVector[TVector[double]] LeafWeights
         TVector[TCatFeature] CatFeatures
         TVector[TFloatFeature] FloatFeatures
@@ -361,6 +408,16 @@ cdef extern from "catboost/libs/algo/apply.h":
         int threadCount
     ) nogil except +ProcessException
 
+    cdef void ApplyModelStaged(
+        const TFullModel& model,
+        const TPool& pool,
+        int begin,
+        int end,
+        int evalPeriod,
+        int threadCount,
+        TVector[double]* stagedApprox
+    ) nogil except +ProcessException
+
 cdef extern from "catboost/libs/algo/helpers.h":
     cdef void ConfigureMalloc() nogil except *
 
@@ -450,6 +507,40 @@ cdef inline float _FloatOrNan(object obj) except *:
         raise ValueError("Cannot convert obj {} to float".format(str(obj)))
     return res
 
+cdef _set_float_vector(values, size_t size, TVector[float]* dst):
+    cdef const float[:] values_view = numpy.ascontiguousarray(values, dtype=numpy.float32).reshape(-1)
+    if <size_t>values_view.shape[0] != size:
+        raise CatboostError("Invalid values count={} : must be equal to {}".format(values_view.shape[0], size))
+    dst.resize(size)
+    if size > 0:
+        memcpy(dst.data(), &values_view[0], size * sizeof(float))
+
+cdef _set_uint32_vector(values, size_t size, TVector[uint32_t]* dst):
+    values = numpy.asarray(values).reshape(-1)
+    if <size_t>len(values) != size:
+        raise CatboostError("Invalid values count={} : must be equal to {}".format(len(values), size))
+    dst.resize(size)
+    if values.dtype.kind not in 'biu' or (size > 0 and (values.min() < 0 or values.max() > 0xFFFFFFFF)):
+        for i in range(size):
+            dereference(dst)[i] = int(values[i])
+        return
+    cdef const uint32_t[:] values_view = numpy.ascontiguousarray(values, dtype=numpy.uint32)
+    if size > 0:
+        memcpy(dst.data(), &values_view[0], size * sizeof(uint32_t))
+
+cdef _set_ui64_vector(values, size_t size, TVector[ui64]* dst):
+    values = numpy.asarray(values).reshape(-1)
+    if <size_t>len(values) != size:
+        raise CatboostError("Invalid values count={} : must be equal to {}".format(len(values), size))
+    dst.resize(size)
+    if values.dtype.kind not in 'biu' or (size > 0 and values.min() < 0):
+        for i in range(size):
+            dereference(dst)[i] = int(values[i])
+        return
+    cdef const ui64[:] values_view = numpy.ascontiguousarray(values, dtype=numpy.uint64)
+    if size > 0:
+        memcpy(dst.data(), &values_view[0], size * sizeof(ui64))
+
 cdef TString _MetricGetDescription(void* customData) except * with gil:
     cdef metricObject = <object>customData
     name = metricObject.__class__.__name__
@@ -732,13 +823,13 @@ cdef class _PoolBase:
         if len([target for target in self.__pool.Docs.Target]) > 1:
             self.has_label_ = True
 
-    cpdef _init_pool(self, data, label, cat_features, pairs, weight, group_id, group_weight, subgroup_id, pairs_weight, baseline, feature_names):
+    cpdef _init_pool(self, data, label, cat_features, pairs, weight, group_id, group_weight, subgroup_id, pairs_weight, baseline, feature_names, thread_count):
         if group_weight is not None and weight is not None:
             raise CatboostError('Pool must have either weight or group_weight.')
 
         if cat_features is not None:
             self._init_cat_features(cat_features)
-        self._set_data(data)
+        self._set_data(data, UpdateThreadCount(thread_count))
         num_class = 2
         if label is not None:
             self._set_label(label)
@@ -766,15 +857,102 @@ cdef class _PoolBase:
         for feature in cat_features:
             self.__pool.CatFeatures.push_back(int(feature))
 
-    cpdef _set_data(self, data):
+    cpdef _set_data(self, data, int thread_count=1):
         self.__pool.Docs.Clear()
         if len(data) == 0:
             return
         cdef bool_t has_group_id = not self.__pool.Docs.QueryId.empty()
         cdef bool_t has_subgroup_id = not self.__pool.Docs.SubgroupId.empty()
+        cat_features = set(self.get_cat_feature_indices())
+        if isinstance(data, numpy.ndarray) and data.ndim == 2 and data.dtype.kind in 'biuf':
+            self.__pool.Docs.Resize(data.shape[0], data.shape[1], 0, has_group_id, has_subgroup_id)
+            self._set_numeric_matrix(data, cat_features, thread_count)
+        elif (isinstance(data, numpy.ndarray) and data.ndim == 2) or (DataFrame is not None and isinstance(data, DataFrame)):
+            self.__pool.Docs.Resize(data.shape[0], data.shape[1], 0, has_group_id, has_subgroup_id)
+            # columns of DataFrame keep their own dtypes, numeric ones are not converted to objects
+            for j in range(data.shape[1]):
+                column = data[:, j] if isinstance(data, numpy.ndarray) else data.iloc[:, j].values
+                if j in cat_features:
+                    self._set_cat_feature_column(j, column, thread_count)
+                else:
+                    self._set_float_feature_column(j, column)
+        else:
+            self._set_data_by_rows(data, cat_features)
+
+    cdef _set_numeric_matrix(self, data, cat_features, int thread_count):
+        cdef TVector[int] float_features
+        for j in range(data.shape[1]):
+            if j in cat_features:
+                self._set_cat_feature_column(j, data[:, j], thread_count)
+            else:
+                float_features.push_back(j)
+        if float_features.empty() or data.shape[0] == 0:
+            return
+        if data.dtype != numpy.float32 and data.dtype != numpy.float64:
+            data = data.astype(numpy.float32)
+        # read-only and non-contiguous arrays are accepted as is, columns are copied by strides
+        cdef const float[:, :] float_data
+        cdef const double[:, :] double_data
+        cdef const float* float_ptr
+        cdef const double* double_ptr
+        if data.dtype == numpy.float32:
+            float_data = data
+            float_ptr = &float_data[0, 0]
+            with nogil:
+                SetFloatFeatures(float_ptr, float_data.shape[0], float_data.strides[0], float_data.strides[1],
+                                 float_features, thread_count, &self.__pool.Docs)
+        else:
+            double_data = data
+            double_ptr = &double_data[0, 0]
+            with nogil:
+                SetFloatFeatures(double_ptr, double_data.shape[0], double_data.strides[0], double_data.strides[1],
+                                 float_features, thread_count, &self.__pool.Docs)
+
+    cdef _set_float_feature_column(self, int feature_idx, column):
+        cdef TVector[float]* factor = &self.__pool.Docs.Factors[feature_idx]
+        if column.dtype.kind in 'biu':
+            column = column.astype(numpy.float32)
+        cdef const float[:] float_column
+        cdef const double[:] double_column
+        if column.dtype == numpy.float32:
+            float_column = column
+            if float_column.shape[0] > 0:
+                SetFloatFeature(&float_column[0], float_column.shape[0], float_column.strides[0], factor)
+        elif column.dtype == numpy.float64:
+            double_column = column
+            if double_column.shape[0] > 0:
+                SetFloatFeature(&double_column[0], double_column.shape[0], double_column.strides[0], factor)
+        else:
+            for i, value in enumerate(column):
+                dereference(factor)[i] = _FloatOrNan(value)
+
+    cdef _set_cat_feature_column(self, int feature_idx, column, int thread_count):
+        column = numpy.asarray(column)
+        if column.dtype.kind == 'f' and len(column) > 0 and numpy.all(numpy.floor(column) == column) and numpy.abs(column).max() < 2 ** 63:
+            column = column.astype(numpy.int64)
+        cdef const i64[:] int_column
+        if column.dtype.kind in 'bi' or (column.dtype.kind == 'u' and column.dtype.itemsize < 8):
+            int_column = numpy.ascontiguousarray(column, dtype=numpy.int64)
+            if int_column.shape[0] > 0:
+                SetCatFeature(&int_column[0], int_column.shape[0], thread_count,
+                              &self.__pool.Docs.Factors[feature_idx], &self.__pool.CatFeaturesHashToString)
+            return
+        cdef TVector[TString] values
+        values.reserve(len(column))
+        for i, factor in enumerate(column):
+            if not isinstance(factor, string_types):
+                if isnan(factor) or int(factor) != factor:
+                    raise CatboostError('Invalid type for cat_feature[{},{}]={} : cat_features must be integer or string, real number values and NaN values should be converted to string.'.format(i, feature_idx, factor))
+                factor = str(int(factor))
+            factor = to_binary_str(factor)
+            values.push_back(TString(<char*>factor))
+        SetCatFeature(values, thread_count, &self.__pool.Docs.Factors[feature_idx], &self.__pool.CatFeaturesHashToString)
+
+    cdef _set_data_by_rows(self, data, cat_features):
+        cdef bool_t has_group_id = not self.__pool.Docs.QueryId.empty()
+        cdef bool_t has_subgroup_id = not self.__pool.Docs.SubgroupId.empty()
         self.__pool.Docs.Resize(len(data), len(data[0]), 0, has_group_id, has_subgroup_id)
         cdef TString factor_str
-        cat_features = set(self.get_cat_feature_indices())
         for i in range(len(data)):
             for j, factor in enumerate(data[i]):
                 if j in cat_features:
@@ -791,9 +969,7 @@ cdef class _PoolBase:
                     self.__pool.Docs.Factors[j][i] = _FloatOrNan(factor)
 
     cpdef _set_label(self, label):
-        rows = self.num_row()
-        for i in range(rows):
-            self.__pool.Docs.Target[i] = float(label[i])
+        _set_float_vector(label, self.num_row(), &self.__pool.Docs.Target)
 
     cpdef _set_pairs(self, pairs):
         self.__pool.Pairs.clear()
@@ -804,9 +980,7 @@ cdef class _PoolBase:
             del pair_ptr
 
     cpdef _set_weight(self, weight):
-        rows = self.num_row()
-        for i in range(rows):
-            self.__pool.Docs.Weight[i] = float(weight[i])
+        _set_float_vector(weight, self.num_row(), &self.__pool.Docs.Weight)
         self.__pool.MetaInfo.HasGroupWeight = False
 
     cpdef _set_group_id(self, group_id):
@@ -817,16 +991,14 @@ cdef class _PoolBase:
         if rows == 0:
             return
         self.__pool.Docs.Resize(rows, self.__pool.Docs.GetEffectiveFactorCount(), self.__pool.Docs.GetBaselineDimension(), True, False)
-        for i in range(rows):
-            self.__pool.Docs.QueryId[i] = int(group_id[i])
+        _set_ui64_vector(group_id, rows, &self.__pool.Docs.QueryId)
 
     cpdef _set_group_weight(self, group_weight):
         rows = self.num_row()
         if rows == 0:
             return
         self.__pool.Docs.Resize(rows, self.__pool.Docs.GetEffectiveFactorCount(), self.__pool.Docs.GetBaselineDimension(), False, False)
-        for i in range(rows):
-            self.__pool.Docs.Weight[i] = float(group_weight[i])
+        _set_float_vector(group_weight, rows, &self.__pool.Docs.Weight)
         self.__pool.MetaInfo.HasGroupWeight = True
 
     cpdef _set_subgroup_id(self, subgroup_id):
@@ -837,22 +1009,27 @@ cdef class _PoolBase:
         if rows == 0:
             return
         self.__pool.Docs.Resize(rows, self.__pool.Docs.GetEffectiveFactorCount(), self.__pool.Docs.GetBaselineDimension(), False, True)
-        for i in range(rows):
-            self.__pool.Docs.SubgroupId[i] = int(subgroup_id[i])
+        _set_uint32_vector(subgroup_id, rows, &self.__pool.Docs.SubgroupId)
 
     cpdef _set_pairs_weight(self, pairs_weight):
         rows = self.num_pairs()
         for i in range(rows):
             self.__pool.Pairs[i].Weight = float(pairs_weight[i])
 
+    @cython.boundscheck(False)
     cpdef _set_baseline(self, baseline):
         rows = self.num_row()
         if rows == 0:
             return
-        self.__pool.Docs.Resize(rows, self.__pool.Docs.GetEffectiveFactorCount(), len(baseline[0]), False, False)
-        for i in range(rows):
-            for j, value in enumerate(baseline[i]):
-                self.__pool.Docs.Baseline[j][i] = float(value)
+        cdef const double[:, :] baseline_view = numpy.asarray(baseline, dtype=numpy.float64)
+        if baseline_view.shape[0] != rows:
+            raise CatboostError("Invalid baseline rows count={} : must be equal to {}".format(baseline_view.shape[0], rows))
+        self.__pool.Docs.Resize(rows, self.__pool.Docs.GetEffectiveFactorCount(), baseline_view.shape[1], False, False)
+        cdef Py_ssize_t i, j
+        with nogil:
+            for j in range(baseline_view.shape[1]):
+                for i in range(baseline_view.shape[0]):
+                    self.__pool.Docs.Baseline[j][i] = baseline_view[i, j]
 
     cpdef _set_feature_names(self, feature_names):
         self.__pool.FeatureId.clear()
@@ -1366,8 +1543,14 @@ cpdef _cv(dict params, _PoolBase pool, int fold_count, bool_t inverted, int part
     return result
 
 
+# staged approxes of at most this count of doubles are calculated at once
+cdef size_t _STAGED_PREDICT_BUFFER_SIZE = 1 << 24
+
 cdef class _StagedPredictIterator:
     cdef TVector[TVector[double]] __approx
+    cdef TVector[TVector[double]] __chunk_start_approx
+    cdef TVector[double] __staged_approx
+    cdef size_t __stage_idx, __stage_count
     cdef TFullModel* __model
     cdef _PoolBase pool
     cdef str prediction_type
@@ -1385,6 +1568,8 @@ cdef class _StagedPredictIterator:
         self.eval_period = eval_period
         self.thread_count = thread_count
         self.verbose = verbose
+        self.__stage_idx = 0
+        self.__stage_count = 0
 
     def __dealloc__(self):
         pass
@@ -1392,25 +1577,48 @@ cdef class _StagedPredictIterator:
     def __deepcopy__(self, _):
         raise CatboostError('Can\'t deepcopy _StagedPredictIterator object')
 
+    cdef _calc_next_stages(self):
+        cdef size_t doc_count = self.pool.__pool.Docs.GetDocCount()
+        cdef size_t approx_dimension = self.__model.ObliviousTrees.ApproxDimension
+        cdef size_t stage_size = doc_count * approx_dimension
+        cdef size_t dim
+        if self.__approx.empty():
+            self.__approx.resize(approx_dimension)
+            for dim in range(approx_dimension):
+                self.__approx[dim].resize(doc_count)
+        self.__chunk_start_approx = self.__approx
+        max_stage_count = max(1, _STAGED_PREDICT_BUFFER_SIZE // max(stage_size, 1))
+        cdef int chunk_end = min(self.ntree_end, self.ntree_start + self.eval_period * max_stage_count)
+        ApplyModelStaged(
+            dereference(self.__model),
+            dereference(self.pool.__pool),
+            self.ntree_start,
+            chunk_end,
+            self.eval_period,
+            self.thread_count,
+            &self.__staged_approx
+        )
+        self.__stage_count = self.__staged_approx.size() // max(stage_size, 1)
+        self.__stage_idx = 0
+
     def next(self):
         if self.ntree_start >= self.ntree_end:
             raise StopIteration
 
+        if self.__stage_idx >= self.__stage_count:
+            self._calc_next_stages()
+
+        cdef size_t doc_count = self.pool.__pool.Docs.GetDocCount()
+        cdef size_t approx_dimension = self.__approx.size()
+        cdef size_t dim, doc
+        cdef double* stage_approx = self.__staged_approx.data() + self.__stage_idx * approx_dimension * doc_count
+        for dim in range(approx_dimension):
+            for doc in range(doc_count):
+                self.__approx[dim][doc] = self.__chunk_start_approx[dim][doc] + stage_approx[dim * doc_count + doc]
+        self.__stage_idx += 1
+
         cdef TVector[TVector[double]] pred
         cdef EPredictionType predictionType = PyPredictionType(self.prediction_type).predictionType
-        pred = ApplyModelMulti(dereference(self.__model),
-                               dereference(self.pool.__pool),
-                               self.verbose,
-                               PyPredictionType('RawFormulaVal').predictionType,
-                               self.ntree_start,
-                               min(self.ntree_start + self.eval_period, self.ntree_end),
-                               self.thread_count)
-        if self.__approx.empty():
-            self.__approx = pred
-        else:
-            for i in range(self.__approx.size()):
-                for j in range(self.__approx[0].size()):
-                    self.__approx[i][j] += pred[i][j]
         pred = PrepareEval(predictionType, self.__approx, 1)
         self.ntree_start += self.eval_period
         return [[value for value in vec] for vec in pred]
@@ -258,8 +258,7 @@ class Pool(_PoolBase):
             Names for each given data_feature.
 
         thread_count : int, optional (default=-1)
-            Thread count to read data from file.
-            Use only with reading data from file.
+            Thread count to read data from file or to convert array like data.
             If -1, then the number of threads is set to the number of cores.
 
         """
@@ -274,7 +273,8 @@ class Pool(_PoolBase):
                                         baseline, feature_names should have the None type when the pool is read from the file.")
                 self._read(data, column_description, pairs, delimiter, has_header, thread_count)
             else:
-                self._init(data, label, cat_features, pairs, weight, group_id, group_weight, subgroup_id, pairs_weight, baseline, feature_names)
+                self._check_thread_count(thread_count)
+                self._init(data, label, cat_features, pairs, weight, group_id, group_weight, subgroup_id, pairs_weight, baseline, feature_names, thread_count)
         super(Pool, self).__init__()
 
     def _check_files(self, data, column_description, pairs):
@@ -560,19 +560,19 @@ class Pool(_PoolBase):
             self._check_thread_count(thread_count)
             self._read_pool(pool_file, column_description, pairs, delimiter[0], has_header, thread_count)
 
-    def _init(self, data_matrix, label, cat_features, pairs, weight, group_id, group_weight, subgroup_id, pairs_weight, baseline, feature_names):
+    def _init(self, data_matrix, label, cat_features, pairs, weight, group_id, group_weight, subgroup_id, pairs_weight, baseline, feature_names, thread_count):
         """
         Initialize Pool from array like data.
         """
         if isinstance(data_matrix, DataFrame):
+            # DataFrame is converted by columns, so numeric columns are not converted to objects
             feature_names = list(data_matrix.columns)
-            data_matrix = data_matrix.values
         if isinstance(data_matrix, Series):
             data_matrix = data_matrix.values.tolist()
         if len(np.shape(data_matrix)) == 1:
             data_matrix = np.expand_dims(data_matrix, 1)
         samples_count = len(data_matrix)
-        features_count = len(data_matrix[0])
+        features_count = data_matrix.shape[1] if isinstance(data_matrix, DataFrame) else len(data_matrix[0])
         pairs_len = 0
         if label is not None:
             self._check_label_type(label)
@@ -615,7 +615,7 @@ class Pool(_PoolBase):
             self._check_baseline_shape(baseline, samples_count)
         if feature_names is not None:
             self._check_feature_names(feature_names, features_count)
-        self._init_pool(data_matrix, label, cat_features, pairs, weight, group_id, group_weight, subgroup_id, pairs_weight, baseline, feature_names)
+        self._init_pool(data_matrix, label, cat_features, pairs, weight, group_id, group_weight, subgroup_id, pairs_weight, baseline, feature_names, thread_count)
 
 
 def _build_train_pool(X, y, cat_features, pairs, sample_weight, group_id, group_weight, subgroup_id, pairs_weight, baseline, column_description):
@@ -1518,6 +1518,8 @@ class CatBoost(_CatBoostBase):
                 * coreml_model_version : string
                 * coreml_model_author : string
                 * coreml_model_license: string
+            Parameters for CatBoost binary format:
+                * precompute_ctr_values : bool - store precomputed ctr values, model file is larger but ctrs are applied faster
         """
         if not self.is_fitted_:
             raise CatboostError("There is no trained model to use save_model(). Use fit() to train model. Then use save_model().")
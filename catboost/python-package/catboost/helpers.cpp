@@ -2,10 +2,16 @@
 
 #include "helpers.h"
 
+#include <catboost/libs/cat_feature/cat_feature.h>
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/helpers/interrupt.h>
 #include <catboost/libs/data_types/groupid.h>
 
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/cast.h>
+#include <util/string/cast.h>
+
 extern "C" PyObject* PyCatboostExceptionType;
 
 void ProcessException() {
@@ -35,6 +41,87 @@ void ResetPythonInterruptHandler() {
     ResetInterruptHandler();
 }
 
+template <class T>
+static void SetFloatFeatureImpl(const T* column, size_t docCount, ptrdiff_t stride, TVector<float>* factor) {
+    factor->yresize(docCount);
+    if (std::is_same<T, float>::value && stride == sizeof(float)) {
+        memcpy(factor->data(), column, docCount * sizeof(float));
+        return;
+    }
+    const char* value = reinterpret_cast<const char*>(column);
+    for (size_t doc = 0; doc < docCount; ++doc, value += stride) {
+        (*factor)[doc] = static_cast<float>(*reinterpret_cast<const T*>(value));
+    }
+}
+
+template <class T>
+static void SetFloatFeaturesImpl(const T* data, size_t docCount, ptrdiff_t docStride, ptrdiff_t featureStride,
+                                 const TVector<int>& featureIndices, int threadCount, TDocumentStorage* docs) {
+    NPar::TLocalExecutor localExecutor;
+    localExecutor.RunAdditionalThreads(threadCount - 1);
+    localExecutor.ExecRange([&](int idx) {
+        const int featureIdx = featureIndices[idx];
+        const T* column = reinterpret_cast<const T*>(reinterpret_cast<const char*>(data) + featureIdx * featureStride);
+        SetFloatFeatureImpl(column, docCount, docStride, &docs->Factors[featureIdx]);
+    }, 0, featureIndices.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
+}
+
+void SetFloatFeatures(const float* data, size_t docCount, ptrdiff_t docStride, ptrdiff_t featureStride,
+                      const TVector<int>& featureIndices, int threadCount, TDocumentStorage* docs) {
+    SetFloatFeaturesImpl(data, docCount, docStride, featureStride, featureIndices, threadCount, docs);
+}
+
+void SetFloatFeatures(const double* data, size_t docCount, ptrdiff_t docStride, ptrdiff_t featureStride,
+                      const TVector<int>& featureIndices, int threadCount, TDocumentStorage* docs) {
+    SetFloatFeaturesImpl(data, docCount, docStride, featureStride, featureIndices, threadCount, docs);
+}
+
+void SetFloatFeature(const float* column, size_t docCount, ptrdiff_t stride, TVector<float>* factor) {
+    SetFloatFeatureImpl(column, docCount, stride, factor);
+}
+
+void SetFloatFeature(const double* column, size_t docCount, ptrdiff_t stride, TVector<float>* factor) {
+    SetFloatFeatureImpl(column, docCount, stride, factor);
+}
+
+void SetCatFeature(const TVector<TString>& values, int threadCount, TVector<float>* factor, THashMap<int, TString>* hashToString) {
+    const int docCount = values.ysize();
+    factor->yresize(docCount);
+    if (docCount == 0) {
+        return;
+    }
+    NPar::TLocalExecutor localExecutor;
+    localExecutor.RunAdditionalThreads(threadCount - 1);
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, docCount);
+    blockParams.SetBlockCount(threadCount);
+    // hash to string maps of blocks are merged afterwards, most of values are repeated
+    TVector<THashMap<int, TStringBuf>> blockHashToString(blockParams.GetBlockCount());
+    localExecutor.ExecRange([&](int blockIdx) {
+        auto& blockMap = blockHashToString[blockIdx];
+        const int blockEnd = Min(docCount, (blockIdx + 1) * blockParams.GetBlockSize());
+        for (int doc = blockIdx * blockParams.GetBlockSize(); doc < blockEnd; ++doc) {
+            const int hash = CalcCatFeatureHash(values[doc]);
+            (*factor)[doc] = ConvertCatFeatureHashToFloat(hash);
+            blockMap.emplace(hash, values[doc]);
+        }
+    }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
+    for (const auto& blockMap : blockHashToString) {
+        for (const auto& hashWithString : blockMap) {
+            (*hashToString)[hashWithString.first] = hashWithString.second;
+        }
+    }
+}
+
+void SetCatFeature(const i64* values, size_t docCount, int threadCount, TVector<float>* factor, THashMap<int, TString>* hashToString) {
+    TVector<TString> strings(docCount);
+    NPar::TLocalExecutor localExecutor;
+    localExecutor.RunAdditionalThreads(threadCount - 1);
+    localExecutor.ExecRange([&](int doc) {
+        strings[doc] = ToString(values[doc]);
+    }, 0, SafeIntegerCast<int>(docCount), NPar::TLocalExecutor::WAIT_COMPLETE);
+    SetCatFeature(strings, threadCount, factor, hashToString);
+}
+
 TVector<TVector<double>> EvalMetrics(
     const TFullModel& model,
     const TPool& pool,
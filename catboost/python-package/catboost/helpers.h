@@ -1,6 +1,9 @@
 #pragma once
 
 #include <catboost/libs/algo/plot.h>
+#include <catboost/libs/data/pool.h>
+
+#include <util/generic/hash.h>
 
 #include <util/generic/noncopyable.h>
 
@@ -35,6 +38,19 @@ TVector<TVector<double>> EvalMetrics(
     const TString& tmpDir
 );
 
+// Strides are in bytes as in numpy arrays, columns are copied in parallel
+void SetFloatFeatures(const float* data, size_t docCount, ptrdiff_t docStride, ptrdiff_t featureStride,
+                      const TVector<int>& featureIndices, int threadCount, TDocumentStorage* docs);
+void SetFloatFeatures(const double* data, size_t docCount, ptrdiff_t docStride, ptrdiff_t featureStride,
+                      const TVector<int>& featureIndices, int threadCount, TDocumentStorage* docs);
+
+void SetFloatFeature(const float* column, size_t docCount, ptrdiff_t stride, TVector<float>* factor);
+void SetFloatFeature(const double* column, size_t docCount, ptrdiff_t stride, TVector<float>* factor);
+
+// Values of categorical feature are hashed in parallel
+void SetCatFeature(const TVector<TString>& values, int threadCount, TVector<float>* factor, THashMap<int, TString>* hashToString);
+void SetCatFeature(const i64* values, size_t docCount, int threadCount, TVector<float>* factor, THashMap<int, TString>* hashToString);
+
 TVector<TString> GetMetricNames(const TFullModel& model, const TVector<TString>& metricsDescription);
 
 TVector<double> EvalMetricsForUtils(
@@ -126,6 +126,30 @@ def test_load_df_vs_load_from_file():
     assert pool1 == pool2
 
 
+def test_load_numpy_columns_vs_load_by_rows():
+    pool_size = (100, 6)
+    cat_features = [1, 4]
+    data = np.round(np.random.normal(size=pool_size), decimals=3)
+    data[:, cat_features] = np.random.randint(10, size=(pool_size[0], len(cat_features)))
+    label = np.random.randint(2, size=pool_size[0])
+    weight = np.random.random(pool_size[0])
+    baseline = np.random.random((pool_size[0], 2))
+    # group ids do not fit in 32 bits
+    group_id = np.sort(np.random.randint(10, size=pool_size[0])) + 2 ** 40
+    pool1 = Pool(data.tolist(), label.tolist(), cat_features, weight=weight.tolist(), baseline=baseline.tolist(), group_id=group_id.tolist())
+
+    readonly_data = np.asfortranarray(data, dtype=np.float32)
+    readonly_data.setflags(write=False)
+    pool2 = Pool(readonly_data, label, cat_features, weight=weight, baseline=baseline, group_id=group_id)
+    assert pool1 == pool2
+
+    df = DataFrame(data)
+    df[cat_features] = df[cat_features].astype(int)
+    pool3 = Pool(df, label, cat_features, weight=weight, baseline=baseline, group_id=group_id, thread_count=2)
+    assert _check_data(pool1.get_features(), pool3.get_features())
+    assert _check_data(pool1.get_label(), pool3.get_label())
+
+
 def test_load_series():
     pool = Pool(TRAIN_FILE, column_description=CD_FILE)
     data = read_table(TRAIN_FILE, header=None)
@@ -321,6 +345,18 @@ def test_save_model():
     assert _check_data(pred1, pred2)
 
 
+def test_save_model_with_precomputed_ctr_values():
+    train_pool = Pool(TRAIN_FILE, column_description=CD_FILE)
+    test_pool = Pool(TEST_FILE, column_description=CD_FILE)
+    model = CatBoost({'iterations': 10, 'random_seed': 0})
+    model.fit(train_pool)
+    model.save_model(OUTPUT_MODEL_PATH, export_parameters={'precompute_ctr_values': True})
+    model2 = CatBoost(model_file=OUTPUT_MODEL_PATH)
+    pred1 = model.predict(test_pool)
+    pred2 = model2.predict(test_pool)
+    assert np.array_equal(pred1, pred2)
+
+
 def test_multiclass():
     pool = Pool(CLOUDNESS_TRAIN_FILE, column_description=CLOUDNESS_CD_FILE)
     classifier = CatBoostClassifier(iterations=2, random_seed=0, loss_function='MultiClass', thread_count=8)